@@ -51,7 +51,8 @@ void AISystem::tick( float timeElapsed )
 {
    // AI frame definition
 
-   // 1. update animations ( LAST )
+   // 1. update animations ( LAST ) - the worlds are ticked one after another, each of them
+   //    distributes the sampling of its players' poses between the worker threads
    for ( List< AnimationWorld* >::iterator it = m_worlds.begin(); !it.isEnd(); ++it )
    {
       AnimationWorld* world = *it;
@@ -0,0 +1,162 @@
+#include "core-AI\AnimationLODManager.h"
+#include "core-AI\AnimationPlayer.h"
+#include "core-MVC\Entity.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   // every how many frames are the players with the specified update rates sampled
+   const uint g_updatePeriods[] = { 1, 2, 4, 0 };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+AnimationLODState::AnimationLODState()
+   : m_staggerOffset( 0 )
+{
+   reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationLODState::reset()
+{
+   m_updateRate = AUR_EveryFrame;
+   m_samplesCount = 0;
+   m_timeSinceSample = 0.0f;
+   m_framesSinceSample = 0;
+   m_sampleThisFrame = true;
+   m_timeToSample = 0.0f;
+   m_interpolationProgress = 1.0f;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+AnimationLODManager::AnimationLODManager()
+   : m_viewpoint( Vector_ZERO )
+   , m_everyFrameDistanceSq( 20.0f * 20.0f )
+   , m_every2ndFrameDistanceSq( 50.0f * 50.0f )
+   , m_visibilityProvider( NULL )
+   , m_enabled( false )
+   , m_frameIdx( 0 )
+   , m_nextStaggerOffset( 0 )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationLODManager::setDistances( float everyFrameDistance, float every2ndFrameDistance )
+{
+   m_everyFrameDistanceSq = everyFrameDistance * everyFrameDistance;
+   m_every2ndFrameDistanceSq = every2ndFrameDistance * every2ndFrameDistance;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationLODManager::nextFrame()
+{
+   ++m_frameIdx;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationLODManager::registerPlayer( AnimationPlayer& player )
+{
+   // consecutive players land in different frames of the longest update period
+   player.accessLODState().m_staggerOffset = m_nextStaggerOffset;
+   m_nextStaggerOffset = ( m_nextStaggerOffset + 1 ) % g_updatePeriods[AUR_Every4thFrame];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationLODManager::updatePlayer( AnimationPlayer& player, float timeElapsed ) const
+{
+   AnimationLODState& state = player.accessLODState();
+   const AnimationUpdateRate prevUpdateRate = state.m_updateRate;
+   state.m_updateRate = m_enabled ? calcUpdateRate( player ) : AUR_EveryFrame;
+
+   if ( state.m_updateRate == AUR_Paused )
+   {
+      // the time doesn't flow for the paused players
+      state.m_sampleThisFrame = false;
+      return;
+   }
+
+   if ( prevUpdateRate == AUR_Paused )
+   {
+      // the poses sampled before the player was paused are out of date - it needs
+      // a fresh one right away, regardless of the frame its update period starts in
+      state.m_samplesCount = 0;
+      state.m_framesSinceSample = 0;
+   }
+
+   state.m_timeSinceSample += timeElapsed;
+
+   // a player that was just started needs a pose to begin with
+   const uint period = g_updatePeriods[state.m_updateRate];
+   state.m_sampleThisFrame = state.m_samplesCount == 0 || ( ( m_frameIdx + state.m_staggerOffset ) % period ) == 0;
+   if ( state.m_sampleThisFrame )
+   {
+      state.m_timeToSample = state.m_timeSinceSample;
+      state.m_timeSinceSample = 0.0f;
+      state.m_framesSinceSample = 0;
+      if ( state.m_samplesCount < 2 )
+      {
+         ++state.m_samplesCount;
+      }
+   }
+   else
+   {
+      ++state.m_framesSinceSample;
+   }
+
+   // the displayed pose trails the sampled one, so that the frames in between can be interpolated
+   // between the last two sampled poses - it reaches the last sampled pose just before the next one gets sampled.
+   // Until there are two poses to interpolate between, the only sampled one is displayed
+   const uint framesCount = state.m_framesSinceSample + 1;
+   if ( state.m_samplesCount < 2 || framesCount >= period )
+   {
+      state.m_interpolationProgress = 1.0f;
+   }
+   else
+   {
+      state.m_interpolationProgress = (float)framesCount / (float)period;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+AnimationUpdateRate AnimationLODManager::calcUpdateRate( const AnimationPlayer& player ) const
+{
+   const Entity* entity = player.getParent();
+   if ( !entity )
+   {
+      return AUR_EveryFrame;
+   }
+
+   if ( m_visibilityProvider && !m_visibilityProvider->isVisible( entity ) )
+   {
+      return AUR_Paused;
+   }
+
+   Vector toEntity;
+   toEntity.setSub( entity->getGlobalMtx().position(), m_viewpoint );
+   const float distanceSq = toEntity.lengthSq().getFloat();
+   if ( distanceSq < m_everyFrameDistanceSq )
+   {
+      return AUR_EveryFrame;
+   }
+   else if ( distanceSq < m_every2ndFrameDistanceSq )
+   {
+      return AUR_Every2ndFrame;
+   }
+   else
+   {
+      return AUR_Every4thFrame;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -12,6 +12,7 @@ END_OBJECT();
 AnimationPlayer::AnimationPlayer( const char* name )
    : Component( name )
    , m_isPlaying( false )
+   , m_poseCache( NULL )
 {
 }
 
@@ -20,6 +21,7 @@ AnimationPlayer::AnimationPlayer( const char* name )
 AnimationPlayer::AnimationPlayer( const AnimationPlayer& rhs )
    : Component( rhs )
    , m_isPlaying( false )
+   , m_poseCache( NULL )
 {
 }
 
@@ -34,6 +36,7 @@ AnimationPlayer::~AnimationPlayer()
 void AnimationPlayer::start()
 {
    m_isPlaying = true;
+   m_lodState.reset();
 
    onStarted();
 }
@@ -0,0 +1,233 @@
+#include "core-AI\AnimationPoseCache.h"
+#include "core-AI\SnapshotAnimation.h"
+#include "core\CriticalSection.h"
+#include "core\Transform.h"
+#include "core\Math.h"
+#include "core\Assert.h"
+#include <math.h>
+#include <string.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool AnimationPoseCache::Key::operator==( const Key& rhs ) const
+{
+   return m_animation == rhs.m_animation && m_skeleton == rhs.m_skeleton && m_timeIdx == rhs.m_timeIdx;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint AnimationPoseCache::Key::getHash() const
+{
+   uint hash = (uint)m_animation;
+   hash = hash * 31 + (uint)m_skeleton;
+   hash = hash * 31 + (uint)m_timeIdx;
+
+   // mix the bits, so that the low ones the table is indexed with depend on all of them
+   hash ^= hash >> 16;
+   hash *= 0x85ebca6b;
+   hash ^= hash >> 13;
+   hash *= 0xc2b2ae35;
+   hash ^= hash >> 16;
+
+   return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+AnimationPoseCache::AnimationPoseCache()
+   : m_enabled( false )
+   , m_timeQuantum( 1.0f / 120.0f )
+   , m_maxEntriesCount( 0 )
+   , m_lock( new CriticalSection() )
+   , m_usedEntriesCount( 0 )
+{
+   setMaxEntriesCount( 256 );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+AnimationPoseCache::~AnimationPoseCache()
+{
+   const uint count = m_entries.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      delete m_entries[i];
+   }
+   m_entries.clear();
+   m_entriesTable.clear();
+
+   delete m_lock;
+   m_lock = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationPoseCache::setTimeQuantum( float quantum )
+{
+   ASSERT_MSG( quantum > 0.0f, "Invalid time quantum" );
+   m_timeQuantum = quantum;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationPoseCache::setMaxEntriesCount( uint count )
+{
+   m_maxEntriesCount = count;
+
+   uint capacity = 16;
+   while ( capacity < count * 2 )
+   {
+      capacity <<= 1;
+   }
+
+   // rebuild the table, keeping the entries used this frame
+   m_entriesTable.resize( capacity );
+   memset( m_entriesTable.getRaw(), 0, sizeof( Entry* ) * capacity );
+
+   if ( m_usedEntriesCount > count )
+   {
+      m_usedEntriesCount = count;
+   }
+
+   for ( uint i = 0; i < m_usedEntriesCount; ++i )
+   {
+      insertEntry( m_entries[i] );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationPoseCache::nextFrame()
+{
+   memset( m_entriesTable.getRaw(), 0, sizeof( Entry* ) * m_entriesTable.size() );
+   m_usedEntriesCount = 0;
+
+   m_hitsCount.set( 0 );
+   m_missesCount.set( 0 );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationPoseCache::samplePose( const SnapshotAnimation& animation, const Skeleton* skeleton, float trackTime, Transform* outBoneLocalTransforms, uint bonesCount )
+{
+   if ( !m_enabled )
+   {
+      animation.samplePose( trackTime, outBoneLocalTransforms, bonesCount );
+      return;
+   }
+
+   Key key;
+   key.m_animation = &animation;
+   key.m_skeleton = skeleton;
+   key.m_timeIdx = (int)floor( trackTime / m_timeQuantum + 0.5f );
+   const float quantizedTrackTime = (float)key.m_timeIdx * m_timeQuantum;
+
+   // the clip may animate fewer bones than the skeleton has - the remaining bones are left intact
+   const uint sampledBonesCount = min2( bonesCount, animation.m_bonesCount );
+
+   Entry* entry = NULL;
+   bool sampleIntoEntry = false;
+   {
+      CriticalSectionedSection lock( *m_lock );
+
+      entry = findEntry( key );
+      if ( entry )
+      {
+         // if the pose is still being sampled by another player, don't wait for it - sample it here
+         entry = entry->m_ready ? entry : NULL;
+      }
+      else
+      {
+         entry = allocateEntry();
+         if ( entry )
+         {
+            entry->m_key = key;
+            entry->m_ready = false;
+            insertEntry( entry );
+            sampleIntoEntry = true;
+         }
+      }
+   }
+
+   if ( entry && !sampleIntoEntry )
+   {
+      // the entries sampled this frame don't change until the next one
+      m_hitsCount.increment();
+      memcpy( outBoneLocalTransforms, entry->m_pose.getRaw(), sizeof( Transform ) * sampledBonesCount );
+      return;
+   }
+
+   m_missesCount.increment();
+   animation.samplePose( quantizedTrackTime, outBoneLocalTransforms, bonesCount );
+
+   if ( sampleIntoEntry )
+   {
+      // the entry is reserved for this thread until it's marked as ready
+      entry->m_pose.resizeWithoutInitializing( sampledBonesCount );
+      memcpy( entry->m_pose.getRaw(), outBoneLocalTransforms, sizeof( Transform ) * sampledBonesCount );
+
+      CriticalSectionedSection lock( *m_lock );
+      entry->m_ready = true;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+float AnimationPoseCache::getHitRate() const
+{
+   const uint hitsCount = getHitsCount();
+   const uint requestsCount = hitsCount + getMissesCount();
+   return requestsCount > 0 ? (float)hitsCount / (float)requestsCount : 0.0f;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+AnimationPoseCache::Entry* AnimationPoseCache::allocateEntry()
+{
+   if ( m_usedEntriesCount >= m_maxEntriesCount )
+   {
+      return NULL;
+   }
+
+   if ( m_usedEntriesCount == m_entries.size() )
+   {
+      m_entries.push_back( new Entry() );
+   }
+
+   Entry* entry = m_entries[m_usedEntriesCount];
+   ++m_usedEntriesCount;
+   return entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+AnimationPoseCache::Entry* AnimationPoseCache::findEntry( const Key& key ) const
+{
+   const uint mask = m_entriesTable.size() - 1;
+   for ( uint idx = key.getHash() & mask; ; idx = ( idx + 1 ) & mask )
+   {
+      Entry* entry = m_entriesTable[idx];
+      if ( !entry || entry->m_key == key )
+      {
+         return entry;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationPoseCache::insertEntry( Entry* entry )
+{
+   const uint mask = m_entriesTable.size() - 1;
+   uint idx = entry->m_key.getHash() & mask;
+   while ( m_entriesTable[idx] )
+   {
+      idx = ( idx + 1 ) & mask;
+   }
+
+   m_entriesTable[idx] = entry;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -4,12 +4,15 @@
 #include "core-MVC\Model.h"
 #include "core\ListUtils.h"
 #include "core\Assert.h"
+#include "core\MultithreadedTasksScheduler.h"
+#include "core\Profiler.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
 AnimationWorld::AnimationWorld()
    : m_playing( false )
+   , m_parallelUpdates( true )
 {
    AISystem& animSys = TSingleton< AISystem >::getInstance();
    animSys.registerWorld( this );
@@ -48,6 +51,8 @@ void AnimationWorld::onNodeAdded( SceneNode* node )
    {
       // this is the first added instance
       m_players.pushBack( player );
+      m_lodManager.registerPlayer( *player );
+      player->setPoseCache( &m_poseCache );
 
       if ( m_playing && player->isEnabled() )
       {
@@ -72,6 +77,14 @@ void AnimationWorld::onNodeRemoved( SceneNode* node )
    {
       AnimationPlayer* player = *it;
       it.markForRemoval();
+      player->setPoseCache( NULL );
+
+      // the player may be removed while the other ones are publishing their results
+      uint activePlayerIdx = m_activePlayers.find( player );
+      if ( activePlayerIdx != EOA )
+      {
+         m_activePlayers[activePlayerIdx] = NULL;
+      }
 
       // before the player gets detached, make it restore the controlled object's transforms
       if ( player->isPlaying() )
@@ -93,7 +106,12 @@ void AnimationWorld::onNodeChanged( SceneNode* node )
 void AnimationWorld::resetContents( Model& model )
 {
    simulationFinished();
+   for ( List< AnimationPlayer* >::iterator it = m_players.begin(); !it.isEnd(); ++it )
+   {
+      ( *it )->setPoseCache( NULL );
+   }
    m_players.clear();
+   m_activePlayers.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -148,8 +166,49 @@ void AnimationWorld::simulationFinished()
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// minimum number of players sampled by a single job
+#define MIN_PLAYERS_PER_JOB      4
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct AnimationWorld::PosesSampler
+{
+   AnimationPlayer* const*    m_players;
+   float                      m_timeElapsed;
+
+   PosesSampler( AnimationPlayer* const* players, float timeElapsed )
+      : m_players( players )
+      , m_timeElapsed( timeElapsed )
+   {}
+
+   void operator()( uint chunkStart, uint chunkEnd ) const
+   {
+      for ( uint i = chunkStart; i < chunkEnd; ++i )
+      {
+         AnimationPlayer* player = m_players[i];
+         const AnimationLODState& lodState = player->getLODState();
+         if ( lodState.m_sampleThisFrame )
+         {
+            player->samplePoses( lodState.m_timeToSample );
+         }
+
+         if ( lodState.m_updateRate != AUR_EveryFrame )
+         {
+            player->interpolatePoses( lodState.m_interpolationProgress, m_timeElapsed );
+         }
+      }
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 void AnimationWorld::tickAnimations( float timeElapsed )
 {
+   // update the players' statuses and start the frame - the players get started and stopped here,
+   // which affects the scene, so it needs to be done serially
+   m_lodManager.nextFrame();
+   m_poseCache.nextFrame();
+   m_activePlayers.clear();
    for ( List< AnimationPlayer* >::iterator it = m_players.begin(); !it.isEnd(); ++it )
    {
       AnimationPlayer* player = *it;
@@ -174,11 +233,70 @@ void AnimationWorld::tickAnimations( float timeElapsed )
 
       if ( player->isPlaying() )
       {
-         player->onFrameStart();
-         player->samplePoses( timeElapsed );
+         // decide whether the player's poses should be sampled or interpolated this frame
+         m_lodManager.updatePlayer( *player, timeElapsed );
+
+         const AnimationLODState& lodState = player->getLODState();
+         if ( lodState.m_sampleThisFrame )
+         {
+            player->onFrameStart();
+         }
+
+         if ( lodState.m_updateRate != AUR_Paused )
+         {
+            m_activePlayers.push_back( player );
+         }
+      }
+   }
+
+   // sample the poses
+   const uint playersCount = m_activePlayers.size();
+   PosesSampler posesSampler( m_activePlayers.getRaw(), timeElapsed );
+   if ( m_parallelUpdates )
+   {
+      MultithreadedTasksScheduler& scheduler = TSingleton< MultithreadedTasksScheduler >::getInstance();
+      scheduler.parallelFor( 0, playersCount, scheduler.calcGrainSize( playersCount, MIN_PLAYERS_PER_JOB ), posesSampler );
+   }
+   else
+   {
+      posesSampler( 0, playersCount );
+   }
+
+   profilePoseCache();
+
+   // publish the results in a deterministic order
+   for ( uint i = 0; i < playersCount; ++i )
+   {
+      AnimationPlayer* player = m_activePlayers[i];
+      if ( player )
+      {
          player->onFrameEnd();
       }
    }
+   m_activePlayers.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AnimationWorld::profilePoseCache() const
+{
+   if ( !m_poseCache.isEnabled() )
+   {
+      return;
+   }
+
+   {
+      uint poseCacheHits = m_poseCache.getHitsCount();
+      PROFILE_VALUE( uint, poseCacheHits );
+   }
+   {
+      uint poseCacheMisses = m_poseCache.getMissesCount();
+      PROFILE_VALUE( uint, poseCacheMisses );
+   }
+   {
+      float poseCacheHitRate = m_poseCache.getHitRate();
+      PROFILE_VALUE( float, poseCacheHitRate );
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
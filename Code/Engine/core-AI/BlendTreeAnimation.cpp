@@ -9,6 +9,7 @@
 #include "core-AI\BlendTreeSyncPoint.h"
 #include "core-AI\BlendTreeSyncProfile.h"
 #include "core-AI\BlendTreeAnimationTrack.h"
+#include "core-AI\AnimationPoseCache.h"
 #include "core\ListUtils.h"
 #include "core\ArrayUtils.h"
 #include "core\CollectionComparators.h"
@@ -340,8 +341,16 @@ void BlendTreeAnimation::onSamplePose( BlendTreePlayer* player, float timeDelta,
    bool animationLooped = runtimeSyncPointsList->update( timeDelta );
    const float newTrackTime = runtimeSyncPointsList->m_trackTime;
 
-   // sample the pose
-   m_animation->samplePose( newTrackTime, outGeneratedPoseDiffLS, bonesCount );
+   // sample the pose - the players that play this clip at the same time share it through the pose cache
+   AnimationPoseCache* poseCache = player->getPoseCache();
+   if ( poseCache )
+   {
+      poseCache->samplePose( *m_animation, player->getSkeleton(), newTrackTime, outGeneratedPoseDiffLS, bonesCount );
+   }
+   else
+   {
+      m_animation->samplePose( newTrackTime, outGeneratedPoseDiffLS, bonesCount );
+   }
 
    // get the accumulated motion
    {
@@ -381,11 +390,7 @@ void BlendTreeAnimation::onSamplePose( BlendTreePlayer* player, float timeDelta,
    // notify listeners of a completed sync point ( if any )
    if ( runtimeSyncPointsList->m_completedSyncPoint )
    {
-      for ( List< BlendTreePlayerListener* >::iterator it = player->m_listeners.begin(); !it.isEnd(); ++it )
-      {
-         BlendTreePlayerListener* listener = *it;
-         listener->onSyncPointReached( player, this, runtimeSyncPointsList->m_completedSyncPoint );
-      }
+      player->notifySyncPointReached( this, runtimeSyncPointsList->m_completedSyncPoint );
    }
 }
 
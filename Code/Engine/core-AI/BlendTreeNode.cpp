@@ -134,11 +134,7 @@ void BlendTreeNode::activateNode( BlendTreePlayer* player ) const
    data[m_state] = ToSynchronize;
 
    // notify about the state change
-   for ( List< BlendTreePlayerListener* >::iterator it = player->m_listeners.begin(); !it.isEnd(); ++it )
-   {
-      BlendTreePlayerListener* listener = *it;
-      listener->onNodeStateChanged( player, this );
-   }
+   player->notifyNodeStateChanged( this );
 
    onActivateNode( player );
 }
@@ -156,11 +152,7 @@ void BlendTreeNode::deactivateNode( BlendTreePlayer* player ) const
    data[m_state] = Inactive;
 
    // notify about the state change
-   for ( List< BlendTreePlayerListener* >::iterator it = player->m_listeners.begin(); !it.isEnd(); ++it )
-   {
-      BlendTreePlayerListener* listener = *it;
-      listener->onNodeStateChanged( player, this );
-   }
+   player->notifyNodeStateChanged( this );
 
    onDeactivateNode( player );
 }
@@ -10,6 +10,7 @@
 #include "core-AI\SkeletonMapper.h"
 #include "core-AI\SkeletonMapperRuntime.h"
 #include "core-AI\BlendTreePlayerListener.h"
+#include "core-AI\PoseBlendingUtils.h"
 #include "core-MVC\EntityUtils.h"
 #include "core-MVC\Entity.h"
 #include "core\RuntimeData.h"
@@ -43,6 +44,8 @@ BlendTreePlayer::BlendTreePlayer( const char* name )
    , m_eventsReadFrameOffset( 0 )
    , m_eventsWriteFrameOffset( 0 )
    , m_syncData( NULL )
+   , m_sampling( false )
+   , m_sampledTimeElapsed( 0.0f )
 {
 }
 
@@ -62,6 +65,8 @@ BlendTreePlayer::BlendTreePlayer( const BlendTreePlayer& rhs )
    , m_eventsReadFrameOffset( 0 )
    , m_eventsWriteFrameOffset( 0 )
    , m_syncData( NULL )
+   , m_sampling( false )
+   , m_sampledTimeElapsed( 0.0f )
 {
 }
 
@@ -90,6 +95,7 @@ BlendTreePlayer::~BlendTreePlayer()
    m_posesSink = NULL;
 
    m_listeners.clear();
+   m_pendingNotifications.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -237,6 +243,8 @@ void BlendTreePlayer::initializeBlendTreeRuntimeContext()
    m_skeleton = m_blendTree->m_skeleton;
    m_sourceBonesCount = m_skeleton->getBoneCount();
    m_finalSourcePose.resize( m_sourceBonesCount, Transform::IDENTITY );
+   m_prevFinalSourcePose.resize( m_sourceBonesCount, Transform::IDENTITY );
+   m_interpolatedSourcePose.resize( m_sourceBonesCount, Transform::IDENTITY );
 
    if ( m_sourceBonesCount > 0 )
    {
@@ -280,6 +288,8 @@ void BlendTreePlayer::deinitializeBlendTreeRuntimeContext()
    m_skeleton = NULL;
    m_sourceBonesCount = 0;
    m_finalSourcePose.clear();
+   m_prevFinalSourcePose.clear();
+   m_interpolatedSourcePose.clear();
    m_sourceBoneLocalMatrices.clear();
 }
 
@@ -515,6 +525,7 @@ void BlendTreePlayer::onStarted()
    initializeSkeletonMapper();
 
    // notify listeners - do it before we activate the tree
+   m_pendingNotifications.clear();
    for ( List< BlendTreePlayerListener* >::iterator it = m_listeners.begin(); !it.isEnd(); ++it )
    {
       BlendTreePlayerListener* listener = *it;
@@ -568,6 +579,9 @@ void BlendTreePlayer::onFrameStart()
 
 void BlendTreePlayer::samplePoses( float timeElapsed )
 {
+   // this may run in parallel with the other players - hold on to the notifications until the frame ends
+   m_sampling = true;
+
    BlendTreeStateMachine& root = m_blendTree->getRoot();
 
    // update tree logic
@@ -584,20 +598,63 @@ void BlendTreePlayer::samplePoses( float timeElapsed )
    root.samplePose( this, timeElapsed );
    Transform* sourcePoseChange = root.getGeneratedPose( this );
 
+   // memorize the previous pose, so that we can interpolate between the two if the player
+   // isn't sampled every frame - unless it's the first pose sampled since the player was started
+   const bool firstSample = getLODState().m_samplesCount < 2;
+   if ( !firstSample )
+   {
+      m_prevFinalSourcePose = m_finalSourcePose;
+   }
+
    // calculate the final pose
    for ( uint i = 0; i < m_sourceBonesCount; ++i )
    {
       m_finalSourcePose[i].setMul( sourcePoseChange[i], m_sourceBoneLocalMatrices[i] );
    }
 
+   if ( firstSample )
+   {
+      m_prevFinalSourcePose = m_finalSourcePose;
+   }
+
+   applyPose( m_finalSourcePose.getRaw() );
+
+   // get the accumulated motion
+   m_accumulatedMotion = root.getAccumulatedMotion( this );
+   m_sampledMotion = m_accumulatedMotion;
+   m_sampledTimeElapsed = timeElapsed;
+
+   m_sampling = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BlendTreePlayer::interpolatePoses( float progress, float timeElapsed )
+{
+   PoseBlendingUtils::blend( FastFloat::fromFloat( progress ), m_prevFinalSourcePose.getRaw(), m_finalSourcePose.getRaw(), m_sourceBonesCount, m_interpolatedSourcePose.getRaw() );
+   applyPose( m_interpolatedSourcePose.getRaw() );
+
+   // spread the motion accumulated over the sampled period evenly over its frames
+   if ( m_sampledTimeElapsed > timeElapsed )
+   {
+      m_accumulatedMotion.setSlerp( Transform::IDENTITY, m_sampledMotion, FastFloat::fromFloat( timeElapsed / m_sampledTimeElapsed ) );
+   }
+   else
+   {
+      m_accumulatedMotion = m_sampledMotion;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BlendTreePlayer::applyPose( const Transform* sourcePose )
+{
    // translate the pose using a skeleton mapper ( if applicable )
    if ( m_skeletonMapperRuntime )
    {
-      const Transform* finalSourcePose = m_finalSourcePose.getRaw();
-      const Transform* finalTargetPose = m_skeletonMapperRuntime->translatePose( finalSourcePose );
+      const Transform* finalTargetPose = m_skeletonMapperRuntime->translatePose( sourcePose );
 
       // set the pose on the skeleton component
-      Matrix tmpMtx;
       for ( uint i = 0; i < m_targetBonesCount; ++i )
       {
          finalTargetPose[i].toMatrix( m_posesSink->m_boneLocalMtx[i] );
@@ -606,21 +663,27 @@ void BlendTreePlayer::samplePoses( float timeElapsed )
    else
    {
       // set the pose on the skeleton component
-      Matrix tmpMtx;
       for ( uint i = 0; i < m_sourceBonesCount; ++i )
       {
-         m_finalSourcePose[i].toMatrix( m_posesSink->m_boneLocalMtx[i] );
+         sourcePose[i].toMatrix( m_posesSink->m_boneLocalMtx[i] );
       }
    }
-
-   // get the accumulated motion
-   m_accumulatedMotion = root.getAccumulatedMotion( this );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void BlendTreePlayer::onFrameEnd()
 {
+   // the bones global matrices need to be recalculated
+   m_posesSink->markTransformDirty();
+
+   // send out the notifications issued while sampling
+   uint count = m_pendingNotifications.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      sendNotification( m_pendingNotifications[i] );
+   }
+   m_pendingNotifications.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -654,11 +717,74 @@ void BlendTreePlayer::triggerEvent( BlendTreeEvent* btEvent )
    uint eventIdx = btEvent->getIndex();
    m_triggeredEvents[m_eventsWriteFrameOffset + eventIdx] = true;
 
-   // notify listeners
+   notifyListeners( NT_EventTriggered, NULL, btEvent );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BlendTreePlayer::notifyNodeStateChanged( const BlendTreeNode* node )
+{
+   notifyListeners( NT_NodeStateChanged, node, NULL );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BlendTreePlayer::notifySyncPointReached( const BlendTreeNode* node, const BlendTreeEvent* syncPoint )
+{
+   notifyListeners( NT_SyncPointReached, node, syncPoint );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BlendTreePlayer::notifyListeners( NotificationType type, const BlendTreeNode* node, const BlendTreeEvent* btEvent )
+{
+   if ( m_listeners.empty() )
+   {
+      return;
+   }
+
+   Notification notification;
+   notification.m_type = type;
+   notification.m_node = node;
+   notification.m_event = btEvent;
+
+   if ( m_sampling )
+   {
+      m_pendingNotifications.push_back( notification );
+   }
+   else
+   {
+      sendNotification( notification );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BlendTreePlayer::sendNotification( const Notification& notification )
+{
    for ( List< BlendTreePlayerListener* >::iterator it = m_listeners.begin(); !it.isEnd(); ++it )
    {
       BlendTreePlayerListener* listener = *it;
-      listener->onEventTriggered( this, btEvent );
+      switch ( notification.m_type )
+      {
+      case NT_NodeStateChanged:
+      {
+         listener->onNodeStateChanged( this, notification.m_node );
+         break;
+      }
+
+      case NT_EventTriggered:
+      {
+         listener->onEventTriggered( this, notification.m_event );
+         break;
+      }
+
+      case NT_SyncPointReached:
+      {
+         listener->onSyncPointReached( this, notification.m_node, notification.m_event );
+         break;
+      }
+      }
    }
 }
 
@@ -19,6 +19,7 @@ EntityAnimationPlayer::EntityAnimationPlayer( const char* name )
    , m_source( NULL )
    , m_animatedEntity( NULL )
    , m_trackTime( 0.f )
+   , m_motionDelta( Transform::IDENTITY )
 {
 }
 
@@ -29,6 +30,7 @@ EntityAnimationPlayer::EntityAnimationPlayer( const EntityAnimationPlayer& rhs )
    , m_source( rhs.m_source )
    , m_animatedEntity( NULL )
    , m_trackTime( 0.f )
+   , m_motionDelta( Transform::IDENTITY )
 {
 
 }
@@ -90,20 +92,29 @@ void EntityAnimationPlayer::samplePoses( float timeElapsed )
    m_trackTime += timeElapsed;
    m_trackTime = fmod( m_trackTime, m_source->m_duration );
 
-   // apply animation results
-   Transform startTransform, endTransform, deltaTransform;
+   // sample the motion - it will be applied to the entity once the frame ends
+   Transform startTransform, endTransform;
    m_source->samplePose( prevTrackTime, &startTransform, 1 );
    m_source->samplePose( m_trackTime, &endTransform, 1 );
 
-   deltaTransform.setMulInverse( endTransform, startTransform );
+   m_motionDelta.setMulInverse( endTransform, startTransform );
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
+void EntityAnimationPlayer::onFrameEnd()
+{
+   // apply animation results
    Matrix deltaMotionMtx;
-   deltaTransform.toMatrix( deltaMotionMtx );
+   m_motionDelta.toMatrix( deltaMotionMtx );
 
    Matrix currLocalTransform = m_animatedEntity->getLocalMtx();
    Matrix newLocalTransform;
    newLocalTransform.setMul( currLocalTransform, deltaMotionMtx );
    m_animatedEntity->setLocalMtx( newLocalTransform );
+
+   // the delta was consumed - the frames the player isn't sampled in ( see AnimationLODManager ) don't move the entity
+   m_motionDelta = Transform::IDENTITY;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
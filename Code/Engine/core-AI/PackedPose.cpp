@@ -0,0 +1,105 @@
+#include "core-AI\PackedPose.h"
+#include "core\Transform.h"
+#include "core\Assert.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedPose::Quad::setIdentity()
+{
+   for ( uint lane = 0; lane < 4; ++lane )
+   {
+      setTransform( lane, Transform::IDENTITY );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedPose::Quad::setTransform( uint lane, const Transform& transform )
+{
+   const float* rotation = ( const float* )&transform.m_rotation.m_quad;
+   const float* translation = ( const float* )&transform.m_translation.m_quad;
+   for ( uint i = 0; i < 4; ++i )
+   {
+      ( ( float* )&m_rotation[i] )[lane] = rotation[i];
+   }
+   for ( uint i = 0; i < 3; ++i )
+   {
+      ( ( float* )&m_translation[i] )[lane] = translation[i];
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedPose::Quad::getTransform( uint lane, Transform& outTransform ) const
+{
+   outTransform.m_rotation.set( ( ( const float* )&m_rotation[0] )[lane], ( ( const float* )&m_rotation[1] )[lane], ( ( const float* )&m_rotation[2] )[lane], ( ( const float* )&m_rotation[3] )[lane] );
+   outTransform.m_translation.set( ( ( const float* )&m_translation[0] )[lane], ( ( const float* )&m_translation[1] )[lane], ( ( const float* )&m_translation[2] )[lane] );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+PackedPose::PackedPose( uint bonesCount )
+   : m_quads( bonesCount / 4 + 1 )
+   , m_bonesCount( 0 )
+{
+   resize( bonesCount );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedPose::resize( uint bonesCount )
+{
+   const uint quadsCount = ( bonesCount + 3 ) / 4;
+   m_quads.resize( quadsCount );
+   for ( uint i = 0; i < quadsCount; ++i )
+   {
+      m_quads[i].setIdentity();
+   }
+
+   m_bonesCount = bonesCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedPose::set( uint boneIdx, const Transform& transform )
+{
+   ASSERT_MSG( boneIdx < m_bonesCount, "Bone index out of bounds" );
+   m_quads[boneIdx >> 2].setTransform( boneIdx & 3, transform );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedPose::get( uint boneIdx, Transform& outTransform ) const
+{
+   ASSERT_MSG( boneIdx < m_bonesCount, "Bone index out of bounds" );
+   m_quads[boneIdx >> 2].getTransform( boneIdx & 3, outTransform );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedPose::pack( const Transform* pose, uint bonesCount )
+{
+   if ( bonesCount != m_bonesCount )
+   {
+      resize( bonesCount );
+   }
+
+   for ( uint i = 0; i < bonesCount; ++i )
+   {
+      m_quads[i >> 2].setTransform( i & 3, pose[i] );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedPose::unpack( Transform* outPose ) const
+{
+   for ( uint i = 0; i < m_bonesCount; ++i )
+   {
+      m_quads[i >> 2].getTransform( i & 3, outPose[i] );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -1,8 +1,179 @@
 #include "core-AI\PoseBlendingUtils.h"
+#include "core-AI\PackedPose.h"
 #include "core\Algorithms.h"
 #include "core\Assert.h"
+#ifdef _USE_SIMD
+#include "core\SimdUtils.h"
+#endif
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+#ifdef _USE_SIMD
+
+   /**
+    * result = mask ? a : b
+    */
+   inline __m128 select( const __m128& mask, const __m128& a, const __m128& b )
+   {
+      return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+   }
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * Calculates arc cosines of 4 values in range < 0 .. 1 >.
+    *
+    * A polynomial approximation ( Abramowitz & Stegun, 4.4.46 ) - the absolute error is below 2e-8,
+    * which is below the precision of a float anyway.
+    */
+   inline __m128 acos4( const __m128& x )
+   {
+      __m128 poly = _mm_set1_ps( -0.0012624911f );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x ), _mm_set1_ps( 0.0066700901f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x ), _mm_set1_ps( -0.0170881256f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x ), _mm_set1_ps( 0.0308918810f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x ), _mm_set1_ps( -0.0501743046f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x ), _mm_set1_ps( 0.0889789874f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x ), _mm_set1_ps( -0.2145988016f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x ), _mm_set1_ps( 1.5707963050f ) );
+
+      return _mm_mul_ps( poly, _mm_sqrt_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), x ) ) );
+   }
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * Calculates sines of 4 angles in range < 0 .. PI/2 > ( a Taylor series, the error is below 1e-7 in that range ).
+    */
+   inline __m128 sin4( const __m128& x )
+   {
+      const __m128 x2 = _mm_mul_ps( x, x );
+
+      __m128 poly = _mm_set1_ps( -1.0f / 39916800.0f );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x2 ), _mm_set1_ps( 1.0f / 362880.0f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x2 ), _mm_set1_ps( -1.0f / 5040.0f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x2 ), _mm_set1_ps( 1.0f / 120.0f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x2 ), _mm_set1_ps( -1.0f / 6.0f ) );
+      poly = _mm_add_ps( _mm_mul_ps( poly, x2 ), _mm_set1_ps( 1.0f ) );
+
+      return _mm_mul_ps( poly, x );
+   }
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * out = ( b - a ) * t + a, for each of the 'count' components ( the same order of operations as in Vector::setLerp ).
+    */
+   inline void lerp4( const __m128& t, const __m128* a, const __m128* b, uint count, __m128* out )
+   {
+      for ( uint i = 0; i < count; ++i )
+      {
+         out[i] = _mm_add_ps( _mm_mul_ps( _mm_sub_ps( b[i], a[i] ), t ), a[i] );
+      }
+   }
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * Normalizes 4 packed quaternions ( the same way SimdUtils::normalize does ).
+    */
+   inline void normalizeQuats4( __m128* q )
+   {
+      const __m128 lengthSq = _mm_add_ps( _mm_add_ps( _mm_mul_ps( q[0], q[0] ), _mm_mul_ps( q[1], q[1] ) ), _mm_add_ps( _mm_mul_ps( q[2], q[2] ), _mm_mul_ps( q[3], q[3] ) ) );
+
+      const __m128 equalsZero = _mm_cmple_ps( lengthSq, _mm_setzero_ps() );
+      const __m128 length = _mm_andnot_ps( equalsZero, _mm_sqrt_ps( lengthSq ) );
+      for ( uint i = 0; i < 4; ++i )
+      {
+         q[i] = _mm_div_ps( q[i], length );
+      }
+   }
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * Spherically interpolates 4 packed quaternions - a vectorized version of Quaternion::setSlerp.
+    */
+   void slerpQuats4( const __m128& t, const __m128* a, const __m128* b, __m128* out )
+   {
+      const __m128 one = _mm_set1_ps( 1.0f );
+
+      __m128 cosTheta = _mm_add_ps( _mm_add_ps( _mm_mul_ps( a[0], b[0] ), _mm_mul_ps( a[1], b[1] ) ), _mm_add_ps( _mm_mul_ps( a[2], b[2] ), _mm_mul_ps( a[3], b[3] ) ) );
+
+      // interpolate along the shorter arc
+      const __m128 flipSignMask = _mm_and_ps( _mm_cmplt_ps( cosTheta, _mm_setzero_ps() ), _MM_SIGN_MASK );
+      cosTheta = _mm_xor_ps( cosTheta, flipSignMask );
+
+      // the lanes with the rotations that are very close to each other are linearly interpolated.
+      // The other branch produces garbage in them, but we calculate both and select the results per lane
+      const __m128 useLerpMask = _mm_cmpge_ps( cosTheta, _mm_set1_ps( 1.0f - 1e-3f ) );
+
+      const __m128 theta = acos4( cosTheta );
+      const __m128 iSinTheta = _mm_div_ps( one, _mm_sqrt_ps( _mm_sub_ps( one, _mm_mul_ps( cosTheta, cosTheta ) ) ) );
+      const __m128 tTheta = _mm_mul_ps( t, theta );
+      const __m128 slerpT0 = _mm_mul_ps( sin4( _mm_sub_ps( theta, tTheta ) ), iSinTheta );
+      const __m128 slerpT1 = _mm_mul_ps( sin4( tTheta ), iSinTheta );
+
+      const __m128 t0 = select( useLerpMask, _mm_sub_ps( one, t ), slerpT0 );
+      const __m128 t1 = _mm_xor_ps( select( useLerpMask, t, slerpT1 ), flipSignMask );
+
+      for ( uint i = 0; i < 4; ++i )
+      {
+         out[i] = _mm_add_ps( _mm_mul_ps( t0, a[i] ), _mm_mul_ps( t1, b[i] ) );
+      }
+      normalizeQuats4( out );
+   }
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * Linearly interpolates and normalizes 4 packed quaternions - a vectorized version of Quaternion::setNlerp.
+    */
+   inline void nlerpQuats4( const __m128& t, const __m128* a, const __m128* b, __m128* out )
+   {
+      lerp4( t, a, b, 4, out );
+      normalizeQuats4( out );
+   }
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * Scales 4 packed additive rotations by the specified weight, and combines them with the base rotations
+    * as in Quaternion::setMul( additive, base ).
+    */
+   void addAdditiveQuats4( const __m128& t, const __m128* base, const __m128* additive, __m128* out )
+   {
+      // nlerp from identity along the shorter arc
+      const __m128 flipSignMask = _mm_and_ps( _mm_cmplt_ps( additive[3], _mm_setzero_ps() ), _MM_SIGN_MASK );
+
+      __m128 q1[4];
+      for ( uint i = 0; i < 3; ++i )
+      {
+         q1[i] = _mm_mul_ps( _mm_xor_ps( additive[i], flipSignMask ), t );
+      }
+      const __m128 one = _mm_set1_ps( 1.0f );
+      q1[3] = _mm_add_ps( _mm_mul_ps( _mm_sub_ps( _mm_xor_ps( additive[3], flipSignMask ), one ), t ), one );
+      normalizeQuats4( q1 );
+
+      // q1 * base ( see Quaternion::setMul )
+      const __m128* q2 = base;
+      const __m128 x = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( q2[0], q1[3] ), _mm_mul_ps( q2[3], q1[0] ) ), _mm_mul_ps( q2[1], q1[2] ) ), _mm_mul_ps( q2[2], q1[1] ) );
+      const __m128 y = _mm_add_ps( _mm_add_ps( _mm_sub_ps( _mm_mul_ps( q2[3], q1[1] ), _mm_mul_ps( q2[0], q1[2] ) ), _mm_mul_ps( q2[1], q1[3] ) ), _mm_mul_ps( q2[2], q1[0] ) );
+      const __m128 z = _mm_add_ps( _mm_sub_ps( _mm_add_ps( _mm_mul_ps( q2[3], q1[2] ), _mm_mul_ps( q2[0], q1[1] ) ), _mm_mul_ps( q2[1], q1[0] ) ), _mm_mul_ps( q2[2], q1[3] ) );
+      const __m128 w = _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( _mm_mul_ps( q2[3], q1[3] ), _mm_mul_ps( q2[0], q1[0] ) ), _mm_mul_ps( q2[1], q1[1] ) ), _mm_mul_ps( q2[2], q1[2] ) );
+
+      out[0] = x;
+      out[1] = y;
+      out[2] = z;
+      out[3] = w;
+   }
+
+#endif // _USE_SIMD
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void PoseBlendingUtils::blend( const FastFloat& blendWeight, const Transform* sourcePose, const Transform* targetPose, uint bonesCount, Transform* outBlendedPose )
@@ -10,6 +181,43 @@ void PoseBlendingUtils::blend( const FastFloat& blendWeight, const Transform* so
    FastFloat clampedBlendWeight;
    clampedBlendWeight.setClamped( blendWeight, Float_0, Float_1 );
 
+#ifdef _USE_SIMD
+   __m128 sourceRotation[4], sourceTranslation[4];
+   __m128 targetRotation[4], targetTranslation[4];
+   __m128 blendedRotation[4], blendedTranslation[4];
+   for ( uint firstBoneIdx = 0; firstBoneIdx < bonesCount; firstBoneIdx += 4 )
+   {
+      const uint quadBonesCount = bonesCount - firstBoneIdx < 4 ? bonesCount - firstBoneIdx : 4;
+
+      // transpose the transforms - the missing bones of the last quad are substituted with the last bone
+      for ( uint j = 0; j < 4; ++j )
+      {
+         const uint boneIdx = firstBoneIdx + ( j < quadBonesCount ? j : quadBonesCount - 1 );
+         sourceRotation[j] = sourcePose[boneIdx].m_rotation.m_quad;
+         sourceTranslation[j] = sourcePose[boneIdx].m_translation.m_quad;
+         targetRotation[j] = targetPose[boneIdx].m_rotation.m_quad;
+         targetTranslation[j] = targetPose[boneIdx].m_translation.m_quad;
+      }
+      _MM_TRANSPOSE4_PS( sourceRotation[0], sourceRotation[1], sourceRotation[2], sourceRotation[3] );
+      _MM_TRANSPOSE4_PS( sourceTranslation[0], sourceTranslation[1], sourceTranslation[2], sourceTranslation[3] );
+      _MM_TRANSPOSE4_PS( targetRotation[0], targetRotation[1], targetRotation[2], targetRotation[3] );
+      _MM_TRANSPOSE4_PS( targetTranslation[0], targetTranslation[1], targetTranslation[2], targetTranslation[3] );
+
+      slerpQuats4( clampedBlendWeight.m_val, sourceRotation, targetRotation, blendedRotation );
+      lerp4( clampedBlendWeight.m_val, sourceTranslation, targetTranslation, 3, blendedTranslation );
+      blendedTranslation[3] = _mm_setzero_ps();
+
+      // and transpose them back
+      _MM_TRANSPOSE4_PS( blendedRotation[0], blendedRotation[1], blendedRotation[2], blendedRotation[3] );
+      _MM_TRANSPOSE4_PS( blendedTranslation[0], blendedTranslation[1], blendedTranslation[2], blendedTranslation[3] );
+      for ( uint j = 0; j < quadBonesCount; ++j )
+      {
+         Transform& blendedTransform = outBlendedPose[firstBoneIdx + j];
+         blendedTransform.m_rotation.m_quad = blendedRotation[j];
+         blendedTransform.m_translation.m_quad = blendedTranslation[j];
+      }
+   }
+#else
    for ( uint i = 0; i < bonesCount; ++i )
    {
       const Transform& sourceTransform = sourcePose[i];
@@ -17,6 +225,116 @@ void PoseBlendingUtils::blend( const FastFloat& blendWeight, const Transform* so
       Transform& blendedTransform = outBlendedPose[i];
       blendedTransform.setSlerp( sourceTransform, targetTransform, clampedBlendWeight );
    }
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PoseBlendingUtils::blend( const FastFloat& blendWeight, const PackedPose& sourcePose, const PackedPose& targetPose, PackedPose& outBlendedPose )
+{
+   ASSERT_MSG( sourcePose.size() == targetPose.size() && sourcePose.size() == outBlendedPose.size(), "The poses need to have the same number of bones" );
+
+   FastFloat clampedBlendWeight;
+   clampedBlendWeight.setClamped( blendWeight, Float_0, Float_1 );
+
+   const uint quadsCount = sourcePose.getQuadsCount();
+   for ( uint i = 0; i < quadsCount; ++i )
+   {
+      const PackedPose::Quad& sourceQuad = sourcePose.getQuad( i );
+      const PackedPose::Quad& targetQuad = targetPose.getQuad( i );
+      PackedPose::Quad& blendedQuad = outBlendedPose.getQuad( i );
+
+#ifdef _USE_SIMD
+      slerpQuats4( clampedBlendWeight.m_val, sourceQuad.m_rotation, targetQuad.m_rotation, blendedQuad.m_rotation );
+      lerp4( clampedBlendWeight.m_val, sourceQuad.m_translation, targetQuad.m_translation, 3, blendedQuad.m_translation );
+#else
+      Transform sourceTransform, targetTransform, blendedTransform;
+      for ( uint lane = 0; lane < 4; ++lane )
+      {
+         sourceQuad.getTransform( lane, sourceTransform );
+         targetQuad.getTransform( lane, targetTransform );
+         blendedTransform.setSlerp( sourceTransform, targetTransform, clampedBlendWeight );
+         blendedQuad.setTransform( lane, blendedTransform );
+      }
+#endif
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PoseBlendingUtils::nlerp( const FastFloat& blendWeight, const PackedPose& sourcePose, const PackedPose& targetPose, PackedPose& outBlendedPose )
+{
+   ASSERT_MSG( sourcePose.size() == targetPose.size() && sourcePose.size() == outBlendedPose.size(), "The poses need to have the same number of bones" );
+
+   FastFloat clampedBlendWeight;
+   clampedBlendWeight.setClamped( blendWeight, Float_0, Float_1 );
+
+   const uint quadsCount = sourcePose.getQuadsCount();
+   for ( uint i = 0; i < quadsCount; ++i )
+   {
+      const PackedPose::Quad& sourceQuad = sourcePose.getQuad( i );
+      const PackedPose::Quad& targetQuad = targetPose.getQuad( i );
+      PackedPose::Quad& blendedQuad = outBlendedPose.getQuad( i );
+
+#ifdef _USE_SIMD
+      nlerpQuats4( clampedBlendWeight.m_val, sourceQuad.m_rotation, targetQuad.m_rotation, blendedQuad.m_rotation );
+      lerp4( clampedBlendWeight.m_val, sourceQuad.m_translation, targetQuad.m_translation, 3, blendedQuad.m_translation );
+#else
+      Transform sourceTransform, targetTransform, blendedTransform;
+      for ( uint lane = 0; lane < 4; ++lane )
+      {
+         sourceQuad.getTransform( lane, sourceTransform );
+         targetQuad.getTransform( lane, targetTransform );
+         blendedTransform.setNlerp( sourceTransform, targetTransform, clampedBlendWeight );
+         blendedQuad.setTransform( lane, blendedTransform );
+      }
+#endif
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PoseBlendingUtils::addAdditive( const FastFloat& blendWeight, const PackedPose& basePose, const PackedPose& additivePose, PackedPose& outPose )
+{
+   ASSERT_MSG( basePose.size() == additivePose.size() && basePose.size() == outPose.size(), "The poses need to have the same number of bones" );
+
+   FastFloat clampedBlendWeight;
+   clampedBlendWeight.setClamped( blendWeight, Float_0, Float_1 );
+
+   const uint quadsCount = basePose.getQuadsCount();
+   for ( uint i = 0; i < quadsCount; ++i )
+   {
+      const PackedPose::Quad& baseQuad = basePose.getQuad( i );
+      const PackedPose::Quad& additiveQuad = additivePose.getQuad( i );
+      PackedPose::Quad& outQuad = outPose.getQuad( i );
+
+#ifdef _USE_SIMD
+      addAdditiveQuats4( clampedBlendWeight.m_val, baseQuad.m_rotation, additiveQuad.m_rotation, outQuad.m_rotation );
+      for ( uint j = 0; j < 3; ++j )
+      {
+         // the same order of operations as in Vector::setMulAdd
+         outQuad.m_translation[j] = _mm_add_ps( _mm_mul_ps( additiveQuad.m_translation[j], clampedBlendWeight.m_val ), baseQuad.m_translation[j] );
+      }
+#else
+      Transform baseTransform, additiveTransform, outTransform;
+      Quaternion weightedRotation;
+      for ( uint lane = 0; lane < 4; ++lane )
+      {
+         baseQuad.getTransform( lane, baseTransform );
+         additiveQuad.getTransform( lane, additiveTransform );
+
+         if ( additiveTransform.m_rotation[3] < 0.0f )
+         {
+            additiveTransform.m_rotation.neg();
+         }
+         weightedRotation.setNlerp( Quaternion::IDENTITY, additiveTransform.m_rotation, clampedBlendWeight );
+         outTransform.m_rotation.setMul( weightedRotation, baseTransform.m_rotation );
+         outTransform.m_translation.setMulAdd( additiveTransform.m_translation, clampedBlendWeight, baseTransform.m_translation );
+
+         outQuad.setTransform( lane, outTransform );
+      }
+#endif
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -23,6 +23,7 @@ SkeletonAnimationPlayer::SkeletonAnimationPlayer( const char* name )
    , m_motionExtractionSink( NULL )
    , m_tmpBoneTransforms( NULL )
    , m_trackTime( 0.f )
+   , m_motionDelta( Transform::IDENTITY )
 {
 }
 
@@ -35,6 +36,7 @@ SkeletonAnimationPlayer::SkeletonAnimationPlayer( const SkeletonAnimationPlayer&
    , m_motionExtractionSink( NULL )
    , m_tmpBoneTransforms( NULL )
    , m_trackTime( 0.f )
+   , m_motionDelta( Transform::IDENTITY )
 {
 
 }
@@ -151,19 +153,28 @@ void SkeletonAnimationPlayer::samplePoses( float timeElapsed )
       }
    }
 
+   // sample the extracted motion - it will be applied to the entity once the frame ends
+   m_source->sampleMotion( prevTrackTime, m_trackTime, m_motionDelta );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkeletonAnimationPlayer::onFrameEnd()
+{
+   // the bones global matrices need to be recalculated
+   m_posesSink->markTransformDirty();
+
    // apply motion extraction
-   {
-      Transform deltaTransform;
-      m_source->sampleMotion( prevTrackTime, m_trackTime, deltaTransform );
+   Matrix deltaMotionMtx;
+   m_motionDelta.toMatrix( deltaMotionMtx );
 
-      Matrix deltaMotionMtx;
-      deltaTransform.toMatrix( deltaMotionMtx );
+   Matrix currLocalTransform = m_motionExtractionSink->getLocalMtx();
+   Matrix newLocalTransform;
+   newLocalTransform.setMul( currLocalTransform, deltaMotionMtx );
+   m_motionExtractionSink->setLocalMtx( newLocalTransform );
 
-      Matrix currLocalTransform = m_motionExtractionSink->getLocalMtx();
-      Matrix newLocalTransform;
-      newLocalTransform.setMul( currLocalTransform, deltaMotionMtx );
-      m_motionExtractionSink->setLocalMtx( newLocalTransform );
-   }
+   // the delta was consumed - the frames the player isn't sampled in ( see AnimationLODManager ) don't move the entity
+   m_motionDelta = Transform::IDENTITY;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
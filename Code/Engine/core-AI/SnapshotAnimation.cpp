@@ -1,6 +1,7 @@
 #include "core-AI\SnapshotAnimation.h"
 #include "core-AI\BoneSRTAnimation.h"
 #include "core\Math.h"
+#include "core\Assert.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -13,12 +14,212 @@ BEGIN_RESOURCE( SnapshotAnimation, tsa, AM_BINARY );
    PROPERTY( float, m_playbackFrequency );
    PROPERTY( float, m_duration );
    PROPERTY( uint, m_bonesCount );
-   PROPERTY( Array< Transform >, m_poseTracks );
+   PROPERTY( Array< uint >, m_trackDescriptors );
+   PROPERTY( Array< word >, m_keyFrames );
+   PROPERTY( Array< word >, m_keyValues );
+   PROPERTY( Array< float >, m_translationRanges );
    PROPERTY( Array< Transform >, m_motionTrack );
+   PROPERTY( Array< Transform >, m_poseTracks );
 END_RESOURCE();
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace // anonymous
+{
+   // the three smallest components of a normalized quaternion fall into the range [-1/sqrt(2), 1/sqrt(2)]
+   const float SMALLEST_THREE_RANGE = 0.70710678f;
+
+   const float ROTATION_QUANTIZATION_STEPS = 32767.0f;         // 15 bits per component
+   const float TRANSLATION_QUANTIZATION_STEPS = 65535.0f;      // 16 bits per component
+
+   // -------------------------------------------------------------------------
+
+   void quantizeRotation( const float* rotation, word* outKey )
+   {
+      // the largest component can be restored from the remaining ones, since the quaternion is normalized
+      uint largestIdx = 0;
+      for ( uint i = 1; i < 4; ++i )
+      {
+         if ( fabs( rotation[i] ) > fabs( rotation[largestIdx] ) )
+         {
+            largestIdx = i;
+         }
+      }
+
+      // q and -q describe the same rotation, so we can always store the one with a positive largest component
+      const float sign = rotation[largestIdx] < 0.0f ? -1.0f : 1.0f;
+
+      uint keyIdx = 0;
+      for ( uint i = 0; i < 4; ++i )
+      {
+         if ( i == largestIdx )
+         {
+            continue;
+         }
+
+         const float normalizedVal = ( rotation[i] * sign + SMALLEST_THREE_RANGE ) / ( 2.0f * SMALLEST_THREE_RANGE );
+         outKey[keyIdx] = (word)clamp( (int)( normalizedVal * ROTATION_QUANTIZATION_STEPS + 0.5f ), 0, 32767 );
+         ++keyIdx;
+      }
+
+      // the index of the largest component is stored in the top bits of the first two values
+      outKey[0] |= (word)( ( largestIdx & 1 ) << 15 );
+      outKey[1] |= (word)( ( largestIdx >> 1 ) << 15 );
+   }
+
+   // -------------------------------------------------------------------------
+
+   void dequantizeRotation( const word* key, Quaternion& outRotation )
+   {
+      const uint largestIdx = ( key[0] >> 15 ) | ( ( key[1] >> 15 ) << 1 );
+      const float scale = ( 2.0f * SMALLEST_THREE_RANGE ) / ROTATION_QUANTIZATION_STEPS;
+
+      float components[4];
+      float sqLength = 0.0f;
+      uint keyIdx = 0;
+      for ( uint i = 0; i < 4; ++i )
+      {
+         if ( i == largestIdx )
+         {
+            continue;
+         }
+
+         const float val = (float)( key[keyIdx] & 0x7fff ) * scale - SMALLEST_THREE_RANGE;
+         components[i] = val;
+         sqLength += val * val;
+         ++keyIdx;
+      }
+      components[largestIdx] = sqrtf( max2( 0.0f, 1.0f - sqLength ) );
+
+      outRotation.set( components[0], components[1], components[2], components[3] );
+   }
+
+   // -------------------------------------------------------------------------
+
+   void quantizeTranslation( const float* translation, const float* range, word* outKey )
+   {
+      for ( uint i = 0; i < 3; ++i )
+      {
+         const float extent = range[3 + i];
+         const float normalizedVal = extent > 0.0f ? ( translation[i] - range[i] ) / extent : 0.0f;
+         outKey[i] = (word)clamp( (int)( normalizedVal * TRANSLATION_QUANTIZATION_STEPS + 0.5f ), 0, 65535 );
+      }
+   }
+
+   // -------------------------------------------------------------------------
+
+   void dequantizeTranslation( const word* key, const float* range, Vector& outTranslation )
+   {
+      const float scale = 1.0f / TRANSLATION_QUANTIZATION_STEPS;
+      outTranslation.set( range[0] + (float)key[0] * range[3] * scale,
+                          range[1] + (float)key[1] * range[4] * scale,
+                          range[2] + (float)key[2] * range[5] * scale );
+   }
+
+   // -------------------------------------------------------------------------
+
+   float getMaxDeviation( const float* val1, const float* val2, uint componentsCount )
+   {
+      float maxDeviation = 0.0f;
+      for ( uint i = 0; i < componentsCount; ++i )
+      {
+         maxDeviation = max2( maxDeviation, (float)fabs( val1[i] - val2[i] ) );
+      }
+
+      return maxDeviation;
+   }
+
+   // -------------------------------------------------------------------------
+
+   inline float getDot( const float* rotation1, const float* rotation2 )
+   {
+      return rotation1[0] * rotation2[0] + rotation1[1] * rotation2[1] + rotation1[2] * rotation2[2] + rotation1[3] * rotation2[3];
+   }
+
+   // -------------------------------------------------------------------------
+
+   bool isConstant( const float* values, uint framesCount, uint componentsCount, float tolerance )
+   {
+      for ( uint frameIdx = 1; frameIdx < framesCount; ++frameIdx )
+      {
+         if ( getMaxDeviation( values, values + frameIdx * componentsCount, componentsCount ) > tolerance )
+         {
+            return false;
+         }
+      }
+
+      return true;
+   }
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * Checks if the frames between the specified ones can be interpolated from them
+    * without exceeding the error tolerance.
+    */
+   bool canInterpolate( const float* values, uint componentsCount, bool normalize, uint startFrameIdx, uint endFrameIdx, float tolerance )
+   {
+      const float* startVal = values + startFrameIdx * componentsCount;
+      const float* endVal = values + endFrameIdx * componentsCount;
+      const float framesSpan = (float)( endFrameIdx - startFrameIdx );
+
+      float interpolatedVal[4];
+      for ( uint frameIdx = startFrameIdx + 1; frameIdx < endFrameIdx; ++frameIdx )
+      {
+         const float lerpDist = (float)( frameIdx - startFrameIdx ) / framesSpan;
+
+         float sqLength = 0.0f;
+         for ( uint i = 0; i < componentsCount; ++i )
+         {
+            interpolatedVal[i] = startVal[i] + ( endVal[i] - startVal[i] ) * lerpDist;
+            sqLength += interpolatedVal[i] * interpolatedVal[i];
+         }
+
+         if ( normalize && sqLength > 0.0f )
+         {
+            const float invLength = 1.0f / sqrtf( sqLength );
+            for ( uint i = 0; i < componentsCount; ++i )
+            {
+               interpolatedVal[i] *= invLength;
+            }
+         }
+
+         if ( getMaxDeviation( interpolatedVal, values + frameIdx * componentsCount, componentsCount ) > tolerance )
+         {
+            return false;
+         }
+      }
+
+      return true;
+   }
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * Selects the frames the rest of the track can be interpolated from.
+    */
+   void reduceKeys( const float* values, uint framesCount, uint componentsCount, bool normalize, float tolerance, Array< uint >& outKeyFrames )
+   {
+      outKeyFrames.push_back( 0 );
+
+      uint startFrameIdx = 0;
+      while ( startFrameIdx + 1 < framesCount )
+      {
+         // extend the span of the key as far as the tolerance allows
+         uint endFrameIdx = startFrameIdx + 1;
+         while ( endFrameIdx + 1 < framesCount && canInterpolate( values, componentsCount, normalize, startFrameIdx, endFrameIdx + 1, tolerance ) )
+         {
+            ++endFrameIdx;
+         }
+
+         outKeyFrames.push_back( endFrameIdx );
+         startFrameIdx = endFrameIdx;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 SnapshotAnimation::SnapshotAnimation( const FilePath& resourceName )
    : Resource( resourceName )
    , m_playbackFrequency( ANIMATION_SAMPLING_FREQUENCY )
@@ -43,8 +244,34 @@ void SnapshotAnimation::replaceContents( Resource& rhs )
    m_playbackFrequency = rhsSnapshotAnimation.m_playbackFrequency;
    m_duration = rhsSnapshotAnimation.m_duration;
    m_bonesCount = rhsSnapshotAnimation.m_bonesCount;
-   m_poseTracks = rhsSnapshotAnimation.m_poseTracks;
+   m_trackDescriptors = rhsSnapshotAnimation.m_trackDescriptors;
+   m_keyFrames = rhsSnapshotAnimation.m_keyFrames;
+   m_keyValues = rhsSnapshotAnimation.m_keyValues;
+   m_translationRanges = rhsSnapshotAnimation.m_translationRanges;
    m_motionTrack = rhsSnapshotAnimation.m_motionTrack;
+   m_poseTracks = rhsSnapshotAnimation.m_poseTracks;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SnapshotAnimation::onObjectLoaded()
+{
+   Resource::onObjectLoaded();
+
+   if ( !m_poseTracks.empty() )
+   {
+      // the resource was saved before we started compressing the pose tracks
+      const uint framesCount = m_motionTrack.size();
+      compressPoseTracks( framesCount, (const Transform*)m_poseTracks, AnimationCompressionSettings() );
+      m_poseTracks.clear();
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+uint SnapshotAnimation::getPoseTracksSize() const
+{
+   return m_trackDescriptors.size() * sizeof( uint ) + m_keyFrames.size() * sizeof( word ) + m_keyValues.size() * sizeof( word ) + m_translationRanges.size() * sizeof( float );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -57,28 +284,116 @@ void SnapshotAnimation::samplePose( float trackTime, Transform* outBoneLocalTran
    }
 
    float clampedTrackTime = clamp( trackTime, 0.0f, m_duration );
+   const float framePos = clampedTrackTime / m_playbackFrequency;
 
-   uint lastFrameIdx = m_motionTrack.size() - 1;
-   uint startFrameIdx = min2( (uint)ceilf( clampedTrackTime / m_playbackFrequency ), lastFrameIdx );
-   uint endFrameIdx = min2( startFrameIdx + 1, lastFrameIdx );
+   uint updatedBonesCount = min2( bonesCount, m_bonesCount );
+   for ( uint boneIdx = 0; boneIdx < updatedBonesCount; ++boneIdx )
+   {
+      Transform& boneLocalTransform = outBoneLocalTransforms[boneIdx];
+
+      const uint rotationTrackIdx = boneIdx * 2;
+      sampleRotationTrack( rotationTrackIdx, framePos, boneLocalTransform.m_rotation );
+      sampleTranslationTrack( rotationTrackIdx + 1, &m_translationRanges[boneIdx * 6], framePos, boneLocalTransform.m_translation );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
-   float timeIntoFrame = clampedTrackTime - (float)startFrameIdx * m_playbackFrequency;
+void SnapshotAnimation::sampleRotationTrack( uint trackIdx, float framePos, Quaternion& outRotation ) const
+{
+   const uint firstKeyIdx = m_trackDescriptors[trackIdx * 2];
+   const uint keysCount = m_trackDescriptors[trackIdx * 2 + 1];
+   if ( keysCount == 0 )
+   {
+      // the bone doesn't rotate
+      outRotation = Quaternion::IDENTITY;
+      return;
+   }
 
    FastFloat lerpDist;
-   lerpDist.setFromFloat( timeIntoFrame / m_playbackFrequency );
+   const uint keyIdx = findKey( firstKeyIdx, keysCount, framePos, lerpDist );
+   if ( keyIdx + 1 >= firstKeyIdx + keysCount )
+   {
+      // we're past the last key
+      dequantizeRotation( &m_keyValues[keyIdx * 3], outRotation );
+      return;
+   }
 
-   uint updatedBonesCount = min2( bonesCount, m_bonesCount );
-   uint startTransformIdx = startFrameIdx * m_bonesCount;
-   uint endTransformIdx = endFrameIdx * m_bonesCount;
-   for ( uint boneIdx = 0; boneIdx < updatedBonesCount; ++boneIdx, ++startTransformIdx, ++endTransformIdx )
+   Quaternion startRotation, endRotation;
+   dequantizeRotation( &m_keyValues[keyIdx * 3], startRotation );
+   dequantizeRotation( &m_keyValues[( keyIdx + 1 ) * 3], endRotation );
+
+   // the keys don't have to lie in the same hemisphere - make sure we're interpolating along the shortest path
+   const float dot = startRotation[0] * endRotation[0] + startRotation[1] * endRotation[1] + startRotation[2] * endRotation[2] + startRotation[3] * endRotation[3];
+   if ( dot < 0.0f )
    {
-      Transform& boneLocalTransform = outBoneLocalTransforms[boneIdx];
+      endRotation.neg();
+   }
+
+   outRotation.setNlerp( startRotation, endRotation, lerpDist );
+   outRotation.normalize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SnapshotAnimation::sampleTranslationTrack( uint trackIdx, const float* range, float framePos, Vector& outTranslation ) const
+{
+   const uint firstKeyIdx = m_trackDescriptors[trackIdx * 2];
+   const uint keysCount = m_trackDescriptors[trackIdx * 2 + 1];
+   if ( keysCount == 0 )
+   {
+      // a constant translation is stored as the range's minimum
+      outTranslation.set( range[0], range[1], range[2] );
+      return;
+   }
+
+   FastFloat lerpDist;
+   const uint keyIdx = findKey( firstKeyIdx, keysCount, framePos, lerpDist );
+   if ( keyIdx + 1 >= firstKeyIdx + keysCount )
+   {
+      dequantizeTranslation( &m_keyValues[keyIdx * 3], range, outTranslation );
+      return;
+   }
+
+   Vector startTranslation, endTranslation;
+   dequantizeTranslation( &m_keyValues[keyIdx * 3], range, startTranslation );
+   dequantizeTranslation( &m_keyValues[( keyIdx + 1 ) * 3], range, endTranslation );
+
+   outTranslation.setLerp( startTranslation, endTranslation, lerpDist );
+}
 
-      const Transform& startTransform = m_poseTracks[startTransformIdx];
-      const Transform& endTransform = m_poseTracks[endTransformIdx];
+///////////////////////////////////////////////////////////////////////////////
 
-      boneLocalTransform.setNlerp( startTransform, endTransform, lerpDist );
+uint SnapshotAnimation::findKey( uint firstKeyIdx, uint keysCount, float framePos, FastFloat& outLerpDist ) const
+{
+   // binary search for the last key that doesn't come after the sampled frame
+   uint startIdx = firstKeyIdx;
+   uint endIdx = firstKeyIdx + keysCount - 1;
+   while ( startIdx < endIdx )
+   {
+      const uint midIdx = ( startIdx + endIdx + 1 ) >> 1;
+      if ( (float)m_keyFrames[midIdx] <= framePos )
+      {
+         startIdx = midIdx;
+      }
+      else
+      {
+         endIdx = midIdx - 1;
+      }
    }
+
+   if ( startIdx + 1 < firstKeyIdx + keysCount )
+   {
+      const float keyFrame = (float)m_keyFrames[startIdx];
+      const float nextKeyFrame = (float)m_keyFrames[startIdx + 1];
+      outLerpDist.setFromFloat( clamp( ( framePos - keyFrame ) / ( nextKeyFrame - keyFrame ), 0.0f, 1.0f ) );
+   }
+   else
+   {
+      outLerpDist = Float_0;
+   }
+
+   return startIdx;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -136,7 +451,7 @@ void SnapshotAnimation::sampleMotion( float trackTime, Transform& outMotionTrans
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void SnapshotAnimation::build( SnapshotAnimation& animation, uint bonesCount, BoneSRTAnimation* poseKeysArr, BoneSRTAnimation& motionKeys )
+void SnapshotAnimation::build( SnapshotAnimation& animation, uint bonesCount, BoneSRTAnimation* poseKeysArr, BoneSRTAnimation& motionKeys, const AnimationCompressionSettings& settings )
 {
    animation.m_bonesCount = bonesCount;
    animation.m_playbackFrequency = ANIMATION_SAMPLING_FREQUENCY;
@@ -154,7 +469,8 @@ void SnapshotAnimation::build( SnapshotAnimation& animation, uint bonesCount, Bo
    animation.m_motionTrack.resize( framesCount );
 
    uint poseEntriesCount = bonesCount * framesCount;
-   animation.m_poseTracks.resize( poseEntriesCount );
+   Array< Transform > poseTracks;
+   poseTracks.resize( poseEntriesCount );
 
    // sample poses and the motion track
    uint poseIdx = 0;
@@ -163,7 +479,7 @@ void SnapshotAnimation::build( SnapshotAnimation& animation, uint bonesCount, Bo
    {
       for ( uint boneIdx = 0; boneIdx < bonesCount; ++boneIdx )
       {
-         Transform& poseTransform = animation.m_poseTracks[poseIdx];
+         Transform& poseTransform = poseTracks[poseIdx];
          ++poseIdx;
 
          BoneSRTAnimation& poseTrack = poseKeysArr[boneIdx];
@@ -174,11 +490,13 @@ void SnapshotAnimation::build( SnapshotAnimation& animation, uint bonesCount, Bo
       Transform& motionTransform = animation.m_motionTrack[frameIdx];
       motionKeys.sample( sampledTrackTime, motionTransform );
    }
+
+   animation.compressPoseTracks( framesCount, (const Transform*)poseTracks, settings );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void SnapshotAnimation::build( SnapshotAnimation& animation, float playbackSpeed, uint framesCount, uint bonesCount, Transform* poseKeysArr, Transform* motionKeysArr )
+void SnapshotAnimation::build( SnapshotAnimation& animation, float playbackSpeed, uint framesCount, uint bonesCount, Transform* poseKeysArr, Transform* motionKeysArr, const AnimationCompressionSettings& settings )
 {
    animation.m_bonesCount = bonesCount;
    animation.m_duration = (float)framesCount / playbackSpeed;
@@ -187,17 +505,7 @@ void SnapshotAnimation::build( SnapshotAnimation& animation, float playbackSpeed
    // allocate enough room in the arrays
    animation.m_motionTrack.resize( framesCount );
 
-   uint poseEntriesCount = bonesCount * framesCount;
-   animation.m_poseTracks.resize( poseEntriesCount );
-
-   if ( poseKeysArr )
-   {
-      uint poseIdx = 0;
-      for ( uint poseIdx = 0; poseIdx < poseEntriesCount; ++poseIdx )
-      {
-         animation.m_poseTracks[poseIdx] = poseKeysArr[poseIdx];
-      }
-   }
+   animation.compressPoseTracks( framesCount, poseKeysArr, settings );
 
    if ( motionKeysArr )
    {
@@ -214,8 +522,146 @@ void SnapshotAnimation::clear()
 {
    m_duration = 0.0f;
    m_bonesCount = 0;
-   m_poseTracks.clear();
+   m_trackDescriptors.clear();
+   m_keyFrames.clear();
+   m_keyValues.clear();
+   m_translationRanges.clear();
    m_motionTrack.clear();
+   m_poseTracks.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SnapshotAnimation::compressPoseTracks( uint framesCount, const Transform* poseKeysArr, const AnimationCompressionSettings& settings )
+{
+   ASSERT_MSG( framesCount <= 65536, "The animation is too long to be compressed" );
+
+   // a track without any keys represents an identity rotation, or a constant translation - the minimum of its range.
+   // The clip may be recompressed, so the old descriptors need to go - resizing would only reset the new ones
+   m_trackDescriptors.clear();
+   m_translationRanges.clear();
+   m_trackDescriptors.resize( m_bonesCount * 4, 0 );
+   m_translationRanges.resize( m_bonesCount * 6, 0.0f );
+   m_keyFrames.clear();
+   m_keyValues.clear();
+
+   if ( !poseKeysArr || framesCount == 0 )
+   {
+      return;
+   }
+
+   Array< float > values;
+   values.resize( framesCount * 4 );
+   Array< uint > keyFrames;
+   word key[3];
+
+   for ( uint boneIdx = 0; boneIdx < m_bonesCount; ++boneIdx )
+   {
+      uint* rotationTrack = &m_trackDescriptors[boneIdx * 4];
+      uint* translationTrack = rotationTrack + 2;
+      float* range = &m_translationRanges[boneIdx * 6];
+
+      // rotation track
+      for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+      {
+         const Quaternion& rotation = poseKeysArr[frameIdx * m_bonesCount + boneIdx].m_rotation;
+         float* val = &values[frameIdx * 4];
+
+         for ( uint i = 0; i < 4; ++i )
+         {
+            val[i] = rotation[i];
+         }
+
+         // q and -q describe the same rotation - keep the subsequent frames in the same hemisphere,
+         // so that they interpolate along the shortest path
+         if ( frameIdx > 0 && getDot( val, val - 4 ) < 0.0f )
+         {
+            for ( uint i = 0; i < 4; ++i )
+            {
+               val[i] = -val[i];
+            }
+         }
+      }
+
+      keyFrames.clear();
+      if ( isConstant( (const float*)values, framesCount, 4, settings.m_rotationTolerance ) )
+      {
+         // a bone that doesn't rotate needs no keys at all
+         const float identity[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+         const float negatedIdentity[] = { 0.0f, 0.0f, 0.0f, -1.0f };
+         if ( getMaxDeviation( (const float*)values, identity, 4 ) > settings.m_rotationTolerance && getMaxDeviation( (const float*)values, negatedIdentity, 4 ) > settings.m_rotationTolerance )
+         {
+            keyFrames.push_back( 0 );
+         }
+      }
+      else
+      {
+         reduceKeys( (const float*)values, framesCount, 4, true, settings.m_rotationTolerance, keyFrames );
+      }
+
+      rotationTrack[0] = m_keyFrames.size();
+      rotationTrack[1] = keyFrames.size();
+      for ( uint i = 0; i < keyFrames.size(); ++i )
+      {
+         quantizeRotation( &values[keyFrames[i] * 4], key );
+         m_keyFrames.push_back( (word)keyFrames[i] );
+         m_keyValues.push_back( key[0] );
+         m_keyValues.push_back( key[1] );
+         m_keyValues.push_back( key[2] );
+      }
+
+      // translation track
+      for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+      {
+         const Vector& translation = poseKeysArr[frameIdx * m_bonesCount + boneIdx].m_translation;
+         float* val = &values[frameIdx * 3];
+         for ( uint i = 0; i < 3; ++i )
+         {
+            val[i] = translation[i];
+         }
+      }
+
+      keyFrames.clear();
+      if ( isConstant( (const float*)values, framesCount, 3, settings.m_translationTolerance ) )
+      {
+         // a constant translation is stored as the minimum of the range
+         for ( uint i = 0; i < 3; ++i )
+         {
+            range[i] = values[i];
+            range[3 + i] = 0.0f;
+         }
+      }
+      else
+      {
+         // quantize the translations within the range they span
+         for ( uint i = 0; i < 3; ++i )
+         {
+            float minVal = values[i];
+            float maxVal = values[i];
+            for ( uint frameIdx = 1; frameIdx < framesCount; ++frameIdx )
+            {
+               minVal = min2( minVal, values[frameIdx * 3 + i] );
+               maxVal = max2( maxVal, values[frameIdx * 3 + i] );
+            }
+
+            range[i] = minVal;
+            range[3 + i] = maxVal - minVal;
+         }
+
+         reduceKeys( (const float*)values, framesCount, 3, false, settings.m_translationTolerance, keyFrames );
+      }
+
+      translationTrack[0] = m_keyFrames.size();
+      translationTrack[1] = keyFrames.size();
+      for ( uint i = 0; i < keyFrames.size(); ++i )
+      {
+         quantizeTranslation( &values[keyFrames[i] * 3], range, key );
+         m_keyFrames.push_back( (word)keyFrames[i] );
+         m_keyValues.push_back( key[0] );
+         m_keyValues.push_back( key[1] );
+         m_keyValues.push_back( key[2] );
+      }
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
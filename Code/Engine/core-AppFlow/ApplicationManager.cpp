@@ -2,6 +2,7 @@
 #include "core-AppFlow\Application.h"
 #include "core-AppFlow\ApplicationData.h"
 #include "core\TimeController.h"
+#include "core\ResourcesManager.h"
 #include <stdexcept>
 #include <windows.h>
 
@@ -113,6 +114,9 @@ bool ApplicationManager::step()
    float timeElapsed = getTimeElapsed();
    m_globalTimeController->update(timeElapsed);
 
+   // register the resources that finished loading in the background
+   TSingleton< ResourcesManager >::getInstance().processAsyncLoads();
+
    switch(onStep())
    {
    case APC_SYSTEM:      return true;
@@ -30,6 +30,8 @@ Entity::Entity( const char* name )
    , m_localMtx( Matrix::IDENTITY )
    , m_globalVolume( NULL )
    , m_parentWorldMtx( &Matrix::IDENTITY )
+   , m_transformsStore( NULL )
+   , m_transformIdx( -1 )
 {
    m_globalMtx.setIdentity();
    buildBoundingVolume();
@@ -42,15 +44,17 @@ Entity::Entity( const Entity& rhs )
    , m_prefab( rhs.m_prefab )
    , m_serializedChildren( rhs.m_serializedChildren )
    , m_localVolume( new AxisAlignedBox( *rhs.m_localVolume ) )
-   , m_localMtx( rhs.m_localMtx )
-   , m_globalVolume( new AxisAlignedBox( *rhs.m_globalVolume ) )
+   , m_localMtx( rhs.getLocalMtx() )
+   , m_globalVolume( new AxisAlignedBox( rhs.getBoundingVolume() ) )
    , m_parentWorldMtx( &Matrix::IDENTITY )
+   , m_transformsStore( NULL )
+   , m_transformIdx( -1 )
 {
    if ( m_prefab )
    {
       m_prefab->addReference();
    }
-   m_globalMtx = rhs.m_globalMtx;
+   m_globalMtx = rhs.getGlobalMtx();
 
    // clone the children and attach them
    uint count = rhs.m_children.size();
@@ -71,6 +75,8 @@ Entity::Entity( const Entity& rhs )
 
 Entity::~Entity()
 {
+   ASSERT_MSG( !m_transformsStore, "The entity is still bound to a transforms store" );
+
    clear();
 
    if ( m_prefab )
@@ -314,7 +320,16 @@ void Entity::onPrePropertyChanged( ReflectionProperty& property )
 {
    SceneNode::onPrePropertyChanged( property );
 
-   if ( property.getName() == "m_prefab" )
+   if ( property.getName() == "m_localMtx" )
+   {
+      if ( m_transformsStore )
+      {
+         // the matrix may have been modified in the store ( see accessLocalMtx ) - refresh the member
+         // before it's edited, otherwise the edit would be based on a stale value
+         m_localMtx = m_transformsStore->getLocalMtx( m_transformIdx );
+      }
+   }
+   else if ( property.getName() == "m_prefab" )
    {
       if ( m_prefab )
       {
@@ -333,7 +348,15 @@ void Entity::onPropertyChanged( ReflectionProperty& property )
 {
    SceneNode::onPropertyChanged( property );
 
-   if ( property.getName() == "m_prefab" )
+   if ( property.getName() == "m_localMtx" )
+   {
+      if ( m_transformsStore )
+      {
+         m_transformsStore->accessLocalMtx( m_transformIdx ) = m_localMtx;
+      }
+      markTransformDirty();
+   }
+   else if ( property.getName() == "m_prefab" )
    {
       instantiatePrefab();
 
@@ -391,6 +414,12 @@ void Entity::onObjectPreSave()
 {
    SceneNode::onObjectPreSave();
 
+   if ( m_transformsStore )
+   {
+      // the current local matrix is kept in the store
+      m_localMtx = m_transformsStore->getLocalMtx( m_transformIdx );
+   }
+
    m_serializedChildren.clear();
 
    // copy only the nodes that haven't been instantiated from a prefab
@@ -556,6 +585,7 @@ void Entity::onDetached( Entity* parent )
    m_parentWorldMtx = &Matrix::IDENTITY;
 
    SceneNode::onDetached( parent );
+   markTransformDirty();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -577,69 +607,131 @@ void Entity::pullStructure( ModelView* view )
 
 void Entity::setLocalMtx( const Matrix& localMtx ) 
 {
+   // the member is written to even if the store holds the matrix - it's what the property
+   // observers see, and it will be copied back to the store once the property change is announced
    m_localMtx = localMtx;
+   if ( m_transformsStore )
+   {
+      m_transformsStore->accessLocalMtx( m_transformIdx ) = localMtx;
+   }
+   markTransformDirty();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Entity::setRightVec( const Vector& vec )
 {
-   m_localMtx.setSideVec<3>( vec );
+   Matrix localMtx = getLocalMtx();
+   localMtx.setSideVec<3>( vec );
+   setLocalMtx( localMtx );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Entity::setUpVec( const Vector& vec )
 {
-   m_localMtx.setUpVec<3>( vec );
+   Matrix localMtx = getLocalMtx();
+   localMtx.setUpVec<3>( vec );
+   setLocalMtx( localMtx );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Entity::setLookVec( const Vector& vec )
 {
-   m_localMtx.setForwardVec<3>( vec );
+   Matrix localMtx = getLocalMtx();
+   localMtx.setForwardVec<3>( vec );
+   setLocalMtx( localMtx );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Entity::setPosition( const Vector& vec )
 {
-   m_localMtx.setPosition<3>( vec );
+   Matrix localMtx = getLocalMtx();
+   localMtx.setPosition<3>( vec );
+   setLocalMtx( localMtx );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Entity::getRightVec( Vector& outRightVec ) const
 {
-   outRightVec = m_localMtx.sideVec();
+   outRightVec = getLocalMtx().sideVec();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Entity::getUpVec( Vector& outUpVec ) const
 {
-   outUpVec = m_localMtx.upVec();
+   outUpVec = getLocalMtx().upVec();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Entity::getLookVec( Vector& outLookVec ) const
 {
-   outLookVec = m_localMtx.forwardVec();
+   outLookVec = getLocalMtx().forwardVec();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Entity::getPosition( Vector& outPos ) const
 {
-   outPos = m_localMtx.position();
+   outPos = getLocalMtx().position();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void Entity::updateTransforms()
 {
+   if ( m_transformsStore )
+   {
+      // the transforms of the entire scene are managed by the store
+      m_transformsStore->update();
+      return;
+   }
+
+   // the entire hierarchy is about to be updated
+   updateOwnTransforms( false );
+   updateChildrenTransforms( 0, m_children.size(), true );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Entity::updateDirtyTransforms()
+{
+   if ( m_transformsStore )
+   {
+      // the store updates only the dirty entities anyway
+      m_transformsStore->update();
+      return;
+   }
+
+   if ( !m_transformDirty && !m_dirtyDescendants )
+   {
+      // nothing changed in this branch
+      return;
+   }
+
+   // if the global matrix changes, so do the matrices of all the nodes below
+   bool updated = updateOwnTransforms( true );
+   updateChildrenTransforms( 0, m_children.size(), updated );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Entity::updateOwnTransforms( bool dirtyOnly )
+{
+   bool updateRequired = !dirtyOnly || m_transformDirty;
+   m_transformDirty = false;
+   m_dirtyDescendants = false;
+
+   if ( !updateRequired )
+   {
+      return false;
+   }
+
    // update this matrix
    m_globalMtx.setMul( m_localMtx, *m_parentWorldMtx );
 
@@ -647,12 +739,64 @@ void Entity::updateTransforms()
    ASSERT( m_localVolume && m_globalVolume );
    m_localVolume->transform( m_globalMtx, *m_globalVolume );
 
-   // propagate the call down the hierarchy
-   uint childrenCount = m_children.size();
-   for ( uint i = 0; i < childrenCount; ++i )
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Entity::updateChildrenTransforms( uint firstChildIdx, uint lastChildIdx, bool fullUpdate )
+{
+   for ( uint i = firstChildIdx; i < lastChildIdx; ++i )
    {
       SceneNode* child = m_children[i];
-      child->updateTransforms();
+      if ( fullUpdate )
+      {
+         child->m_transformDirty = false;
+         child->updateTransforms();
+      }
+      else
+      {
+         child->updateDirtyTransforms();
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Entity::beginParallelChildrenUpdate()
+{
+   m_dirtyDescendants = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Entity::endParallelChildrenUpdate()
+{
+   m_dirtyDescendants = false;
+
+   const uint count = m_children.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      const SceneNode* child = m_children[i];
+      if ( child->m_transformDirty || child->m_dirtyDescendants )
+      {
+         m_dirtyDescendants = true;
+         break;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Entity::markTransformDirty()
+{
+   if ( m_transformsStore )
+   {
+      m_transformsStore->markDirty( m_transformIdx );
+   }
+   else
+   {
+      flagTransformDirty();
    }
 }
 
@@ -660,14 +804,14 @@ void Entity::updateTransforms()
 
 void Entity::getGlobalVectors( Vector& outRightVec, Vector& outUpVec, Vector& outLookVec, Vector& outPos ) const
 {
-   m_globalMtx.getVectors( outRightVec, outUpVec, outLookVec, outPos );
+   getGlobalMtx().getVectors( outRightVec, outUpVec, outLookVec, outPos );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 const AxisAlignedBox& Entity::getBoundingVolume() const
 {
-   return *m_globalVolume;
+   return m_transformsStore ? m_transformsStore->getGlobalVolume( m_transformIdx ) : *m_globalVolume;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -686,6 +830,7 @@ void Entity::addBoundingVolume( AxisAlignedBox* volume )
       m_localVolume = NULL;
 
       buildBoundingVolume();
+      markTransformDirty();
    }
 }
 
@@ -707,6 +852,7 @@ void Entity::removeBoundingVolume( AxisAlignedBox* volume )
    }
 
    buildBoundingVolume();
+   markTransformDirty();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -731,6 +877,11 @@ void Entity::buildBoundingVolume()
 
    delete m_globalVolume;
    m_globalVolume = new AxisAlignedBox(boundingBox );
+
+   if ( m_transformsStore )
+   {
+      m_transformsStore->setLocalVolume( m_transformIdx, boundingBox );
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
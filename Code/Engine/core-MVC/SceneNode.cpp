@@ -20,6 +20,8 @@ SceneNode::SceneNode( const char* name )
    , m_parentNode( NULL )
    , m_hostModel ( NULL )
    , m_instantiatedFromPrefab( false )
+   , m_transformDirty( true )
+   , m_dirtyDescendants( false )
 {
 }
 
@@ -31,6 +33,8 @@ SceneNode::SceneNode( const SceneNode& rhs )
    , m_parentNode( NULL )
    , m_hostModel ( NULL )
    , m_instantiatedFromPrefab( false )
+   , m_transformDirty( true )
+   , m_dirtyDescendants( false )
 {
 }
 
@@ -115,6 +119,9 @@ void SceneNode::onAttached( Entity* parent )
    ASSERT_MSG( !m_parentNode, "This node already has a parent" );
    m_parentNode = parent;
 
+   // the node now lives in a different coordinate system
+   markTransformDirty();
+
    // if the parent is a part of the model, make sure the children attached to it become a part of it as well
    Model* parentsHostModel = m_parentNode->getHostModel();
    if ( parentsHostModel )
@@ -148,6 +155,48 @@ void SceneNode::onDetached( Entity* parent )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void SceneNode::markTransformDirty()
+{
+   SceneTransforms* transformsStore = m_parentNode ? m_parentNode->getTransformsStore() : NULL;
+   if ( transformsStore )
+   {
+      // the store will update the node along with the rest of its parent's components
+      m_transformDirty = true;
+      transformsStore->markComponentsDirty( m_parentNode->getTransformIdx() );
+   }
+   else
+   {
+      flagTransformDirty();
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneNode::flagTransformDirty()
+{
+   m_transformDirty = true;
+
+   // let the ancestors know they need to step into this branch - if one of them already knows it,
+   // so do all the nodes above it
+   for ( Entity* ancestor = m_parentNode; ancestor != NULL && !ancestor->m_dirtyDescendants; ancestor = ancestor->m_parentNode )
+   {
+      ancestor->m_dirtyDescendants = true;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneNode::updateDirtyTransforms()
+{
+   if ( m_transformDirty )
+   {
+      m_transformDirty = false;
+      updateTransforms();
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void SceneNode::onPropertyChanged( ReflectionProperty& property )
 {
    ReflectionObject::onPropertyChanged( property );
@@ -0,0 +1,265 @@
+#include "core-MVC\SceneTransforms.h"
+#include "core-MVC\Model.h"
+#include "core-MVC\Entity.h"
+#include "core\Assert.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+SceneTransforms::SceneTransforms()
+   : m_scene( NULL )
+   , m_rebuildRequired( false )
+   , m_updateInProgress( false )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SceneTransforms::~SceneTransforms()
+{
+   // ModelView's destructor detaches the view from the model, but our
+   // implementation of the notification won't be called by then
+   invalidate();
+   m_scene = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::update()
+{
+   if ( m_rebuildRequired )
+   {
+      rebuild();
+   }
+
+   m_updateInProgress = true;
+
+   // sweep the entities - parents always precede their children, so by the time we get
+   // to an entity, its parent's global matrix is already up to date
+   const uint entitiesCount = m_entities.size();
+   const int* parentIndices = m_parentIndices.getRaw();
+   const Matrix* localMatrices = m_localMatrices.getRaw();
+   Matrix* globalMatrices = m_globalMatrices.getRaw();
+   const AxisAlignedBox* localVolumes = m_localVolumes.getRaw();
+   AxisAlignedBox* globalVolumes = m_globalVolumes.getRaw();
+   bool* dirty = m_dirty.getRaw();
+   bool* updated = m_updated.getRaw();
+
+   for ( uint i = 0; i < entitiesCount; ++i )
+   {
+      const int parentIdx = parentIndices[i];
+      const bool parentUpdated = parentIdx >= 0 && updated[parentIdx];
+
+      updated[i] = dirty[i] || parentUpdated;
+      dirty[i] = false;
+
+      if ( updated[i] )
+      {
+         const Matrix& parentMtx = parentIdx >= 0 ? globalMatrices[parentIdx] : Matrix::IDENTITY;
+         globalMatrices[i].setMul( localMatrices[i], parentMtx );
+         localVolumes[i].transform( globalMatrices[i], globalVolumes[i] );
+      }
+   }
+
+   // update the components of the entities that moved, and those that requested it themselves
+   for ( uint i = 0; i < entitiesCount; ++i )
+   {
+      if ( !updated[i] && !m_componentsDirty[i] )
+      {
+         continue;
+      }
+      m_componentsDirty[i] = false;
+
+      const uint lastComponentIdx = m_firstComponentIndices[i + 1];
+      for ( uint j = m_firstComponentIndices[i]; j < lastComponentIdx; ++j )
+      {
+         SceneNode* component = m_components[j];
+         if ( component )
+         {
+            component->m_transformDirty = false;
+            component->updateTransforms();
+         }
+      }
+   }
+
+   m_updateInProgress = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::onNodeAdded( SceneNode* node )
+{
+   m_rebuildRequired = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::onNodeRemoved( SceneNode* node )
+{
+   if ( !m_updateInProgress )
+   {
+      // the node is about to be removed, and maybe deleted - unbind everything, the store
+      // will be rebuilt during the next update
+      invalidate();
+      return;
+   }
+
+   // a node is being removed while we're iterating over the arrays - so we can't
+   // clear them, but we must forget about the node
+   m_rebuildRequired = true;
+   if ( node->isA< Entity >() )
+   {
+      Entity* entity = static_cast< Entity* >( node );
+      if ( entity->m_transformsStore == this )
+      {
+         unbindEntity( entity->m_transformIdx );
+      }
+   }
+   else
+   {
+      uint idx = m_components.find( node );
+      if ( idx != EOA )
+      {
+         m_components[idx] = NULL;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::onAttachedToModel( Model& model )
+{
+   ASSERT_MSG( m_scene == NULL, "SceneTransforms can observe only one scene at a time" );
+
+   ModelView::onAttachedToModel( model );
+
+   m_scene = &model;
+   m_rebuildRequired = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::onDetachedFromModel( Model& model )
+{
+   ModelView::onDetachedFromModel( model );
+
+   m_scene = NULL;
+   m_rebuildRequired = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::resetContents( Model& model )
+{
+   invalidate();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::rebuild()
+{
+   invalidate();
+   m_rebuildRequired = false;
+
+   Entity* root = m_scene ? m_scene->getRoot() : NULL;
+   if ( !root )
+   {
+      return;
+   }
+
+   // the entities array doubles as the queue of the breadth-first traversal
+   addEntity( root, -1 );
+   for ( uint i = 0; i < m_entities.size(); ++i )
+   {
+      Entity* entity = m_entities[i];
+      m_firstComponentIndices.push_back( m_components.size() );
+
+      const uint childrenCount = entity->m_children.size();
+      for ( uint j = 0; j < childrenCount; ++j )
+      {
+         SceneNode* child = entity->m_children[j];
+         if ( child->isA< Entity >() )
+         {
+            addEntity( static_cast< Entity* >( child ), i );
+         }
+         else
+         {
+            m_components.push_back( child );
+         }
+      }
+   }
+   m_firstComponentIndices.push_back( m_components.size() );
+   m_componentsDirty.resize( m_entities.size(), true );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::addEntity( Entity* entity, int parentIdx )
+{
+   ASSERT_MSG( entity->m_transformsStore == NULL, "The entity is already bound to a transforms store" );
+
+   entity->m_transformsStore = this;
+   entity->m_transformIdx = m_entities.size();
+
+   m_entities.push_back( entity );
+   m_parentIndices.push_back( parentIdx );
+   m_localMatrices.push_back( entity->m_localMtx );
+   m_globalMatrices.push_back( entity->m_globalMtx );
+   m_localVolumes.push_back( *entity->m_localVolume );
+   m_globalVolumes.push_back( *entity->m_globalVolume );
+   m_dirty.push_back( true );
+   m_updated.push_back( false );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::invalidate()
+{
+   const uint count = m_entities.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      unbindEntity( i );
+   }
+
+   m_entities.clear();
+   m_parentIndices.clear();
+   m_localMatrices.clear();
+   m_globalMatrices.clear();
+   m_localVolumes.clear();
+   m_globalVolumes.clear();
+   m_dirty.clear();
+   m_updated.clear();
+   m_components.clear();
+   m_firstComponentIndices.clear();
+   m_componentsDirty.clear();
+
+   m_rebuildRequired = ( m_scene != NULL );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SceneTransforms::unbindEntity( uint idx )
+{
+   Entity* entity = m_entities[idx];
+   if ( !entity )
+   {
+      return;
+   }
+   m_entities[idx] = NULL;
+
+   entity->m_transformsStore = NULL;
+   entity->m_transformIdx = -1;
+
+   // copy the transforms back
+   entity->m_localMtx = m_localMatrices[idx];
+   entity->m_globalMtx = m_globalMatrices[idx];
+   *entity->m_globalVolume = m_globalVolumes[idx];
+
+   if ( m_dirty[idx] )
+   {
+      // the change hasn't been propagated yet
+      entity->markTransformDirty();
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -2,7 +2,9 @@
 #include "core-MVC\Model.h"
 #include "core-MVC\Entity.h"
 #include "core-MVC\Transformable.h"
+#include "core-MVC\SceneTransforms.h"
 #include "core\ListUtils.h"
+#include "core\MultithreadedTasksScheduler.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -12,6 +14,8 @@ INIT_SINGLETON( TransformsManagementSystem );
 ///////////////////////////////////////////////////////////////////////////////
 
 TransformsManagementSystem::TransformsManagementSystem( const SingletonConstruct& )
+   : m_incrementalUpdates( true )
+   , m_parallelUpdates( true )
 {
 }
 
@@ -19,6 +23,15 @@ TransformsManagementSystem::TransformsManagementSystem( const SingletonConstruct
 
 TransformsManagementSystem::~TransformsManagementSystem()
 {
+   for ( List< SceneTransforms* >::iterator it = m_transformStores.begin(); !it.isEnd(); ++it )
+   {
+      SceneTransforms* transformsStore = *it;
+      Model* scene = transformsStore->getScene();
+
+      delete transformsStore;
+      scene->removeReference();
+   }
+
    for ( List< Model* >::iterator it = m_scenes.begin(); !it.isEnd(); ++it )
    {
       Model* scene = *it;
@@ -28,7 +41,7 @@ TransformsManagementSystem::~TransformsManagementSystem()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void TransformsManagementSystem::addScene( Model* scene )
+void TransformsManagementSystem::addScene( Model* scene, bool useTransformsStore )
 {
    if ( !scene )
    {
@@ -36,11 +49,30 @@ void TransformsManagementSystem::addScene( Model* scene )
    }
 
    List< Model* >::iterator it = ListUtils::find( m_scenes, scene );
-   if ( it.isEnd() )
+   if ( !it.isEnd() )
+   {
+      return;
+   }
+
+   for ( List< SceneTransforms* >::iterator storeIt = m_transformStores.begin(); !storeIt.isEnd(); ++storeIt )
+   {
+      if ( ( *storeIt )->getScene() == scene )
+      {
+         return;
+      }
+   }
+
+   if ( useTransformsStore )
+   {
+      SceneTransforms* transformsStore = new SceneTransforms();
+      scene->attachListener( transformsStore );
+      m_transformStores.pushBack( transformsStore );
+   }
+   else
    {
       m_scenes.pushBack( scene );
-      scene->addReference();
    }
+   scene->addReference();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -57,6 +89,20 @@ void TransformsManagementSystem::removeScene( Model* scene )
    {
       scene->removeReference();
       it.markForRemoval();
+      return;
+   }
+
+   for ( List< SceneTransforms* >::iterator storeIt = m_transformStores.begin(); !storeIt.isEnd(); ++storeIt )
+   {
+      SceneTransforms* transformsStore = *storeIt;
+      if ( transformsStore->getScene() == scene )
+      {
+         // deleting the store copies the transforms back to the entities
+         delete transformsStore;
+         scene->removeReference();
+         storeIt.markForRemoval();
+         return;
+      }
    }
 }
 
@@ -69,12 +115,11 @@ void TransformsManagementSystem::addTransformable( Transformable* obj )
       return;
    }
 
-   List< Transformable* >::iterator it = ListUtils::find( m_transformables, obj );
-   if ( it.isEnd() )
+   uint idx = m_transformables.find( obj );
+   if ( idx == EOA )
    {
-      m_transformables.pushBack( obj );
+      m_transformables.push_back( obj );
    }
-
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -86,29 +131,120 @@ void TransformsManagementSystem::removeTransformable( Transformable* obj )
       return;
    }
 
-   List< Transformable* >::iterator it = ListUtils::find( m_transformables, obj );
-   if ( !it.isEnd() )
+   uint idx = m_transformables.find( obj );
+   if ( idx != EOA )
    {
-      it.markForRemoval();
+      m_transformables.remove( idx );
    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// minimum number of transformable objects updated by a single job - there's usually
+// just a handful of them ( cameras and such ), not worth distributing
+#define MIN_TRANSFORMABLES_PER_JOB     64
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct TransformsManagementSystem::SubtreesUpdater
+{
+   Entity&        m_root;
+   bool           m_fullUpdate;
+
+   SubtreesUpdater( Entity& root, bool fullUpdate )
+      : m_root( root )
+      , m_fullUpdate( fullUpdate )
+   {}
+
+   void operator()( uint chunkStart, uint chunkEnd ) const
+   {
+      // Every subtree is updated by exactly one job, and it only reads the transforms of the root,
+      // which has already been updated. A node marked dirty during the update ( by a physics body
+      // that pulls its entity along, for instance ) flags its ancestors, but the flagging stops
+      // at the root, which stays flagged until all of the jobs are done.
+      m_root.updateChildrenTransforms( chunkStart, chunkEnd, m_fullUpdate );
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct TransformsManagementSystem::TransformablesUpdater
+{
+   Transformable* const*   m_transformables;
+
+   TransformablesUpdater( Transformable* const* transformables )
+      : m_transformables( transformables )
+   {}
+
+   void operator()( uint chunkStart, uint chunkEnd ) const
+   {
+      for ( uint i = chunkStart; i < chunkEnd; ++i )
+      {
+         m_transformables[i]->updateTransforms();
+      }
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 void TransformsManagementSystem::tick()
 {
    for ( List< Model* >::iterator it = m_scenes.begin(); !it.isEnd(); ++it )
    {
       Model* scene = *it;
-      scene->getRoot()->updateTransforms();
+      updateHierarchy( scene->getRoot() );
    }
 
-   for ( List< Transformable* >::iterator it = m_transformables.begin(); !it.isEnd(); ++it )
+   for ( List< SceneTransforms* >::iterator it = m_transformStores.begin(); !it.isEnd(); ++it )
    {
-      Transformable* transformable = *it;
-      transformable->updateTransforms();
+      SceneTransforms* transformsStore = *it;
+      transformsStore->update();
    }
 
+   const uint transformablesCount = m_transformables.size();
+   TransformablesUpdater transformablesUpdater( m_transformables.getRaw() );
+   if ( m_parallelUpdates )
+   {
+      MultithreadedTasksScheduler& scheduler = TSingleton< MultithreadedTasksScheduler >::getInstance();
+      scheduler.parallelFor( 0, transformablesCount, scheduler.calcGrainSize( transformablesCount, MIN_TRANSFORMABLES_PER_JOB ), transformablesUpdater );
+   }
+   else
+   {
+      transformablesUpdater( 0, transformablesCount );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TransformsManagementSystem::updateHierarchy( Entity* root )
+{
+   if ( !m_parallelUpdates || root->getTransformsStore() )
+   {
+      if ( m_incrementalUpdates )
+      {
+         root->updateDirtyTransforms();
+      }
+      else
+      {
+         root->updateTransforms();
+      }
+      return;
+   }
+
+   if ( m_incrementalUpdates && !root->isTransformDirty() && !root->hasDirtyDescendants() )
+   {
+      // nothing changed in the scene
+      return;
+   }
+
+   // update the root first, then distribute its subtrees between the workers
+   bool fullUpdate = root->updateOwnTransforms( m_incrementalUpdates );
+
+   const uint childrenCount = root->getChildrenCount();
+   MultithreadedTasksScheduler& scheduler = TSingleton< MultithreadedTasksScheduler >::getInstance();
+   root->beginParallelChildrenUpdate();
+   scheduler.parallelFor( 0, childrenCount, scheduler.calcGrainSize( childrenCount, 1 ), SubtreesUpdater( *root, fullUpdate ) );
+   root->endParallelChildrenUpdate();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
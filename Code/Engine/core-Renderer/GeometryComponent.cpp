@@ -1,5 +1,11 @@
 #include "core-Renderer\GeometryComponent.h"
 #include "core-Renderer\GeometryResource.h"
+#include "core-Renderer\TriangleMesh.h"
+#include "core-Renderer\Material.h"
+#include "core-Renderer\MaterialProfile.h"
+#include "core-Renderer\Renderer.h"
+#include "core-Renderer\RenderingContext.h"
+#include "core-Renderer\Defines.h"
 #include "core-Renderer\Camera.h"
 #include "core-Renderer\RenderState.h"
 #include "core-Renderer\Shader.h"
@@ -8,6 +14,7 @@
 #include "core\ListUtils.h"
 #include "core\ArrayUtils.h"
 #include "core\AxisAlignedBox.h"
+#include "core\Assert.h"
 #include <algorithm>
 
 
@@ -79,12 +86,86 @@ void GeometryComponent::setMaterial( Material* material )
 ///////////////////////////////////////////////////////////////////////////////
 
 void GeometryComponent::render( Renderer& renderer, RenderProfileId profile )
+{
+   if ( !m_renderState )
+   {
+      return;
+   }
+
+   m_renderState->beginBatch( renderer, profile );
+   draw( renderer, profile );
+   m_renderState->endBatch( renderer );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeometryComponent::draw( Renderer& renderer, RenderProfileId profile )
 {
    if ( !m_resource || !m_enabled || !m_renderState )
    {
       return;
    }
 
+   RCBindShader* shaderComm = bindShader( renderer, profile );
+   if ( shaderComm )
+   {
+      m_resource->render( renderer );
+      m_renderState->postRender( renderer );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool GeometryComponent::canBeInstanced( RenderProfileId profile ) const
+{
+   // selection queries identify the rendered entities by the data sent along with each draw call
+   if ( !m_resource || !m_enabled || !m_renderState || profile == RP_SelectionQuery )
+   {
+      return false;
+   }
+
+   const Material* material = m_renderState->m_material;
+   if ( !material || !material->getProfile()->isInstanced() )
+   {
+      return false;
+   }
+
+   // skinned meshes are deformed by the skeletons of their own entities, so they need to be rendered one by one
+   if ( !m_resource->isA< TriangleMesh >() || static_cast< const TriangleMesh* >( m_resource )->hasVertexWeights() )
+   {
+      return false;
+   }
+
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void GeometryComponent::drawInstances( Renderer& renderer, RenderProfileId profile, const GeometryComponent* const* instances, uint instancesCount )
+{
+   ASSERT_MSG( canBeInstanced( profile ), "This geometry can't be rendered using instancing" );
+   ASSERT_MSG( instancesCount <= MAX_INSTANCES_PER_DRAW_CALL, "Too many instances rendered in a single draw call" );
+
+   // the material nodes will take the transforms of the instances from the context
+   RenderingContext& context = renderer.accessContext();
+   context.m_instances = instances;
+   context.m_instancesCount = instancesCount;
+
+   RCBindShader* shaderComm = bindShader( renderer, profile );
+   if ( shaderComm )
+   {
+      m_resource->renderInstances( renderer, instancesCount );
+      m_renderState->postRender( renderer );
+   }
+
+   context.m_instances = NULL;
+   context.m_instancesCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+RCBindShader* GeometryComponent::bindShader( Renderer& renderer, RenderProfileId profile ) const
+{
    RCBindShader* shaderComm = NULL;
    switch ( profile )
    {
@@ -113,11 +194,7 @@ void GeometryComponent::render( Renderer& renderer, RenderProfileId profile )
       }
    }
 
-   if ( shaderComm )
-   {
-      m_resource->render( renderer );
-      m_renderState->postRender( renderer );
-   }
+   return shaderComm;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -136,6 +213,9 @@ void GeometryComponent::setMesh( GeometryResource& mesh )
 {
    m_resource = &mesh;
    m_boundingVol = m_resource->getBoundingVolume();
+
+   // world space bounds need to be recalculated
+   markTransformDirty();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -204,6 +284,7 @@ void GeometryComponent::onObjectLoaded( )
    {
       m_boundingVol = m_resource->getBoundingVolume();
       m_worldSpaceBounds = m_boundingVol;
+      markTransformDirty();
    }
 }
 
@@ -96,7 +96,7 @@ void IndexedDirectionalLightRenderer::renderLighting( Renderer& renderer, const
       psComm->setBool( "g_drawShadows", drawShadows );
       if ( data.m_screenSpaceShadowMap )
       {
-         psComm->setTexture( "g_ShadowMap", data.m_screenSpaceShadowMap );
+         psComm->setTexture( IDSTR( "g_ShadowMap" ), data.m_screenSpaceShadowMap );
       }
    }
 
@@ -242,7 +242,7 @@ void IndexedDirectionalLightRenderer::combineCascades( Renderer& renderer, const
          float texelDimension = 1.0f / cascadeDimensions;
          float cascadeScale = cascadeDimensions / shadowMapDimension;
          psComm->setFloat( "g_texelDimension", texelDimension );
-         psComm->setTexture( "g_shadowDepthMap", data.m_shadowDepthTexture );
+         psComm->setTexture( IDSTR( "g_shadowDepthMap" ), data.m_shadowDepthTexture );
          psComm->setFloat( "g_cascadeScale", cascadeScale );
          psComm->setFloat( "g_cascadeDepthRanges", depthRanges, numCascades + 1 );
          psComm->setVec4( "g_cascadeOffsets", viewportOffsets, numCascades  );
@@ -1 +1,21 @@
 #include "core-Renderer\InternalRenderCommands.h"
+#include "core-Renderer\Renderer.h"
+#include "core-Renderer\RenderCommandsBuffer.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+RCExecuteCommandsBuffer::RCExecuteCommandsBuffer( RenderCommandsBuffer* buffer )
+   : m_buffer( buffer )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RCExecuteCommandsBuffer::execute( Renderer& renderer )
+{
+   m_buffer->process( renderer );
+   renderer.releaseCommandsBuffer( m_buffer );
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,149 @@
+#include "core-Renderer\MNInstanceTransform.h"
+#include "core-Renderer\RenderState.h"
+#include "core-Renderer\Renderer.h"
+#include "core-Renderer\RenderingContext.h"
+#include "core-Renderer\MaterialShaderBuilder.h"
+#include "core-Renderer\GeometryComponent.h"
+#include "core-Renderer\Camera.h"
+#include "core-Renderer\ShaderDataBuffer.h"
+#include "core-Renderer\Defines.h"
+#include "core\Assert.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+BEGIN_OBJECT( MNInstanceTransform );
+   PARENT( MaterialNode );
+   PROPERTY_EDIT( "Type", TransformationType, m_transformType );
+END_OBJECT();
+
+///////////////////////////////////////////////////////////////////////////////
+
+MNInstanceTransform::MNInstanceTransform( const char* name, TransformationType transformType )
+   : MaterialNode( name )
+   , m_transformType( transformType )
+   , m_output( NULL )
+{
+   if ( !IS_BEING_SERIALIZED() )
+   {
+      m_output = new MSMatrixOutput( "Transform" );
+      defineOutput( m_output );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MNInstanceTransform::MNInstanceTransform( const MNInstanceTransform& rhs )
+   : MaterialNode( rhs )
+   , m_transformType( rhs.m_transformType )
+{
+   m_output = static_cast< MSMatrixOutput* >( findOutput( "Transform" ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MNInstanceTransform::~MNInstanceTransform()
+{
+   m_output = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MNInstanceTransform::onObjectLoaded()
+{
+   MaterialNode::onObjectLoaded();
+
+   m_output = static_cast< MSMatrixOutput* >( findOutput( "Transform" ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MNInstanceTransform::buildMaterialShader( MaterialShaderBuilder& builder )
+{
+   std::string transformsArrName;
+   builder.addGlobal< MSMatrixOutput >( var_transforms, transformsArrName, MAX_INSTANCES_PER_DRAW_CALL );
+
+   const char* outputVar = builder.addVariable( m_output );
+   builder.addCodeLine( "<type_Mtx4x4> %s = %s[gl_InstanceID];", outputVar, transformsArrName.c_str() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MNInstanceTransform::render( Renderer& renderer, const RenderState& host, RCBindShader* shaderComm, ShaderDataBuffer* constantsBuf ) const
+{
+   const RenderingContext& context = renderer.getContext();
+   const GeometryComponent* const* instances = context.m_instances;
+   uint instancesCount = context.m_instancesCount;
+
+   const GeometryComponent* parent = host.getParent();
+   if ( !instances )
+   {
+      // a regular draw call that renders the host geometry only
+      if ( !parent )
+      {
+         return;
+      }
+
+      instances = &parent;
+      instancesCount = 1;
+   }
+   ASSERT_MSG( instancesCount <= MAX_INSTANCES_PER_DRAW_CALL, "Too many instances rendered in a single draw call" );
+
+   // the part of the transform that's shared by all instances
+   Matrix cameraMtx;
+   Camera& camera = renderer.getActiveCamera();
+   switch ( m_transformType )
+   {
+      case SPACE_Model_to_View:
+      {
+         cameraMtx = camera.getViewMtx();
+         break;
+      }
+
+      case SPACE_Model_To_Projection:
+      {
+         cameraMtx.setMul( camera.getViewMtx(), camera.getProjectionMtx() );
+         break;
+      }
+
+      default:
+      {
+         cameraMtx = Matrix::IDENTITY;
+         break;
+      }
+   }
+
+   Matrix* transforms = &constantsBuf->accessData< Matrix >( var_transforms );
+   for ( uint i = 0; i < instancesCount; ++i )
+   {
+      calcTransform( instances[i]->getGlobalMtx(), cameraMtx, transforms[i] );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MNInstanceTransform::calcTransform( const Matrix& worldMtx, const Matrix& cameraMtx, Matrix& outTransform ) const
+{
+   switch ( m_transformType )
+   {
+      case SPACE_Model_to_World:
+      {
+         outTransform = worldMtx;
+         break;
+      }
+
+      case SPACE_Model_to_InvTranspWorld:
+      {
+         outTransform.setInverseTranspose( worldMtx );
+         break;
+      }
+
+      default:
+      {
+         outTransform.setMul( worldMtx, cameraMtx );
+         break;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -13,16 +13,16 @@ MaterialConstantsBlock::MaterialConstantsBlock( const char* name )
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MaterialConstantsBlock::add( const ReflectionType* engineType, uint& outOffset, std::string& outName )
+void MaterialConstantsBlock::add( const ReflectionType* engineType, uint& outOffset, std::string& outName, uint arrSize )
 {
    char tmpName[128];
    sprintf_s( tmpName, "internalGlobal_%03d", m_entries.size() );
 
-   m_entries.pushBack( Entry( m_nextOffset, engineType, tmpName, 1 ) );
+   m_entries.pushBack( Entry( m_nextOffset, engineType, tmpName, arrSize ) );
    outOffset = m_nextOffset;
    outName = tmpName;
 
-   m_nextOffset += MaterialShaderBuilder::getTypeSize( engineType );
+   m_nextOffset += MaterialShaderBuilder::getTypeSize( engineType ) * arrSize;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1,6 +1,7 @@
 #include "core-Renderer\MaterialProfile.h"
 #include "core-Renderer\RenderState.h"
 #include "core-Renderer\MaterialNode.h"
+#include "core-Renderer\MNInstanceTransform.h"
 #include "core-Renderer\Renderer.h"
 #include "core-Renderer\MaterialShaderBuilder.h"
 #include "core-Renderer\Shader.h"
@@ -27,6 +28,7 @@ MaterialProfile::MaterialProfile()
    : m_shader( new Shader() )
    , m_transparent( false )
    , m_doubleSided( false )
+   , m_instanced( false )
 {
    m_nodes[0] = &m_vertexRoutineNodes;
    m_nodes[1] = &m_tessControlRoutineNodes;
@@ -201,6 +203,15 @@ void MaterialProfile::buildProfile()
       m_routineConstantBufferName[routineIdx] = constantBufferName;
    }
 
+   // the profile supports instancing if the vertex routine takes the transforms from the instances
+   m_instanced = false;
+   const Array< MaterialNode* >& vertexNodesQueue = m_nodesQueue[SHADER_VERTEX];
+   const uint vertexNodesCount = vertexNodesQueue.size();
+   for ( uint i = 0; i < vertexNodesCount && !m_instanced; ++i )
+   {
+      m_instanced = vertexNodesQueue[i]->isA< MNInstanceTransform >();
+   }
+
    // rebuild the shader
    m_shader->build();
 }
@@ -52,7 +52,7 @@ void SurfaceQuery::allocateBuffer( uint width, uint height, byte pixelStride )
       // we need to reallocate
       MemoryRouter& memRouter = TSingleton< MemoryRouter >::getInstance();
       memRouter.dealloc( m_buffer, AM_DEFAULT );
-      m_buffer = (byte*)memRouter.alloc( newSize, AM_DEFAULT, &memRouter.m_defaultAllocator );
+      m_buffer = (byte*)memRouter.alloc( newSize, AM_DEFAULT, memRouter.getDefaultAllocator() );
    }
 
    // memorize the new buffer size
@@ -71,6 +71,9 @@ void PointLight::initializeBounds()
    Sphere sphere;
    sphere.set( Quad_0, m_radius );
    sphere.calculateBoundingBox( m_boundingVol );
+
+   // world space bounds need to be recalculated
+   markTransformDirty();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
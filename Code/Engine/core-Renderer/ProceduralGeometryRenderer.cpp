@@ -1,6 +1,6 @@
 #include "core-Renderer\ProceduralGeometryRenderer.h"
 #include "core-Renderer\Renderer.h"
-#include "core\TSContinuousMemoryPool.h"
+#include "core\FrameMemoryPool.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,39 @@
+#include "core-Renderer\RenderCommandsBuffer.h"
+#include "core-Renderer\RenderStateChangeTracker.h"
+#include "core-Renderer\RenderStateFlags.h"
+#include "core-Renderer\RenderingContext.h"
+#include "core\FragmentedMemoryPool.h"
+#include "core\Assert.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+RenderCommandsBuffer::RenderCommandsBuffer( size_t pageSize )
+   : LocklessCommandsBuffer< Renderer >( pageSize )
+   , m_renderStateCommandsQueue( new FragmentedMemoryPool( 1024, 64 ) )
+   , m_renderStateFlags( new RenderStateFlags() )
+   , m_context( new RenderingContext() )
+{
+   m_stateChangeTrackersStack = new Stack< RenderStateChangeTracker* >( m_renderStateCommandsQueue );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+RenderCommandsBuffer::~RenderCommandsBuffer()
+{
+   ASSERT_MSG( m_stateChangeTrackersStack->empty(), "The render state changes recorded in the buffer weren't restored" );
+
+   delete m_stateChangeTrackersStack;
+   m_stateChangeTrackersStack = NULL;
+
+   delete m_renderStateCommandsQueue;
+   m_renderStateCommandsQueue = NULL;
+
+   delete m_renderStateFlags;
+   m_renderStateFlags = NULL;
+
+   delete m_context;
+   m_context = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
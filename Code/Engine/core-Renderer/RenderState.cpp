@@ -276,19 +276,6 @@ RCBindShader* RenderState::renderDefault( Renderer& renderer ) const
       return NULL;
    }
 
-   // TODO: these render states - we're gonna have separate passes for rendering transparency etc.
-   // set the render state
-   SAVE_RENDER_STATE( renderer );
-   if ( profile->isTransparent() )
-   {
-      CHANGE_RENDER_STATE( renderer, RSSetAlphaTest( true ) );
-   }
-
-   if ( profile->isDoubleSided() )
-   {
-      CHANGE_RENDER_STATE( renderer, RSSetFaceCulling( CULL_NONE ) );
-   }
-
    // set the render command
    RCBindShader* shaderComm = new ( renderer.rtComm() ) RCBindShader( shader, renderer );
 
@@ -309,8 +296,6 @@ RCBindShader* RenderState::renderSelectionQuery( Renderer& renderer ) const
       return NULL;
    }
 
-   SAVE_RENDER_STATE( renderer );
-
    // set the render command
    RCBindShader* shaderComm = new ( renderer.rtComm() ) RCBindShader( m_selectionQueryShader, renderer );
    if ( m_parent )
@@ -325,7 +310,7 @@ RCBindShader* RenderState::renderSelectionQuery( Renderer& renderer ) const
    {
       m_selectionQueryPassDataBuffer->accessData< Vector >() = Vector_ZERO;
    }
-   shaderComm->setDataBuf( "FragmentShaderConstants", m_selectionQueryPassDataBuffer );
+   shaderComm->setDataBuf( IDSTR( "FragmentShaderConstants" ), m_selectionQueryPassDataBuffer );
 
    for ( uint routineIdx = 0; routineIdx < SHADER_FRAGMENT; ++routineIdx )
    {
@@ -344,14 +329,12 @@ RCBindShader* RenderState::renderSelection( Renderer& renderer ) const
       return NULL;
    }
 
-   SAVE_RENDER_STATE( renderer );
-
    // set the render command
    RCBindShader* shaderComm = new ( renderer.rtComm() ) RCBindShader( m_singleColorShader, renderer );
 
    const RenderingContext& context = renderer.getContext();
    m_selectionPassDataBuffer->accessData< Color >() = context.m_color;
-   shaderComm->setDataBuf( "FragmentShaderConstants", m_selectionPassDataBuffer );
+   shaderComm->setDataBuf( IDSTR( "FragmentShaderConstants" ), m_selectionPassDataBuffer );
    
    for ( uint routineIdx = 0; routineIdx < SHADER_FRAGMENT; ++routineIdx )
    {
@@ -370,8 +353,6 @@ RCBindShader* RenderState::rendererShadowMap( Renderer& renderer ) const
       return NULL;
    }
 
-   SAVE_RENDER_STATE( renderer );
-
    // set the render command
    RCBindShader* shaderComm = new ( renderer.rtComm() ) RCBindShader( m_shadowMapShader, renderer );
    const RenderingContext& context = renderer.getContext();
@@ -416,6 +397,36 @@ void RenderState::updateMaterialNodes( uint routineIdx, Renderer& renderer, RCBi
 void RenderState::postRender( Renderer& renderer ) const
 {
    new ( renderer.rtComm() ) RCUnbindShader();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RenderState::beginBatch( Renderer& renderer, RenderProfileId profile ) const
+{
+   SAVE_RENDER_STATE( renderer );
+
+   if ( profile != RP_Default || !m_material )
+   {
+      return;
+   }
+
+   // TODO: these render states - we're gonna have separate passes for rendering transparency etc.
+   const MaterialProfile* materialProfile = m_material->getProfile();
+   if ( materialProfile->isTransparent() )
+   {
+      CHANGE_RENDER_STATE( renderer, RSSetAlphaTest( true ) );
+   }
+
+   if ( materialProfile->isDoubleSided() )
+   {
+      CHANGE_RENDER_STATE( renderer, RSSetFaceCulling( CULL_NONE ) );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RenderState::endBatch( Renderer& renderer ) const
+{
    RESTORE_RENDER_STATE( renderer );
 }
 
@@ -7,9 +7,10 @@
 #include "core\ThreadSystem.h"
 #include "core\Thread.h"
 #include "core\CriticalSection.h"
+#include "core\ConditionVariable.h"
 
 // memory
-#include "core\TSContinuousMemoryPool.h"
+#include "core\FrameMemoryPool.h"
 
 // utils
 #include "core\ListUtils.h"
@@ -23,8 +24,9 @@
 #define RENDER_THREAD_QUEUE_SIZE          1024*1024
 #define MAIN_THREAD_QUEUE_SIZE            20*1024
 
-// and 1MB for any extra allocations render commands make
-#define RENDER_MEMORY_SIZE                2024*1024
+// any extra allocations render commands make are stored in 256 KB pages - the pool will allocate
+// as many as it needs
+#define RENDER_MEMORY_PAGE_SIZE           256*1024
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -32,11 +34,44 @@ INIT_SINGLETON( RenderSystem );
 
 ///////////////////////////////////////////////////////////////////////////////
 
+struct RenderSystem::RenderThreadWakeUpPredicate
+{
+   const RenderSystem&     m_system;
+
+   RenderThreadWakeUpPredicate( const RenderSystem& system ) : m_system( system ) {}
+
+   bool operator()() const
+   {
+      return !m_system.m_runRenderingThread || ( !m_system.m_rendererRegistrationsPending && m_system.isFrameCommitted() );
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct RenderSystem::RenderingFinishedPredicate
+{
+   const RenderSystem&     m_system;
+
+   RenderingFinishedPredicate( const RenderSystem& system ) : m_system( system ) {}
+
+   bool operator()() const
+   {
+      return !m_system.m_renderingInProgress;
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 RenderSystem::RenderSystem( const SingletonConstruct& )
    : m_runRenderingThread( true )
    , m_rendererRegistrationsPending( false )
    , m_renderingInProgress( false )
 {
+   // the synchronization tools need to be in place before the rendering thread starts
+   m_renderersListLock = new CriticalSection();
+   m_renderThreadWakeUp = new ConditionVariable();
+   m_renderingFinished = new ConditionVariable();
+
    // create the rendering thread
    ThreadSystem& threadSys = TSingleton< ThreadSystem >::getInstance();
    m_mainRenderingThread = &threadSys.getCurrentThread();
@@ -44,20 +79,28 @@ RenderSystem::RenderSystem( const SingletonConstruct& )
 
    bool wasThreadStarted = m_renderingThread->start( *this );
    ASSERT_MSG( wasThreadStarted, "Unable to start the rendering thread" );
-
-   m_renderersListLock = new CriticalSection();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 RenderSystem::~RenderSystem()
 {
+   m_renderersListLock->enter();
    m_runRenderingThread = false;
+   m_renderThreadWakeUp->notifyOne();
+   m_renderersListLock->leave();
+
    m_renderingThread->join(); 
 
    delete m_renderingThread;
    m_renderingThread = NULL;
 
+   delete m_renderThreadWakeUp;
+   m_renderThreadWakeUp = NULL;
+
+   delete m_renderingFinished;
+   m_renderingFinished = NULL;
+
    delete m_renderersListLock;
    m_renderersListLock = NULL;
 }
@@ -112,23 +155,27 @@ void RenderSystem::registerRenderer( Renderer* renderer )
 
    // add a new entry
    {
-      // signal the rendering thread that it needs to pause until we can remove 
+      // signal the rendering thread that it needs to pause until we can add 
       // the renderer
+      m_renderersListLock->enter();
       m_rendererRegistrationsPending = true;
+      m_renderersListLock->leave();
 
       // wait until the rendering thread finishes the loop
-      while ( m_renderingInProgress )
-      {
-         Thread::yield();
-      }
+      m_renderingFinished->waitUntil( *m_renderersListLock, RenderingFinishedPredicate( *this ) );
 
       // create and add the new entry
       RendererEntry* entry = new RendererEntry( renderer, this );
+
+      m_renderersListLock->enter();
       m_renderers.push_back( entry );
 
       // resume the rendering thread's loop
       m_rendererRegistrationsPending = false;
+      m_renderersListLock->leave();
 
+      // it might have missed a frame committed in the meantime
+      wakeUpRenderThread();
    }
 }
 
@@ -147,20 +194,20 @@ void RenderSystem::unregisterRenderer( Renderer* renderer )
    {
       // signal the rendering thread that it needs to pause until we can remove 
       // the renderer
+      m_renderersListLock->enter();
       m_rendererRegistrationsPending = true;
+      m_renderersListLock->leave();
+
+      // wait until the rendering thread finishes the loop
+      m_renderingFinished->waitUntil( *m_renderersListLock, RenderingFinishedPredicate( *this ) );
 
+      m_renderersListLock->enter();
       const int count = m_renderers.size();
       for ( int i = count - 1; i >= 0; --i )
       {
          RendererEntry* entry = m_renderers[i];
          if ( entry->m_renderer == renderer )
          {
-            // wait until the rendering thread finishes the loop
-            while( m_renderingInProgress )
-            {
-               Thread::yield();
-            }
-
             // remove the entry from the list
             removedEntry = entry;
 
@@ -177,6 +224,10 @@ void RenderSystem::unregisterRenderer( Renderer* renderer )
 
       // resume the rendering thread's loop
       m_rendererRegistrationsPending = false;
+      m_renderersListLock->leave();
+
+      // it might have missed a frame committed in the meantime
+      wakeUpRenderThread();
    }
 
    // process the remaining commands here
@@ -206,8 +257,13 @@ void RenderSystem::flush()
    for ( uint i = 0; i < count; ++i )
    {
       RendererEntry* entry = m_renderers[i];
+      ASSERT_MSG( entry->m_renderer->areCommandsBuffersRecorded(), "Some of the reserved commands buffers haven't been recorded" );
+
+      entry->m_commandsDataAllocator->nextFrame();
       entry->m_renderThreadCommandsQueue->commit();
    }
+
+   wakeUpRenderThread();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -228,6 +284,12 @@ void RenderSystem::render()
          entry->m_mainThreadCommandsQueue->process( *entry->m_renderer );
 
          entry->m_renderer->render();
+
+         // the buffers recorded by the worker threads are already spliced into the queue
+         ASSERT_MSG( entry->m_renderer->areCommandsBuffersRecorded(), "Some of the reserved commands buffers haven't been recorded" );
+
+         // the commands data of the next frame will be allocated while the render thread is busy with this one
+         entry->m_commandsDataAllocator->nextFrame();
          entry->m_renderThreadCommandsQueue->commit();
       }
 
@@ -235,7 +297,19 @@ void RenderSystem::render()
          uint renderCommandsCount = entry->m_renderThreadCommandsQueue->getMemoryUsed();
          PROFILE_VALUE( uint, renderCommandsCount );
       );
+
+      // each profiled value needs a scope of its own
+      DEBUG_CODE( 
+         uint renderCommandsDataHighWaterMark = entry->m_commandsDataAllocator->getHighWaterMark();
+         PROFILE_VALUE( uint, renderCommandsDataHighWaterMark );
+      );
+      DEBUG_CODE( 
+         uint renderCommandsDataPagesCount = entry->m_commandsDataAllocator->getPagesCount();
+         PROFILE_VALUE( uint, renderCommandsDataPagesCount );
+      );
    }
+
+   wakeUpRenderThread();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -243,15 +317,27 @@ void RenderSystem::render()
 /// @Rendering thread
 void RenderSystem::run()
 {
-   while ( m_runRenderingThread )
+   while ( true )
    {
-      while ( m_rendererRegistrationsPending )
+      // sleep until there's a frame to render ( or until we're asked to stop )
+      m_renderThreadWakeUp->waitUntil( *m_renderersListLock, RenderThreadWakeUpPredicate( *this ) );
+
+      m_renderersListLock->enter();
+      if ( !m_runRenderingThread )
       {
-         // wait until pending registrations are processed
-         Thread::yield();
+         m_renderersListLock->leave();
+         break;
       }
 
+      if ( m_rendererRegistrationsPending )
+      {
+         // a registration slipped in after we woke up - wait until it's processed
+         m_renderersListLock->leave();
+         continue;
+      }
       m_renderingInProgress = true;
+      m_renderersListLock->leave();
+
       const uint count = m_renderers.size();
       for ( uint i = 0; i < count; ++i )
       {
@@ -261,11 +347,40 @@ void RenderSystem::run()
             renderSingleFrame( entry );
          }
       }
+
+      m_renderersListLock->enter();
       m_renderingInProgress = false;
+      m_renderingFinished->notifyAll();
+      m_renderersListLock->leave();
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
-      // yield the execution and let other threads do something for a change
-      Thread::yield();
+bool RenderSystem::isFrameCommitted() const
+{
+   const uint count = m_renderers.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      if ( m_renderers[i]->m_renderThreadCommandsQueue->getCommandsCount() > 1 )
+      {
+         return true;
+      }
    }
+
+   return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RenderSystem::wakeUpRenderThread()
+{
+   // The frames are committed without holding the lock - but the render thread checks for them
+   // while holding it, so entering it here guarantees it either sees the committed frames,
+   // or is already waiting for the notification
+   m_renderersListLock->enter();
+   m_renderThreadWakeUp->notifyOne();
+   m_renderersListLock->leave();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -310,7 +425,7 @@ RenderSystem::RendererEntry::RendererEntry( Renderer* renderer, RenderSystem* sy
    : m_renderer( renderer )
 {
    // create a memory pool dedicated to keeping the rendering commands related data
-   m_commandsDataAllocator = new TSContinuousMemoryPool( RENDER_MEMORY_SIZE );
+   m_commandsDataAllocator = new FrameMemoryPool( RENDER_MEMORY_PAGE_SIZE );
 
    // create the commands queue
    m_renderThreadCommandsQueue = new SteppedLocklessCommandsQueue< Renderer >( RENDER_THREAD_QUEUE_SIZE );
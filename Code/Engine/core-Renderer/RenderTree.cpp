@@ -2,134 +2,330 @@
 #include "core-Renderer\GeometryComponent.h"
 #include "core-Renderer\RenderState.h"
 #include "core-Renderer\Renderer.h"
+#include "core-Renderer\RenderCommandsBuffer.h"
+#include "core-Renderer\Camera.h"
+#include "core-Renderer\Defines.h"
 #include "core\ContinuousMemoryPool.h"
+#include "core\AxisAlignedBox.h"
+#include "core\Algorithms.h"
+#include "core\MultithreadedTasksScheduler.h"
+#include <map>
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
-GeometryNode::GeometryNode( GeometryNode*& nextNode, GeometryComponent& geometry )
-   : m_next( nextNode )
-   , m_geometry( geometry )
+namespace // anonymous
 {
-   nextNode = this;
-}
+   /**
+    * Assigns consecutive ids to the objects, in the order they are first encountered in.
+    */
+   class IdsMap
+   {
+   private:
+      std::map< const void*, uint >    m_ids;
+      uint                             m_maxId;
 
-///////////////////////////////////////////////////////////////////////////////
+   public:
+      IdsMap( uint maxId ) : m_maxId( maxId ) {}
 
-GeometryNode::~GeometryNode()
-{
+      uint getId( const void* obj )
+      {
+         std::map< const void*, uint >::const_iterator it = m_ids.find( obj );
+         if ( it != m_ids.end() )
+         {
+            return it->second;
+         }
+
+         // the objects that don't fit in the key will share the last id
+         uint id = m_ids.size();
+         if ( id > m_maxId )
+         {
+            id = m_maxId;
+         }
+         m_ids.insert( std::make_pair( obj, id ) );
+         return id;
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   /**
+    * Records chunks of the draw calls of a render tree, each in a commands buffer of its own.
+    */
+   struct DrawCallsRecorder
+   {
+      RenderTree&                               m_tree;
+      const Array< RenderCommandsBuffer* >&     m_buffers;
+      uint                                      m_drawCallsPerChunk;
+
+      DrawCallsRecorder( RenderTree& tree, const Array< RenderCommandsBuffer* >& buffers, uint drawCallsPerChunk )
+         : m_tree( tree )
+         , m_buffers( buffers )
+         , m_drawCallsPerChunk( drawCallsPerChunk )
+      {
+      }
+
+      void operator()( uint chunkStart, uint chunkEnd ) const
+      {
+         const uint drawCallsCount = m_tree.getDrawCallsCount();
+         for ( uint chunkIdx = chunkStart; chunkIdx < chunkEnd; ++chunkIdx )
+         {
+            const uint firstDrawCall = chunkIdx * m_drawCallsPerChunk;
+            const uint lastDrawCall = min2( firstDrawCall + m_drawCallsPerChunk, drawCallsCount );
+
+            m_tree.m_renderer.beginRecording( m_buffers[chunkIdx] );
+            m_tree.renderDrawCalls( firstDrawCall, lastDrawCall );
+            m_tree.m_renderer.endRecording();
+         }
+      }
+   };
 }
 
-///////////////////////////////////////////////////////////////////////////////
-///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
-StateTreeNode::StateTreeNode( const RenderState& state ) 
-   : m_sibling( NULL )
-   , m_state( &state ) 
-   , m_geometryNode( NULL )
+RenderTree::RenderTree( Renderer& renderer, const Array< GeometryComponent* >& visibleElems, RenderProfileId profile )
+   : m_renderer( renderer )
+   , m_profile( profile )
+   , m_entries( visibleElems.size() )
+   , m_renderedGeometry( visibleElems.size() )
+   , m_drawCalls( visibleElems.size() )
 {
-}
+   if ( visibleElems.empty() )
+   {
+      return;
+   }
 
+   // the geometry will be rendered front to back
+   const Camera& camera = renderer.getActiveCamera();
+   Vector cameraPos, lookVec;
+   camera.getPosition( cameraPos );
+   camera.getLookVec( lookVec );
+   const float farZPlane = camera.getFarClippingPlane();
+   const float maxDepthBucket = (float)( ( 1 << DEPTH_BITS ) - 1 );
 
-///////////////////////////////////////////////////////////////////////////////
+   IdsMap materialIds( ( 1 << MATERIAL_BITS ) - 1 );
+   IdsMap meshIds( ( 1 << MESH_BITS ) - 1 );
 
-StateTreeNode::~StateTreeNode()
-{
+   const RenderSortKey profileBits = (RenderSortKey)profile << ( STATE_PREFIX_SHIFT + MATERIAL_BITS );
+
+   uint elemsCount = visibleElems.size();
+   for ( uint i = 0; i < elemsCount; ++i )
+   {
+      GeometryComponent* geometry = visibleElems[i];
+      const RenderState* renderState = geometry->getRenderState();
+      if ( !renderState )
+      {
+         // there's nothing this geometry could be rendered with
+         continue;
+      }
+
+      Vector center, toCenter;
+      geometry->getBoundingVolume().getCenter( center );
+      toCenter.setSub( center, cameraPos );
+      const float depth = toCenter.dot( lookVec ).getFloat();
+      const uint depthBucket = (uint)( clamp( depth / farZPlane, 0.0f, 1.0f ) * maxDepthBucket );
+
+      RenderQueueEntry entry;
+      entry.m_geometry = geometry;
+      entry.m_key = profileBits;
+      entry.m_key |= (RenderSortKey)materialIds.getId( renderState->m_material ) << STATE_PREFIX_SHIFT;
+      entry.m_key |= (RenderSortKey)meshIds.getId( geometry->getMesh() ) << DEPTH_BITS;
+      entry.m_key |= depthBucket;
+      m_entries.push_back( entry );
+   }
+
+   sortEntries();
+   buildDrawCalls();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool StateTreeNode::compareState( const RenderState* state )
+RenderTree::~RenderTree()
 {
-   return RenderState::isEqual( *m_state, *state );
 }
 
-///////////////////////////////////////////////////////////////////////////////
-///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
-RenderTree::RenderTree( Renderer& renderer, const Array< GeometryComponent* >& visibleElems )
-   : m_renderer( renderer )
-   , m_root( NULL )
+void RenderTree::sortEntries()
 {
-   if ( visibleElems.empty() )
+   const uint entriesCount = m_entries.size();
+   if ( entriesCount < 2 )
    {
       return;
    }
 
-   // the first element
-   {
-      GeometryComponent* geometry = visibleElems[0];
-      const RenderState* checkedState = geometry->getRenderState();
-      m_root = new ( renderer.m_renderTreeMemPool ) StateTreeNode( *checkedState );
-      new ( renderer.m_renderTreeMemPool ) GeometryNode( m_root->m_geometryNode, *geometry );
-   }
+   // LSD radix sort, one byte at a time. The sort is stable, so the geometry with equal keys
+   // is rendered in the order it was queued in
+   Array< RenderQueueEntry > buffer;
+   buffer.resizeWithoutInitializing( entriesCount );
 
-   // subsequent elements
-   uint elemsCount = visibleElems.size();
-   for ( uint i = 1; i < elemsCount; ++i )
+   RenderQueueEntry* src = m_entries.getRaw();
+   RenderQueueEntry* dst = buffer.getRaw();
+
+   uint offsets[256];
+   for ( uint shift = 0; shift < 64; shift += 8 )
    {
-      GeometryComponent* geometry = visibleElems[i];
-      const RenderState* checkedState = geometry->getRenderState();
-      // at this point the states are already sorted
+      memset( offsets, 0, sizeof( offsets ) );
+      for ( uint i = 0; i < entriesCount; ++i )
+      {
+         ++offsets[( src[i].m_key >> shift ) & 0xff];
+      }
 
-      // states span into the tree depth - so each branch is a unique state,
-      // and its leaves contain geometry to render
+      // most of the bytes ( the profile, the high bits of the ids ) are the same in all keys
+      if ( offsets[( src[0].m_key >> shift ) & 0xff] == entriesCount )
+      {
+         continue;
+      }
 
-      // find the child node for the state of the added element
-      StateTreeNode* currNode = m_root;
+      uint offset = 0;
+      for ( uint digit = 0; digit < 256; ++digit )
+      {
+         const uint count = offsets[digit];
+         offsets[digit] = offset;
+         offset += count;
+      }
 
-      // check the siblings and look for a similar state
-      StateTreeNode* prevNode = currNode;
-      while ( currNode && currNode->compareState( checkedState ) == false )
+      for ( uint i = 0; i < entriesCount; ++i )
       {
-         prevNode = currNode;
-         currNode = currNode->m_sibling;
+         dst[offsets[( src[i].m_key >> shift ) & 0xff]++] = src[i];
       }
 
-      if ( currNode == NULL )
+      RenderQueueEntry* tmp = src;
+      src = dst;
+      dst = tmp;
+   }
+
+   if ( src != m_entries.getRaw() )
+   {
+      memcpy( m_entries.getRaw(), src, sizeof( RenderQueueEntry ) * entriesCount );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RenderTree::buildDrawCalls()
+{
+   const uint entriesCount = m_entries.size();
+   for ( uint i = 0; i < entriesCount; ++i )
+   {
+      m_renderedGeometry.push_back( m_entries[i].m_geometry );
+   }
+
+   uint i = 0;
+   while ( i < entriesCount )
+   {
+      const RenderQueueEntry& entry = m_entries[i];
+
+      RenderDrawCall drawCall;
+      drawCall.m_key = entry.m_key;
+      drawCall.m_firstInstance = i;
+      drawCall.m_instancesCount = 1;
+
+      // the entries that use the same mesh and the same material are adjacent in the queue -
+      // try rendering them in a single draw call
+      if ( entry.m_geometry->canBeInstanced( m_profile ) )
       {
-         // there is no node with a matching state - create a new one
-         prevNode->m_sibling = new ( renderer.m_renderTreeMemPool ) StateTreeNode( *checkedState );
-         currNode = prevNode->m_sibling;
+         const GeometryResource* mesh = entry.m_geometry->getMesh();
+         const Material* material = entry.m_geometry->getRenderState()->m_material;
+
+         for ( uint j = i + 1; j < entriesCount && drawCall.m_instancesCount < MAX_INSTANCES_PER_DRAW_CALL; ++j )
+         {
+            const GeometryComponent* instance = m_entries[j].m_geometry;
+            if ( instance->getMesh() != mesh || instance->getRenderState()->m_material != material || !instance->canBeInstanced( m_profile ) )
+            {
+               break;
+            }
+
+            ++drawCall.m_instancesCount;
+         }
       }
 
-      // there are no more states to check - add the geometry
-      new ( renderer.m_renderTreeMemPool ) GeometryNode( currNode->m_geometryNode, *geometry );
+      m_drawCalls.push_back( drawCall );
+      i += drawCall.m_instancesCount;
    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-RenderTree::~RenderTree()
+void RenderTree::render()
 {
-   for ( StateTreeNode* stateNode = m_root; stateNode != NULL; )
+   const uint drawCallsCount = m_drawCalls.size();
+
+   MultithreadedTasksScheduler& scheduler = TSingleton< MultithreadedTasksScheduler >::getInstance();
+   const uint chunksCount = min2( drawCallsCount / MIN_DRAW_CALLS_PER_CHUNK, scheduler.getWorkersCount() + 1 );
+   if ( chunksCount < 2 || m_renderer.isRecording() )
    {
-      for ( GeometryNode* geomNode = stateNode->m_geometryNode; geomNode != NULL; )
+      renderDrawCalls( 0, drawCallsCount );
+      return;
+   }
+
+   // the buffers are executed in the order they were reserved in, no matter which thread records them first
+   const uint drawCallsPerChunk = ( drawCallsCount + chunksCount - 1 ) / chunksCount;
+   Array< RenderCommandsBuffer* > buffers( chunksCount );
+   for ( uint i = 0; i < chunksCount; ++i )
+   {
+      buffers.push_back( m_renderer.reserveCommandsBuffer() );
+   }
+
+   scheduler.parallelFor( 0, chunksCount, 1, DrawCallsRecorder( *this, buffers, drawCallsPerChunk ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void RenderTree::renderDrawCalls( uint firstDrawCall, uint lastDrawCall )
+{
+   const RenderState* batchState = NULL;
+   RenderSortKey batchPrefix = 0;
+
+   for ( uint i = firstDrawCall; i < lastDrawCall; ++i )
+   {
+      const RenderDrawCall& drawCall = m_drawCalls[i];
+      GeometryComponent* geometry = m_renderedGeometry[drawCall.m_firstInstance];
+
+      const RenderSortKey prefix = getStatePrefix( drawCall.m_key );
+      if ( !batchState || prefix != batchPrefix )
       {
-         GeometryNode* gnToRemove = geomNode;
-         geomNode = geomNode->m_next;
-         delete gnToRemove;
+         if ( batchState )
+         {
+            batchState->endBatch( m_renderer );
+         }
+
+         batchState = geometry->getRenderState();
+         batchPrefix = prefix;
+         batchState->beginBatch( m_renderer, m_profile );
       }
 
-      StateTreeNode* snToRemove = stateNode;
-      stateNode = stateNode->m_sibling;
-      delete snToRemove;
+      if ( drawCall.m_instancesCount > 1 )
+      {
+         geometry->drawInstances( m_renderer, m_profile, &m_renderedGeometry[drawCall.m_firstInstance], drawCall.m_instancesCount );
+      }
+      else
+      {
+         geometry->draw( m_renderer, m_profile );
+      }
+   }
+
+   if ( batchState )
+   {
+      batchState->endBatch( m_renderer );
    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void RenderTree::render( RenderProfileId profileIdx )
+uint RenderTree::getStateChangesCount() const
 {
-   for ( StateTreeNode* stateNode = m_root; stateNode != NULL; stateNode = stateNode->m_sibling )
+   const uint entriesCount = m_entries.size();
+   uint changesCount = entriesCount > 0 ? 1 : 0;
+   for ( uint i = 1; i < entriesCount; ++i )
    {
-      for ( GeometryNode* geomNode = stateNode->m_geometryNode; geomNode != NULL; geomNode = geomNode->m_next )
+      if ( getStatePrefix( m_entries[i].m_key ) != getStatePrefix( m_entries[i - 1].m_key ) )
       {
-         geomNode->m_geometry.render( m_renderer, profileIdx );
+         ++changesCount;
       }
    }
+
+   return changesCount;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
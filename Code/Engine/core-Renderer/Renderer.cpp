@@ -6,6 +6,7 @@
 #include "core-Renderer\Camera.h"
 #include "core-Renderer\Viewport.h"
 #include "core-Renderer\InternalRenderCommands.h"
+#include "core-Renderer\RenderCommandsBuffer.h"
 #include "core-Renderer\RenderingContext.h"
 #include "core-Renderer\RenderStateFlags.h"
 #include "core-Renderer\RenderStateChangeTracker.h"
@@ -26,11 +27,23 @@
 #include "core\Assert.h"
 #include "core\MatrixUtils.h"
 #include "core\Profiler.h"
-#include "core\TSContinuousMemoryPool.h"
+#include "core\FrameMemoryPool.h"
 #include "core\ContinuousMemoryPool.h"
 #include "core\FragmentedMemoryPool.h"
+#include "core\CriticalSection.h"
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+// the commands a worker thread records are stored in pages of 64 KB
+#define RENDER_COMMANDS_BUFFER_PAGE_SIZE  64*1024
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the commands buffer the current thread records the render commands to
+static __declspec( thread ) Renderer*                 g_recordingRenderer = NULL;
+static __declspec( thread ) RenderCommandsBuffer*     g_recordedCommandsBuffer = NULL;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 namespace // anonymous
@@ -58,6 +71,7 @@ Renderer::Renderer( RendererImplementation* implementation, uint viewportWidth,
    , m_renderStateFlags( new RenderStateFlags() )
    , m_renderThreadCommandsQueue( NULL )
    , m_commandsDataAllocator( NULL )
+   , m_commandsBuffersLock( new CriticalSection() )
    , m_context( new RenderingContext() )
 {
    // state changes trackers
@@ -138,13 +152,25 @@ Renderer::~Renderer()
    delete m_defaultCamera;
    m_defaultCamera = NULL;
 
+   // the render thread's queue has been flushed, so all recorded commands were executed by now
+   const uint buffersCount = m_commandsBuffers.size();
+   for ( uint i = 0; i < buffersCount; ++i )
+   {
+      delete m_commandsBuffers[i];
+   }
+   m_commandsBuffers.clear();
+   m_freeCommandsBuffers.clear();
+
+   delete m_commandsBuffersLock;
+   m_commandsBuffersLock = NULL;
+
    m_renderThreadCommandsQueue = NULL;
    m_commandsDataAllocator = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void Renderer::initialize( TSContinuousMemoryPool* commandsDataAllocator, SteppedLocklessCommandsQueue< Renderer >* renderThreadCommandsQueue )
+void Renderer::initialize( FrameMemoryPool* commandsDataAllocator, SteppedLocklessCommandsQueue< Renderer >* renderThreadCommandsQueue )
 {
    ASSERT( !m_commandsDataAllocator && !m_renderThreadCommandsQueue );
 
@@ -154,6 +180,142 @@ void Renderer::initialize( TSContinuousMemoryPool* commandsDataAllocator, Steppe
 
 ///////////////////////////////////////////////////////////////////////////////
 
+MemoryAllocator* Renderer::rtComm()
+{
+   if ( g_recordingRenderer == this )
+   {
+      return g_recordedCommandsBuffer;
+   }
+
+   return m_renderThreadCommandsQueue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+RenderCommandsBuffer* Renderer::reserveCommandsBuffer()
+{
+   ASSERT_MSG( g_recordingRenderer != this, "Commands buffers can't be reserved while recording commands" );
+
+   RenderCommandsBuffer* buffer = NULL;
+   m_commandsBuffersLock->enter();
+   if ( m_freeCommandsBuffers.empty() )
+   {
+      buffer = new RenderCommandsBuffer( RENDER_COMMANDS_BUFFER_PAGE_SIZE );
+      m_commandsBuffers.push_back( buffer );
+   }
+   else
+   {
+      const uint lastIdx = m_freeCommandsBuffers.size() - 1;
+      buffer = m_freeCommandsBuffers[lastIdx];
+      m_freeCommandsBuffers.remove( lastIdx );
+   }
+   m_commandsBuffersLock->leave();
+
+   // the buffer will be executed at this point of the queue, so its recording starts with the current state
+   *buffer->m_renderStateFlags = *m_renderStateFlags;
+   *buffer->m_context = *m_context;
+
+   // splice the buffer into the render thread's queue - from now on the queue can't be committed
+   // until the buffer is recorded
+   new ( m_renderThreadCommandsQueue ) RCExecuteCommandsBuffer( buffer );
+   m_unrecordedCommandsBuffersCount.increment();
+
+   return buffer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Renderer::releaseCommandsBuffer( RenderCommandsBuffer* buffer )
+{
+   m_commandsBuffersLock->enter();
+   m_freeCommandsBuffers.push_back( buffer );
+   m_commandsBuffersLock->leave();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Renderer::beginRecording( RenderCommandsBuffer* buffer )
+{
+   ASSERT_MSG( g_recordingRenderer == NULL, "The thread is already recording render commands" );
+
+   g_recordingRenderer = this;
+   g_recordedCommandsBuffer = buffer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Renderer::endRecording()
+{
+   ASSERT_MSG( g_recordingRenderer == this, "The thread isn't recording commands for this renderer" );
+
+   // the state changes made while recording need to be reverted by the end of the buffer, so that
+   // the commands that follow it are executed in the state they were recorded with
+   ASSERT_MSG( g_recordedCommandsBuffer->m_stateChangeTrackersStack->empty(), "The render state changes recorded in the buffer weren't restored" );
+
+   g_recordingRenderer = NULL;
+   g_recordedCommandsBuffer = NULL;
+
+   const long unrecordedBuffersCount = m_unrecordedCommandsBuffersCount.decrement();
+   ASSERT_MSG( unrecordedBuffersCount >= 0, "More commands buffers were recorded than reserved" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool Renderer::isRecording() const
+{
+   return g_recordingRenderer == this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const RenderingContext& Renderer::getContext() const
+{
+   if ( g_recordingRenderer == this )
+   {
+      return *g_recordedCommandsBuffer->m_context;
+   }
+
+   return *m_context;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+RenderingContext& Renderer::accessContext()
+{
+   if ( g_recordingRenderer == this )
+   {
+      return *g_recordedCommandsBuffer->m_context;
+   }
+
+   return *m_context;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FragmentedMemoryPool* Renderer::rsComm()
+{
+   if ( g_recordingRenderer == this )
+   {
+      return g_recordedCommandsBuffer->m_renderStateCommandsQueue;
+   }
+
+   return m_renderStateCommandsQueue;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+RenderStateFlags& Renderer::accessRenderStateFlags()
+{
+   if ( g_recordingRenderer == this )
+   {
+      return *g_recordedCommandsBuffer->m_renderStateFlags;
+   }
+
+   return *m_renderStateFlags;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void Renderer::setMechanism( RenderingMechanism* mechanism )
 {
    // deinitialize and release the old mechanism
@@ -179,6 +341,8 @@ void Renderer::setMechanism( RenderingMechanism* mechanism )
 
 void Renderer::pushCamera( Camera& camera ) 
 { 
+   ASSERT_MSG( g_recordingRenderer != this, "The cameras can't be changed while recording commands" );
+
    TransformsManagementSystem& tmSys = TSingleton< TransformsManagementSystem >::getInstance();
 
    // stop updating the previously active camera
@@ -198,6 +362,8 @@ void Renderer::pushCamera( Camera& camera )
 
 void Renderer::popCamera() 
 { 
+   ASSERT_MSG( g_recordingRenderer != this, "The cameras can't be changed while recording commands" );
+
    // stop updating the camera that's about to become inactive
    TransformsManagementSystem& tmSys = TSingleton< TransformsManagementSystem >::getInstance();
    tmSys.removeTransformable( m_camerasStack.top() );
@@ -268,35 +434,46 @@ void Renderer::getViewport( Viewport& outViewportDesc )
 
 ///////////////////////////////////////////////////////////////////////////////
 
-RenderTree* Renderer::buildRenderTree( const Array< GeometryComponent* >& visibleElems )
+RenderTree* Renderer::buildRenderTree( const Array< GeometryComponent* >& visibleElems, RenderProfileId profile )
 {
    if ( visibleElems.empty() )
    {
       return NULL;
    }
 
-   return new ( m_renderTreeMemPool ) RenderTree( *this, visibleElems );
+   return new ( m_renderTreeMemPool ) RenderTree( *this, visibleElems, profile );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-// @MainThread
 RenderStateChangeTracker* Renderer::pushStateTracker()
 {
-   RenderStateChangeTracker* newTracker = new ( m_renderStateCommandsQueue ) RenderStateChangeTracker( *this );
+   // a thread that's recording commands tracks the state changes it makes on its own
+   Stack< RenderStateChangeTracker* >* trackersStack = m_stateChangeTrackersStack;
+   if ( g_recordingRenderer == this )
+   {
+      trackersStack = g_recordedCommandsBuffer->m_stateChangeTrackersStack;
+   }
+
+   RenderStateChangeTracker* newTracker = new ( rsComm() ) RenderStateChangeTracker( *this );
 
-   m_stateChangeTrackersStack->push( newTracker );
+   trackersStack->push( newTracker );
    return newTracker;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-// @MainThread
 void Renderer::popStateTracker()
 {
-   ASSERT( !m_stateChangeTrackersStack->empty() );
-   RenderStateChangeTracker* tracker = m_stateChangeTrackersStack->top();
-   m_stateChangeTrackersStack->pop();
+   Stack< RenderStateChangeTracker* >* trackersStack = m_stateChangeTrackersStack;
+   if ( g_recordingRenderer == this )
+   {
+      trackersStack = g_recordedCommandsBuffer->m_stateChangeTrackersStack;
+   }
+
+   ASSERT( !trackersStack->empty() );
+   RenderStateChangeTracker* tracker = trackersStack->top();
+   trackersStack->pop();
    delete tracker;
 }
 
@@ -3,7 +3,7 @@
 #include "core-Renderer\RenderResource.h"
 #include "core-Renderer\ShaderTexture.h"
 #include "core-Renderer\ShaderCompiler.h"
-#include "core\TSContinuousMemoryPool.h"
+#include "core\FrameMemoryPool.h"
 #include "core\StreamBuffer.h"
 #include "core\Filesystem.h"
 #include "core\StringParser.h"
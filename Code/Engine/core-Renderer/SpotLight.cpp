@@ -102,6 +102,9 @@ void SpotLight::initializeBounds()
 
    Sphere sphere( sphereOrigin, radius );
    sphere.calculateBoundingBox( m_boundingVol );
+
+   // world space bounds need to be recalculated
+   markTransformDirty();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -112,6 +112,13 @@ void TriangleMesh::render( Renderer& renderer )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void TriangleMesh::renderInstances( Renderer& renderer, uint instancesCount )
+{
+   new ( renderer.rtComm() ) RCRenderTriangleMesh( this, instancesCount );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void TriangleMesh::calculateTangents()
 {
    MeshUtils::calculateVertexTangents( m_faces, m_vertices );
@@ -242,8 +249,9 @@ void TriangleMesh::merge( const TriangleMesh& rhs, const Matrix& transform )
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
-RCRenderTriangleMesh::RCRenderTriangleMesh( const TriangleMesh* mesh )
-   : m_mesh( mesh ) 
+RCRenderTriangleMesh::RCRenderTriangleMesh( const TriangleMesh* mesh, uint instancesCount )
+   : m_mesh( mesh )
+   , m_instancesCount( instancesCount )
 { 
 }
 
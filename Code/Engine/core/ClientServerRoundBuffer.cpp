@@ -23,7 +23,7 @@ ClientServerRoundBuffer::ClientServerRoundBuffer( size_t size )
    m_bufSize = size;
 
    MemoryRouter& memRouter = TSingleton< MemoryRouter >::getInstance();
-   m_memory = (char*)memRouter.alloc( m_bufSize * sizeof( char ), AM_DEFAULT, &memRouter.m_defaultAllocator );
+   m_memory = (char*)memRouter.alloc( m_bufSize * sizeof( char ), AM_DEFAULT, memRouter.getDefaultAllocator() );
 
    m_tail = 0;
    m_head = 0;
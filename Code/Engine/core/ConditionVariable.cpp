@@ -0,0 +1,89 @@
+#include "core\ConditionVariable.h"
+#include "core\Assert.h"
+#include <windows.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+ConditionVariable::ConditionVariable()
+   : m_spinsLimit( 64 )
+{
+   // a condition variable is the size of a pointer and doesn't need any additional resources,
+   // so we're storing it in place - that way the variable can be instantiated before the memory system is in place
+   InitializeConditionVariable( (CONDITION_VARIABLE*)&m_conditionVariable );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ConditionVariable::~ConditionVariable()
+{
+   // condition variables don't need to be explicitly destroyed
+   ASSERT_MSG( m_waitersCount.get() == 0, "There are still some threads waiting on the condition variable" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConditionVariable::wait( CriticalSection& lock )
+{
+   m_waitersCount.increment();
+   sleep( lock );
+   m_waitersCount.decrement();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConditionVariable::notifyOne()
+{
+   // waking a condition variable nobody sleeps on still costs a kernel transition
+   if ( m_waitersCount.get() > 0 )
+   {
+      WakeConditionVariable( (CONDITION_VARIABLE*)&m_conditionVariable );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConditionVariable::notifyAll()
+{
+   if ( m_waitersCount.get() > 0 )
+   {
+      WakeAllConditionVariable( (CONDITION_VARIABLE*)&m_conditionVariable );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConditionVariable::sleep( CriticalSection& lock )
+{
+   BOOL result = SleepConditionVariableCS( (CONDITION_VARIABLE*)&m_conditionVariable, (CRITICAL_SECTION*)lock.m_criticalSectionHandle, INFINITE );
+   ASSERT_MSG( result != FALSE, "Waiting for condition variable has finished incorrectly" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConditionVariable::onSpinFinished( bool successful )
+{
+   // spin longer if the spinning paid off, and shorter if we had to go to sleep anyway
+   uint spinsLimit = m_spinsLimit;
+   if ( successful )
+   {
+      spinsLimit = spinsLimit * 2 < MAX_SPINS_COUNT ? spinsLimit * 2 : MAX_SPINS_COUNT;
+   }
+   else
+   {
+      spinsLimit = spinsLimit / 2 > MIN_SPINS_COUNT ? spinsLimit / 2 : MIN_SPINS_COUNT;
+   }
+
+   // several threads may be updating it at the same time - but it's just a heuristic,
+   // so we don't mind losing an update
+   m_spinsLimit = spinsLimit;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ConditionVariable::pause()
+{
+   YieldProcessor();
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -178,6 +178,14 @@ std::size_t File::size() const
 
 ///////////////////////////////////////////////////////////////////////////////
 
+HANDLE File::getSystemHandle() const
+{
+   ASSERT_MSG( m_file, "File not opened" );
+   return (HANDLE)_get_osfhandle( _fileno( m_file ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void File::setSize(std::size_t newSize)
 {
    ASSERT_MSG( m_file, "File not opened" );
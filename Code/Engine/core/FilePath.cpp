@@ -6,11 +6,13 @@
 #include "core/FilesystemUtils.h"
 #include "core/StringUtils.h"
 #include "core/Profiler.h"
+#include "core/IDString.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
 FilePath::FilePath()
+   : m_hash( IDStringHash::OFFSET_BASIS ) // hash of an empty string
 {
 }
 
@@ -25,13 +27,15 @@ FilePath::~FilePath()
 FilePath::FilePath( const std::string& path )
 {
    FilesystemUtils::normalize( path, m_relativePath );
+   updateHash();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 FilePath::FilePath( const FilePath& rhs )
+   : m_relativePath( rhs.m_relativePath )
+   , m_hash( rhs.m_hash )
 {
-   m_relativePath = rhs.m_relativePath;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -39,6 +43,14 @@ FilePath::FilePath( const FilePath& rhs )
 void FilePath::set( const std::string& path )
 {
    FilesystemUtils::normalize( path, m_relativePath );
+   updateHash();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FilePath::updateHash()
+{
+   m_hash = IDStringHash::calculate( m_relativePath.c_str() );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -55,6 +67,7 @@ FilePath FilePath::operator+( const FilePath& rhs ) const
    FilePath newPath;
    std::string path = m_relativePath + rhs.getRelativePath();
    FilesystemUtils::normalize( path, newPath.m_relativePath );
+   newPath.updateHash();
 
    return newPath;
 }
@@ -65,6 +78,7 @@ FilePath& FilePath::operator+=( const FilePath& rhs )
 {
    std::string path = m_relativePath + rhs.getRelativePath();
    FilesystemUtils::normalize( path, m_relativePath );
+   updateHash();
 
    return *this;
 }
@@ -88,6 +102,7 @@ std::string FilePath::extractExtension() const
 void FilePath::extractDir( FilePath& outDir ) const
 {
    outDir.m_relativePath = FilesystemUtils::extractDir( m_relativePath );
+   outDir.updateHash();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -95,6 +110,7 @@ void FilePath::extractDir( FilePath& outDir ) const
 void FilePath::leaveDir(  unsigned int levels, FilePath& outDirectory ) const
 {
    FilesystemUtils::leaveDir( m_relativePath, levels, outDirectory.m_relativePath );
+   outDirectory.updateHash();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -111,7 +127,7 @@ void FilePath::changeFileExtension( const std::string& newExtension, FilePath& o
    if ( newExtension.empty() )
    {
       // nothing to change
-      outPath.m_relativePath = m_relativePath;
+      outPath = *this;
       return;
    }
 
@@ -124,6 +140,7 @@ void FilePath::changeFileExtension( const std::string& newExtension, FilePath& o
    {
       outPath.m_relativePath = m_relativePath + "." + newExtension;
    }
+   outPath.updateHash();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -173,7 +190,7 @@ void FilePath::appendPostfix( const std::string& posfix, FilePath& outPath ) con
    if ( posfix.empty() )
    {
       // nothing to change
-      outPath.m_relativePath = m_relativePath;
+      outPath = *this;
       return;
    }
 
@@ -186,6 +203,7 @@ void FilePath::appendPostfix( const std::string& posfix, FilePath& outPath ) con
    {
       outPath.m_relativePath = m_relativePath + posfix;
    }
+   outPath.updateHash();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -222,6 +240,7 @@ OutStream& operator<<( OutStream& serializer, const FilePath& path )
 InStream& operator>>( InStream& serializer, FilePath& path )
 {
    serializer >> path.m_relativePath;
+   path.updateHash();
    return serializer;
 }
 
@@ -5,7 +5,7 @@
 #include "core\StringUtils.h"
 #include "core\ListUtils.h"
 #include "core\CriticalSection.h"
-#include "core\Thread.h"
+#include "core\ConditionVariable.h"
 #include "core\ResourceUtils.h"
 #include <stdexcept>
 #include <algorithm>
@@ -28,6 +28,7 @@ INIT_SINGLETON( Filesystem );
 Filesystem::Filesystem( const char* rootDir )
    : m_rootDir( rootDir )
    , m_fsAccessLock( new CriticalSection() )
+   , m_fileClosed( new ConditionVariable() )
    , m_changesScanner( NULL )
 {
    m_filesystemSnapshot = new FilesystemSnapshot( *this );
@@ -37,6 +38,7 @@ Filesystem::Filesystem( const char* rootDir )
 
 Filesystem::Filesystem( const SingletonConstruct& )
    : m_fsAccessLock( new CriticalSection() )
+   , m_fileClosed( new ConditionVariable() )
    , m_changesScanner( NULL )
 {
    m_filesystemSnapshot = new FilesystemSnapshot( *this );
@@ -54,6 +56,9 @@ Filesystem::~Filesystem()
    }
    m_listeners.clear();
 
+   delete m_fileClosed;
+   m_fileClosed = NULL;
+
    delete m_fsAccessLock;
    m_fsAccessLock = NULL;
 
@@ -140,23 +145,15 @@ bool Filesystem::doesExist( const FilePath& fileName ) const
 File* Filesystem::open( const FilePath& fileName, const std::ios_base::openmode mode )
 {
    // block until the file can be open
-   File* file = NULL;
-   while( true )
+   m_fsAccessLock->enter();
+   while ( !tryReservingFile( fileName, mode ) )
    {
-      file = tryOpenFile( fileName, mode );
-
-      if ( file )
-      {
-         break;
-      }
-
-      Thread::yield();    
+      // sleep until another thread closes a file
+      m_fileClosed->wait( *m_fsAccessLock );
    }
+   m_fsAccessLock->leave();
 
-   // at this point we're releasing the lock - because if it turns out that the file could not be opened
-   // for some reason, we're gonna destroy its handle which in turn will call 'notifyFileClosed' that will acquire the lock again
-   // in order to unregister the file handler
-
+   File* file = new File( *this, fileName, mode );
    if ( !file->isOpened() )
    {
       LOG( "Filesystem: Couldn't open the file '%s'", fileName.c_str() );
@@ -170,13 +167,12 @@ File* Filesystem::open( const FilePath& fileName, const std::ios_base::openmode
 
 ///////////////////////////////////////////////////////////////////////////////
 
-File* Filesystem::tryOpenFile( const FilePath& fileName, const std::ios_base::openmode mode )
+bool Filesystem::tryReservingFile( const FilePath& fileName, const std::ios_base::openmode mode )
 {
    // verify the file is not open
    bool isToBeWritten = ( ( mode & std::ios_base::out ) == std::ios_base::out );
    OpenFileDesc desc( fileName, !isToBeWritten );
 
-   m_fsAccessLock->enter();
    uint openFileIdx = m_openFiles.find( desc );
    if ( openFileIdx != EOA )
    {
@@ -185,12 +181,12 @@ File* Filesystem::tryOpenFile( const FilePath& fileName, const std::ios_base::op
       if ( isToBeWritten )
       {
          // The file is already open, and we cannot open it again for writing
-         return NULL;
+         return false;
       }
       else if ( desc.isOpenForWriting() )
       {
          // The file is already open for writing - wait until that operation finishes and try again
-         return NULL;
+         return false;
       }
 
       // at this point we only deal with files open for reading - meaning that they have positive ref values counters.
@@ -201,10 +197,8 @@ File* Filesystem::tryOpenFile( const FilePath& fileName, const std::ios_base::op
    {
       m_openFiles.push_back( desc );
    }
-   m_fsAccessLock->leave();
 
-   File* file = new File( *this, fileName, mode );
-   return file;
+   return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -230,6 +224,9 @@ void Filesystem::notifyFileClosed( const FilePath& fileName )
          m_openFiles.remove( openFileIdx );
       }
    }
+
+   // wake up the threads waiting for the file to become available
+   m_fileClosed->notifyAll();
    m_fsAccessLock->leave();
 
    // Update the file's timestamp in the filesystem snapshot - this is done to prevent files edited inside the editor
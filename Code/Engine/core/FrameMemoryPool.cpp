@@ -0,0 +1,229 @@
+#include "core\FrameMemoryPool.h"
+#include "core\Assert.h"
+#include "core\CriticalSection.h"
+#include "core\ConditionVariable.h"
+#include <string.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct FrameMemoryPool::FrameDrainedPredicate
+{
+   const Frame&            m_frame;
+
+   FrameDrainedPredicate( const Frame& frame ) : m_frame( frame ) {}
+
+   bool operator()() const
+   {
+      return m_frame.m_allocationsCount == 0;
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameMemoryPool::FrameMemoryPool( size_t pageSize )
+   : m_pageSize( pageSize )
+   , m_activeFrameIdx( 0 )
+   , m_freePages( NULL )
+   , m_pagesCount( 0 )
+   , m_highWaterMark( 0 )
+   , m_lock( new CriticalSection() )
+   , m_frameDrained( new ConditionVariable() )
+{
+   memset( m_frames, 0, sizeof( m_frames ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameMemoryPool::~FrameMemoryPool()
+{
+   ASSERT_MSG( m_frames[0].m_allocationsCount == 0 && m_frames[1].m_allocationsCount == 0, "There are still some objects left in the pool" );
+
+   releasePages( m_frames[0] );
+   releasePages( m_frames[1] );
+
+   while ( m_freePages )
+   {
+      Page* page = m_freePages;
+      m_freePages = page->m_nextPage;
+      delete [] (char*)page;
+   }
+   m_pagesCount = 0;
+
+   delete m_frameDrained;
+   m_frameDrained = NULL;
+
+   delete m_lock;
+   m_lock = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameMemoryPool::nextFrame()
+{
+   // Wait for the consumer to release the other frame. Were we to start appending to it earlier,
+   // the data of two different frames would get mixed up in it, and its memory wouldn't be reclaimed
+   // for as long as the consumer kept lagging behind.
+   // Only the producer switches the frames, so the active frame index won't change in the meantime.
+   const uint nextFrameIdx = 1 - m_activeFrameIdx;
+   m_frameDrained->waitUntil( *m_lock, FrameDrainedPredicate( m_frames[nextFrameIdx] ) );
+
+   m_lock->enter();
+   m_activeFrameIdx = nextFrameIdx;
+   m_lock->leave();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+size_t FrameMemoryPool::getHighWaterMark() const
+{
+   m_lock->enter();
+
+   // include the frames that are still in use
+   size_t highWaterMark = m_highWaterMark;
+   for ( uint i = 0; i < 2; ++i )
+   {
+      if ( m_frames[i].m_memoryUsed > highWaterMark )
+      {
+         highWaterMark = m_frames[i].m_memoryUsed;
+      }
+   }
+
+   m_lock->leave();
+
+   return highWaterMark;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ulong FrameMemoryPool::getMemoryUsed() const
+{
+   m_lock->enter();
+   size_t val = m_frames[0].m_memoryUsed + m_frames[1].m_memoryUsed;
+   m_lock->leave();
+
+   return val;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void* FrameMemoryPool::alloc( size_t size )
+{
+   // keep the subsequent allocations aligned
+   const size_t allocationSize = ( size + POOL_INFO_CHUNK_SIZE + MEMORY_ALIGNMENT - 1 ) & ~( MEMORY_ALIGNMENT - 1 );
+
+   m_lock->enter();
+
+   Frame& frame = m_frames[m_activeFrameIdx];
+   Page* page = frame.m_lastPage;
+   if ( !page || page->m_allocStartOffset + allocationSize > page->m_size )
+   {
+      // chain a new page
+      page = acquirePage( allocationSize );
+      if ( frame.m_lastPage )
+      {
+         frame.m_lastPage->m_nextPage = page;
+      }
+      else
+      {
+         frame.m_firstPage = page;
+      }
+      frame.m_lastPage = page;
+   }
+
+   // memorize the frame the memory was allocated in
+   char* ptr = page->getMemory() + page->m_allocStartOffset;
+   *(size_t*)ptr = m_activeFrameIdx;
+   ptr += POOL_INFO_CHUNK_SIZE;
+
+   page->m_allocStartOffset += allocationSize;
+   frame.m_memoryUsed += allocationSize;
+   ++frame.m_allocationsCount;
+
+   m_lock->leave();
+
+   return ptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameMemoryPool::dealloc( void* ptr )
+{
+   const size_t frameIdx = *(size_t*)( (char*)ptr - POOL_INFO_CHUNK_SIZE );
+
+   m_lock->enter();
+
+   Frame& frame = m_frames[frameIdx];
+   ASSERT_MSG( frame.m_allocationsCount > 0, "Trying to deallocate an invalid address" );
+
+   --frame.m_allocationsCount;
+   if ( frame.m_allocationsCount == 0 )
+   {
+      // all of the frame's data was released
+      releasePages( frame );
+      m_frameDrained->notifyAll();
+   }
+
+   m_lock->leave();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+FrameMemoryPool::Page* FrameMemoryPool::acquirePage( size_t minSize )
+{
+   // look for a free page that can fit the allocation
+   Page* prevPage = NULL;
+   for ( Page* page = m_freePages; page; page = page->m_nextPage )
+   {
+      if ( page->m_size >= minSize )
+      {
+         if ( prevPage )
+         {
+            prevPage->m_nextPage = page->m_nextPage;
+         }
+         else
+         {
+            m_freePages = page->m_nextPage;
+         }
+
+         page->m_nextPage = NULL;
+         page->m_allocStartOffset = 0;
+         return page;
+      }
+
+      prevPage = page;
+   }
+
+   // allocate a new one - allocations larger than a page get a page of their own
+   const size_t pageSize = minSize > m_pageSize ? minSize : m_pageSize;
+   Page* page = (Page*)( new char[sizeof( Page ) + MEMORY_ALIGNMENT - 1 + pageSize] );
+   page->m_nextPage = NULL;
+   page->m_size = pageSize;
+   page->m_allocStartOffset = 0;
+   ++m_pagesCount;
+
+   return page;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void FrameMemoryPool::releasePages( Frame& frame )
+{
+   if ( frame.m_memoryUsed > m_highWaterMark )
+   {
+      m_highWaterMark = frame.m_memoryUsed;
+   }
+
+   if ( frame.m_lastPage )
+   {
+      frame.m_lastPage->m_nextPage = m_freePages;
+      m_freePages = frame.m_firstPage;
+   }
+
+   frame.m_firstPage = NULL;
+   frame.m_lastPage = NULL;
+   frame.m_allocationsCount = 0;
+   frame.m_memoryUsed = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,7 @@
 #include "core\AxisAlignedBox.h"
 #include "core\Sphere.h"
 #include "core\PlaneUtils.h"
+#include "core\PackedAxisAlignedBoxes.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -97,3 +98,157 @@ void Frustum::calculateBoundingBox( AxisAlignedBox& outBB ) const
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace // anonymous
+{
+   /**
+    * Frustum planes prepared for testing packed boxes.
+    */
+   struct PackedFrustumPlanes
+   {
+      ALIGN_16 QuadStorage    m_coeffs[6][4];            // each coefficient of each plane, broadcast to all lanes
+      bool                    m_useMaxCorner[6][3];      // which corner of a box lies the furthest along the plane's normal
+
+      PackedFrustumPlanes( const Frustum& frustum )
+      {
+         for ( uint i = 0; i < 6; ++i )
+         {
+            const Plane& plane = frustum.planes[i];
+            for ( uint j = 0; j < 4; ++j )
+            {
+#ifdef _USE_SIMD
+               m_coeffs[i][j] = _mm_set1_ps( plane[j] );
+#else
+               m_coeffs[i][j].v[0] = m_coeffs[i][j].v[1] = m_coeffs[i][j].v[2] = m_coeffs[i][j].v[3] = plane[j];
+#endif
+            }
+
+            for ( uint j = 0; j < 3; ++j )
+            {
+               m_useMaxCorner[i][j] = plane[j] > 0;
+            }
+         }
+      }
+
+      /**
+       * Tests 4 boxes and returns a bit mask with the bits of the boxes that are outside the frustum set.
+       */
+      int findOutsideBoxes( const PackedAxisAlignedBoxes::Quad& quad ) const
+      {
+#ifdef _USE_SIMD
+         const __m128 zero = _mm_setzero_ps();
+         __m128 outside = zero;
+         for ( uint i = 0; i < 6; ++i )
+         {
+            // the same corners and the same order of operations as in 'isInside' ( and Plane::dotCoord ),
+            // so that the results are exactly the same
+            const __m128& px = m_useMaxCorner[i][0] ? quad.m_max[0] : quad.m_min[0];
+            const __m128& py = m_useMaxCorner[i][1] ? quad.m_max[1] : quad.m_min[1];
+            const __m128& pz = m_useMaxCorner[i][2] ? quad.m_max[2] : quad.m_min[2];
+
+            const __m128 xz = _mm_add_ps( _mm_mul_ps( m_coeffs[i][0], px ), _mm_mul_ps( m_coeffs[i][2], pz ) );
+            const __m128 yw = _mm_add_ps( _mm_mul_ps( m_coeffs[i][1], py ), m_coeffs[i][3] );
+            const __m128 dist = _mm_add_ps( xz, yw );
+
+            outside = _mm_or_ps( outside, _mm_cmplt_ps( dist, zero ) );
+         }
+
+         return _mm_movemask_ps( outside );
+#else
+         int outsideMask = 0;
+         for ( uint lane = 0; lane < 4; ++lane )
+         {
+            for ( uint i = 0; i < 6; ++i )
+            {
+               const float x = m_useMaxCorner[i][0] ? quad.m_max[0].v[lane] : quad.m_min[0].v[lane];
+               const float y = m_useMaxCorner[i][1] ? quad.m_max[1].v[lane] : quad.m_min[1].v[lane];
+               const float z = m_useMaxCorner[i][2] ? quad.m_max[2].v[lane] : quad.m_min[2].v[lane];
+
+               const float dist = x * m_coeffs[i][0].v[0] + y * m_coeffs[i][1].v[0] + z * m_coeffs[i][2].v[0] + m_coeffs[i][3].v[0];
+               if ( dist < 0.0f )
+               {
+                  outsideMask |= 1 << lane;
+                  break;
+               }
+            }
+         }
+         return outsideMask;
+#endif
+      }
+   };
+
+   void writeResults( int outsideMask, uint count, byte* outVisible )
+   {
+      for ( uint lane = 0; lane < count; ++lane )
+      {
+         outVisible[lane] = ( ( outsideMask >> lane ) & 1 ) ? 0 : 1;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Frustum::cull( const PackedAxisAlignedBoxes& boxes, byte* outVisible ) const
+{
+   PackedFrustumPlanes packedPlanes( *this );
+
+   const uint boxesCount = boxes.size();
+   const uint quadsCount = boxes.getQuadsCount();
+   for ( uint i = 0; i < quadsCount; ++i )
+   {
+      const uint firstBoxIdx = i << 2;
+      const uint count = boxesCount - firstBoxIdx < 4 ? boxesCount - firstBoxIdx : 4;
+
+      int outsideMask = packedPlanes.findOutsideBoxes( boxes.getQuad( i ) );
+      writeResults( outsideMask, count, outVisible + firstBoxIdx );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Frustum::cull( const AxisAlignedBox* boxes, uint count, byte* outVisible ) const
+{
+   PackedFrustumPlanes packedPlanes( *this );
+
+   PackedAxisAlignedBoxes::Quad quad;
+   for ( uint firstBoxIdx = 0; firstBoxIdx < count; firstBoxIdx += 4 )
+   {
+      const uint quadBoxesCount = count - firstBoxIdx < 4 ? count - firstBoxIdx : 4;
+      const AxisAlignedBox* quadBoxes = boxes + firstBoxIdx;
+
+#ifdef _USE_SIMD
+      // transpose the corners - the W components end up in the 4th quads, which we don't need
+      __m128 minCorners[4];
+      __m128 maxCorners[4];
+      for ( uint j = 0; j < 4; ++j )
+      {
+         // the missing boxes of the last quad are substituted with the last box
+         const AxisAlignedBox& box = quadBoxes[j < quadBoxesCount ? j : quadBoxesCount - 1];
+         minCorners[j] = box.min.m_quad;
+         maxCorners[j] = box.max.m_quad;
+      }
+      _MM_TRANSPOSE4_PS( minCorners[0], minCorners[1], minCorners[2], minCorners[3] );
+      _MM_TRANSPOSE4_PS( maxCorners[0], maxCorners[1], maxCorners[2], maxCorners[3] );
+
+      for ( uint j = 0; j < 3; ++j )
+      {
+         quad.m_min[j] = minCorners[j];
+         quad.m_max[j] = maxCorners[j];
+      }
+#else
+      for ( uint j = 0; j < 4; ++j )
+      {
+         const AxisAlignedBox& box = quadBoxes[j < quadBoxesCount ? j : quadBoxesCount - 1];
+         for ( uint k = 0; k < 3; ++k )
+         {
+            quad.m_min[k].v[j] = box.min[k];
+            quad.m_max[k].v[j] = box.max[k];
+         }
+      }
+#endif
+
+      int outsideMask = packedPlanes.findOutsideBoxes( quad );
+      writeResults( outsideMask, quadBoxesCount, outVisible + firstBoxIdx );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -1,10 +1,30 @@
 #include "core.h"
 #include "core\IDString.h"
+#include "core\CriticalSection.h"
+#include "core\Assert.h"
+#include "core\Log.h"
 #include "stdio.h"
+#include <stdlib.h>
+#include <intrin.h>
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
+uint IDStringHash::calculate( const char* str )
+{
+   uint hash = OFFSET_BASIS;
+   for ( ; *str != 0; ++str )
+   {
+      hash = ( hash ^ ( byte )*str ) * PRIME;
+   }
+
+   return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
 IDString::IDString( uint stringId )
    : m_stringId( stringId )
 {
@@ -95,61 +115,212 @@ INIT_SINGLETON( IDStringsPool );
 ///////////////////////////////////////////////////////////////////////////////
 
 IDStringsPool::IDStringsPool()
-   : m_strings( 1024 )
+   : m_retiredTables( 4 )
+   , m_arenaPages( 16 )
 {
+   init();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 IDStringsPool::IDStringsPool( const SingletonConstruct& )
-   : m_strings( 1024 )
+   : m_retiredTables( 4 )
+   , m_arenaPages( 16 )
 {
+   init();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 IDStringsPool::~IDStringsPool()
 {
-   uint count = m_strings.size();
+   delete [] m_table->m_entries;
+   delete m_table;
+   m_table = NULL;
+
+   uint count = m_retiredTables.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      Table* table = m_retiredTables[i];
+      delete [] table->m_entries;
+      delete table;
+   }
+   m_retiredTables.clear();
+
+   count = m_arenaPages.size();
    for ( uint i = 0; i < count; ++i )
    {
-      char* str = m_strings[i];
-      delete [] str;
+      char* page = m_arenaPages[i];
+      delete [] page;
    }
-   m_strings.clear();
+   m_arenaPages.clear();
+
+   delete m_insertLock;
+   m_insertLock = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void IDStringsPool::init()
+{
+   Table* table = new Table();
+   table->m_capacity = INITIAL_CAPACITY;
+   table->m_entries = new Entry[INITIAL_CAPACITY];
+   memset( table->m_entries, 0, sizeof( Entry ) * INITIAL_CAPACITY );
+   m_table = table;
+
+   m_stringsCount = 0;
+   m_insertLock = new CriticalSection();
+
+   // the first registered string will allocate a new page
+   m_arenaPage = NULL;
+   m_arenaPageOffset = ARENA_PAGE_SIZE;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 uint IDStringsPool::registerString( const char* str )
 {
-   // check if the string is already registered
-   uint count = m_strings.size();
-   for ( uint i = 0; i < count; ++i )
+   uint hash = IDStringHash::calculate( str );
+
+   // most of the time the string will already be there, and we won't need to lock anything
+   const Entry* entry = find( m_table, hash );
+   if ( !entry )
    {
-      if ( strcmp( m_strings[i], str ) == 0 )
+      CriticalSectionedSection lock( *m_insertLock, false );
+
+      // another thread might have registered it in the meantime
+      entry = find( m_table, hash );
+      if ( !entry )
       {
-         // found it
-         return i;
+         // keep the table at most half full, so that the probe sequences stay short
+         if ( ( m_stringsCount + 1 ) * 2 > m_table->m_capacity )
+         {
+            grow();
+         }
+
+         const char* strCopy = storeString( str );
+         insert( m_table, hash, strCopy );
+         ++m_stringsCount;
+
+         return hash;
       }
    }
 
-   // it's a new string - add it
+   if ( strcmp( entry->m_str, str ) != 0 )
+   {
+      // The id is the hash itself - it's stored with the resources and the IDSTR literals are
+      // hashed at compile time, so we can't hand a different id out to one of the strings.
+      // Letting them share it would make them silently alias each other, so we stop right here
+      // no matter what the build is - rename one of the strings to get rid of the collision.
+      LOG( "IDString hash collision: '%s' and '%s' share the id %u", entry->m_str, str, hash );
+      ASSERT_MSG( false, "IDString hash collision" );
+      abort();
+   }
+
+   return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const char* IDStringsPool::getString( uint stringId ) const
+{
+   const Entry* entry = find( m_table, stringId );
+   return entry ? entry->m_str : "";
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const IDStringsPool::Entry* IDStringsPool::find( const Table* table, uint hash ) const
+{
+   uint mask = table->m_capacity - 1;
+   for ( uint idx = hash & mask; ; idx = ( idx + 1 ) & mask )
+   {
+      const Entry& entry = table->m_entries[idx];
+
+      // the string pointer is published last, so once it's there, the hash is valid as well
+      if ( entry.m_str == NULL )
+      {
+         return NULL;
+      }
+
+      if ( entry.m_hash == hash )
+      {
+         return &entry;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+const char* IDStringsPool::storeString( const char* str )
+{
    uint strLength = strlen( str ) + 1;
-   char* strCopy = new char[strLength];
-   strcpy_s( strCopy, strLength, str );
 
-   uint stringId = m_strings.size();
-   m_strings.push_back( strCopy );
+   char* strCopy = NULL;
+   if ( strLength > ARENA_PAGE_SIZE / 4 )
+   {
+      // long strings get pages of their own, so that we don't waste the space left in the current page
+      strCopy = new char[strLength];
+      m_arenaPages.push_back( strCopy );
+   }
+   else
+   {
+      if ( m_arenaPageOffset + strLength > ARENA_PAGE_SIZE )
+      {
+         m_arenaPage = new char[ARENA_PAGE_SIZE];
+         m_arenaPages.push_back( m_arenaPage );
+         m_arenaPageOffset = 0;
+      }
+
+      strCopy = m_arenaPage + m_arenaPageOffset;
+      m_arenaPageOffset += strLength;
+   }
 
-   return stringId;
+   memcpy( strCopy, str, strLength );
+   return strCopy;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-const char* IDStringsPool::getString( uint stringId ) const
+void IDStringsPool::insert( Table* table, uint hash, const char* str )
 {
-   return m_strings[stringId];
+   uint mask = table->m_capacity - 1;
+   uint idx = hash & mask;
+   while ( table->m_entries[idx].m_str != NULL )
+   {
+      idx = ( idx + 1 ) & mask;
+   }
+
+   Entry& entry = table->m_entries[idx];
+   entry.m_hash = hash;
+
+   // publish the string only after the hash is set - the lookups don't take the lock
+   _InterlockedExchangePointer( ( void* volatile* )&entry.m_str, ( void* )str );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void IDStringsPool::grow()
+{
+   Table* oldTable = m_table;
+
+   Table* newTable = new Table();
+   newTable->m_capacity = oldTable->m_capacity * 2;
+   newTable->m_entries = new Entry[newTable->m_capacity];
+   memset( newTable->m_entries, 0, sizeof( Entry ) * newTable->m_capacity );
+
+   for ( uint i = 0; i < oldTable->m_capacity; ++i )
+   {
+      const Entry& entry = oldTable->m_entries[i];
+      if ( entry.m_str != NULL )
+      {
+         insert( newTable, entry.m_hash, entry.m_str );
+      }
+   }
+
+   _InterlockedExchangePointer( ( void* volatile* )&m_table, newTable );
+   m_retiredTables.push_back( oldTable );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
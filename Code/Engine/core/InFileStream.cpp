@@ -2,17 +2,27 @@
 #include "core\InFileStream.h"
 #include "core\File.h"
 #include "core\Assert.h"
+#include "core\Algorithms.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
-InFileStream::InFileStream( File* archive )
+InFileStream::InFileStream( File* archive, uint readAheadSize )
    : m_archive( archive )
+   , m_buffer( NULL )
+   , m_bufferSize( readAheadSize )
+   , m_bufferedBytesCount( 0 )
+   , m_bufferOffset( 0 )
 {
    if ( m_archive == NULL )
    {
       ASSERT_MSG( false, "NULL pointer instead a File instance");
    }
+
+   if ( m_bufferSize > 0 )
+   {
+      m_buffer = new byte[m_bufferSize];
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -21,13 +31,52 @@ InFileStream::~InFileStream()
 {
    delete m_archive;
    m_archive = NULL;
+
+   delete [] m_buffer;
+   m_buffer = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void InFileStream::load( void* val, unsigned int dataSize )
 {
-   m_archive->read( (byte*)val, dataSize );
+   if ( !m_buffer )
+   {
+      m_archive->read( (byte*)val, dataSize );
+      return;
+   }
+
+   byte* outPtr = (byte*)val;
+   while ( dataSize > 0 )
+   {
+      // copy what's already buffered
+      uint availableBytesCount = m_bufferedBytesCount - m_bufferOffset;
+      if ( availableBytesCount > 0 )
+      {
+         uint copiedBytesCount = min2( availableBytesCount, dataSize );
+         memcpy( outPtr, m_buffer + m_bufferOffset, copiedBytesCount );
+         m_bufferOffset += copiedBytesCount;
+         outPtr += copiedBytesCount;
+         dataSize -= copiedBytesCount;
+         continue;
+      }
+
+      if ( dataSize >= m_bufferSize )
+      {
+         // large blocks are read directly - there's no point in copying them twice
+         m_archive->read( outPtr, dataSize );
+         return;
+      }
+
+      // refill the buffer
+      m_bufferOffset = 0;
+      m_bufferedBytesCount = m_archive->read( m_buffer, m_bufferSize );
+      if ( m_bufferedBytesCount == 0 )
+      {
+         // we've reached the end of the file
+         return;
+      }
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,91 @@
+#include "core.h"
+#include "core\InMappedFileStream.h"
+#include "core\File.h"
+#include "core\Assert.h"
+#include "core\Algorithms.h"
+#include "core\Log.h"
+#include <windows.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+InMappedFileStream::InMappedFileStream( File* archive )
+   : m_archive( archive )
+   , m_mapping( NULL )
+   , m_data( NULL )
+   , m_fallbackBuffer( NULL )
+   , m_size( 0 )
+   , m_offset( 0 )
+{
+   if ( m_archive == NULL )
+   {
+      ASSERT_MSG( false, "NULL pointer instead a File instance");
+      return;
+   }
+
+   // the stream continues from wherever the file currently is, just like InFileStream
+   m_size = (uint)m_archive->size();
+   m_offset = (uint)m_archive->tell();
+   if ( m_size == 0 )
+   {
+      // empty files can't be mapped, but then again - there's nothing to read there
+      return;
+   }
+
+   m_mapping = CreateFileMapping( m_archive->getSystemHandle(), NULL, PAGE_READONLY, 0, 0, NULL );
+   if ( m_mapping )
+   {
+      m_data = (const byte*)MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 );
+      if ( !m_data )
+      {
+         CloseHandle( m_mapping );
+         m_mapping = NULL;
+      }
+   }
+
+   if ( !m_data )
+   {
+      LOG( "InMappedFileStream: Couldn't map file '%s' into memory, reading it instead", m_archive->getName().c_str() );
+
+      m_fallbackBuffer = new byte[m_size];
+      m_archive->seek( 0 );
+      m_archive->read( m_fallbackBuffer, m_size );
+      m_data = m_fallbackBuffer;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+InMappedFileStream::~InMappedFileStream()
+{
+   if ( m_mapping )
+   {
+      UnmapViewOfFile( m_data );
+      CloseHandle( m_mapping );
+      m_mapping = NULL;
+   }
+   m_data = NULL;
+
+   delete [] m_fallbackBuffer;
+   m_fallbackBuffer = NULL;
+
+   delete m_archive;
+   m_archive = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void InMappedFileStream::load( void* val, unsigned int dataSize )
+{
+   // just like with a regular file, reading past its end yields nothing
+   uint availableBytesCount = m_offset < m_size ? m_size - m_offset : 0;
+   dataSize = min2( dataSize, availableBytesCount );
+
+   if ( dataSize > 0 )
+   {
+      memcpy( val, m_data + m_offset, dataSize );
+      m_offset += dataSize;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,101 @@
+#include "core\Job.h"
+#include "core\MultithreadedTasksScheduler.h"
+#include "core\Assert.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+JobCounter::JobCounter()
+   : m_count( 0 )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+Job::Job( MultithreadedTasksScheduler& scheduler, JobCounter* counter )
+   : m_scheduler( &scheduler )
+   , m_counter( counter )
+   , m_dependenciesCount( 0 )
+   , m_pendingDependenciesCount( 0 )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Job::~Job()
+{
+   m_scheduler = NULL;
+   m_counter = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Job::setCounter( JobCounter* counter )
+{
+   ASSERT_MSG( getStatus() != MTS_Running, "Can't change the counter of a running job" );
+   m_counter = counter;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Job::addContinuation( Job& continuation )
+{
+   ASSERT_MSG( &continuation != this, "A job can't be its own continuation" );
+
+   m_continuations.push_back( &continuation );
+
+   ++continuation.m_dependenciesCount;
+   continuation.m_pendingDependenciesCount.increment();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Job::run()
+{
+   execute();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Job::onScheduled()
+{
+   if ( m_counter )
+   {
+      m_counter->increment();
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void Job::onCompleted()
+{
+   // Schedule the continuations first - they will increase the counter they are assigned to, and
+   // if that's the same counter as ours, it can't be allowed to reach zero in the meantime
+   uint count = m_continuations.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      Job* continuation = m_continuations[i];
+      if ( continuation->m_pendingDependenciesCount.decrement() == 0 )
+      {
+         // the last dependency has just completed - rearm the continuation so that
+         // the graph can be run again, and schedule it
+         continuation->m_pendingDependenciesCount.set( continuation->m_dependenciesCount );
+         m_scheduler->spawn( *continuation );
+      }
+   }
+
+   // the counter is decremented by the scheduler, once the job's been marked as completed ( see getCompletionCounter )
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+JobCounter* Job::getCompletionCounter() const
+{
+   // the counter may be waited on by the job's owner, who can release the job as soon as
+   // it reaches zero - so it can only be decremented after the job's been marked as completed
+   return m_counter;
+}
+
+///////////////////////////////////////////////////////////////////////////////
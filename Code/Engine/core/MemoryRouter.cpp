@@ -16,6 +16,12 @@ uint MemoryRouter::s_headerSize = sizeof( void* );
 
 MemoryRouter::MemoryRouter( const SingletonConstruct& )
 {
+#ifdef _USE_THREAD_CACHING_ALLOCATOR
+   m_generalPurposeAllocator = &m_threadCachingAllocator;
+#else
+   m_generalPurposeAllocator = &m_defaultAllocator;
+#endif
+
 #ifdef _TRACK_MEMORY_ALLOCATIONS
    m_tracer = new CallstackTracer();
    m_callstacksTree = new CallstackTree();
@@ -38,7 +44,7 @@ MemoryRouter::~MemoryRouter()
       {
          dbgOutput << 
             "\n\n===================================================================\n" <<
-            " MEMORY LEAKS REPORT - " << callstacksCount << " leaks encountered, " << memoryRouter.m_defaultAllocator.getMemoryUsed() << " bytes leaked \n" <<
+            " MEMORY LEAKS REPORT - " << callstacksCount << " leaks encountered, " << memoryRouter.getMemoryUsed() << " bytes leaked \n" <<
             "===================================================================\n\n";
 
          ulong callstackTrace[128];
@@ -71,6 +77,21 @@ MemoryRouter::~MemoryRouter()
 
    delete m_callstacksTree;
    m_callstacksTree = NULL;
+
+#else
+
+   // we don't know where the leaks come from, but we can at least tell that there are some
+   ulong memoryUsed = getMemoryUsed();
+   if ( memoryUsed > 0 )
+   {
+      dostream dbgOutput;
+      dbgOutput << 
+         "\n\n===================================================================\n" <<
+         " MEMORY LEAKS REPORT - " << memoryUsed << " bytes leaked \n" <<
+         "===================================================================\n\n";
+      dbgOutput.flush();
+   }
+
 #endif
 }
 
@@ -1,15 +1,35 @@
 #include "core\MultithreadedTask.h"
 #include "core\CriticalSection.h"
-#include "core\Thread.h"
+#include "core\ConditionVariable.h"
 #include "core\Assert.h"
+#include "core\Job.h"
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   // tasks are rarely joined, so all of them share a single condition variable
+   CriticalSection         g_taskCompletionLock;
+   ConditionVariable       g_taskCompleted;
+
+   struct TaskCompletedPredicate
+   {
+      const MultithreadedTask&      m_task;
+
+      TaskCompletedPredicate( const MultithreadedTask& task ) : m_task( task ) {}
+
+      bool operator()() const
+      {
+         return m_task.getStatus() == MultithreadedTask::MTS_Completed;
+      }
+   };
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 MultithreadedTask::MultithreadedTask()
    : m_forceClose( false )
-   , m_forceCloseLock( new CriticalSection() )
-   , m_statusLock( new CriticalSection() )
    , m_status( MTS_Inactive )
 {
 }
@@ -18,70 +38,87 @@ MultithreadedTask::MultithreadedTask()
 
 MultithreadedTask::~MultithreadedTask()
 {
-   delete m_forceCloseLock;
-   m_forceCloseLock = NULL;
-
-   delete m_statusLock;
-   m_statusLock = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void MultithreadedTask::forceClose()
 {
-   m_forceCloseLock->enter();
    m_forceClose = true;
-   m_forceCloseLock->leave();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void MultithreadedTask::setStatus( Status status )
 {
-   m_statusLock->enter();
-   m_status = status;
-   m_statusLock->leave();
+   if ( status == MTS_Completed )
+   {
+      // the waiters check the status while holding the lock - if it changed outside of it,
+      // the notification could be issued after a waiter checked it, but before it fell asleep
+      CriticalSectionedSection lock( g_taskCompletionLock );
+      m_status.set( status );
+      g_taskCompleted.notifyAll();
+   }
+   else
+   {
+      m_status.set( status );
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-MultithreadedTask::Status MultithreadedTask::getStatus() const
+void MultithreadedTask::complete()
 {
-   m_statusLock->enter();
-   MultithreadedTask::Status status = m_status;
-   m_statusLock->leave();
+   onCompleted();
 
-   return status;
+   // once the status changes, the task may be released before we get to the counter
+   JobCounter* counter = getCompletionCounter();
+   setStatus( MTS_Completed );
+
+   if ( counter )
+   {
+      counter->decrement();
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MultithreadedTask::join()
+bool MultithreadedTask::activate()
 {
-   while( true )
+   while ( true )
    {
-      m_statusLock->enter();
-      MultithreadedTask::Status status = m_status;
-      m_statusLock->leave();
-
-      if ( status == MTS_Completed )
+      long status = m_status.get();
+      if ( status == MTS_Running )
       {
-         return;
+         return false;
       }
 
-      Thread::yield();
+      if ( m_status.compareExchange( MTS_Running, status ) == status )
+      {
+         return true;
+      }
    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool MultithreadedTask::shouldClose() const
+MultithreadedTask::Status MultithreadedTask::getStatus() const
+{
+   return (MultithreadedTask::Status)m_status.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MultithreadedTask::join()
 {
-   m_forceCloseLock->enter();
-   bool val = m_forceClose;
-   m_forceCloseLock->leave();
+   g_taskCompleted.waitUntil( g_taskCompletionLock, TaskCompletedPredicate( *this ) );
+}
 
-   return val;
+///////////////////////////////////////////////////////////////////////////////
+
+bool MultithreadedTask::shouldClose() const
+{
+   return m_forceClose;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1,7 +1,10 @@
 #include "core\MultithreadedTasksScheduler.h"
 #include "core\MultithreadedTask.h"
+#include "core\Job.h"
 #include "core\Thread.h"
 #include "core\CriticalSection.h"
+#include "core\ConditionVariable.h"
+#include "core\Semaphore.h"
 #include "core\Singleton.h"
 #include "core\ThreadSystem.h"
 
@@ -12,6 +15,28 @@ INIT_SINGLETON( MultithreadedTasksScheduler );
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// how many tasks can be spawned to a worker's local queue before they start overflowing to the shared queue
+#define LOCAL_QUEUE_CAPACITY     1024
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   struct TaskStoppedPredicate
+   {
+      MultithreadedTask* const&     m_task;
+
+      TaskStoppedPredicate( MultithreadedTask* const& task ) : m_task( task ) {}
+
+      bool operator()() const
+      {
+         return m_task == NULL;
+      }
+   };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 MultithreadedTasksScheduler::MultithreadedTasksScheduler( uint numThreads )
 {
    init( numThreads );
@@ -29,209 +54,428 @@ MultithreadedTasksScheduler::MultithreadedTasksScheduler( const SingletonConstru
 
 void MultithreadedTasksScheduler::init( uint numThreads )
 {
-   m_runningTasksLock = new CriticalSection();
    m_closeRequest = false;
-   m_schedulerThread = new Thread();
-   
+   m_temporaryContextsLock = new CriticalSection();
+   m_sharedQueueLock = new CriticalSection();
+
+   // each sleeping worker may hold one wake up token, and on top of that we need
+   // enough tokens to wake all of them up when the scheduler closes down
+   m_wakeUpSemaphore = new Semaphore( 0, numThreads * 2 + 1 );
+
    m_fixedThreadsCount = numThreads;
-   m_freeThreadIds = new Dequeue< uint >( numThreads );
    m_threadContexts.resize( numThreads );
    for ( uint i = 0; i < numThreads; ++i )
    {
-      ThreadContext* context = new ThreadContext( this, i );
-      m_threadContexts[i] = context;
-      m_freeThreadIds->push( i );
+      m_threadContexts[i] = NULL;
    }
 
-   // start the scheduler thread
-   m_schedulerThread->start( *this );
+   // workers may start stealing from one another as soon as they start, so
+   // create all contexts before we start any of them
+   for ( uint i = 0; i < numThreads; ++i )
+   {
+      m_threadContexts[i] = new ThreadContext( this, i );
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 MultithreadedTasksScheduler::~MultithreadedTasksScheduler()
 {
-   // stop the scheduler thread
+   // stop the workers
    m_closeRequest = true;
-   m_schedulerThread->join();
-   delete m_schedulerThread;
-   m_schedulerThread = NULL;
+   uint count = m_threadContexts.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      m_threadContexts[i]->close();
+   }
+   m_wakeUpSemaphore->release( count );
 
    // join and delete threads
-   uint count = m_threadContexts.size();
    for ( uint i = 0; i < count; ++i )
    {
-      ThreadContext* context = m_threadContexts[i];      
+      ThreadContext* context = m_threadContexts[i];
       delete context;
    }
+   m_threadContexts.clear();
 
-   delete m_freeThreadIds;
-   m_freeThreadIds = NULL;
+   count = m_temporaryContexts.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      delete m_temporaryContexts[i];
+   }
+   m_temporaryContexts.clear();
+
+   delete m_wakeUpSemaphore;
+   m_wakeUpSemaphore = NULL;
 
-   delete m_runningTasksLock;
-   m_runningTasksLock = NULL;
+   delete m_sharedQueueLock;
+   m_sharedQueueLock = NULL;
+
+   delete m_temporaryContextsLock;
+   m_temporaryContextsLock = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void MultithreadedTasksScheduler::clear()
 {
-   // clear tasks queue
-   m_tasksQueue.clear();
+   // clear tasks queues
+   MultithreadedTask* task = NULL;
+   uint numThreads = m_threadContexts.size();
+   for ( uint i = 0; i < numThreads; ++i )
+   {
+      ThreadContext* context = m_threadContexts[i];
+      while ( context->m_localQueue->steal( task ) )
+      {
+         m_scheduledTasksCount.decrement();
+      }
+   }
+
+   m_sharedQueueLock->enter();
+   m_scheduledTasksCount.add( -(long)m_sharedQueue.size() );
+   m_sharedTasksCount.add( -(long)m_sharedQueue.size() );
+   m_sharedQueue.clear();
+   m_sharedQueueLock->leave();
 
    // close all running tasks
-   uint numThreads = m_threadContexts.size();
    for ( uint i = 0; i < numThreads; ++i )
    {
-      ThreadContext* context = m_threadContexts[i]; 
+      ThreadContext* context = m_threadContexts[i];
       context->stopTask();
    }
+
+   CriticalSectionedSection lock( *m_temporaryContextsLock, false );
+   uint temporaryContextsCount = m_temporaryContexts.size();
+   for ( uint i = 0; i < temporaryContextsCount; ++i )
+   {
+      m_temporaryContexts[i]->stopTask();
+   }
+   releaseFinishedTemporaryContexts();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void MultithreadedTasksScheduler::run( MultithreadedTask& task, bool immediateExecution )
 {
-   if ( immediateExecution )
+   if ( !immediateExecution )
+   {
+      enqueueShared( &task );
+      return;
+   }
+
+   CriticalSectionedSection lock( *m_temporaryContextsLock, false );
+   releaseFinishedTemporaryContexts();
+
+   // if there's a worker that will be able to pick the task up right away, let it do so,
+   // otherwise create a new thread specifically for this task
+   long idleWorkersCount = (long)m_fixedThreadsCount - m_busyWorkersCount.get() - m_scheduledTasksCount.get();
+   if ( idleWorkersCount > 0 )
    {
-      scheduleImmediateTask( task );
+      enqueueShared( &task );
    }
    else
    {
-      m_tasksQueue.pushBack( &task );
+      m_temporaryContexts.push_back( new ThreadContext( this, &task ) );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MultithreadedTasksScheduler::spawn( MultithreadedTask& task )
+{
+   ThreadContext* context = findCurrentWorker();
+   if ( !context )
+   {
+      // we're not on a worker thread
+      enqueueShared( &task );
+      return;
+   }
+
+   // the count needs to go up before the task becomes visible to other workers,
+   // otherwise a worker that picks it up could take the count below zero
+   task.onScheduled();
+   m_scheduledTasksCount.increment();
+   if ( !context->m_localQueue->push( &task ) )
+   {
+      // the local queue is full - the task will have to go to the shared queue
+      pushToSharedQueue( &task );
+   }
+
+   wakeUpWorker();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MultithreadedTasksScheduler::waitFor( const JobCounter& counter )
+{
+   ThreadContext* context = findCurrentWorker();
+
+   while ( !counter.isDone() )
+   {
+      MultithreadedTask* task = acquireTask( context );
+      if ( task )
+      {
+         executeTask( task, context );
+      }
+      else
+      {
+         // the remaining jobs are being processed by other threads - give them a moment
+         Thread::yield();
+      }
    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+uint MultithreadedTasksScheduler::calcGrainSize( uint elementsCount, uint minGrainSize ) const
+{
+   // a few chunks per worker, so that the ones that get the simpler chunks can help out the others
+   uint grainSize = elementsCount / ( ( getWorkersCount() + 1 ) * 4 );
+   return grainSize < minGrainSize ? minGrainSize : grainSize;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 uint MultithreadedTasksScheduler::getAllTasksCount() const
 {
-   CriticalSectionedSection lock( *m_runningTasksLock, false );
-   uint activeTasksCount = m_threadContexts.size() - m_freeThreadIds->size();
+   // tasks move from the scheduled to the running state, so in order not to miss
+   // a task that's being moved, the scheduled tasks need to be counted first
+   long scheduledTasksCount = m_scheduledTasksCount.get();
+   long runningTasksCount = m_runningTasksCount.get();
 
-   return m_tasksQueue.size() + activeTasksCount;
+   long count = scheduledTasksCount + runningTasksCount;
+   return count > 0 ? (uint)count : 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 uint MultithreadedTasksScheduler::getScheduledTasksCount() const
 {
-   return m_tasksQueue.size();
+   long count = m_scheduledTasksCount.get();
+   return count > 0 ? (uint)count : 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 uint MultithreadedTasksScheduler::getRunningTasksCount() const
 {
-   CriticalSectionedSection lock( *m_runningTasksLock, false );
-   uint activeTasksCount = m_threadContexts.size() - m_freeThreadIds->size();
-
-   return activeTasksCount;
+   long count = m_runningTasksCount.get();
+   return count > 0 ? (uint)count : 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MultithreadedTasksScheduler::run()
+void MultithreadedTasksScheduler::enqueueShared( MultithreadedTask* task )
 {
-   while ( !m_closeRequest )
-   {
-      scheduleTasks();
-   }
+   task->onScheduled();
+   m_scheduledTasksCount.increment();
+
+   pushToSharedQueue( task );
+   wakeUpWorker();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MultithreadedTasksScheduler::scheduleTasks()
+void MultithreadedTasksScheduler::pushToSharedQueue( MultithreadedTask* task )
 {
-   CriticalSectionedSection lock( *m_runningTasksLock, false );
+   m_sharedQueueLock->enter();
+   m_sharedQueue.push( task );
+   m_sharedTasksCount.increment();
+   m_sharedQueueLock->leave();
+}
 
-   // Activate new tasks
-   int taskIdx = 0;
-   for ( TasksQueue::iterator it = m_tasksQueue.begin(); !it.isEnd() && !m_freeThreadIds->empty(); )
-   {
-      MultithreadedTask* scheduledTask = *it;
+///////////////////////////////////////////////////////////////////////////////
 
-      // The user might have scheduled the same task twice in a row - same instance that is.
-      // But if we're scheduling on multiple threads, we can't allow for the same instance to be 
-      // running on two threads at the same time.
-      if ( scheduledTask->getStatus() == MultithreadedTask::MTS_Running )
+MultithreadedTasksScheduler::ThreadContext* MultithreadedTasksScheduler::findCurrentWorker() const
+{
+   uint count = m_threadContexts.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      ThreadContext* context = m_threadContexts[i];
+      if ( context->isCurrentThread() )
       {
-         ++taskIdx;
-         ++it;
-         continue;
+         return context;
       }
+   }
 
-      // get the index of the next free thread
-      uint threadIdx = m_freeThreadIds->pop();
+   return NULL;
+}
 
-      // start the task
-      m_threadContexts[threadIdx]->assignTask( scheduledTask );
+///////////////////////////////////////////////////////////////////////////////
 
-      // remove the task from scheduled tasks queue
-      {
-         TasksQueue::iterator removedTaskIt = it;
+MultithreadedTask* MultithreadedTasksScheduler::acquireTask( ThreadContext* context )
+{
+   MultithreadedTask* task = NULL;
 
-         if ( taskIdx > 0 )
-         {
-            ++it;
-            m_tasksQueue.remove( removedTaskIt );
-         }
-         else
+   // first - check the worker's own queue
+   if ( context && context->m_localQueue->pop( task ) )
+   {
+      return task;
+   }
+
+   // then the tasks scheduled from outside of the workers
+   if ( m_sharedTasksCount.get() > 0 )
+   {
+      m_sharedQueueLock->enter();
+
+      // A task that's still running on another thread ( the same instance scheduled twice ) can't
+      // be taken - move it to the back of the queue and take the first task that can run instead,
+      // so that the running one doesn't hold up the tasks scheduled after it.
+      uint queuedTasksCount = m_sharedQueue.size();
+      for ( uint i = 0; i < queuedTasksCount; ++i )
+      {
+         MultithreadedTask* queuedTask = m_sharedQueue.pop();
+         if ( queuedTask->getStatus() != MultithreadedTask::MTS_Running )
          {
-            m_tasksQueue.remove( removedTaskIt );
-            it = m_tasksQueue.begin();
+            task = queuedTask;
+            m_sharedTasksCount.decrement();
+            break;
          }
+
+         m_sharedQueue.push( queuedTask );
       }
-   }
+      m_sharedQueueLock->leave();
 
+      if ( task )
+      {
+         return task;
+      }
+   }
 
-   // claim unused temporary contexts back
-   int threadsCount = m_threadContexts.size();
-   for ( int i = threadsCount - 1; i >= (int)m_fixedThreadsCount; --i )
+   // and finally try stealing from other workers, starting with the worker next to us,
+   // so that the workers don't all go after the same victim
+   uint count = m_threadContexts.size();
+   uint firstVictimIdx = context ? context->m_threadIdx + 1 : 0;
+   for ( uint i = 0; i < count; ++i )
    {
-      ThreadContext* context = m_threadContexts[i];
-      if ( !context->isProcessing() )
+      ThreadContext* victim = m_threadContexts[( firstVictimIdx + i ) % count];
+      if ( victim != context && victim->m_localQueue->steal( task ) )
       {
-         delete m_threadContexts[i];
-         m_threadContexts.remove(i);
+         return task;
       }
    }
+
+   return NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MultithreadedTasksScheduler::scheduleImmediateTask( MultithreadedTask& task )
+void MultithreadedTasksScheduler::executeTask( MultithreadedTask* task, ThreadContext* context )
 {
-   CriticalSectionedSection lock( *m_runningTasksLock, false );
+   // The user might have scheduled the same task twice in a row - same instance that is.
+   // But if we're scheduling on multiple threads, we can't allow for the same instance to be
+   // running on two threads at the same time - so put it back at the end of the queue.
+   // acquireTask skips such tasks in the shared queue, so it only happens if the task got
+   // activated in the meantime, or if it was spawned to a local queue.
+   if ( !task->activate() )
+   {
+      pushToSharedQueue( task );
 
-   // acquire an execution context for the task
-   uint threadIdx = -1;
-   if ( m_freeThreadIds->empty() )
+      Thread::yield();
+      return;
+   }
+
+   // the task needs to be counted as running before it stops being counted as scheduled
+   m_runningTasksCount.increment();
+   if ( context )
    {
-      // there are no free threads to run the task on - create a new one
-      threadIdx = m_threadContexts.size();
-      m_threadContexts.push_back( new ThreadContext( this, threadIdx ) );
+      m_busyWorkersCount.increment();
    }
-   else
+   m_scheduledTasksCount.decrement();
+
+   if ( context )
    {
-      threadIdx = m_freeThreadIds->pop();
+      context->setCurrentTask( task );
    }
 
-   // run the task
-   ThreadContext* context = m_threadContexts[threadIdx];
-   context->assignTask( &task );
+   task->run();
+
+   if ( context )
+   {
+      context->setCurrentTask( NULL );
+   }
+
+   task->complete();
+
+   // from this point on, the task may no longer exist
+
+   if ( context )
+   {
+      m_busyWorkersCount.decrement();
+   }
+   m_runningTasksCount.decrement();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MultithreadedTasksScheduler::reportTaskCompleted( uint threadIdx )
+void MultithreadedTasksScheduler::waitForTasks()
 {
-   if ( threadIdx < m_fixedThreadsCount )
+   // announce that we're going to sleep first, and only then check if there's anything to do -
+   // anyone who schedules a task after we've checked is going to see us sleeping and wake us up
+   m_sleepingWorkersCount.increment();
+
+   if ( m_scheduledTasksCount.get() <= 0 && !m_closeRequest )
    {
-      // return the thread to the pool of free threads only if it wasn't a temporary
-      m_runningTasksLock->enter();
-      m_freeThreadIds->push( threadIdx );
-      m_runningTasksLock->leave();
+      m_wakeUpSemaphore->acquire();
+      return;
+   }
+
+   // there's work to do after all - cancel the sleep. If someone has already
+   // issued a wake up call on our behalf, we need to consume it
+   while ( true )
+   {
+      long sleepingWorkersCount = m_sleepingWorkersCount.get();
+      if ( sleepingWorkersCount <= 0 )
+      {
+         m_wakeUpSemaphore->acquire();
+         return;
+      }
+
+      if ( m_sleepingWorkersCount.compareExchange( sleepingWorkersCount - 1, sleepingWorkersCount ) == sleepingWorkersCount )
+      {
+         // the scheduled tasks we couldn't acquire are either being moved by other threads, or they're
+         // still running elsewhere - give them a moment
+         Thread::yield();
+         return;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MultithreadedTasksScheduler::wakeUpWorker()
+{
+   while ( true )
+   {
+      long sleepingWorkersCount = m_sleepingWorkersCount.get();
+      if ( sleepingWorkersCount <= 0 )
+      {
+         // everybody's awake
+         return;
+      }
+
+      if ( m_sleepingWorkersCount.compareExchange( sleepingWorkersCount - 1, sleepingWorkersCount ) == sleepingWorkersCount )
+      {
+         m_wakeUpSemaphore->release();
+         return;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void MultithreadedTasksScheduler::releaseFinishedTemporaryContexts()
+{
+   // Must be called with m_temporaryContextsLock held
+   int count = m_temporaryContexts.size();
+   for ( int i = count - 1; i >= 0; --i )
+   {
+      ThreadContext* context = m_temporaryContexts[i];
+      if ( context->isFinished() )
+      {
+         delete context;
+         m_temporaryContexts.remove( i );
+      }
    }
 }
 
@@ -239,15 +483,40 @@ void MultithreadedTasksScheduler::reportTaskCompleted( uint threadIdx )
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
-MultithreadedTasksScheduler::ThreadContext::ThreadContext( MultithreadedTasksScheduler* scheduler, int threadIdx )
-   : m_thread( new Thread() )
+MultithreadedTasksScheduler::ThreadContext::ThreadContext( MultithreadedTasksScheduler* scheduler, uint threadIdx )
+   : m_localQueue( new WorkStealingQueue< MultithreadedTask* >( LOCAL_QUEUE_CAPACITY ) )
+   , m_thread( new Thread() )
    , m_scheduler( scheduler )
    , m_threadIdx( threadIdx )
    , m_taskLock( new CriticalSection() )
+   , m_taskStopped( new ConditionVariable() )
+   , m_task( NULL )
+   , m_immediateTask( NULL )
+   , m_forceClose( false )
+   , m_finished( false )
+{
+   m_thread->start( *this );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+MultithreadedTasksScheduler::ThreadContext::ThreadContext( MultithreadedTasksScheduler* scheduler, MultithreadedTask* immediateTask )
+   : m_localQueue( NULL )
+   , m_thread( new Thread() )
+   , m_scheduler( scheduler )
+   , m_threadIdx( -1 )
+   , m_taskLock( new CriticalSection() )
+   , m_taskStopped( new ConditionVariable() )
    , m_task( NULL )
-   , m_newTaskAvailable( false )
+   , m_immediateTask( immediateTask )
    , m_forceClose( false )
+   , m_finished( false )
 {
+   // the task counts as running from the moment it's handed over to the context
+   m_immediateTask->onScheduled();
+   m_immediateTask->setStatus( MultithreadedTask::MTS_Running );
+   m_scheduler->m_runningTasksCount.increment();
+
    m_thread->start( *this );
 }
 
@@ -256,90 +525,97 @@ MultithreadedTasksScheduler::ThreadContext::ThreadContext( MultithreadedTasksSch
 MultithreadedTasksScheduler::ThreadContext::~ThreadContext()
 {
    // signal the thread that it should stop working and wait for the thread to finish
-   m_taskLock->enter();
-   if ( m_task )
-   {
-      m_task->forceClose();
-   }
-   m_taskLock->leave();
-
-   m_forceClose = true;
+   close();
    m_thread->join();
 
    m_scheduler = NULL;
    m_threadIdx = 0;
 
+   delete m_taskStopped;
+   m_taskStopped = NULL;
+
    delete m_taskLock;
    m_taskLock = NULL;
 
    delete m_thread;
    m_thread = NULL;
+
+   delete m_localQueue;
+   m_localQueue = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void MultithreadedTasksScheduler::ThreadContext::assignTask( MultithreadedTask* task )
+void MultithreadedTasksScheduler::ThreadContext::close()
 {
    m_taskLock->enter();
-
-   ASSERT_MSG( m_task == NULL && !m_newTaskAvailable, "Another task is currently running in this context" );
-
-   m_task = task;
-   m_task->setStatus( MultithreadedTask::MTS_Running );
-   m_newTaskAvailable = true;
-
+   if ( m_task )
+   {
+      m_task->forceClose();
+   }
    m_taskLock->leave();
+
+   m_forceClose = true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void MultithreadedTasksScheduler::ThreadContext::run()
 {
-   while( !m_forceClose )
-   {      
-      // NOTE: we're not locking task access, because we're only performing atomic read operations
-      // whenever a task might be active and running, and we're assigning a new task when we the old
-      // one has reported completion and was safely removed from the queue
+   if ( m_immediateTask )
+   {
+      MultithreadedTask* task = m_immediateTask;
+      m_immediateTask = NULL;
 
-      // wait for a task to become available
-      while ( !m_newTaskAvailable && !m_forceClose )
-      {
-         Thread::yield();
-      }
+      setCurrentTask( task );
+      task->run();
+      setCurrentTask( NULL );
 
-      if ( m_forceClose )
-      {
-         // stop execution
-         break;
-      }
+      task->complete();
+      m_scheduler->m_runningTasksCount.decrement();
 
-      // another task was scheduled for execution - run it
-      m_taskLock->enter();
-      MultithreadedTask* task = m_task; 
-      m_taskLock->leave();
+      m_finished = true;
+   }
+   else
+   {
+      runWorkerLoop();
+   }
+}
 
+///////////////////////////////////////////////////////////////////////////////
+
+void MultithreadedTasksScheduler::ThreadContext::runWorkerLoop()
+{
+   while( !m_forceClose )
+   {
+      MultithreadedTask* task = m_scheduler->acquireTask( this );
       if ( task )
       {
-         task->run();
+         m_scheduler->executeTask( task, this );
       }
-
-      m_taskLock->enter();
-      m_newTaskAvailable = false;
-      m_task = NULL;
-      m_taskLock->leave();
-
-      task->setStatus( MultithreadedTask::MTS_Completed );
-
-      // report back to the scheduler that the task has completed ( only if we're not stopping the entire context )
-      if ( !m_forceClose )
+      else
       {
-         m_scheduler->reportTaskCompleted( m_threadIdx );
+         // there's nothing to do - go to sleep until more tasks are scheduled
+         m_scheduler->waitForTasks();
       }
    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void MultithreadedTasksScheduler::ThreadContext::setCurrentTask( MultithreadedTask* task )
+{
+   m_taskLock->enter();
+   m_task = task;
+   if ( !task )
+   {
+      m_taskStopped->notifyAll();
+   }
+   m_taskLock->leave();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void MultithreadedTasksScheduler::ThreadContext::stopTask()
 {
    m_taskLock->enter();
@@ -354,19 +630,7 @@ void MultithreadedTasksScheduler::ThreadContext::stopTask()
    m_taskLock->leave();
 
    // wait for the task to complete
-   while ( true )
-   {
-      m_taskLock->enter();
-      bool isStopped = ( m_task == NULL );
-      m_taskLock->leave();
-
-      if ( isStopped )
-      {
-         return;
-      }
-
-      Thread::yield();
-   }
+   m_taskStopped->waitUntil( *m_taskLock, TaskStoppedPredicate( m_task ) );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -382,3 +646,9 @@ bool MultithreadedTasksScheduler::ThreadContext::isProcessing() const
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool MultithreadedTasksScheduler::ThreadContext::isCurrentThread() const
+{
+   return m_thread->isCurrentThread();
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,66 @@
+#include "core\PackedAxisAlignedBoxes.h"
+#include "core\AxisAlignedBox.h"
+#include "core\Assert.h"
+#include <string.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+PackedAxisAlignedBoxes::PackedAxisAlignedBoxes( uint capacity )
+   : m_quads( ( capacity + 3 ) / 4 )
+   , m_boxesCount( 0 )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedAxisAlignedBoxes::clear()
+{
+   m_quads.clear();
+   m_boxesCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedAxisAlignedBoxes::push_back( const AxisAlignedBox& box )
+{
+   if ( ( m_boxesCount & 3 ) == 0 )
+   {
+      // start a new quad
+      Quad quad;
+      memset( &quad, 0, sizeof( Quad ) );
+      m_quads.push_back( quad );
+   }
+
+   ++m_boxesCount;
+   set( m_boxesCount - 1, box );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedAxisAlignedBoxes::set( uint idx, const AxisAlignedBox& box )
+{
+   ASSERT_MSG( idx < m_boxesCount, "Box index out of bounds" );
+
+   Quad& quad = m_quads[idx >> 2];
+   const uint lane = idx & 3;
+   for ( uint coord = 0; coord < 3; ++coord )
+   {
+      ( ( float* )&quad.m_min[coord] )[lane] = box.min[coord];
+      ( ( float* )&quad.m_max[coord] )[lane] = box.max[coord];
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void PackedAxisAlignedBoxes::get( uint idx, AxisAlignedBox& outBox ) const
+{
+   ASSERT_MSG( idx < m_boxesCount, "Box index out of bounds" );
+
+   const Quad& quad = m_quads[idx >> 2];
+   const uint lane = idx & 3;
+   outBox.min.set( ( ( const float* )&quad.m_min[0] )[lane], ( ( const float* )&quad.m_min[1] )[lane], ( ( const float* )&quad.m_min[2] )[lane] );
+   outBox.max.set( ( ( const float* )&quad.m_max[0] )[lane], ( ( const float* )&quad.m_max[1] )[lane], ( ( const float* )&quad.m_max[2] )[lane] );
+}
+
+///////////////////////////////////////////////////////////////////////////////
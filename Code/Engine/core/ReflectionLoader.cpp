@@ -9,6 +9,7 @@
 #include "core/ReflectionSerializationMacros.h"
 #include "core/MemoryRouter.h"
 #include "core/DefaultAllocator.h"
+#include "core/FilePathMap.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -115,6 +116,15 @@ uint ReflectionLoader::loadExternalDependencies( InStream& stream, std::vector<
       // deserialize the dependencies
       uint dependenciesCount = 0;
       stream >> dependenciesCount;
+
+      // index the dependencies that are already on the list, so that we don't add them twice
+      TFilePathMap< bool > dependenciesToLoadIndex;
+      uint currDependenciesCount = outDependenciesToLoad->size();
+      for ( uint j = 0; j < currDependenciesCount; ++j )
+      {
+         dependenciesToLoadIndex.insert( (*outDependenciesToLoad)[j], true );
+      }
+
       for ( uint i = 0; i < dependenciesCount; ++i )
       {
          FilePath path;
@@ -127,18 +137,7 @@ uint ReflectionLoader::loadExternalDependencies( InStream& stream, std::vector<
 
          // as for the list of additional dependencies to load, we need to make sure 
          // the path doesn't duplicate any of the existing entries. Only then can we add it there
-         bool isUnique = true;
-         uint currDependenciesCount = outDependenciesToLoad->size();
-         for ( uint j = 0; j < currDependenciesCount; ++j )
-         {
-            if ( (*outDependenciesToLoad)[j] == path )
-            {
-               isUnique = false;
-               break;
-            }
-         }
-
-         if ( isUnique )
+         if ( dependenciesToLoadIndex.insert( path, true ) )
          {
             outDependenciesToLoad->push_back( path );
          }
@@ -175,7 +174,7 @@ bool ReflectionLoader::loadInternalDependencies( InStream& stream, uint firstExt
       uint skipSize = 0;
       stream >> skipSize;
 
-      byte* dataBuf = (byte*)memRouter.alloc( skipSize, AM_DEFAULT, &memRouter.m_defaultAllocator );
+      byte* dataBuf = (byte*)memRouter.alloc( skipSize, AM_DEFAULT, memRouter.getDefaultAllocator() );
       stream.load( dataBuf, skipSize );
       InRawArrayStream objStream( dataBuf, skipSize );
 
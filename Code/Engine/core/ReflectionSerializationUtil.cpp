@@ -78,7 +78,7 @@ void ReflectionSerializationUtil::loadObjects( const FilePath& loadPath, std::ve
    Filesystem& filesystem = resMgr.getFilesystem();
 
    File* file = filesystem.open( loadPath, std::ios_base::in | std::ios_base::binary );
-   InFileStream stream( file );
+   InFileStream stream( file, InFileStream::DEFAULT_READ_AHEAD_SIZE );
 
    std::vector< FilePath > resourcesToLoad;
    std::vector< FilePath > resourcesMap;
@@ -13,6 +13,7 @@
 ReflectionType::ReflectionType( const std::string& name ) 
    : m_name( name )
    , m_versionNo( 0 )
+   , m_ancestryIdx( -1 )
 {
    m_id = generateId( m_name );
 }
@@ -40,6 +41,7 @@ SerializableReflectionType::SerializableReflectionType( const std::string& name
    : ReflectionType( name )
    , m_instantiator( NULL )
    , m_searchMemPool( new TSContinuousMemoryPool( 256 ) )
+   , m_ancestryMask( NULL )
 {
 }
 
@@ -72,12 +74,24 @@ void SerializableReflectionType::setupInstantiator( SerializableTypeInstantiator
 
 bool SerializableReflectionType::isA( const ReflectionType& referenceType ) const
 {
+   if ( m_id == referenceType.m_id )
+   {
+      return true;
+   }
+
+   // once the registry flattens the hierarchy, it's just a matter of checking a single bit
+   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+   if ( typesRegistry.areAncestryTablesValid() && m_ancestryMask && referenceType.m_ancestryIdx >= 0 )
+   {
+      uint refIdx = referenceType.m_ancestryIdx;
+      return ( m_ancestryMask[refIdx >> 5] & ( 1u << ( refIdx & 31 ) ) ) != 0;
+   }
+
    // we'll perform these operations in the current thread's constant memory pool, for performance reasons
    ThreadSystem& threadSystem = TSingleton< ThreadSystem >::getInstance();
    Thread& thread = threadSystem.getCurrentThread();
 
    // run a search on the type's inheritance tree
-   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
    List< const SerializableReflectionType* > bfs( thread.m_sharedMemoryPool );
    bfs.pushBack( this );
    while ( !bfs.empty() )
@@ -129,6 +143,8 @@ void SerializableReflectionType::addBaseType( uint baseTypeId, int versionNo )
    }
 
    m_baseTypesIds.push_back( ParentTypeDesc( baseTypeId, versionNo ) );
+
+   TSingleton< ReflectionTypesRegistry >::getInstance().invalidateAncestryTables();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -142,6 +158,8 @@ void SerializableReflectionType::removeBaseType( uint baseTypeId )
       if ( m_baseTypesIds[i].m_id == baseTypeId )
       {
          m_baseTypesIds.erase( m_baseTypesIds.begin() + i );
+
+         TSingleton< ReflectionTypesRegistry >::getInstance().invalidateAncestryTables();
          return;
       }
    }
@@ -14,6 +14,8 @@ INIT_SINGLETON( ReflectionTypesRegistry );
 
 ReflectionTypesRegistry::ReflectionTypesRegistry( const SingletonConstruct& )
    : m_genericEnumType( NULL )
+   , m_ancestryRowSize( 0 )
+   , m_ancestryTablesValid( false )
 {
    m_genericEnumType = new ReflectionEnum( "ReflectionEnum" );
 }
@@ -118,6 +120,10 @@ void ReflectionTypesRegistry::clear()
    m_allTypes.clear();
    m_externalTypesMap.clear();
    m_serializableTypesMap.clear();
+
+   invalidateAncestryTables();
+   m_ancestryTable.clear();
+   m_ancestryRowSize = 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -127,6 +133,8 @@ void ReflectionTypesRegistry::build( PatchesDB& patchesDB )
    resolveTypeVersions();
 
    createPatchInfo( patchesDB );
+
+   buildAncestryTables();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -163,4 +171,85 @@ void ReflectionTypesRegistry::createPatchInfo( PatchesDB& patchesDB ) const
    }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+void ReflectionTypesRegistry::invalidateAncestryTables()
+{
+   m_ancestryTablesValid = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ReflectionTypesRegistry::buildAncestryTables()
+{
+   // assign each serializable type a bit
+   uint typeIdx = 0;
+   for ( SerializableTypesMap::iterator it = m_serializableTypesMap.begin(); it != m_serializableTypesMap.end(); ++it, ++typeIdx )
+   {
+      it->second->m_ancestryIdx = typeIdx;
+   }
+
+   uint typesCount = typeIdx;
+   m_ancestryRowSize = ( typesCount + 31 ) / 32;
+   m_ancestryTable.clear();
+   m_ancestryTable.resize( typesCount * m_ancestryRowSize, 0 );
+   if ( typesCount == 0 )
+   {
+      m_ancestryTablesValid = true;
+      return;
+   }
+
+   // the rows can only be assigned once the table's memory won't be reallocated anymore
+   for ( SerializableTypesMap::iterator it = m_serializableTypesMap.begin(); it != m_serializableTypesMap.end(); ++it )
+   {
+      SerializableReflectionType* type = it->second;
+      type->m_ancestryMask = &m_ancestryTable[type->m_ancestryIdx * m_ancestryRowSize];
+   }
+
+   // fill the rows
+   std::vector< bool > visitedTypes( typesCount, false );
+   for ( SerializableTypesMap::iterator it = m_serializableTypesMap.begin(); it != m_serializableTypesMap.end(); ++it )
+   {
+      collectAncestors( it->second, visitedTypes );
+   }
+
+   m_ancestryTablesValid = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ReflectionTypesRegistry::collectAncestors( SerializableReflectionType* type, std::vector< bool >& visitedTypes )
+{
+   uint typeIdx = type->m_ancestryIdx;
+   if ( visitedTypes[typeIdx] )
+   {
+      return;
+   }
+
+   // mark the type as visited up front - this way a cyclic hierarchy won't send us into an infinite loop
+   visitedTypes[typeIdx] = true;
+
+   uint* row = &m_ancestryTable[typeIdx * m_ancestryRowSize];
+   row[typeIdx >> 5] |= 1u << ( typeIdx & 31 );
+
+   // a type inherits all ancestors of its parents
+   uint parentsCount = type->m_baseTypesIds.size();
+   for ( uint i = 0; i < parentsCount; ++i )
+   {
+      SerializableReflectionType* parentType = findSerializable( type->m_baseTypesIds[i].m_id );
+      if ( !parentType )
+      {
+         continue;
+      }
+
+      collectAncestors( parentType, visitedTypes );
+
+      const uint* parentRow = &m_ancestryTable[parentType->m_ancestryIdx * m_ancestryRowSize];
+      for ( uint j = 0; j < m_ancestryRowSize; ++j )
+      {
+         row[j] |= parentRow[j];
+      }
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
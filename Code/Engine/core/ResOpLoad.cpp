@@ -4,13 +4,15 @@
 #include "core\IProgressObserver.h"
 #include "core\Filesystem.h"
 #include "core\File.h"
-#include "core\InFileStream.h"
+#include "core\InMappedFileStream.h"
 #include "core\Resource.h"
 #include "core\ReflectionObject.h"
 #include "core\ExternalDependenciesLinker.h"
 #include "core\Thread.h"
+#include "core\MultithreadedTasksScheduler.h"
 #include "core\Assert.h"
 #include "core\Log.h"
+#include "core\FilePathMap.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -27,23 +29,58 @@ ResOpLoad::ResOpLoad( ResourcesManager* resMgr, const FilePath& loadPath, bool l
 
 ///////////////////////////////////////////////////////////////////////////////
 
+ResOpLoad::~ResOpLoad()
+{
+   // release the files that were loaded, but never committed
+   const uint filesCount = m_loadedFiles.size();
+   for ( uint i = 0; i < filesCount; ++i )
+   {
+      LoadedFile* loadedFile = m_loadedFiles[i];
+      if ( loadedFile->m_resource )
+      {
+         loadedFile->m_resource->removeReference();
+      }
+      delete loadedFile;
+   }
+   m_loadedFiles.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void ResOpLoad::execute()
 {
-   ResourcesDB* resourcesDB = m_resMgr->getResourcesDB();
+   prepare();
+   commit();
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
+void ResOpLoad::prepare()
+{
    // first - try locating an existing resource in the resources manager - perhaps it already exists
-   m_loadedResource = resourcesDB->findResource( m_resourcePath );
-   if ( m_loadedResource == NULL  )
+   if ( !isRegistered( m_resourcePath ) )
    {
       // the resource doesn't exist - try loading it.
-      m_loadedResource = load();
+      loadFiles();
+   }
+}
 
-      if ( !m_loadedResource && !m_loadOnly )
-      {
-         // loading failed - and the user indicated that in this case he wants a new resource created, so let's do it
-         m_loadedResource = create();
-         m_resourceToSave = m_loadedResource;
-      }
+///////////////////////////////////////////////////////////////////////////////
+
+void ResOpLoad::commit()
+{
+   ResourcesDB* resourcesDB = m_resMgr->getResourcesDB();
+
+   linkLoadedFiles();
+
+   // the resource might have been registered by another operation while this one was loading it,
+   // so look among the registered resources as well
+   m_loadedResource = findResource( m_resourcePath );
+   if ( !m_loadedResource && !m_loadOnly )
+   {
+      // loading failed - and the user indicated that in this case he wants a new resource created, so let's do it
+      m_loadedResource = create();
+      m_resourceToSave = m_loadedResource;
    }
 
    // commit operation results
@@ -170,98 +207,197 @@ public:
 
 Resource* ResOpLoad::load()
 {
-   BROADCAST_SERIALIZATION_IN_PROGRESS();
+   loadFiles();
+   linkLoadedFiles();
 
-   Filesystem& filesystem = m_resMgr->getFilesystem();
+   // return the loaded resource
+   Resource* loadedResource = NULL;
+   {
+      ResourcesMap::iterator it = m_resourcesToFinalize.find( m_resourcePath );
+      if ( it != m_resourcesToFinalize.end() )
+      {
+         loadedResource = it->second;
+      }
+   }
+   return loadedResource;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct ResOpLoad::FilesLoader
+{
+   const ResOpLoad&                             m_operation;
+   const std::vector< ResOpLoad::LoadedFile* >& m_files;
+
+   FilesLoader( const ResOpLoad& operation, const std::vector< ResOpLoad::LoadedFile* >& files )
+      : m_operation( operation )
+      , m_files( files )
+   {}
+
+   void operator()( uint chunkStart, uint chunkEnd ) const
+   {
+      for ( uint i = chunkStart; i < chunkEnd; ++i )
+      {
+         m_operation.loadFile( *m_files[i] );
+      }
+   }
+};
 
-   std::vector< FilePath > resourcesToLoad;
-   std::vector< FilePath > resourcesMap;
-   resourcesToLoad.push_back( m_resourcePath );
+///////////////////////////////////////////////////////////////////////////////
 
+void ResOpLoad::loadFiles()
+{
    // notify about the serialization progress
    if ( m_progressObserver )
    {
-      m_progressObserver->initialize( resourcesToLoad.size() );
+      m_progressObserver->initialize( 1 );
       m_progressObserver->setStatus( "Loading resources" );
    }
 
+   // Go through the tree of dependencies level by level. Files on the same level don't depend
+   // on each other, so they can be loaded in parallel, and the dependencies they reference
+   // make up the next level.
+   MultithreadedTasksScheduler& scheduler = TSingleton< MultithreadedTasksScheduler >::getInstance();
 
-   // Go through all resources in the list and load them. New resources
-   // will be added to the list as we keep mapping them.
-   std::vector< ReflectionObject* > mappedResources;
-   std::vector< ReflectionObject* > allLoadedObjects;
-   uint loadedResourceIdx = 0;
-   FilePath loadedResourcePath;
-   while( loadedResourceIdx < resourcesToLoad.size() )
+   TFilePathMap< bool > visitedPaths;
+   visitedPaths.insert( m_resourcePath, true );
+
+   std::vector< LoadedFile* > currLevel;
+   std::vector< LoadedFile* > nextLevel;
+   currLevel.push_back( new LoadedFile( m_resourcePath ) );
+   while ( !currLevel.empty() )
    {
-      loadedResourcePath = resourcesToLoad[loadedResourceIdx];
-      ++loadedResourceIdx;
+      const uint filesCount = currLevel.size();
+      scheduler.parallelFor( 0, filesCount, 1, FilesLoader( *this, currLevel ) );
 
-      // first check if such a resource is not yet loaded ( perhaps it's already there, and we can save time )
-      Resource* res = findResource( loadedResourcePath );
-      if ( res == NULL )
+      for ( uint i = 0; i < filesCount; ++i )
       {
-         // open the file for loading
-         std::string extension = loadedResourcePath.extractExtension();
-         std::ios_base::openmode accessMode = Resource::getFileAccessMode( extension );
-         File* file = filesystem.open( loadedResourcePath, std::ios_base::in | accessMode );
+         LoadedFile* loadedFile = currLevel[i];
+         m_loadedFiles.push_back( loadedFile );
 
-         if ( file )
+         // NOTE: do not stop the process if any of the external dependencies are missing - they will simply be missing and the user will have to fill them in manually,
+         // however log this incident
+         if ( !loadedFile->m_resource )
          {
-            InFileStream inStream( file );
-            ReflectionLoader loader;
-            loader.deserialize( inStream, &resourcesToLoad, &resourcesMap );
-            res = loader.getNextObject< Resource >();
+            LOG( "ResOpLoad: Resource '%s' was found missing when resource '%s' was being loaded", loadedFile->m_path.c_str(), m_resourcePath.c_str() );
+         }
 
-            allLoadedObjects.insert( allLoadedObjects.end(), loader.m_allLoadedObjects.begin(), loader.m_allLoadedObjects.end() );
+         if ( m_progressObserver )
+         {
+            m_progressObserver->advance();
          }
 
-         if ( res )
+         // the dependencies that haven't been loaded yet go to the next level
+         const uint dependenciesCount = loadedFile->m_dependencies.size();
+         for ( uint j = 0; j < dependenciesCount; ++j )
          {
-            // add the newly loaded resource to our list of resources to finalize
-            res->setFilePath( loadedResourcePath );
-            m_resourcesToFinalize.insert( std::make_pair( loadedResourcePath, res ) );
+            const FilePath& dependencyPath = loadedFile->m_dependencies[j];
+            if ( visitedPaths.insert( dependencyPath, true ) && !isRegistered( dependencyPath ) )
+            {
+               nextLevel.push_back( new LoadedFile( dependencyPath ) );
+            }
          }
       }
 
-      // memorize the mapped resource
-      mappedResources.push_back( res );
+      currLevel.swap( nextLevel );
+      nextLevel.clear();
+   }
+}
 
-      // NOTE: do not stop the process if any of the external dependencies are missing - they will simply be missing and the user will have to fill them in manually,
-      // however log this incident
-      if ( !res )
+///////////////////////////////////////////////////////////////////////////////
+
+void ResOpLoad::loadFile( LoadedFile& loadedFile ) const
+{
+   BROADCAST_SERIALIZATION_IN_PROGRESS();
+
+   // open the file for loading
+   Filesystem& filesystem = m_resMgr->getFilesystem();
+   std::string extension = loadedFile.m_path.extractExtension();
+   std::ios_base::openmode accessMode = Resource::getFileAccessMode( extension );
+   File* file = filesystem.open( loadedFile.m_path, std::ios_base::in | accessMode );
+   if ( !file )
+   {
+      return;
+   }
+
+   // resources are only read here, so we can read them straight from the mapped file
+   InMappedFileStream inStream( file );
+   ReflectionLoader loader;
+   loader.deserialize( inStream, &loadedFile.m_dependencies, &loadedFile.m_remappedDependencies );
+   loadedFile.m_resource = loader.getNextObject< Resource >();
+
+   loadedFile.m_objects.assign( loader.m_allLoadedObjects.begin(), loader.m_allLoadedObjects.end() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ResOpLoad::linkLoadedFiles()
+{
+   BROADCAST_SERIALIZATION_IN_PROGRESS();
+
+   // put the loaded resources up for registration
+   const uint filesCount = m_loadedFiles.size();
+   for ( uint i = 0; i < filesCount; ++i )
+   {
+      LoadedFile* loadedFile = m_loadedFiles[i];
+      if ( !loadedFile->m_resource )
       {
-         LOG( "ResOpLoad: Resource '%s' was found missing when resource '%s' was being loaded", loadedResourcePath.c_str(), m_resourcePath.c_str() );
+         continue;
       }
 
-      // advance the observer ONLY when the resource was successfully loaded
-      if ( m_progressObserver )
+      if ( isRegistered( loadedFile->m_path ) )
       {
-         m_progressObserver->advance();
+         // another operation registered the resource while we were loading it - and we can't replace it, 
+         // since pointers to it may exist all over the running application, so we'll link to that instance instead
+         loadedFile->m_resource->removeReference();
+         loadedFile->m_resource = NULL;
+         loadedFile->m_objects.clear();
+         continue;
       }
-   }
 
-   // mapped the loaded resources
-   ExternalDependenciesLinker linker( resourcesMap, FindResourceDelegate::FROM_METHOD( ResOpLoad, findResource, this ) );
-   linker.linkDependencies( allLoadedObjects );
+      loadedFile->m_resource->setFilePath( loadedFile->m_path );
+      m_resourcesToFinalize.insert( std::make_pair( loadedFile->m_path, loadedFile->m_resource ) );
+   }
 
-   // make sure that all loaded objects are informed that they were loaded
-   uint allLoadedObjectsCount = allLoadedObjects.size();
-   for ( uint i = 0; i < allLoadedObjectsCount; ++i )
+   // map the loaded resources - each file references its external dependencies by the indices
+   // into its own list of dependencies
+   FindResourceDelegate findResourceDelegate = FindResourceDelegate::FROM_METHOD( ResOpLoad, findResource, this );
+   for ( uint i = 0; i < filesCount; ++i )
    {
-      allLoadedObjects[i]->notifyObjectLoaded();
+      LoadedFile* loadedFile = m_loadedFiles[i];
+
+      ExternalDependenciesLinker linker( loadedFile->m_remappedDependencies, findResourceDelegate );
+      linker.linkDependencies( loadedFile->m_objects );
    }
 
-   // return the loaded resource
-   Resource* loadedResource = NULL;
+   // make sure that all loaded objects are informed that they were loaded
+   for ( uint i = 0; i < filesCount; ++i )
    {
-      ResourcesMap::iterator it = m_resourcesToFinalize.find( m_resourcePath );
-      if ( it != m_resourcesToFinalize.end() )
+      LoadedFile* loadedFile = m_loadedFiles[i];
+
+      const uint objectsCount = loadedFile->m_objects.size();
+      for ( uint j = 0; j < objectsCount; ++j )
       {
-         loadedResource = it->second;
+         loadedFile->m_objects[j]->notifyObjectLoaded();
       }
+
+      delete loadedFile;
    }
-   return loadedResource;
+   m_loadedFiles.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool ResOpLoad::isRegistered( const FilePath& path ) const
+{
+   if ( m_reloaderResourcePath == path )
+   {
+      // reloaded resource is assumed not to exist
+      return false;
+   }
+
+   ResourcesDB* resourcesDB = m_resMgr->getResourcesDB();
+   return resourcesDB->findResource( path ) != NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
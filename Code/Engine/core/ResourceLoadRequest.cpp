@@ -0,0 +1,68 @@
+#include "core\ResourceLoadRequest.h"
+#include "core\ResourcesManager.h"
+#include "core\Assert.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+ResourceLoadRequest::ResourceLoadRequest( MultithreadedTasksScheduler& scheduler, ResourcesManager* resMgr, const FilePath& path, bool loadOnly )
+   : Job( scheduler )
+   , m_operation( resMgr, path, loadOnly )
+   , m_committed( false )
+   , m_referencesCount( 0 )
+{
+   setCounter( &m_loadingCounter );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ResourceLoadRequest::~ResourceLoadRequest()
+{
+   ASSERT_MSG( isLoaded(), "A resource load request can't be deleted while it's being loaded" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Resource* ResourceLoadRequest::getResource() const
+{
+   return m_committed ? m_operation.getAcquiredResource() : NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ResourceLoadRequest::addReference()
+{
+   m_referencesCount.increment();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ResourceLoadRequest::removeReference()
+{
+   if ( m_referencesCount.decrement() == 0 )
+   {
+      delete this;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ResourceLoadRequest::execute()
+{
+   m_operation.prepare();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ResourceLoadRequest::commit()
+{
+   ASSERT_MSG( isLoaded(), "The resource is still being loaded" );
+
+   if ( !m_committed )
+   {
+      m_operation.commit();
+      m_committed = true;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
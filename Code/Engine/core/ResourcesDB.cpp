@@ -5,12 +5,14 @@
 #include "core\Log.h"
 #include "core\Filesystem.h"
 #include "core\FilesystemScanner.h"
+#include "core\CriticalSection.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
 ResourcesDB::ResourcesDB( ResourcesManager& host )
    : m_host( host )
+   , m_lock( new CriticalSection() )
 {
 }
 
@@ -18,27 +20,32 @@ ResourcesDB::ResourcesDB( ResourcesManager& host )
 
 ResourcesDB::~ResourcesDB()
 {
+   delete m_lock;
+   m_lock = NULL;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void ResourcesDB::lock()
 {
+   m_lock->enter();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void ResourcesDB::unlock()
 {
+   m_lock->leave();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void ResourcesDB::clear()
 {
-   for ( ResourcesMap::iterator it = m_resources.begin(); it != m_resources.end(); ++it )
+   const uint count = m_resources.size();
+   for ( uint i = 0; i < count; ++i )
    {
-      Resource* resource = it->second;
+      Resource* resource = m_resources.getEntry( i ).m_value;
 
       resource->resetResourcesManager();
       resource->removeReference();
@@ -65,8 +72,7 @@ bool ResourcesDB::insertResourceEntry( Resource* resource )
    FilePath correctResourcePath;
    resource->getFilePath().changeFileExtension( resource->getVirtualExtension(), correctResourcePath );
 
-   ResourcesMap::iterator it = m_resources.find( correctResourcePath );
-   if ( it != m_resources.end() )
+   if ( m_resources.find( correctResourcePath ) )
    {
       // a resource by this name already exists - and we can't replace it, since
       // pointers to it may exist all over the running application
@@ -75,7 +81,7 @@ bool ResourcesDB::insertResourceEntry( Resource* resource )
    }
 
    resource->setFilePath( correctResourcePath );
-   m_resources.insert( std::make_pair( correctResourcePath, resource ) );
+   m_resources.insert( correctResourcePath, resource );
    resource->setResourcesManager( *this );
 
    // notify the host
@@ -101,16 +107,17 @@ bool ResourcesDB::removeResourceEntry( Resource* resource )
 
 bool ResourcesDB::removeResourceEntry( const FilePath& resourcePath )
 {
-   ResourcesMap::iterator it = m_resources.find( resourcePath );
-   if ( it == m_resources.end() )
+   Resource** resourceEntry = m_resources.find( resourcePath );
+   if ( !resourceEntry )
    {
       return false;
    }
 
-   Resource* resource = it->second;
+   Resource* resource = *resourceEntry;
+   m_resources.remove( resourcePath );
+
    resource->resetResourcesManager();
    resource->removeReference();
-   m_resources.erase( it );
 
    return true;
 }
@@ -119,24 +126,22 @@ bool ResourcesDB::removeResourceEntry( const FilePath& resourcePath )
 
 void ResourcesDB::changeFilePath( const FilePath& oldPath, const FilePath& newPath )
 {
-   ResourcesMap::iterator existingResIt = m_resources.find( oldPath );
-   if ( existingResIt == m_resources.end() )
+   Resource** existingResEntry = m_resources.find( oldPath );
+   if ( !existingResEntry )
    {
       // the resource we want to update doesn't exist
       return;
    }
 
-   ResourcesMap::iterator newResIt = m_resources.find( newPath );
-   if ( newResIt != m_resources.end() )
+   if ( m_resources.find( newPath ) )
    {
       // the resource we want to map the old one to already exists - overwriting is not supported
       return;
    }
 
-   Resource* resource = existingResIt->second;
+   Resource* resource = *existingResEntry;
    resource->setFilePath( newPath, this );
-   m_resources.erase( existingResIt );
-   m_resources.insert( std::make_pair( newPath, resource ) );
+   m_resources.changePath( oldPath, newPath );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -145,31 +150,32 @@ void ResourcesDB::changeDirPath( const FilePath& oldDirPath, const FilePath& new
 {
    List< FilePath > entriesToRemove;
    List< Resource* > resourcesToReadd;
-   for ( ResourcesMap::iterator it = m_resources.begin(); it != m_resources.end(); ++it )
+   const uint count = m_resources.size();
+   for ( uint i = 0; i < count; ++i )
    {
-      if ( it->first.isLocatedInDir( oldDirPath ) )
+      ResourcesMap::Entry& entry = m_resources.getEntry( i );
+      if ( entry.m_path.isLocatedInDir( oldDirPath ) )
       {
          FilePath newResourcePath;
-         it->first.swapPart( oldDirPath, newDirPath, newResourcePath );
+         entry.m_path.swapPart( oldDirPath, newDirPath, newResourcePath );
 
-         it->second->setFilePath( newResourcePath );
-         resourcesToReadd.pushBack( it->second );
-         entriesToRemove.pushBack( it->first );
+         entry.m_value->setFilePath( newResourcePath );
+         resourcesToReadd.pushBack( entry.m_value );
+         entriesToRemove.pushBack( entry.m_path );
       }
    }
 
    // remove old entries
    for ( List< FilePath >::iterator it = entriesToRemove.begin(); !it.isEnd(); ++it )
    {
-      ResourcesMap::iterator entryToRemoveIt = m_resources.find( *it );
-      m_resources.erase( entryToRemoveIt );
+      m_resources.remove( *it );
    }
 
    // re-add remapped resources
    for ( List< Resource* >::iterator it = resourcesToReadd.begin(); !it.isEnd(); ++it )
    {
       Resource* resource = *it;
-      m_resources.insert( std::make_pair( resource->getFilePath(), resource ) );
+      m_resources.insert( resource->getFilePath(), resource );
    }
 
 }
@@ -180,16 +186,17 @@ void ResourcesDB::unlinkDependencies( const FilePath& path )
 {
    // check all registered resources and remove their dependencies on the removed resource
    MissingDependenciesMapper mapper;
-   ResourcesMap::const_iterator lastResIt = m_resources.end();
-   for ( ResourcesMap::const_iterator it = m_resources.begin(); it != lastResIt; ++it )
+   const uint count = m_resources.size();
+   for ( uint i = 0; i < count; ++i )
    {
-      if ( it->first == path )
+      const ResourcesMap::Entry& entry = m_resources.getEntry( i );
+      if ( entry.m_path == path )
       {
          // don't edit the resource we're removing
          continue;
       }
 
-      Resource* checkedRes = it->second;
+      Resource* checkedRes = entry.m_value;
       mapper.set( *checkedRes );
       mapper.removeDependenciesOn( path );
    }
@@ -200,24 +207,27 @@ void ResourcesDB::unlinkDependencies( const FilePath& path )
 
 Resource* ResourcesDB::findResource( const FilePath& name )
 {
-   ResourcesMap::iterator it = m_resources.find( name );
-   if ( it != m_resources.end() )
-   {
-      return it->second;
-   }
-   else
+   Resource* resource = NULL;
+
+   m_lock->enter();
+   Resource** resourceEntry = m_resources.find( name );
+   if ( resourceEntry )
    {
-      return NULL;
+      resource = *resourceEntry;
    }
+   m_lock->leave();
+
+   return resource;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void ResourcesDB::collectLoadedResourcesPaths( std::set< FilePath >& outPaths ) const
 {
-   for ( ResourcesMap::const_iterator it = m_resources.begin(); it != m_resources.end(); ++it )
+   const uint count = m_resources.size();
+   for ( uint i = 0; i < count; ++i )
    {
-      outPaths.insert( it->first );
+      outPaths.insert( m_resources.getEntry( i ).m_path );
    }
 }
 
@@ -225,9 +235,10 @@ void ResourcesDB::collectLoadedResourcesPaths( std::set< FilePath >& outPaths )
 
 void ResourcesDB::collectResourcesFromDir( const FilePath& dir, Array< FilePath >& outPaths ) const
 {
-   for ( ResourcesMap::const_iterator it = m_resources.begin(); it != m_resources.end(); ++it )
+   const uint count = m_resources.size();
+   for ( uint i = 0; i < count; ++i )
    {
-      const FilePath& path = it->first;
+      const FilePath& path = m_resources.getEntry( i ).m_path;
       if ( path.isLocatedInDir( dir ) || path == dir )
       {
          outPaths.push_back( path );
@@ -239,10 +250,11 @@ void ResourcesDB::collectResourcesFromDir( const FilePath& dir, Array< FilePath
 
 void ResourcesDB::collectResourcesFromDir( const FilePath& dir, List< Resource* >& outResources )
 {
-   for ( ResourcesMap::iterator it = m_resources.begin(); it != m_resources.end(); ++it )
+   const uint count = m_resources.size();
+   for ( uint i = 0; i < count; ++i )
    {
-      Resource* resource = it->second;
-      const FilePath& path = it->first;
+      Resource* resource = m_resources.getEntry( i ).m_value;
+      const FilePath& path = m_resources.getEntry( i ).m_path;
       if ( path.isLocatedInDir( dir ) || path == dir )
       {
          outResources.pushBack( resource );
@@ -257,9 +269,10 @@ void ResourcesDB::scan( const FilePath& rootDir, FilesystemScanner& scanner, boo
    Filesystem& fs = m_host.getFilesystem();
 
    const std::size_t rootDirNameLen = rootDir.getRelativePath().length();
-   for ( ResourcesMap::const_iterator it = m_resources.begin(); it != m_resources.end(); ++it )
+   const uint count = m_resources.size();
+   for ( uint i = 0; i < count; ++i )
    {
-      const FilePath& file = it->first;
+      const FilePath& file = m_resources.getEntry( i ).m_path;
 
       std::size_t rootDirPos = file.getRelativePath().find( rootDir );
       if ( rootDirPos != 0 )
@@ -10,6 +10,8 @@
 #include "core\ResOpLoad.h"
 #include "core\ResourceUtils.h"
 #include "core\ResourceDependenciesGraph.h"
+#include "core\ResourceLoadRequest.h"
+#include "core\MultithreadedTasksScheduler.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -51,6 +53,16 @@ ResourcesManager::~ResourcesManager()
       m_filesystem->detach( *this );
    }
 
+   // the background loads need to complete before the resources can be released
+   uint count = m_asyncLoads.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      ResourceLoadRequest* request = m_asyncLoads[i];
+      TSingleton< MultithreadedTasksScheduler >::getInstance().waitFor( request->getLoadingCounter() );
+      request->removeReference();
+   }
+   m_asyncLoads.clear();
+
    reset();
 
    m_filesystem = NULL;
@@ -67,7 +79,9 @@ ResourcesManager::~ResourcesManager()
 void ResourcesManager::reset()
 {
    // release all resources
+   m_resourcesDB->lock();
    m_resourcesDB->clear();
+   m_resourcesDB->unlock();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -206,6 +220,92 @@ Resource* ResourcesManager::create( const FilePath& filePath, bool loadOnly )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+TResourceLoadHandle< Resource > ResourcesManager::createAsync( const FilePath& filePath, bool loadOnly )
+{
+   // maybe the resource is already being loaded
+   uint count = m_asyncLoads.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      ResourceLoadRequest* request = m_asyncLoads[i];
+      if ( request->getResourcePath() == filePath )
+      {
+         return TResourceLoadHandle< Resource >( request );
+      }
+   }
+
+   MultithreadedTasksScheduler& scheduler = TSingleton< MultithreadedTasksScheduler >::getInstance();
+   ResourceLoadRequest* request = new ResourceLoadRequest( scheduler, this, filePath, loadOnly );
+   TResourceLoadHandle< Resource > handle( request );
+
+   if ( m_resourcesDB->findResource( filePath ) )
+   {
+      // the resource is already there - there's nothing to load
+      request->commit();
+   }
+   else
+   {
+      // the manager keeps the request until it's committed
+      request->addReference();
+      m_asyncLoads.push_back( request );
+
+      scheduler.run( *request );
+   }
+
+   return handle;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ResourcesManager::waitFor( ResourceLoadRequest* request )
+{
+   if ( request->isCommitted() )
+   {
+      return;
+   }
+
+   uint count = m_asyncLoads.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      if ( m_asyncLoads[i] == request )
+      {
+         TSingleton< MultithreadedTasksScheduler >::getInstance().waitFor( request->getLoadingCounter() );
+         commitAsyncLoad( i );
+         break;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ResourcesManager::processAsyncLoads()
+{
+   // commit the loads in the order they were requested in
+   for ( uint i = 0; i < m_asyncLoads.size(); )
+   {
+      if ( m_asyncLoads[i]->isLoaded() )
+      {
+         commitAsyncLoad( i );
+      }
+      else
+      {
+         ++i;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ResourcesManager::commitAsyncLoad( uint loadIdx )
+{
+   ResourceLoadRequest* request = m_asyncLoads[loadIdx];
+   m_asyncLoads.remove( loadIdx );
+
+   request->commit();
+   request->removeReference();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void ResourcesManager::onResourceAdded( Resource* resource )
 {
    scanResourceDependencies( resource->getFilePath() );
@@ -228,6 +328,7 @@ void ResourcesManager::onDirRemoved( const FilePath& dir )
    m_resourcesDB->collectResourcesFromDir( dir, entriesToRemove );
 
    // remove the removed resources entries from the map
+   m_resourcesDB->lock();
    unsigned int count = entriesToRemove.size();
    for ( unsigned int i = 0; i < count; ++i )
    {
@@ -239,6 +340,7 @@ void ResourcesManager::onDirRemoved( const FilePath& dir )
          ASSERT( result );
       }
    }
+   m_resourcesDB->unlock();
 
    m_dependenciesGraph->onDirRemoved( dir );
 }
@@ -280,7 +382,10 @@ void ResourcesManager::onFileEdited( const FilePath& path )
 
 void ResourcesManager::onFileRemoved( const FilePath& path )
 {
+   m_resourcesDB->lock();
    m_resourcesDB->removeResourceEntry( path );
+   m_resourcesDB->unlock();
+
    m_dependenciesGraph->onFileRemoved( path );
 }
 
@@ -288,7 +393,10 @@ void ResourcesManager::onFileRemoved( const FilePath& path )
 
 void ResourcesManager::onFileRenamed( const FilePath& oldPath, const FilePath& newPath )
 {
+   m_resourcesDB->lock();
    m_resourcesDB->changeFilePath( oldPath, newPath );
+   m_resourcesDB->unlock();
+
    m_dependenciesGraph->onFileRenamed( oldPath, newPath );
 }
 
@@ -296,7 +404,10 @@ void ResourcesManager::onFileRenamed( const FilePath& oldPath, const FilePath& n
 
 void ResourcesManager::onDirRenamed( const FilePath& oldPath, const FilePath& newPath )
 {
+   m_resourcesDB->lock();
    m_resourcesDB->changeDirPath( oldPath, newPath );
+   m_resourcesDB->unlock();
+
    m_dependenciesGraph->onDirRenamed( oldPath, newPath );
 }
 
@@ -19,6 +19,21 @@ Semaphore::Semaphore( uint maxThreadsCount )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+Semaphore::Semaphore( uint initialCount, uint maxThreadsCount )
+{
+   ASSERT_MSG( initialCount <= maxThreadsCount, "Initial semaphore count exceeds its capacity" );
+
+   m_semaphoreHandle = CreateSemaphore( 
+      NULL,             // default security attributes
+      initialCount,     // initial count
+      maxThreadsCount,  // maximum count
+      NULL);            // unnamed semaphore
+
+   ASSERT_MSG( m_semaphoreHandle != NULL, "Semaphore could not be created" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 Semaphore::~Semaphore()
 {
    if ( m_semaphoreHandle )
@@ -60,6 +75,18 @@ void Semaphore::release()
 
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+void Semaphore::release( uint count )
+{
+   ASSERT_MSG( m_semaphoreHandle != NULL, "Semaphore doesn't exist" );
+
+   if ( count > 0 && !ReleaseSemaphore( m_semaphoreHandle, count, NULL ) )
+   {
+      ASSERT_MSG( false, "Semaphore flag count wasn't decreased" );
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -13,7 +13,7 @@ TSFragmentedMemoryPool::TSFragmentedMemoryPool( uint chunksCount, uint chunkSize
    MemoryRouter& memRouter = TSingleton< MemoryRouter >::getInstance();
 
    uint memToAllocSize = ( m_chunksCount + 1 ) * m_chunkSize;
-   m_memBuf = ( char* ) memRouter.alloc( memToAllocSize * sizeof( char ), AM_DEFAULT, &memRouter.m_defaultAllocator );
+   m_memBuf = ( char* ) memRouter.alloc( memToAllocSize * sizeof( char ), AM_DEFAULT, memRouter.getDefaultAllocator() );
 
    // initialize the head
    m_head = 0;
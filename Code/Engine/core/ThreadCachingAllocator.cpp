@@ -0,0 +1,289 @@
+#include "core\ThreadCachingAllocator.h"
+#include "core\CriticalSection.h"
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+// size of a memory chunk the blocks of a single size class are carved out of
+#define CHUNK_SIZE         16384
+
+///////////////////////////////////////////////////////////////////////////////
+
+ThreadCachingAllocator::ThreadCachingAllocator()
+   : m_centralLock( new CriticalSection() )
+   , m_tlsIndex( TlsAlloc() )
+   , m_chunks( NULL )
+   , m_caches( NULL )
+   , m_unusedCaches( NULL )
+{
+   memset( m_centralFreeLists, 0, sizeof( m_centralFreeLists ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ThreadCachingAllocator::~ThreadCachingAllocator()
+{
+   if ( getMemoryUsed() != 0 )
+   {
+      // The blocks still in use live in our chunks, and releasing them will touch the thread caches
+      // and the central heap - so leave everything in place. The leak has already been reported
+      // by the MemoryRouter, and the system will reclaim the memory once the process exits.
+      return;
+   }
+
+   TlsFree( m_tlsIndex );
+
+   while ( m_caches )
+   {
+      ThreadCache* cache = m_caches;
+      m_caches = cache->m_nextCache;
+      ::free( cache );
+   }
+   m_unusedCaches = NULL;
+
+   while ( m_chunks )
+   {
+      Chunk* chunk = m_chunks;
+      m_chunks = chunk->m_next;
+      ::free( chunk );
+   }
+
+   delete m_centralLock;
+   m_centralLock = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void* ThreadCachingAllocator::alloc( size_t size )
+{
+   ThreadCache* cache = getThreadCache();
+   cache->m_allocatedMemorySize += (long)size;
+
+   size_t* origPtr = NULL;
+   if ( size > MAX_CACHED_SIZE )
+   {
+      origPtr = (size_t*)::malloc( size + sizeof( size_t ) );
+   }
+   else
+   {
+      uint sizeClass = getSizeClass( size );
+      FreeList& list = cache->m_freeLists[sizeClass];
+      if ( list.m_head == NULL )
+      {
+         fetchFromCentralHeap( sizeClass, list );
+      }
+
+      FreeBlock* block = list.m_head;
+      list.m_head = block->m_next;
+      --list.m_count;
+
+      origPtr = (size_t*)block;
+   }
+
+   // store the size
+   *origPtr = size;
+
+   return origPtr + 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ThreadCachingAllocator::dealloc( void* ptr )
+{
+   // get the actual pointer to the allocated block and its size
+   size_t* origPtr = (size_t*)ptr - 1;
+   size_t allocatedSize = *origPtr;
+
+   ThreadCache* cache = getThreadCache();
+   cache->m_allocatedMemorySize -= (long)allocatedSize;
+
+#ifdef _DEBUG
+   // fill memory with recognizable value to eradicate its previous contents
+   // and facilitate corrupt memory access calls
+   memset( ptr, 0xff, sizeof( char ) * allocatedSize );
+#endif
+
+   if ( allocatedSize > MAX_CACHED_SIZE )
+   {
+      ::free( origPtr );
+      return;
+   }
+
+   // the block goes to the cache of the calling thread, regardless of which thread allocated it
+   uint sizeClass = getSizeClass( allocatedSize );
+   FreeList& list = cache->m_freeLists[sizeClass];
+
+   FreeBlock* block = (FreeBlock*)origPtr;
+   block->m_next = list.m_head;
+   list.m_head = block;
+   ++list.m_count;
+
+   if ( list.m_count > BATCH_SIZE * 2 )
+   {
+      releaseToCentralHeap( sizeClass, list, BATCH_SIZE );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ulong ThreadCachingAllocator::getMemoryUsed() const
+{
+   long val = 0;
+
+   m_centralLock->enter();
+   for ( ThreadCache* cache = m_caches; cache != NULL; cache = cache->m_nextCache )
+   {
+      val += cache->m_allocatedMemorySize;
+   }
+   m_centralLock->leave();
+
+   return (ulong)val;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ThreadCachingAllocator::releaseThreadCache()
+{
+   ThreadCache* cache = (ThreadCache*)TlsGetValue( m_tlsIndex );
+   if ( cache == NULL )
+   {
+      return;
+   }
+
+   for ( uint i = 0; i < SIZE_CLASSES_COUNT; ++i )
+   {
+      FreeList& list = cache->m_freeLists[i];
+      if ( list.m_count > 0 )
+      {
+         releaseToCentralHeap( i, list, list.m_count );
+      }
+   }
+
+   m_centralLock->enter();
+   cache->m_nextUnusedCache = m_unusedCaches;
+   m_unusedCaches = cache;
+   m_centralLock->leave();
+
+   TlsSetValue( m_tlsIndex, NULL );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+ThreadCachingAllocator::ThreadCache* ThreadCachingAllocator::getThreadCache()
+{
+   ThreadCache* cache = (ThreadCache*)TlsGetValue( m_tlsIndex );
+   if ( cache )
+   {
+      return cache;
+   }
+
+   m_centralLock->enter();
+   if ( m_unusedCaches )
+   {
+      // reuse a cache released by one of the threads that exited - along with
+      // the memory usage it kept track of
+      cache = m_unusedCaches;
+      m_unusedCaches = cache->m_nextUnusedCache;
+      cache->m_nextUnusedCache = NULL;
+   }
+   else
+   {
+      // the caches can't be allocated using the allocator itself
+      cache = (ThreadCache*)::malloc( sizeof( ThreadCache ) );
+      memset( cache, 0, sizeof( ThreadCache ) );
+
+      cache->m_nextCache = m_caches;
+      m_caches = cache;
+   }
+   m_centralLock->leave();
+
+   TlsSetValue( m_tlsIndex, cache );
+   return cache;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ThreadCachingAllocator::fetchFromCentralHeap( uint sizeClass, FreeList& list )
+{
+   m_centralLock->enter();
+
+   FreeList& centralList = m_centralFreeLists[sizeClass];
+   if ( centralList.m_head == NULL )
+   {
+      allocateChunk( sizeClass );
+   }
+
+   // detach a batch of blocks
+   FreeBlock* first = centralList.m_head;
+   FreeBlock* last = first;
+   uint blocksCount = 1;
+   for ( ; blocksCount < BATCH_SIZE && last->m_next != NULL; ++blocksCount )
+   {
+      last = last->m_next;
+   }
+   centralList.m_head = last->m_next;
+   centralList.m_count -= blocksCount;
+
+   m_centralLock->leave();
+
+   last->m_next = list.m_head;
+   list.m_head = first;
+   list.m_count += blocksCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ThreadCachingAllocator::releaseToCentralHeap( uint sizeClass, FreeList& list, uint blocksCount )
+{
+   // detach the blocks from the thread's list first, so that we hold the lock only
+   // for the duration of the splice
+   FreeBlock* first = list.m_head;
+   FreeBlock* last = first;
+   for ( uint i = 1; i < blocksCount; ++i )
+   {
+      last = last->m_next;
+   }
+   list.m_head = last->m_next;
+   list.m_count -= blocksCount;
+
+   m_centralLock->enter();
+
+   FreeList& centralList = m_centralFreeLists[sizeClass];
+   last->m_next = centralList.m_head;
+   centralList.m_head = first;
+   centralList.m_count += blocksCount;
+
+   m_centralLock->leave();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ThreadCachingAllocator::allocateChunk( uint sizeClass )
+{
+   uint blockSize = sizeof( size_t ) + ( sizeClass + 1 ) * SIZE_CLASS_GRANULARITY;
+   uint blocksCount = CHUNK_SIZE / blockSize;
+   if ( blocksCount < BATCH_SIZE )
+   {
+      blocksCount = BATCH_SIZE;
+   }
+
+   Chunk* chunk = (Chunk*)::malloc( sizeof( Chunk ) + blocksCount * blockSize );
+   chunk->m_next = m_chunks;
+   m_chunks = chunk;
+
+   // carve the blocks out of the chunk and put them on the central list
+   FreeList& centralList = m_centralFreeLists[sizeClass];
+   char* blockAddr = (char*)( chunk + 1 );
+   for ( uint i = 0; i < blocksCount; ++i, blockAddr += blockSize )
+   {
+      FreeBlock* block = (FreeBlock*)blockAddr;
+      block->m_next = centralList.m_head;
+      centralList.m_head = block;
+   }
+   centralList.m_count += blocksCount;
+}
+
+///////////////////////////////////////////////////////////////////////////////
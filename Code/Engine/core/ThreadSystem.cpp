@@ -2,6 +2,7 @@
 #include "core\Singleton.h"
 #include "core\CriticalSection.h"
 #include "core\Thread.h"
+#include "core\MemoryRouter.h"
 #include <windows.h>
 
 
@@ -11,6 +12,11 @@ INIT_SINGLETON( ThreadSystem );
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Thread instance dedicated to the thread of execution that accesses this variable
+static __declspec( thread ) Thread*    g_currentThread = NULL;
+
+///////////////////////////////////////////////////////////////////////////////
+
 ThreadSystem::ThreadSystem( const SingletonConstruct& )
    : m_threadsLock( new CriticalSection() )
    , m_mainThread( new Thread() )
@@ -19,6 +25,7 @@ ThreadSystem::ThreadSystem( const SingletonConstruct& )
    m_mainThread->m_threadId = m_mainThreadId;
 
    m_threads.push_back( new ThreadEntry( m_mainThreadId, m_mainThread ) );
+   g_currentThread = m_mainThread;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -29,6 +36,11 @@ ThreadSystem::~ThreadSystem()
    ASSERT_MSG( m_threads.size() == 1 && m_threads[0]->m_thread == m_mainThread, "Some threads are still running" );
    m_threadsLock->leave();
 
+   if ( g_currentThread == m_mainThread )
+   {
+      g_currentThread = NULL;
+   }
+
    delete m_mainThread;
    m_mainThread = NULL;
 
@@ -56,9 +68,24 @@ uint ThreadSystem::getCoresCount() const
 
 Thread& ThreadSystem::getCurrentThread()
 {
-   Thread* thread = NULL;
-   DWORD threadId = GetCurrentThreadId();
+   Thread* thread = g_currentThread;
+   if ( !thread )
+   {
+      // the thread wasn't started by a Runnable ( or the system was created on another thread
+      // than the main one ) - look it up in the registry and cache it for the future
+      thread = findThread( GetCurrentThreadId() );
+      g_currentThread = thread;
+   }
+
+   ASSERT_MSG( thread != NULL, "No dedicated Thread instance is registered" );
+   return *thread;
+}
 
+///////////////////////////////////////////////////////////////////////////////
+
+Thread* ThreadSystem::findThread( ulong threadId ) const
+{
+   Thread* thread = NULL;
 
    m_threadsLock->enter();
 
@@ -75,8 +102,7 @@ Thread& ThreadSystem::getCurrentThread()
 
    m_threadsLock->leave();
 
-   ASSERT_MSG( thread != NULL, "No dedicated Thread instance is registered" );
-   return *thread;
+   return thread;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -89,6 +115,8 @@ void ThreadSystem::registerThread( Thread& thread )
    m_threadsLock->enter();
    m_threads.push_back( new ThreadEntry( threadId, &thread ) );
    m_threadsLock->leave();
+
+   g_currentThread = &thread;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -97,6 +125,7 @@ void ThreadSystem::registerThread( Thread& thread )
 void ThreadSystem::unregisterThread()
 {
    DWORD threadId = GetCurrentThreadId();
+   g_currentThread = NULL;
 
    m_threadsLock->enter();
 
@@ -111,6 +140,11 @@ void ThreadSystem::unregisterThread()
          m_threads.remove( i );
 
          m_threadsLock->leave();
+
+#ifdef _USE_THREAD_CACHING_ALLOCATOR
+         // give the memory the thread cached back to the other threads
+         TSingleton< MemoryRouter >::getInstance().m_threadCachingAllocator.releaseThreadCache();
+#endif
          return;
       }
    }
@@ -143,6 +143,8 @@ void GL2DLSystem::interpret( const std::string& processOutput, const FilePath& p
    const uint charsCount = processOutput.length();
    const uint bindingsCount = m_prefabBindings.size();
 
+   // request all prefabs first, so that they can be loaded in the background all at once
+   Array< TResourceLoadHandle< Prefab > > prefabLoads;
    for ( uint charIdx = 0; charIdx < charsCount; )
    {
       // compare the input against the rules that we have defined
@@ -156,21 +158,28 @@ void GL2DLSystem::interpret( const std::string& processOutput, const FilePath& p
             charIdx += offset;
 
             FilePath prefabsPath = prefabsDir + binding->m_replacement;
-            Prefab* prefab = resMgr.create< Prefab >( prefabsPath );
-            if ( prefab != NULL )
-            {
-               outPrefabsList.pushBack( prefab );
-            }
-            else
-            {
-               WARNING( "GL2DLSystem::interpret : Can't load prefab %s", prefabsPath.c_str() );
-            }
+            prefabLoads.push_back( resMgr.createAsync< Prefab >( prefabsPath ) );
 
             break;
          }
       }
    }
 
+   // collect the loaded prefabs
+   const uint prefabsCount = prefabLoads.size();
+   for ( uint i = 0; i < prefabsCount; ++i )
+   {
+      Prefab* prefab = resMgr.waitFor( prefabLoads[i] );
+      if ( prefab != NULL )
+      {
+         outPrefabsList.pushBack( prefab );
+      }
+      else
+      {
+         WARNING( "GL2DLSystem::interpret : Can't load prefab %s", prefabLoads[i].getRequest()->getResourcePath().c_str() );
+      }
+   }
+
 }
 
 
@@ -99,11 +99,11 @@ void AmbientOcclusionPass::render( Renderer& renderer, RenderTarget2D* gBuffer,
    settings.m_projParams.set( projMtx( 0, 0 ), projMtx( 1, 1 ), projMtx( 2, 2 ), projMtx( 3, 2 ) );
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setDepthBuffer( "g_DepthBuffer", gBuffer );
-   bindPS->setTexture( "g_TexRandom", m_randomTexture, m_randomTextureSampler );
-   bindPS->setTexture( "g_TexNormals", gBuffer, m_normalsBufferSampler, GBuf_Normals );
-   bindPS->setTexture( "g_TexAlbedo", gBuffer, m_normalsBufferSampler, GBuf_Albedo );
-   bindPS->setDataBuf( "Constants", m_constantsBuf );
+   bindPS->setDepthBuffer( IDSTR( "g_DepthBuffer" ), gBuffer );
+   bindPS->setTexture( IDSTR( "g_TexRandom" ), m_randomTexture, m_randomTextureSampler );
+   bindPS->setTexture( IDSTR( "g_TexNormals" ), gBuffer, m_normalsBufferSampler, GBuf_Normals );
+   bindPS->setTexture( IDSTR( "g_TexAlbedo" ), gBuffer, m_normalsBufferSampler, GBuf_Albedo );
+   bindPS->setDataBuf( IDSTR( "Constants" ), m_constantsBuf );
 
    new ( rcComm ) RCFullscreenQuad( renderer.getViewportWidth(), renderer.getViewportHeight() );
 
@@ -388,6 +388,13 @@ void DeferredRenderingMechanism::assignSelectionGroup( EntitiesGroup* group )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+const AnimationVisibilityProvider& DeferredRenderingMechanism::getMainSceneVisibility() const
+{
+   return *m_mainGeometryView;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void DeferredRenderingMechanism::render( Renderer& renderer )
 {
    // collect the renderables
@@ -345,13 +345,13 @@ void DirectionalLightRenderer::calculateDirectionalCascadeSegment( int cascadeId
 void DirectionalLightRenderer::renderDirectionalShadowMap( Renderer& renderer, RenderTarget2D* outShadowMap )
 {
    // render the shadow map using the visible geometry
-   RenderTree* renderTree = renderer.buildRenderTree( m_litGeometry );
+   RenderTree* renderTree = renderer.buildRenderTree( m_litGeometry, RP_ShadowMap );
    if ( renderTree )
    {
       MemoryAllocator* rtComm = renderer.rtComm();
 
       // activate the render targets we want to render to and clean it
-      renderTree->render( RP_ShadowMap );
+      renderTree->render();
 
       // get rid of the tree
       delete renderTree;
@@ -398,15 +398,15 @@ void DirectionalLightRenderer::renderCascade( Renderer& renderer, RenderTarget2D
    new ( rcComm ) RCActivateRenderTarget( outRenderTarget );
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setDepthBuffer( "g_DepthBuffer", gBuffer );
-   bindPS->setTexture( "g_Diffuse", gBuffer, m_textureSampler, GBuf_Albedo );
-   bindPS->setTexture( "g_Specular", gBuffer, m_textureSampler, GBuf_Specular );
-   bindPS->setTexture( "g_BRDF", gBuffer, m_textureSampler, GBuf_BRDF );
-   bindPS->setTexture( "g_Normals", gBuffer, m_textureSampler, GBuf_Normals );
-   bindPS->setTexture( "g_RoughnessLookup", m_roughnessLookup, m_textureSampler );
-   bindPS->setTexture( "g_NoiseMap", m_noiseMap, m_noiseMapSampler );
-   bindPS->setDepthBuffer( "g_ShadowMap", m_shadowMap );
-   bindPS->setDataBuf( "LightProperties", m_constantBuffer );
+   bindPS->setDepthBuffer( IDSTR( "g_DepthBuffer" ), gBuffer );
+   bindPS->setTexture( IDSTR( "g_Diffuse" ), gBuffer, m_textureSampler, GBuf_Albedo );
+   bindPS->setTexture( IDSTR( "g_Specular" ), gBuffer, m_textureSampler, GBuf_Specular );
+   bindPS->setTexture( IDSTR( "g_BRDF" ), gBuffer, m_textureSampler, GBuf_BRDF );
+   bindPS->setTexture( IDSTR( "g_Normals" ), gBuffer, m_textureSampler, GBuf_Normals );
+   bindPS->setTexture( IDSTR( "g_RoughnessLookup" ), m_roughnessLookup, m_textureSampler );
+   bindPS->setTexture( IDSTR( "g_NoiseMap" ), m_noiseMap, m_noiseMapSampler );
+   bindPS->setDepthBuffer( IDSTR( "g_ShadowMap" ), m_shadowMap );
+   bindPS->setDataBuf( IDSTR( "LightProperties" ), m_constantBuffer );
 
    new ( rcComm ) RCFullscreenQuad( renderer.getViewportWidth(), renderer.getViewportHeight() );
 
@@ -462,13 +462,13 @@ void DirectionalLightRenderer::renderWithoutShadow( Renderer& renderer, const Di
    new ( rcComm ) RCActivateRenderTarget( outRenderTarget );
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setDepthBuffer( "g_DepthBuffer", gBuffer );
-   bindPS->setTexture( "g_Diffuse", gBuffer, m_textureSampler, GBuf_Albedo );
-   bindPS->setTexture( "g_Specular", gBuffer, m_textureSampler, GBuf_Specular );
-   bindPS->setTexture( "g_BRDF", gBuffer, m_textureSampler, GBuf_BRDF );
-   bindPS->setTexture( "g_Normals", gBuffer, m_textureSampler, GBuf_Normals );
-   bindPS->setTexture( "g_RoughnessLookup", m_roughnessLookup, m_textureSampler );
-   bindPS->setDataBuf( "LightProperties", m_constantBuffer );
+   bindPS->setDepthBuffer( IDSTR( "g_DepthBuffer" ), gBuffer );
+   bindPS->setTexture( IDSTR( "g_Diffuse" ), gBuffer, m_textureSampler, GBuf_Albedo );
+   bindPS->setTexture( IDSTR( "g_Specular" ), gBuffer, m_textureSampler, GBuf_Specular );
+   bindPS->setTexture( IDSTR( "g_BRDF" ), gBuffer, m_textureSampler, GBuf_BRDF );
+   bindPS->setTexture( IDSTR( "g_Normals" ), gBuffer, m_textureSampler, GBuf_Normals );
+   bindPS->setTexture( IDSTR( "g_RoughnessLookup" ), m_roughnessLookup, m_textureSampler );
+   bindPS->setDataBuf( IDSTR( "LightProperties" ), m_constantBuffer );
 
    new ( rcComm ) RCFullscreenQuad( renderer.getViewportWidth(), renderer.getViewportHeight() );
 
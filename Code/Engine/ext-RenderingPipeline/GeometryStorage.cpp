@@ -3,7 +3,7 @@
 #include "core-Renderer\GeometryComponent.h"
 #include "core-MVC\Entity.h"
 #include "core-MVC\EntityUtils.h"
-#include "core\ListUtils.h"
+#include "core\PackedAxisAlignedBoxes.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -25,50 +25,53 @@ void GeometryStorage::queryForShadowMapping( const RPBoundingVolume& volume, Arr
 void GeometryStorage::query( const RPBoundingVolume& volume, bool shadowCasters, Array< GeometryComponent* >& outVisibleElems ) const
 {
    // preallocate certain size in order to avoid frequent reallocations
+   const uint firstResultIdx = outVisibleElems.size();
    {
       // at this moment we're making an assumption that all scene elements will be visible
-      uint newSize = outVisibleElems.size() + m_renderables.size();
+      uint newSize = firstResultIdx + m_renderables.size();
       outVisibleElems.allocate( newSize );
    }
 
-   for ( List< GeometryComponent* >::const_iterator it = m_renderables.begin(); !it.isEnd(); ++it )
+   // the tree culls entire regions of the scene, leaving us with the renderables that
+   // are close to the volume - test their bounds in a batch
+   m_renderables.queryCandidates( volume, outVisibleElems );
+
+   const uint candidatesCount = outVisibleElems.size() - firstResultIdx;
+   PackedAxisAlignedBoxes candidatesBounds( candidatesCount );
+   for ( uint i = 0; i < candidatesCount; ++i )
    {
-      GeometryComponent* renderable = *it;
+      candidatesBounds.push_back( outVisibleElems[firstResultIdx + i]->getBoundingVolume() );
+   }
 
-      // check the flags
-      if ( shadowCasters && !renderable->isShadowcaster() )
-      {
-         continue;
-      }
-      
-      const AxisAlignedBox& boundsWorldSpace = renderable->getBoundingVolume();
-      if ( volume.testIntersection( boundsWorldSpace ) )
+   Array< byte > visibility( candidatesCount );
+   visibility.resize( candidatesCount );
+   volume.testIntersections( candidatesBounds, visibility.getRaw() );
+
+   // keep only the visible renderables ( and only the ones that cast shadows, if that's what we're after )
+   uint resultsCount = firstResultIdx;
+   for ( uint i = 0; i < candidatesCount; ++i )
+   {
+      GeometryComponent* renderable = outVisibleElems[firstResultIdx + i];
+      if ( visibility[i] && ( !shadowCasters || renderable->isShadowcaster() ) )
       {
-         outVisibleElems.push_back( renderable );
+         outVisibleElems[resultsCount++] = renderable;
       }
    }
+   outVisibleElems.resize( resultsCount );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void GeometryStorage::insert( GeometryComponent* renderable )
 {
-   List< GeometryComponent* >::iterator it = ListUtils::find( m_renderables, renderable );
-   if ( it.isEnd() )
-   {
-      m_renderables.pushBack( renderable );
-   }
+   m_renderables.insert( *renderable );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void GeometryStorage::remove( GeometryComponent* renderable )
 {
-   List< GeometryComponent* >::iterator it = ListUtils::find( m_renderables, renderable );
-   if ( !it.isEnd() )
-   {
-      it.markForRemoval();
-   }
+   m_renderables.remove( *renderable );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -82,22 +85,21 @@ void GeometryStorage::clear()
 
 void GeometryStorage::getSceneBounds( AxisAlignedBox& outBounds )
 {
-   outBounds = m_sceneBounds;
+   m_renderables.getSceneBounds( outBounds );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void GeometryStorage::recalcSceneBounds()
+void GeometryStorage::update()
 {
-   m_sceneBounds.reset();
+   m_renderables.update();
+}
 
-   for ( List< GeometryComponent* >::iterator it = m_renderables.begin(); !it.isEnd(); ++it )
-   {
-      GeometryComponent* renderable = *it;
+///////////////////////////////////////////////////////////////////////////////
 
-      const AxisAlignedBox& boundsWorldSpace = renderable->getBoundingVolume();
-      m_sceneBounds.add( boundsWorldSpace, m_sceneBounds );
-   }
+void GeometryStorage::rebuild()
+{
+   m_renderables.rebuild();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -29,15 +29,45 @@ GeometryView::~GeometryView()
 
 GeometryArray* GeometryView::queryGeometry( const RPBoundingVolume& volume )
 {
+   // the renderables might have moved since the last frame
+   m_geometryStorage->update();
+
    m_visibleGeometry->m_collection.clear();
    m_geometryStorage->query( volume, m_visibleGeometry->m_collection );
-   m_geometryStorage->recalcSceneBounds();
+
+   // memorize which entities are visible - an entity is visible if any of its children is
+   m_visibleEntities.clear();
+   const uint count = m_visibleGeometry->m_collection.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      for ( const Entity* entity = m_visibleGeometry->m_collection[i]->getParent(); entity; entity = entity->getParent() )
+      {
+         if ( !m_visibleEntities.insert( entity ).second )
+         {
+            // the ancestors of this one are already there
+            break;
+         }
+      }
+   }
 
    return m_visibleGeometry;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool GeometryView::isVisible( const Entity* entity ) const
+{
+   if ( m_visibleEntities.find( entity ) != m_visibleEntities.end() )
+   {
+      return true;
+   }
+
+   // an entity without any geometry ( a pivot, a camera rig ) can't be culled, so it's always considered visible
+   return EntityUtils::getFirstChild< GeometryComponent >( entity ) == NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void GeometryView::onNodeAdded( SceneNode* node )
 {
    if ( node->isA< GeometryComponent >() )
@@ -68,6 +98,7 @@ void GeometryView::onAttachedToModel( Model& model )
 
    // populate the view with scene's contents
    model.pullStructure( this );
+   m_geometryStorage->rebuild();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -77,6 +108,7 @@ void GeometryView::onDetachedFromModel( Model& model )
    ModelView::onDetachedFromModel( model );
 
    m_geometryStorage->clear();
+   m_visibleEntities.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -113,6 +145,7 @@ void GeometryView::onAttachedToGroup( EntitiesGroup& group )
 
    // populate the view with scene's contents
    group.pullStructure( this );
+   m_geometryStorage->rebuild();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -122,6 +155,7 @@ void GeometryView::onDetachedFromGroup( EntitiesGroup& group )
    EntitiesGroupView::onDetachedFromGroup( group );
 
    m_geometryStorage->clear();
+   m_visibleEntities.clear();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -6,7 +6,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 LightsView::LightsView( const AxisAlignedBox& sceneBB )
-   : m_lightsStorage( new LinearStorage< Light >() )
+   : m_lightsStorage( new AABBTree< Light >() )
    , m_visibleLights( new LightsArray( 128 ) )
 {
 }
@@ -26,9 +26,11 @@ LightsView::~LightsView()
 
 LightsArray* LightsView::queryLights( const RPBoundingVolume& volume )
 {
+   // the lights might have moved since the last frame
+   m_lightsStorage->update();
+
    m_visibleLights->m_collection.clear();
    m_lightsStorage->query( volume, m_visibleLights->m_collection );
-   m_lightsStorage->recalcSceneBounds();
 
    return m_visibleLights;
 }
@@ -61,6 +63,7 @@ void LightsView::onAttachedToModel( Model& model )
 
    // populate the view with scene's contents
    model.pullStructure( this );
+   m_lightsStorage->rebuild();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -164,11 +164,11 @@ void PointLightRenderer::renderShadowMap( Renderer& renderer, const PointLight*
       {
          new ( rtComm ) RCActivateRenderTargetCube( m_shadowMap, cubeSideIdx );
          
-         RenderTree* renderTree = renderer.buildRenderTree( m_litGeometry );
+         RenderTree* renderTree = renderer.buildRenderTree( m_litGeometry, RP_ShadowMap );
          if ( renderTree )
          {
             // activate the render targets we want to render to and clean it
-            renderTree->render( RP_ShadowMap );
+            renderTree->render();
 
             // get rid of the tree
             delete renderTree;
@@ -244,15 +244,15 @@ void PointLightRenderer::renderLight( Renderer& renderer, const Shader* shader,
    new ( rcComm ) RCActivateRenderTarget( outRenderTarget );
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setDepthBuffer( "g_DepthBuffer", gBuffer );
-   bindPS->setTexture( "g_Diffuse", gBuffer, m_textureSampler, GBuf_Albedo );
-   bindPS->setTexture( "g_Specular", gBuffer, m_textureSampler, GBuf_Specular );
-   bindPS->setTexture( "g_BRDF", gBuffer, m_textureSampler, GBuf_BRDF );
-   bindPS->setTexture( "g_Normals", gBuffer, m_textureSampler, GBuf_Normals );
-   bindPS->setTexture( "g_RoughnessLookup", m_roughnessLookup, m_textureSampler );
-   bindPS->setTexture( "g_ShadowMap", m_shadowMap, m_textureSampler );
-   bindPS->setDataBuf( "VertexShaderConstants", m_vertexShaderConstants );
-   bindPS->setDataBuf( "LightProperties", m_fragmentShaderConstants );
+   bindPS->setDepthBuffer( IDSTR( "g_DepthBuffer" ), gBuffer );
+   bindPS->setTexture( IDSTR( "g_Diffuse" ), gBuffer, m_textureSampler, GBuf_Albedo );
+   bindPS->setTexture( IDSTR( "g_Specular" ), gBuffer, m_textureSampler, GBuf_Specular );
+   bindPS->setTexture( IDSTR( "g_BRDF" ), gBuffer, m_textureSampler, GBuf_BRDF );
+   bindPS->setTexture( IDSTR( "g_Normals" ), gBuffer, m_textureSampler, GBuf_Normals );
+   bindPS->setTexture( IDSTR( "g_RoughnessLookup" ), m_roughnessLookup, m_textureSampler );
+   bindPS->setTexture( IDSTR( "g_ShadowMap" ), m_shadowMap, m_textureSampler );
+   bindPS->setDataBuf( IDSTR( "VertexShaderConstants" ), m_vertexShaderConstants );
+   bindPS->setDataBuf( IDSTR( "LightProperties" ), m_fragmentShaderConstants );
 
    mesh->render( renderer );
 
@@ -37,6 +37,19 @@ BEGIN_ABSTRACT_OBJECT( RPBoundingVolume );
    PARENT( ReflectionObject );
 END_OBJECT();
 
+///////////////////////////////////////////////////////////////////////////////
+
+void RPBoundingVolume::testIntersections( const PackedAxisAlignedBoxes& boxes, byte* outResults ) const
+{
+   AxisAlignedBox box;
+   const uint count = boxes.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      boxes.get( i, box );
+      outResults[i] = testIntersection( box ) ? 1 : 0;
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -53,6 +66,13 @@ bool RPVolFrustum::testIntersection( const AxisAlignedBox& aab ) const
    return m_volume.isInside( aab );
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+void RPVolFrustum::testIntersections( const PackedAxisAlignedBoxes& boxes, byte* outResults ) const
+{
+   m_volume.cull( boxes, outResults );
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
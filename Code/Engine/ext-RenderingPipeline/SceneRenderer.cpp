@@ -54,14 +54,14 @@ void SceneRenderer::renderObjectPointers( Renderer& renderer, RenderTarget2D* ou
 void SceneRenderer::render( Renderer& renderer, RenderProfileId profile, RenderTarget2D* outTarget )
 {
    // build a tree sorting the nodes by the attributes
-   RenderTree* renderTree = renderer.buildRenderTree( *m_geometry );
+   RenderTree* renderTree = renderer.buildRenderTree( *m_geometry, profile );
    if ( renderTree )
    {
       MemoryAllocator* rtComm = renderer.rtComm();
 
       // activate the render targets we want to render to and clean it
       new ( rtComm ) RCActivateRenderTarget( outTarget );
-      renderTree->render( profile );
+      renderTree->render();
 
       // get rid of the tree
       delete renderTree;
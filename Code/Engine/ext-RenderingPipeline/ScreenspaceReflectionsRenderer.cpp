@@ -64,10 +64,10 @@ void ScreenspaceReflectionsRenderer::render( Renderer& renderer, RenderTarget2D*
    new ( rcComm ) RCActivateRenderTarget( outRenderTarget );
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setTexture( "g_Albedo", gBuffer, m_textureSampler, GBuf_Albedo );
-   bindPS->setTexture( "g_Normals", gBuffer, m_textureSampler, GBuf_Normals );
-   bindPS->setDepthBuffer( "g_Depth", gBuffer );
-   bindPS->setDataBuf( "Constants", m_constants );
+   bindPS->setTexture( IDSTR( "g_Albedo" ), gBuffer, m_textureSampler, GBuf_Albedo );
+   bindPS->setTexture( IDSTR( "g_Normals" ), gBuffer, m_textureSampler, GBuf_Normals );
+   bindPS->setDepthBuffer( IDSTR( "g_Depth" ), gBuffer );
+   bindPS->setDataBuf( IDSTR( "Constants" ), m_constants );
 
    new ( rcComm ) RCFullscreenQuad( renderer.getViewportWidth(), renderer.getViewportHeight() );
 
@@ -83,9 +83,9 @@ void SkyboxRenderer::render( class Renderer& renderer, RenderTarget2D* gBuffer,
    new ( rcComm ) RCActivateRenderTarget( outRenderTarget );
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setDataBuf( "Constants", m_constantsBuf );
-   bindPS->setTexture( "g_Tex1", m_renderTexture, m_cubeMapSamplerSettings );
-   bindPS->setTexture( "g_Albedo", gBuffer, m_albedoSamplerSettings, GBuf_Albedo );
+   bindPS->setDataBuf( IDSTR( "Constants" ), m_constantsBuf );
+   bindPS->setTexture( IDSTR( "g_Tex1" ), m_renderTexture, m_cubeMapSamplerSettings );
+   bindPS->setTexture( IDSTR( "g_Albedo" ), gBuffer, m_albedoSamplerSettings, GBuf_Albedo );
 
    mesh->render( renderer );
 
@@ -173,11 +173,11 @@ void SpotLightRenderer::renderShadowMap( Renderer& renderer, const SpotLight* li
       CHANGE_RENDER_STATE( renderer, RSSetBlending( false ) );
 
       renderer.pushCamera( lightCamera );
-      RenderTree* renderTree = renderer.buildRenderTree( m_litGeometry );
+      RenderTree* renderTree = renderer.buildRenderTree( m_litGeometry, RP_ShadowMap );
       if ( renderTree )
       {
          // activate the render targets we want to render to and clean it
-         renderTree->render( RP_ShadowMap );
+         renderTree->render();
 
          // get rid of the tree
          delete renderTree;
@@ -249,15 +249,15 @@ void SpotLightRenderer::renderLight( Renderer& renderer, const SpotLight* light,
    new ( rcComm ) RCActivateRenderTarget( outRenderTarget );
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setDepthBuffer( "g_DepthBuffer", gBuffer );
-   bindPS->setTexture( "g_Diffuse", gBuffer, m_textureSampler, GBuf_Albedo );
-   bindPS->setTexture( "g_Specular", gBuffer, m_textureSampler, GBuf_Specular );
-   bindPS->setTexture( "g_BRDF", gBuffer, m_textureSampler, GBuf_BRDF );
-   bindPS->setTexture( "g_Normals", gBuffer, m_textureSampler, GBuf_Normals );
-   bindPS->setTexture( "g_RoughnessLookup", m_roughnessLookup, m_textureSampler );
-   bindPS->setDepthBuffer( "g_ShadowMap", m_shadowMap );
-   bindPS->setDataBuf( "VertexShaderConstants", m_vertexShaderConstants );
-   bindPS->setDataBuf( "LightProperties", m_fragmentShaderConstants );
+   bindPS->setDepthBuffer( IDSTR( "g_DepthBuffer" ), gBuffer );
+   bindPS->setTexture( IDSTR( "g_Diffuse" ), gBuffer, m_textureSampler, GBuf_Albedo );
+   bindPS->setTexture( IDSTR( "g_Specular" ), gBuffer, m_textureSampler, GBuf_Specular );
+   bindPS->setTexture( IDSTR( "g_BRDF" ), gBuffer, m_textureSampler, GBuf_BRDF );
+   bindPS->setTexture( IDSTR( "g_Normals" ), gBuffer, m_textureSampler, GBuf_Normals );
+   bindPS->setTexture( IDSTR( "g_RoughnessLookup" ), m_roughnessLookup, m_textureSampler );
+   bindPS->setDepthBuffer( IDSTR( "g_ShadowMap" ), m_shadowMap );
+   bindPS->setDataBuf( IDSTR( "VertexShaderConstants" ), m_vertexShaderConstants );
+   bindPS->setDataBuf( IDSTR( "LightProperties" ), m_fragmentShaderConstants );
 
    // prepare the mesh
    RCRenderProceduralMesh* procMesh = new ( rcComm ) RCRenderProceduralMesh( renderer, 8, SPOT_LIGHT_MESH_FACES_COUNT );
@@ -74,9 +74,9 @@ void TexturesBlender::blendByColor( Renderer& renderer, ShaderTexture* tex1, Sha
 
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setTexture( "g_Tex1", tex2, m_samplerSettings );
-   bindPS->setTexture( "g_Tex2", tex1, m_samplerSettings );
-   bindPS->setDataBuf( "Constants", m_constantsBuf );
+   bindPS->setTexture( IDSTR( "g_Tex1" ), tex2, m_samplerSettings );
+   bindPS->setTexture( IDSTR( "g_Tex2" ), tex1, m_samplerSettings );
+   bindPS->setDataBuf( IDSTR( "Constants" ), m_constantsBuf );
 
    new ( rcComm ) RCFullscreenQuad( renderer.getViewportWidth(), renderer.getViewportHeight() );
 
@@ -110,9 +110,9 @@ void TexturesBlender::blendByAlpha( Renderer& renderer, ShaderTexture* tex1, Sha
 
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setTexture( "g_Tex1", tex2, m_samplerSettings );
-   bindPS->setTexture( "g_Tex2", tex1, m_samplerSettings );
-   bindPS->setDataBuf( "Constants", m_constantsBuf );
+   bindPS->setTexture( IDSTR( "g_Tex1" ), tex2, m_samplerSettings );
+   bindPS->setTexture( IDSTR( "g_Tex2" ), tex1, m_samplerSettings );
+   bindPS->setDataBuf( IDSTR( "Constants" ), m_constantsBuf );
 
    new ( rcComm ) RCFullscreenQuad( renderer.getViewportWidth(), renderer.getViewportHeight() );
 
@@ -141,7 +141,7 @@ void TexturesBlender::blur( class Renderer& renderer, ShaderTexture* inTex, Rend
    new ( rcComm ) RCActivateRenderTarget( outRenderTarget );
 
    RCBindShader* bindPS = new ( rcComm ) RCBindShader( shader, renderer );
-   bindPS->setTexture( "g_Tex", inTex, m_samplerSettings );
+   bindPS->setTexture( IDSTR( "g_Tex" ), inTex, m_samplerSettings );
 
    new ( rcComm ) RCFullscreenQuad( renderer.getViewportWidth(), renderer.getViewportHeight() );
 
@@ -13,7 +13,7 @@ void RCRenderTriangleMesh::execute( Renderer& renderer )
    GLRTriangleMesh* mesh = glRenderer->getTriangleMesh( m_mesh );
    if ( mesh )
    {
-      mesh->render();
+      mesh->render( m_instancesCount );
    }
 }
 
@@ -162,13 +162,20 @@ void GLRTriangleMesh::refresh()
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void GLRTriangleMesh::render()
+void GLRTriangleMesh::render( uint instancesCount )
 {
    // bind the vertex array
    glBindVertexArray( m_vaoID );
 
    // draw the mesh
-   glDrawElements( GL_TRIANGLES, m_facesCount * 3, GL_UNSIGNED_SHORT, 0 );
+   if ( instancesCount > 1 )
+   {
+      glDrawElementsInstanced( GL_TRIANGLES, m_facesCount * 3, GL_UNSIGNED_SHORT, 0, instancesCount );
+   }
+   else
+   {
+      glDrawElements( GL_TRIANGLES, m_facesCount * 3, GL_UNSIGNED_SHORT, 0 );
+   }
    GLR_LOG_ERRORS();
 }
 
@@ -14,6 +14,8 @@
 // ----------------------------------------------------------------------------
 #include "core-AI\AnimationPlayer.h"
 #include "core-AI\AnimationWorld.h"
+#include "core-AI\AnimationLODManager.h"
+#include "core-AI\AnimationPoseCache.h"
 // ----------------------------------------------------------------------------
 // -->SkeletalAnimation
 // ----------------------------------------------------------------------------
@@ -28,6 +30,7 @@
 // ----------------------------------------------------------------------------
 // -->Utils
 // ----------------------------------------------------------------------------
+#include "core-AI\PackedPose.h"
 #include "core-AI\PoseBlendingUtils.h"
 #include "core-AI\SkeletonPoseTool.h"
 
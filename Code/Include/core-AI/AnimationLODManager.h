@@ -0,0 +1,175 @@
+/// @file   core-AI/AnimationLODManager.h
+/// @brief  decides how often the animation players get sampled
+#pragma once
+
+#include "core\MemoryRouter.h"
+#include "core\Vector.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class AnimationPlayer;
+class Entity;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * How often are the poses of an animation player sampled.
+ */
+enum AnimationUpdateRate
+{
+   AUR_EveryFrame,
+   AUR_Every2ndFrame,
+   AUR_Every4thFrame,
+   AUR_Paused,                // the player doesn't advance at all
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Level of detail related runtime data of an animation player.
+ */
+struct AnimationLODState
+{
+   DECLARE_ALLOCATOR( AnimationLODState, AM_DEFAULT );
+
+   AnimationUpdateRate     m_updateRate;
+   uint                    m_staggerOffset;           // moves the frames the player is sampled in, so that the players with the same update rate don't all get sampled in the same frame
+   uint                    m_samplesCount;            // how many times was the player sampled since it was started ( we only care if it's less than 2 )
+   float                   m_timeSinceSample;         // the time that passed since the player was last sampled
+   uint                    m_framesSinceSample;
+
+   // the decision made for the current frame
+   bool                    m_sampleThisFrame;
+   float                   m_timeToSample;            // time the player should advance by, if it's sampled this frame
+   float                   m_interpolationProgress;   // how far between the last two sampled poses the displayed pose should be
+
+   /**
+    * Constructor.
+    */
+   AnimationLODState();
+
+   /**
+    * Resets the runtime data ( the stagger offset is kept ).
+    */
+   void reset();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Tells the level of detail manager which of the animated entities are visible.
+ */
+class AnimationVisibilityProvider
+{
+public:
+   virtual ~AnimationVisibilityProvider() {}
+
+   /**
+    * Tells if the specified entity ( or any of its children ) was visible the last time the visibility was tested.
+    *
+    * @param entity
+    */
+   virtual bool isVisible( const Entity* entity ) const = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Decides how often the animation players get sampled.
+ *
+ * The players are assigned to update rate buckets depending on how far from the viewpoint ( the active camera )
+ * the entities they animate are, and whether they are visible or not. The players that are further away
+ * are sampled every 2nd or every 4th frame, and the ones that are off screen are paused. A paused player
+ * is sampled as soon as it's back on screen.
+ *
+ * The frames the players are sampled in are staggered, so that the players with the same update rate don't
+ * all get sampled in the same frame, and the frames that aren't sampled interpolate between the last
+ * two sampled poses ( see AnimationPlayer::interpolatePoses ).
+ *
+ * The manager is disabled by default - all players are then sampled every frame.
+ */
+class AnimationLODManager
+{
+   DECLARE_ALLOCATOR( AnimationLODManager, AM_ALIGNED_16 );
+
+private:
+   Vector                              m_viewpoint;
+   float                               m_everyFrameDistanceSq;
+   float                               m_every2ndFrameDistanceSq;
+   const AnimationVisibilityProvider*  m_visibilityProvider;
+   bool                                m_enabled;
+
+   uint                                m_frameIdx;
+   uint                                m_nextStaggerOffset;
+
+public:
+   /**
+    * Constructor.
+    */
+   AnimationLODManager();
+
+   /**
+    * Turns the level of detail management on or off.
+    *
+    * @param enable
+    */
+   inline void setEnabled( bool enable ) { m_enabled = enable; }
+
+   /**
+    * Tells if the level of detail management is on.
+    */
+   inline bool isEnabled() const { return m_enabled; }
+
+   /**
+    * Sets the position the distances to the animated entities are measured from - the position
+    * of the active camera. Update it every frame.
+    *
+    * @param position
+    */
+   inline void setViewpoint( const Vector& position ) { m_viewpoint = position; }
+
+   /**
+    * Sets the distances at which the players' update rates drop.
+    *
+    * @param everyFrameDistance       players closer than that are sampled every frame
+    * @param every2ndFrameDistance    players closer than that are sampled every 2nd frame, and the ones further away - every 4th frame
+    */
+   void setDistances( float everyFrameDistance, float every2ndFrameDistance );
+
+   /**
+    * Sets the source of the visibility information. If none is set, all entities are considered visible.
+    *
+    * @param provider
+    */
+   inline void setVisibilityProvider( const AnimationVisibilityProvider* provider ) { m_visibilityProvider = provider; }
+
+   /**
+    * Starts a new frame.
+    */
+   void nextFrame();
+
+   /**
+    * Assigns a stagger offset to a player that was just added to the world.
+    *
+    * @param player
+    */
+   void registerPlayer( AnimationPlayer& player );
+
+   /**
+    * Decides if the player should be sampled this frame, and updates its LOD state.
+    *
+    * @param player
+    * @param timeElapsed
+    */
+   void updatePlayer( AnimationPlayer& player, float timeElapsed ) const;
+
+   /**
+    * Calculates the update rate the player should use.
+    *
+    * @param player
+    */
+   AnimationUpdateRate calcUpdateRate( const AnimationPlayer& player ) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -3,12 +3,29 @@
 #pragma once
 
 #include "core-MVC\Component.h"
+#include "core-AI\AnimationLODManager.h"
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+class AnimationPoseCache;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
  * Base class for all animation players.
+ *
+ * An animation frame consists of three stages:
+ *   - onFrameStart is called for all players that are sampled this frame, one after another
+ *   - samplePoses is called for all players in parallel ( see AnimationWorld::tickAnimations )
+ *   - onFrameEnd is called for all players, one after another, in the order they were added to the world
+ *
+ * So samplePoses may only modify the data the player owns. Anything that can be seen by the other
+ * players or the rest of the scene - the transforms of the animated entities, listener notifications
+ * and such - needs to be deferred until onFrameEnd.
+ *
+ * Depending on the player's level of detail ( see AnimationLODManager ), samplePoses may not be called
+ * every frame - interpolatePoses is called in the frames it's skipped in.
  */
 class AnimationPlayer : public Component
 {
@@ -17,7 +34,9 @@ class AnimationPlayer : public Component
 
 private:
    // runtime data
-   bool        m_isPlaying;
+   bool                 m_isPlaying;
+   AnimationLODState    m_lodState;
+   AnimationPoseCache*  m_poseCache;
 
 public:
    /**
@@ -57,22 +76,62 @@ public:
    // AI frame
    // -------------------------------------------------------------------------
    /**
-    * Called when the frame starts.
+    * Called when a frame the player's poses are sampled in starts - the frames
+    * the sampling is skipped in ( see AnimationLODManager ) don't start it.
     */
    virtual void onFrameStart() {}
 
    /**
     * Samples animation poses.
     *
+    * The method runs concurrently with the samplePoses methods of the other players.
+    *
     * @param timeElapsed
     */
    virtual void samplePoses( float deltaTime ) {}
 
    /**
-    * Called when the frame ends.
+    * Called in the frames the sampling was skipped in, as well as after samplePoses if the player
+    * is not sampled every frame. Shows a pose in between the last two sampled poses.
+    *
+    * The method runs concurrently with the samplePoses methods of the other players.
+    * The default implementation keeps the last sampled pose.
+    *
+    * @param progress      ( 0 .. 1 ) - 0 means the pose before the last one, 1 - the last one
+    * @param timeElapsed   time that passed since the last frame
+    */
+   virtual void interpolatePoses( float progress, float timeElapsed ) {}
+
+   /**
+    * Called when the frame ends. Publishes the results of the sampling.
     */
    virtual void onFrameEnd() {}
 
+   // -------------------------------------------------------------------------
+   // Level of detail
+   // -------------------------------------------------------------------------
+   /**
+    * Returns the level of detail runtime data of the player.
+    */
+   inline const AnimationLODState& getLODState() const { return m_lodState; }
+   inline AnimationLODState& accessLODState() { return m_lodState; }
+
+   // -------------------------------------------------------------------------
+   // Pose cache
+   // -------------------------------------------------------------------------
+   /**
+    * Sets the cache the player should sample the animation clips through ( see AnimationPoseCache ).
+    *
+    * @param poseCache
+    */
+   inline void setPoseCache( AnimationPoseCache* poseCache ) { m_poseCache = poseCache; }
+
+   /**
+    * Returns the cache the player should sample the animation clips through, or NULL
+    * if the clips should be sampled directly.
+    */
+   inline AnimationPoseCache* getPoseCache() const { return m_poseCache; }
+
 protected:
    // -------------------------------------------------------------------------
    // Simulation stage notifications
@@ -0,0 +1,169 @@
+/// @file   core-AI/AnimationPoseCache.h
+/// @brief  a per-frame cache of the poses sampled from the animation clips
+#pragma once
+
+#include "core\MemoryRouter.h"
+#include "core\Array.h"
+#include "core\Atomic.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SnapshotAnimation;
+class Skeleton;
+class CriticalSection;
+struct Transform;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A per-frame cache of the poses sampled from the animation clips.
+ *
+ * In crowd scenes many players play the same clip at the same phase. The cache makes sure
+ * such a pose is sampled only once per frame - the other players that request it get a copy.
+ *
+ * The poses are identified by the clip, the skeleton they are sampled for and the track time.
+ * The track time is quantized ( see setTimeQuantum ), and the poses are sampled at the quantized
+ * time, so that the players whose phases differ only slightly share the same pose - and get
+ * the same pose no matter which one of them sampled it first.
+ *
+ * The cache is used by the players sampled in parallel, so it's thread safe. Its contents are
+ * discarded when a new frame starts ( see nextFrame ) - but the memory isn't, so that a frame
+ * doesn't cost any allocations once the cache has warmed up.
+ *
+ * The cache is disabled by default - the poses are then sampled straight from the clips.
+ */
+class AnimationPoseCache
+{
+   DECLARE_ALLOCATOR( AnimationPoseCache, AM_DEFAULT );
+
+private:
+   struct Key
+   {
+      const SnapshotAnimation*      m_animation;
+      const Skeleton*               m_skeleton;
+      int                           m_timeIdx;
+
+      bool operator==( const Key& rhs ) const;
+      uint getHash() const;
+   };
+
+   struct Entry
+   {
+      DECLARE_ALLOCATOR( Entry, AM_DEFAULT );
+
+      Key                           m_key;
+      Array< Transform >            m_pose;
+      bool                          m_ready;       // set once the pose is sampled - until then it's being sampled by one of the players
+   };
+
+   bool                             m_enabled;
+   float                            m_timeQuantum;
+   uint                             m_maxEntriesCount;
+
+   CriticalSection*                 m_lock;
+   Array< Entry* >                  m_entriesTable;   // an open addressing table of the entries used this frame, kept at most half full
+   Array< Entry* >                  m_entries;        // entries are reused from frame to frame
+   uint                             m_usedEntriesCount;
+
+   // statistics of the current frame
+   AtomicInt                        m_hitsCount;
+   AtomicInt                        m_missesCount;
+
+public:
+   /**
+    * Constructor.
+    */
+   AnimationPoseCache();
+   ~AnimationPoseCache();
+
+   /**
+    * Turns the cache on or off.
+    *
+    * @param enable
+    */
+   inline void setEnabled( bool enable ) { m_enabled = enable; }
+
+   /**
+    * Tells if the cache is on.
+    */
+   inline bool isEnabled() const { return m_enabled; }
+
+   /**
+    * Sets the resolution of the track time the poses are cached with.
+    *
+    * @param quantum    time ( in seconds )
+    */
+   void setTimeQuantum( float quantum );
+
+   /**
+    * Returns the resolution of the track time the poses are cached with.
+    */
+   inline float getTimeQuantum() const { return m_timeQuantum; }
+
+   /**
+    * Sets the maximum number of poses cached in a single frame. The poses requested
+    * once the limit is reached are sampled straight from the clips.
+    *
+    * Mustn't be called while the poses are being sampled.
+    *
+    * @param count
+    */
+   void setMaxEntriesCount( uint count );
+
+   /**
+    * Discards the poses cached in the previous frame and resets the statistics.
+    *
+    * Mustn't be called while the poses are being sampled.
+    */
+   void nextFrame();
+
+   /**
+    * Samples a pose of the specified clip, or copies it if it's already been sampled this frame.
+    *
+    * @param animation
+    * @param skeleton               skeleton the pose is sampled for
+    * @param trackTime
+    * @param outBoneLocalTransforms
+    * @param bonesCount
+    */
+   void samplePose( const SnapshotAnimation& animation, const Skeleton* skeleton, float trackTime, Transform* outBoneLocalTransforms, uint bonesCount );
+
+   /**
+    * Returns the number of poses that were copied from the cache this frame.
+    */
+   inline uint getHitsCount() const { return (uint)m_hitsCount.get(); }
+
+   /**
+    * Returns the number of poses that had to be sampled this frame.
+    */
+   inline uint getMissesCount() const { return (uint)m_missesCount.get(); }
+
+   /**
+    * Returns the ratio of the poses that were copied from the cache this frame to all requested poses.
+    */
+   float getHitRate() const;
+
+private:
+   /**
+    * Returns an unused entry, or NULL if the limit of entries has been reached.
+    * Call it only when the cache is locked.
+    */
+   Entry* allocateEntry();
+
+   /**
+    * Looks for an entry used this frame. Call it only when the cache is locked.
+    *
+    * @param key
+    */
+   Entry* findEntry( const Key& key ) const;
+
+   /**
+    * Adds an entry to the entries table. Call it only when the cache is locked.
+    *
+    * @param entry
+    */
+   void insertEntry( Entry* entry );
+};
+
+///////////////////////////////////////////////////////////////////////////////
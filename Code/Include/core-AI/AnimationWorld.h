@@ -3,8 +3,11 @@
 #pragma once
 
 #include "core-MVC\ModelView.h"
+#include "core-AI\AnimationLODManager.h"
+#include "core-AI\AnimationPoseCache.h"
 #include "core\MemoryRouter.h"
 #include "core\List.h"
+#include "core\Array.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -13,13 +16,32 @@ class AnimationPlayer;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * A model view that gathers all animation players attached to a scene in order to tick them.
+ *
+ * The players don't depend on one another, so their poses are sampled in parallel, as jobs
+ * of the MultithreadedTasksScheduler. Everything else - starting and stopping the players,
+ * and publishing the sampled poses ( see AnimationPlayer::onFrameEnd ) - happens on the calling
+ * thread, in the order the players were added in. A serial update can still be requested
+ * using 'setParallelUpdates'.
+ *
+ * How often the individual players are sampled is decided by the level of detail manager
+ * ( see AnimationLODManager ). The players that play the same clips share the poses sampled
+ * from them through the world's pose cache ( see AnimationPoseCache ).
+ */
 class AnimationWorld : public ModelView
 {
-   DECLARE_ALLOCATOR( AnimationWorld, AM_DEFAULT );
+   DECLARE_ALLOCATOR( AnimationWorld, AM_ALIGNED_16 );
    
 private:
    List< AnimationPlayer* >      m_players;
    bool                          m_playing;
+   bool                          m_parallelUpdates;
+   AnimationLODManager           m_lodManager;
+   AnimationPoseCache            m_poseCache;
+
+   // players ticked this frame
+   Array< AnimationPlayer* >     m_activePlayers;
 
 public:
    /**
@@ -40,6 +62,28 @@ public:
     */
    void play( bool flag );
 
+   /**
+    * Toggles the parallel sampling of the players' poses.
+    *
+    * @param enable
+    */
+   inline void setParallelUpdates( bool enable ) { m_parallelUpdates = enable; }
+
+   /**
+    * Tells if the poses are sampled on multiple threads.
+    */
+   inline bool areUpdatesParallel() const { return m_parallelUpdates; }
+
+   /**
+    * Gives access to the level of detail manager.
+    */
+   inline AnimationLODManager& accessLODManager() { return m_lodManager; }
+
+   /**
+    * Gives access to the cache of the poses sampled from the animation clips.
+    */
+   inline AnimationPoseCache& accessPoseCache() { return m_poseCache; }
+
    /**
     * Updates registered animation players.
     *
@@ -57,8 +101,11 @@ public:
    void resetContents( Model& model );
 
 private:
+   struct PosesSampler;
+
    void simulationStarted();
    void simulationFinished();
+   void profilePoseCache() const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -56,6 +56,12 @@ private:
    RuntimeDataBuffer*                        m_runtimeData;
    SkeletonMapperRuntime*                    m_skeletonMapperRuntime;
 
+   // level of detail - the poses are interpolated between the last two samples when the player isn't sampled every frame
+   Array< Transform >                        m_prevFinalSourcePose;
+   Array< Transform >                        m_interpolatedSourcePose;
+   Transform                                 m_sampledMotion;
+   float                                     m_sampledTimeElapsed;
+
    // ------------------------------------------
    // Events
 
@@ -69,6 +75,29 @@ private:
    uint                                      m_eventsWriteFrameOffset;
    // ------------------------------------------
 
+   // ------------------------------------------
+   // Listener notifications
+
+   // The poses of the players are sampled in parallel, so the notifications issued
+   // while sampling are queued and sent out once the frame ends
+   enum NotificationType
+   {
+      NT_NodeStateChanged,
+      NT_EventTriggered,
+      NT_SyncPointReached,
+   };
+
+   struct Notification
+   {
+      NotificationType                       m_type;
+      const BlendTreeNode*                   m_node;
+      const BlendTreeEvent*                  m_event;
+   };
+
+   bool                                      m_sampling;
+   Array< Notification >                     m_pendingNotifications;
+   // ------------------------------------------
+
 public:
    /**
     * Constructor.
@@ -162,6 +191,21 @@ public:
     */
    void pullStructure( BlendTreePlayerListener* listener );
 
+   /**
+    * Informs the listeners that a node changed its runtime state.
+    *
+    * @param node
+    */
+   void notifyNodeStateChanged( const BlendTreeNode* node );
+
+   /**
+    * Informs the listeners that a node reached a synchronization point.
+    *
+    * @param node
+    * @param syncPoint
+    */
+   void notifySyncPointReached( const BlendTreeNode* node, const BlendTreeEvent* syncPoint );
+
    // -------------------------------------------------------------------------
    // Events
    // -------------------------------------------------------------------------
@@ -186,6 +230,7 @@ public:
    bool isEnabled() const override;
    void onFrameStart() override;
    void samplePoses( float deltaTime ) override;
+   void interpolatePoses( float progress, float timeElapsed ) override;
    void onFrameEnd() override;
    void onStarted() override;
    void onFinished() override;
@@ -235,6 +280,9 @@ private:
    void initializeEventsArray();
    void cacheTransforms();
    void restoreTransforms();
+   void applyPose( const Transform* sourcePose );
+   void notifyListeners( NotificationType type, const BlendTreeNode* node, const BlendTreeEvent* btEvent );
+   void sendNotification( const Notification& notification );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -4,6 +4,7 @@
 
 #include "core-AI\AnimationPlayer.h"
 #include "core\Matrix.h"
+#include "core\Transform.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -29,6 +30,7 @@ private:
    Entity*                                   m_animatedEntity;
 
    float                                     m_trackTime;
+   Transform                                 m_motionDelta;
  
 public:
    /**
@@ -68,6 +70,7 @@ public:
    // ----------------------------------------------------------------------
    bool isEnabled() const;
    void samplePoses( float deltaTime );
+   void onFrameEnd();
    void onStarted();
    void onFinished();
 
@@ -0,0 +1,128 @@
+/// @file   core-AI/PackedPose.h
+/// @brief  a skeleton pose stored in a SIMD friendly layout
+#pragma once
+
+#include "core\MemoryRouter.h"
+#include "core\MathDataStorage.h"
+#include "core\Array.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct Transform;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A skeleton pose stored in a SIMD friendly layout.
+ *
+ * The bone transforms are packed in quads - each quad stores the transforms of 4 bones,
+ * one quad storage per component ( structure of arrays ). That allows the blending kernels
+ * ( see PoseBlendingUtils ) to process 4 bones at a time.
+ *
+ * The last quad may be only partially filled - its unused lanes contain identity transforms.
+ */
+class PackedPose
+{
+   DECLARE_ALLOCATOR( PackedPose, AM_DEFAULT );
+
+public:
+   struct Quad
+   {
+      DECLARE_ALLOCATOR( Quad, AM_ALIGNED_16 );
+
+      QuadStorage       m_rotation[4];       // x, y, z and w components of the rotations of 4 bones
+      QuadStorage       m_translation[3];    // x, y and z components of the translations of 4 bones
+
+      /**
+       * Resets all 4 lanes to identity transforms.
+       */
+      void setIdentity();
+
+      /**
+       * Stores a transform in the specified lane.
+       *
+       * @param lane
+       * @param transform
+       */
+      void setTransform( uint lane, const Transform& transform );
+
+      /**
+       * Returns a transform stored in the specified lane.
+       *
+       * @param lane
+       * @param outTransform
+       */
+      void getTransform( uint lane, Transform& outTransform ) const;
+   };
+
+private:
+   Array< Quad >        m_quads;
+   uint                 m_bonesCount;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param bonesCount
+    */
+   PackedPose( uint bonesCount = 0 );
+
+   /**
+    * Changes the number of bones in the pose. All bones are reset to identity transforms.
+    *
+    * @param bonesCount
+    */
+   void resize( uint bonesCount );
+
+   /**
+    * Returns the number of bones in the pose.
+    */
+   inline uint size() const { return m_bonesCount; }
+
+   /**
+    * Returns the number of quads the bones are packed in.
+    */
+   inline uint getQuadsCount() const { return m_quads.size(); }
+
+   /**
+    * Returns a quad with the specified index.
+    *
+    * @param idx
+    */
+   inline const Quad& getQuad( uint idx ) const { return m_quads[idx]; }
+   inline Quad& getQuad( uint idx ) { return m_quads[idx]; }
+
+   /**
+    * Replaces a transform of the specified bone.
+    *
+    * @param boneIdx
+    * @param transform
+    */
+   void set( uint boneIdx, const Transform& transform );
+
+   /**
+    * Returns a transform of the specified bone.
+    *
+    * @param boneIdx
+    * @param outTransform
+    */
+   void get( uint boneIdx, Transform& outTransform ) const;
+
+   /**
+    * Packs a pose stored as an array of transforms. The pose is resized to fit it.
+    *
+    * @param pose
+    * @param bonesCount
+    */
+   void pack( const Transform* pose, uint bonesCount );
+
+   /**
+    * Unpacks the pose to an array of transforms.
+    *
+    * @param outPose    an array of transforms, size() long
+    */
+   void unpack( Transform* outPose ) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -6,6 +6,11 @@
 #include "core\MemoryRouter.h"
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+class PackedPose;
+
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct TimeBasedSynchroData
@@ -31,6 +36,9 @@ public:
    /**
     * Blends to poses together.
     *
+    * The poses are transposed to the packed layout 4 bones at a time on the fly, and blended
+    * using the same kernel the packed version of the method uses.
+    *
     * @param blendWeight      a value in range ( 0 .. 1 )
     * @param sourcePose
     * @param targetPose
@@ -39,6 +47,46 @@ public:
     */
    static void blend( const FastFloat& blendWeight, const Transform* sourcePose, const Transform* targetPose, uint bonesCount, Transform* outBlendedPose );
 
+   // -------------------------------------------------------------------------
+   // Packed poses kernels - they process 4 bones at a time
+   // -------------------------------------------------------------------------
+
+   /**
+    * Blends two poses together, spherically interpolating the rotations.
+    * The results match the ones of Transform::setSlerp.
+    *
+    * @param blendWeight      a value in range ( 0 .. 1 )
+    * @param sourcePose
+    * @param targetPose
+    * @param outBlendedPose   resulting pose will be stored here ( may be one of the input poses )
+    */
+   static void blend( const FastFloat& blendWeight, const PackedPose& sourcePose, const PackedPose& targetPose, PackedPose& outBlendedPose );
+
+   /**
+    * Blends two poses together, linearly interpolating and normalizing the rotations.
+    * Faster than 'blend', but less accurate - the results match the ones of Transform::setNlerp.
+    *
+    * @param blendWeight      a value in range ( 0 .. 1 )
+    * @param sourcePose
+    * @param targetPose
+    * @param outBlendedPose   resulting pose will be stored here ( may be one of the input poses )
+    */
+   static void nlerp( const FastFloat& blendWeight, const PackedPose& sourcePose, const PackedPose& targetPose, PackedPose& outBlendedPose );
+
+   /**
+    * Applies an additive pose on top of a base pose.
+    *
+    * The additive rotations are scaled by the weight ( an nlerp from identity, along the shorter arc )
+    * and combined with the base ones as in Quaternion::setMul( additive, base ). The weighted
+    * additive translations are simply added to the base ones.
+    *
+    * @param blendWeight      a value in range ( 0 .. 1 )
+    * @param basePose
+    * @param additivePose
+    * @param outPose          resulting pose will be stored here ( may be one of the input poses )
+    */
+   static void addAdditive( const FastFloat& blendWeight, const PackedPose& basePose, const PackedPose& additivePose, PackedPose& outPose );
+
    /**
     * Calculates a synchronization solution that will allow to line up clips so that they hit the specified
     * event at the same time.
@@ -4,6 +4,7 @@
 
 #include "core-AI\AnimationPlayer.h"
 #include "core\Matrix.h"
+#include "core\Transform.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -11,7 +12,6 @@
 class SnapshotAnimation;
 class SkeletonComponent;
 class Entity;
-struct Transform;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -33,6 +33,7 @@ private:
    Transform*                                m_tmpBoneTransforms;
 
    float                                     m_trackTime;
+   Transform                                 m_motionDelta;
  
 public:
    /**
@@ -72,6 +73,7 @@ public:
    // ----------------------------------------------------------------------
    bool isEnabled() const override;
    void samplePoses( float deltaTime ) override;
+   void onFrameEnd() override;
    void onStarted() override;
    void onFinished() override;
 
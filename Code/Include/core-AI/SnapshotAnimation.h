@@ -15,6 +15,41 @@ struct Quaternion;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Tells how much error the compression of the pose tracks is allowed to introduce.
+ */
+struct AnimationCompressionSettings
+{
+   DECLARE_ALLOCATOR( AnimationCompressionSettings, AM_DEFAULT );
+
+   float                                  m_rotationTolerance;       // max deviation of a rotation quaternion component
+   float                                  m_translationTolerance;    // max deviation of a translation component
+
+   /**
+    * Constructor.
+    *
+    * @param rotationTolerance
+    * @param translationTolerance
+    */
+   AnimationCompressionSettings( float rotationTolerance = 0.0005f, float translationTolerance = 0.0005f )
+      : m_rotationTolerance( rotationTolerance )
+      , m_translationTolerance( translationTolerance )
+   {}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * An animation clip that animates skeletons.
+ *
+ * The pose tracks are stored in a compressed form - each bone has a rotation and a translation track,
+ * and each track stores only the keys the rest of its frames can be interpolated from, given
+ * the error tolerance specified in the AnimationCompressionSettings:
+ *   - rotation keys are quantized using the smallest-three encoding ( 3 x 16 bits )
+ *   - translation keys are quantized to 16 bits per component, within the range the track's translations span
+ *   - a track that doesn't change gets stored as a single key ( or no keys, if it doesn't differ from
+ *     the identity rotation, or when it's a translation track - its value is stored as the range then )
+ */
 class SnapshotAnimation : public Resource
 {
    DECLARE_ALLOCATOR( SnapshotAnimation, AM_DEFAULT );
@@ -27,9 +62,18 @@ public:
    float                                  m_duration;          // duration of an animation clip ( in seconds )
    uint                                   m_bonesCount;
 
-   Array< Transform >                     m_poseTracks;
+   // compressed pose tracks - bone's rotation track is followed by its translation track
+   Array< uint >                          m_trackDescriptors;  // 2 entries per track - the index of the track's first key and the number of its keys
+   Array< word >                          m_keyFrames;         // the frame each key was taken at
+   Array< word >                          m_keyValues;         // 3 quantized components per key
+   Array< float >                         m_translationRanges; // 6 entries per bone - the minimum and the extent of the bone's translations
+
    Array< Transform >                     m_motionTrack;
 
+   // uncompressed pose tracks the resources saved before the compression was introduced
+   // have - they are compressed as soon as the resource is loaded
+   Array< Transform >                     m_poseTracks;
+
 public:
    /**
     * Constructor.
@@ -61,6 +105,11 @@ public:
     */
    void sampleMotion( float startTime, float endTime, Transform& outMotionTransform ) const;
 
+   /**
+    * Returns the size of the compressed pose tracks ( in bytes ).
+    */
+   uint getPoseTracksSize() const;
+
    // -------------------------------------------------------------------------
    // Animation definition
    // -------------------------------------------------------------------------
@@ -73,8 +122,9 @@ public:
     * @param bonesCount          how many entries does the poseKeysArr have - how many bones in the skeleton it animates
     * @param poseKeysArr         an array of transform tracks, each dedicated to a single bone
     * @param motionKeys          motion transforms track
+    * @param settings            pose tracks compression settings
     */
-   static void build( SnapshotAnimation& animation, uint bonesCount, BoneSRTAnimation* poseKeysArr, BoneSRTAnimation& motionKeys );
+   static void build( SnapshotAnimation& animation, uint bonesCount, BoneSRTAnimation* poseKeysArr, BoneSRTAnimation& motionKeys, const AnimationCompressionSettings& settings = AnimationCompressionSettings() );
 
    /**
     * Use this method to create a resource based on a raw animation data that consists of an array of transforms for particular bones, sampled every
@@ -86,8 +136,9 @@ public:
     * @param bonesCount          how many bones the pose has
     * @param poseKeysArr         an array of transform tracks, the size == framesCount * bonesCount. They are stored by poses - [ [pose_frame_0], [pose_frame_1], ..., [pose_frame_N] ] 
     * @param motionKeys          motion transforms track, the size == framesCount
+    * @param settings            pose tracks compression settings
     */
-   static void build( SnapshotAnimation& animation, float playbackSpeed, uint framesCount, uint bonesCount, Transform* poseKeysArr, Transform* motionKeysArr );
+   static void build( SnapshotAnimation& animation, float playbackSpeed, uint framesCount, uint bonesCount, Transform* poseKeysArr, Transform* motionKeysArr, const AnimationCompressionSettings& settings = AnimationCompressionSettings() );
 
    /**
     * Resets the animation contents.
@@ -99,8 +150,35 @@ public:
    // -------------------------------------------------------------------------
    void replaceContents( Resource& rhs );
 
+   // -------------------------------------------------------------------------
+   // ReflectionObject implementation
+   // -------------------------------------------------------------------------
+   void onObjectLoaded();
+
 private:
    void sampleMotion( float trackTime, Transform& outMotionTransform ) const;
+   void sampleRotationTrack( uint trackIdx, float framePos, Quaternion& outRotation ) const;
+   void sampleTranslationTrack( uint trackIdx, const float* range, float framePos, Vector& outTranslation ) const;
+
+   /**
+    * Finds the key the specified frame falls after, and the interpolation distance to the next key.
+    *
+    * @param firstKeyIdx
+    * @param keysCount
+    * @param framePos
+    * @param outLerpDist
+    * @return  index of the key
+    */
+   uint findKey( uint firstKeyIdx, uint keysCount, float framePos, FastFloat& outLerpDist ) const;
+
+   /**
+    * Compresses the specified pose tracks.
+    *
+    * @param framesCount
+    * @param poseKeysArr         framesCount * m_bonesCount transforms, stored by poses. NULL means that all bones remain in the identity pose.
+    * @param settings
+    */
+   void compressPoseTracks( uint framesCount, const Transform* poseKeysArr, const AnimationCompressionSettings& settings );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
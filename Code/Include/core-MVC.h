@@ -10,6 +10,7 @@
 #include "core-MVC\Model.h"
 #include "core-MVC\ModelView.h"
 #include "core-MVC\TransformsManagementSystem.h"
+#include "core-MVC\SceneTransforms.h"
 
 // ----------------------------------------------------------------------------
 // EntitiesGroup
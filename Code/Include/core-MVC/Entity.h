@@ -38,6 +38,7 @@
 
 class Prefab;
 class EntityListener;
+class SceneTransforms;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -61,7 +62,8 @@ public:
    // ------------------------
    Prefab*                             m_prefab;
 
-   // local coordinate system
+   // local coordinate system ( while the entity is bound to a SceneTransforms store, the current value
+   // is kept there, and it's copied back here when the entity is saved or unbound )
    Matrix                              m_localMtx;
 
    // ------------------------
@@ -87,6 +89,11 @@ private:
    /// entity listeners
    List< EntityListener* >             m_listeners;
 
+   // ( RUNTIME ) the flat store the entity's transforms live in, if the scene uses one
+   friend class SceneTransforms;
+   SceneTransforms*                    m_transformsStore;
+   int                                 m_transformIdx;
+
 public:
    /**
     * Constructor.
@@ -144,7 +151,7 @@ public:
     * It the node doesn't have a parent, this one will be equal
     * to the global matrix
     */
-   const Matrix& getLocalMtx() const { return m_localMtx; }
+   inline const Matrix& getLocalMtx() const;
 
    /**
     * Assigns the node a new local matrix.
@@ -157,8 +164,12 @@ public:
     * Manipulating the matrix in this way is sometimes necessary
     * as various libs manipulate pointers to matrices. 
     * Not to worry - the global matrix will always remain in sync
+    * ( the entity is marked dirty when the matrix is accessed, so don't hold on
+    * to the reference past the current frame ).
+    * If the entity is bound to a transforms store, the 'm_localMtx' property will only
+    * pick up the changes once it's about to be edited - use setLocalMtx if it should see them right away.
     */
-   Matrix& accessLocalMtx() { return m_localMtx; }
+   inline Matrix& accessLocalMtx();
 
    /*
     * A group of accessors to the local coordinate system vectors
@@ -182,6 +193,55 @@ public:
     */
    void getGlobalVectors( Vector& outRightVec, Vector& outUpVec, Vector& outLookVec, Vector& outPos ) const;
 
+   /**
+    * Returns the number of the entity's children.
+    */
+   inline uint getChildrenCount() const { return m_children.size(); }
+
+   /**
+    * Updates the transforms of this entity only, without stepping into its children.
+    * Together with 'updateChildrenTransforms', it allows to split the update of a hierarchy
+    * ( between multiple threads for instance ).
+    *
+    * @param dirtyOnly     if set to 'true', the transforms will be updated only if the entity was marked dirty
+    * @return              'true' if the transforms were updated, in which case the children need a full update
+    */
+   bool updateOwnTransforms( bool dirtyOnly );
+
+   /**
+    * Updates the hierarchies of a range of the entity's children.
+    *
+    * @param firstChildIdx
+    * @param lastChildIdx  index of the child past the last one updated
+    * @param fullUpdate    should the hierarchies be updated in full, or only their dirty parts
+    */
+   void updateChildrenTransforms( uint firstChildIdx, uint lastChildIdx, bool fullUpdate );
+
+   /**
+    * Call it before the children are updated on multiple threads.
+    *
+    * A node marked dirty during the update lets all of its ancestors know about it, up to the first
+    * one that already knows. This method makes sure that's the entity itself, so that the threads
+    * never write its flags.
+    */
+   void beginParallelChildrenUpdate();
+
+   /**
+    * Call it once the children updated on multiple threads are done. It tells again
+    * whether any of the children need an update.
+    */
+   void endParallelChildrenUpdate();
+
+   /**
+    * Returns the flat transforms store the entity is bound to ( if any ).
+    */
+   inline SceneTransforms* getTransformsStore() const { return m_transformsStore; }
+
+   /**
+    * Returns the index of the entity in the transforms store it's bound to.
+    */
+   inline int getTransformIdx() const { return m_transformIdx; }
+
    // -------------------------------------------------------------------------
    // Bounding volumes management
    // -------------------------------------------------------------------------
@@ -265,6 +325,8 @@ public:
    void collectChildren( List< SceneNode* >& outChildren ) const override;
    void collectChildren( List< const SceneNode* >& outChildren ) const override;
    void updateTransforms() override;
+   void updateDirtyTransforms() override;
+   void markTransformDirty() override;
    void onAttachToModel( Model* model ) override;
    void onDetachFromModel( Model* model ) override;
    void pullStructure( ModelView* view ) override;
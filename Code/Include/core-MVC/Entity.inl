@@ -3,22 +3,43 @@
 #else
 
 #include "core\LocalList.h"
+#include "core-MVC\SceneTransforms.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
 const Matrix& Entity::getGlobalMtx() const
 {
-   return m_globalMtx;
+   return m_transformsStore ? m_transformsStore->getGlobalMtx( m_transformIdx ) : m_globalMtx;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 const Matrix& Entity::getParentWorldMtx() const
 {
+   if ( m_transformsStore )
+   {
+      return m_parentNode ? m_parentNode->getGlobalMtx() : Matrix::IDENTITY;
+   }
+
    return *m_parentWorldMtx;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+const Matrix& Entity::getLocalMtx() const
+{
+   return m_transformsStore ? m_transformsStore->getLocalMtx( m_transformIdx ) : m_localMtx;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Matrix& Entity::accessLocalMtx()
+{
+   markTransformDirty();
+   return m_transformsStore ? m_transformsStore->accessLocalMtx( m_transformIdx ) : m_localMtx;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 #endif // _ENTITY_H
@@ -36,6 +36,13 @@ protected:
    Model*                        m_hostModel;
    bool                          m_instantiatedFromPrefab;
 
+private:
+   friend class Entity;
+   friend class SceneTransforms;
+
+   bool                          m_transformDirty;       // the node's transforms need to be updated
+   bool                          m_dirtyDescendants;     // some of the nodes in the hierarchy below need their transforms updated
+
 public:
    /**
     * Constructor.
@@ -115,6 +122,38 @@ public:
    // -------------------------------------------------------------------------
    // Transforms management
    // -------------------------------------------------------------------------
+   /**
+    * Marks the node's transforms as outdated. The next call to 'updateDirtyTransforms'
+    * on any of its ancestors will update them.
+    *
+    * Nodes that pull their transforms from an external source ( an animation, a physics
+    * simulation etc. ) should mark themselves whenever that source changes.
+    */
+   virtual void markTransformDirty();
+
+   /**
+    * Tells if the node's transforms are outdated.
+    */
+   inline bool isTransformDirty() const { return m_transformDirty; }
+
+   /**
+    * Tells if any of the nodes in the hierarchy below this node have outdated transforms.
+    */
+   inline bool hasDirtyDescendants() const { return m_dirtyDescendants; }
+
+   /**
+    * Updates the transforms of the nodes in this node's hierarchy that were marked dirty
+    * ( along with the nodes that span underneath them ), skipping the rest.
+    */
+   virtual void updateDirtyTransforms();
+
+protected:
+   /**
+    * Sets the dirty flag on the node and lets its ancestors know about it.
+    */
+   void flagTransformDirty();
+
+public:
    /**
     * This is the matrix that describes the node's absolute world position
     * (unlike the local matrix which describes the position relative to node's
@@ -0,0 +1,152 @@
+/// @file   core-MVC\SceneTransforms.h
+/// @brief  a flat store of a scene's transforms
+#pragma once
+
+#include "core\MemoryRouter.h"
+#include "core\Array.h"
+#include "core\Matrix.h"
+#include "core\AxisAlignedBox.h"
+#include "core-MVC\ModelView.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class Entity;
+class SceneNode;
+class Model;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A flat store of a scene's transforms.
+ *
+ * The local and global matrices and the bounding volumes of all entities of the observed scene
+ * are kept in continuous arrays, ordered breadth-first - so that every parent precedes its children.
+ * That turns a hierarchy update into a linear sweep over the arrays.
+ *
+ * Entities bound to the store keep an index into these arrays, and their transforms
+ * accessors read and write the store's data.
+ *
+ * Whenever the structure of the scene changes, the store is rebuilt ( during the next update ).
+ */
+class SceneTransforms : public ModelView
+{
+   DECLARE_ALLOCATOR( SceneTransforms, AM_ALIGNED_16 );
+
+private:
+   Model*                        m_scene;
+   bool                          m_rebuildRequired;
+   bool                          m_updateInProgress;
+
+   // entities data
+   Array< Entity* >              m_entities;
+   Array< int >                  m_parentIndices;        // -1 for the root
+   Array< Matrix >               m_localMatrices;
+   Array< Matrix >               m_globalMatrices;
+   Array< AxisAlignedBox >       m_localVolumes;
+   Array< AxisAlignedBox >       m_globalVolumes;
+   Array< bool >                 m_dirty;                // local transform of the entity has changed
+   Array< bool >                 m_updated;              // global transform of the entity was updated during the last sweep
+
+   // components of an entity occupy a range [ m_firstComponentIndices[i], m_firstComponentIndices[i + 1] )
+   Array< SceneNode* >           m_components;
+   Array< uint >                 m_firstComponentIndices;
+   Array< bool >                 m_componentsDirty;
+
+public:
+   /**
+    * Constructor.
+    */
+   SceneTransforms();
+   ~SceneTransforms();
+
+   /**
+    * Returns the observed scene.
+    */
+   inline Model* getScene() const { return m_scene; }
+
+   /**
+    * Returns the number of stored entities.
+    */
+   inline uint size() const { return m_entities.size(); }
+
+   /**
+    * Updates the global transforms of the entities whose local transforms changed,
+    * as well as the transforms of the nodes that span underneath them.
+    */
+   void update();
+
+   // -------------------------------------------------------------------------
+   // Entities API
+   // -------------------------------------------------------------------------
+   /**
+    * Returns the local matrix of an entity stored under the specified index.
+    *
+    * @param idx
+    */
+   inline const Matrix& getLocalMtx( int idx ) const { return m_localMatrices[idx]; }
+
+   /**
+    * Gives access to the local matrix of an entity stored under the specified index.
+    *
+    * @param idx
+    */
+   inline Matrix& accessLocalMtx( int idx ) { return m_localMatrices[idx]; }
+
+   /**
+    * Returns the global matrix of an entity stored under the specified index.
+    *
+    * @param idx
+    */
+   inline const Matrix& getGlobalMtx( int idx ) const { return m_globalMatrices[idx]; }
+
+   /**
+    * Returns the world space bounding volume of an entity stored under the specified index.
+    *
+    * @param idx
+    */
+   inline const AxisAlignedBox& getGlobalVolume( int idx ) const { return m_globalVolumes[idx]; }
+
+   /**
+    * Sets a new local bounding volume of an entity stored under the specified index.
+    *
+    * @param idx
+    * @param volume
+    */
+   inline void setLocalVolume( int idx, const AxisAlignedBox& volume ) { m_localVolumes[idx] = volume; m_dirty[idx] = true; }
+
+   /**
+    * Marks the local transform of an entity stored under the specified index as changed.
+    *
+    * @param idx
+    */
+   inline void markDirty( int idx ) { m_dirty[idx] = true; }
+
+   /**
+    * Marks the components of an entity stored under the specified index as requiring an update.
+    *
+    * @param idx
+    */
+   inline void markComponentsDirty( int idx ) { m_componentsDirty[idx] = true; }
+
+   // -------------------------------------------------------------------------
+   // ModelView implementation
+   // -------------------------------------------------------------------------
+   void onNodeAdded( SceneNode* node );
+   void onNodeRemoved( SceneNode* node );
+   void onAttachedToModel( Model& model );
+   void onDetachedFromModel( Model& model );
+   void resetContents( Model& model );
+
+private:
+   void rebuild();
+   void addEntity( Entity* entity, int parentIdx );
+
+   /**
+    * Copies the stored transforms back to the entities and unbinds them from the store.
+    */
+   void invalidate();
+   void unbindEntity( uint idx );
+};
+
+///////////////////////////////////////////////////////////////////////////////
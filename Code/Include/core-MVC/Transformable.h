@@ -12,6 +12,9 @@ public:
 
    /**
     * Updates the world transform of the object.
+    *
+    * TransformsManagementSystem may call it from one of the worker threads, concurrently
+    * with the updates of other objects.
     */
    virtual void updateTransforms() = 0;
 };
@@ -5,17 +5,32 @@
 #include "core\MemoryRouter.h"
 #include "core\Singleton.h"
 #include "core\List.h"
+#include "core\Array.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
 class Model;
+class Entity;
 class Transformable;
+class SceneTransforms;
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
  * A system for centralized scene node transforms management.
+ *
+ * By default, only the nodes marked dirty ( see SceneNode::markTransformDirty ) and the hierarchies
+ * that span underneath them are updated - the rest of the scene is skipped. The incremental updates
+ * can be switched off, in which case the entire scenes will be updated every frame.
+ *
+ * A scene can also be added along with a flat transforms store ( see SceneTransforms ), which
+ * keeps the transforms of all its entities in continuous arrays and updates them in a single sweep.
+ *
+ * The hierarchies spanning underneath the children of a scene's root don't depend on each other,
+ * so they are updated in parallel, as jobs of the MultithreadedTasksScheduler ( the same goes
+ * for the individual transformable objects ). The results are exactly the same as those of
+ * a serial update, which can still be requested using 'setParallelUpdates'.
  */
 class TransformsManagementSystem
 {
@@ -24,7 +39,11 @@ class TransformsManagementSystem
 
 private:
    List< Model* >                m_scenes;
-   List< Transformable* >        m_transformables;
+   List< SceneTransforms* >      m_transformStores;
+   Array< Transformable* >       m_transformables;
+
+   bool                          m_incrementalUpdates;
+   bool                          m_parallelUpdates;
 
 public:
    /**
@@ -36,9 +55,11 @@ public:
    /**
     * Adds a scene to the system. From this point on its transforms will
     * be updated every frame.
+    *
     * @param scene
+    * @param useTransformsStore     should the scene's transforms be kept in a flat transforms store
     */
-   void addScene( Model* scene );
+   void addScene( Model* scene, bool useTransformsStore = false );
 
    /**
     * Removes a scene from the system. Scene transforms won't be updated any more.
@@ -64,10 +85,40 @@ public:
     */
    void removeTransformable( Transformable* obj );
 
+   /**
+    * Toggles the incremental updates of the scenes.
+    *
+    * @param enable
+    */
+   inline void setIncrementalUpdates( bool enable ) { m_incrementalUpdates = enable; }
+
+   /**
+    * Tells if the scenes are updated incrementally.
+    */
+   inline bool areUpdatesIncremental() const { return m_incrementalUpdates; }
+
+   /**
+    * Toggles the parallel updates of the scenes and the transformable objects.
+    *
+    * @param enable
+    */
+   inline void setParallelUpdates( bool enable ) { m_parallelUpdates = enable; }
+
+   /**
+    * Tells if the updates are distributed between multiple threads.
+    */
+   inline bool areUpdatesParallel() const { return m_parallelUpdates; }
+
    /**
     * Ticks the manager.
     */
    void tick();
+
+private:
+   struct SubtreesUpdater;
+   struct TransformablesUpdater;
+
+   void updateHierarchy( Entity* root );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
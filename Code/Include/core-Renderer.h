@@ -20,6 +20,7 @@
 // ----------------------------------------------------------------------------
 #include "core-Renderer\BasicRenderCommands.h"
 #include "core-Renderer\InternalRenderCommands.h"
+#include "core-Renderer\RenderCommandsBuffer.h"
 // ----------------------------------------------------------------------------
 // --> Camera
 // ----------------------------------------------------------------------------
@@ -118,6 +119,7 @@
 #include "core-Renderer\MNBool.h"
 #include "core-Renderer\MNTimer.h"
 #include "core-Renderer\MNTransform.h"
+#include "core-Renderer\MNInstanceTransform.h"
 #include "core-Renderer\MNTransformNormal.h"
 #include "core-Renderer\MNTransformVector.h"
 #include "core-Renderer\MNTransformSkinVector.h"
@@ -10,3 +10,7 @@
 #define DEDICATED_PIPELINE_SHADERS_DIR       "/Renderer/Shaders/RenderingPipeline/"
 
 ///////////////////////////////////////////////////////////////////////////////
+
+#define MAX_INSTANCES_PER_DRAW_CALL          64
+
+///////////////////////////////////////////////////////////////////////////////
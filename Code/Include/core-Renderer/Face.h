@@ -43,4 +43,6 @@ struct Face
    }
 };
 
+DECLARE_BLOCK_SERIALIZABLE( Face );
+
 ///////////////////////////////////////////////////////////////////////////////
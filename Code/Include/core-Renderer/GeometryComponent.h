@@ -77,6 +77,33 @@ public:
     */
    void render( Renderer& renderer, RenderProfileId profile );
 
+   /**
+    * Renders the geometry, assuming the render states of its material were already set ( see RenderState::beginBatch ).
+    *
+    * @param renderer
+    * @param profile
+    */
+   void draw( Renderer& renderer, RenderProfileId profile );
+
+   /**
+    * Tells if the geometry can be rendered together with other instances of the same mesh
+    * in a single draw call.
+    *
+    * @param profile
+    */
+   virtual bool canBeInstanced( RenderProfileId profile ) const;
+
+   /**
+    * Renders many instances of the geometry's mesh in a single draw call, using the material of this geometry.
+    * The render states of the material need to be set already ( see RenderState::beginBatch ).
+    *
+    * @param renderer
+    * @param profile
+    * @param instances        geometry components that use the same mesh and material as this one
+    * @param instancesCount   up to MAX_INSTANCES_PER_DRAW_CALL
+    */
+   void drawInstances( Renderer& renderer, RenderProfileId profile, const GeometryComponent* const* instances, uint instancesCount );
+
    /**
     * Toggles rendering of the node on/off.
     *
@@ -175,6 +202,9 @@ protected:
    void onDetachFromModel( Model* model ) override;
    void onObjectLoaded() override;
    void updateTransforms() override;
+
+private:
+   RCBindShader* bindShader( Renderer& renderer, RenderProfileId profile ) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
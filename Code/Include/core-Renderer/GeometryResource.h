@@ -45,6 +45,14 @@ public:
     */
    virtual void render( Renderer& renderer ) {}
 
+   /**
+    * Renders many instances of the resource in a single draw call.
+    *
+    * @param renderer
+    * @param instancesCount
+    */
+   virtual void renderInstances( Renderer& renderer, uint instancesCount ) {}
+
 };
 
 ///////////////////////////////////////////////////////////////////////////////
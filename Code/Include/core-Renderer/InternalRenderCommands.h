@@ -10,6 +10,7 @@
 
 class CriticalSection;
 class RendererInitializer;
+class RenderCommandsBuffer;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -28,3 +29,29 @@ public:
 };
 
 ///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Executes the render commands a worker thread recorded in a commands buffer.
+ */
+class RCExecuteCommandsBuffer : public RenderCommand
+{
+   DECLARE_ALLOCATOR( RCExecuteCommandsBuffer, AM_DEFAULT );
+
+private:
+   RenderCommandsBuffer*      m_buffer;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param buffer
+    */
+   RCExecuteCommandsBuffer( RenderCommandsBuffer* buffer );
+
+   // -------------------------------------------------------------------------
+   // RenderCommand implementation
+   // -------------------------------------------------------------------------
+   void execute( Renderer& renderer );
+};
+
+///////////////////////////////////////////////////////////////////////////////
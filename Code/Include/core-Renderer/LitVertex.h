@@ -4,6 +4,7 @@
 
 #include "core\Vector.h"
 #include "core\types.h"
+#include "core\StreamTraits.h"
 #include <iostream>
 
 
@@ -49,6 +50,8 @@ struct LitVertex
    friend InStream& operator>>( InStream& stream, LitVertex& vtx );
 };
 
+DECLARE_BLOCK_SERIALIZABLE( LitVertex );
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct VertexWeight
@@ -68,6 +71,8 @@ struct VertexWeight
    friend InStream& operator>>( InStream& stream, VertexWeight& weight );
 };
 
+DECLARE_BLOCK_SERIALIZABLE( VertexWeight );
+
 ///////////////////////////////////////////////////////////////////////////////
 
 std::ostream& operator<<( std::ostream& stream, const LitVertex& vertex );
@@ -0,0 +1,68 @@
+/// @file   core-Renderer/MNInstanceTransform.h
+/// @brief  transform provider that supports instanced rendering
+#pragma once
+
+#include "core-Renderer/MaterialNode.h"
+#include "core-Renderer/MNTransform.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class MSMatrixOutput;
+class Matrix;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Provides the transform of the rendered geometry instance.
+ *
+ * Materials that use this node in place of MNTransform can render many instances of the same mesh
+ * in a single draw call. The transforms of all instances are sent in a single array, and the vertex
+ * shader picks the one that corresponds to the instance being drawn - so the node can only be used
+ * in the vertex routine.
+ *
+ * When the geometry is rendered without instancing, the node provides the transform of the host geometry.
+ */
+class MNInstanceTransform : public MaterialNode
+{
+   DECLARE_ALLOCATOR( MNInstanceTransform, AM_ALIGNED_16 );
+   DECLARE_CLASS()
+
+private:
+   TransformationType   m_transformType;
+
+   // sockets
+   MSMatrixOutput*      m_output;
+
+   uint                 var_transforms;
+
+public:
+   /**
+   * Constructor.
+   *
+   * @param transformType
+   */
+   MNInstanceTransform( const char* name = "MNInstanceTransform", TransformationType transformType = SPACE_Model_To_Projection );
+
+   /**
+   * Copy constructor.
+   */
+   MNInstanceTransform( const MNInstanceTransform& rhs );
+   ~MNInstanceTransform();
+
+   // -------------------------------------------------------------------------
+   // Object implementation
+   // -------------------------------------------------------------------------
+   void onObjectLoaded() override;
+
+   // -------------------------------------------------------------------------
+   // MaterialNode implementation
+   // -------------------------------------------------------------------------
+   void buildMaterialShader( MaterialShaderBuilder& builder ) override;
+   void render( Renderer& renderer, const RenderState& host, RCBindShader* shaderComm, ShaderDataBuffer* constantsBuf ) const override;
+
+private:
+   void calcTransform( const Matrix& worldMtx, const Matrix& cameraMtx, Matrix& outTransform ) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
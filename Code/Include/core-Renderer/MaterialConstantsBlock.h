@@ -62,8 +62,9 @@ public:
     * @param engineType
     * @param outOffset
     * @param outName
+    * @param arrSize
     */
-   void add( const ReflectionType* engineType, uint& outOffset, std::string& outName );
+   void add( const ReflectionType* engineType, uint& outOffset, std::string& outName, uint arrSize = 1 );
 
    /**
    * Adds a new global.
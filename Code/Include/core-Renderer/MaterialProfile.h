@@ -48,6 +48,9 @@ private:
    bool                                m_transparent;
    bool                                m_doubleSided;
 
+   // runtime data
+   bool                                m_instanced;
+
 public:
    /**
     * Constructor.
@@ -131,6 +134,14 @@ public:
       return m_doubleSided;
    }
 
+   /**
+    * Tells whether many instances of a mesh can be rendered with this profile in a single draw call
+    * ( the vertex routine takes the transforms from an MNInstanceTransform node ).
+    */
+   inline bool isInstanced() const {
+      return m_instanced;
+   }
+
    // -------------------------------------------------------------------------
    // Listeners
    // -------------------------------------------------------------------------
@@ -168,9 +168,10 @@ public:
     *
     * @param outOffset     data offset
     * @param outName       name of the variable
+    * @param arrSize       number of elements, if the global is an array
     */
    template< typename T >
-   void addGlobal( uint& outOffset, std::string& outName );
+   void addGlobal( uint& outOffset, std::string& outName, uint arrSize = 1 );
 
    /**
     * Adds a new constant variable and defines a name for it.
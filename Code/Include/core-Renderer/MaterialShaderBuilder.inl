@@ -10,12 +10,12 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 template< typename T >
-void MaterialShaderBuilder::addGlobal( uint& outOffset, std::string& outName )
+void MaterialShaderBuilder::addGlobal( uint& outOffset, std::string& outName, uint arrSize )
 {
    ReflectionTypesRegistry& typesReg = TSingleton< ReflectionTypesRegistry >::getInstance();
    const ReflectionType* engineType = typesReg.find< T >();
 
-   m_constantsBlock->add( engineType, outOffset, outName );
+   m_constantsBlock->add( engineType, outOffset, outName, arrSize );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,50 @@
+/// @file   core-Renderer/RenderCommandsBuffer.h
+/// @brief  a buffer a worker thread records the render commands in
+#pragma once
+
+#include "core\MemoryRouter.h"
+#include "core\LocklessCommandsBuffer.h"
+#include "core\Stack.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class Renderer;
+class FragmentedMemoryPool;
+class RenderStateChangeTracker;
+struct RenderStateFlags;
+struct RenderingContext;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A buffer a worker thread records the render commands in ( see Renderer::reserveCommandsBuffer ).
+ *
+ * Apart from the commands, the buffer holds the renderer state the recording thread changes
+ * as it issues them - the render state trackers and flags, and the rendering context. The thread
+ * works on its own copy of that state, taken when the buffer was reserved, so that the buffers
+ * can be recorded in parallel.
+ */
+class RenderCommandsBuffer : public LocklessCommandsBuffer< Renderer >
+{
+   DECLARE_ALLOCATOR( RenderCommandsBuffer, AM_DEFAULT );
+
+private:
+   friend class Renderer;
+
+   FragmentedMemoryPool*                  m_renderStateCommandsQueue;
+   Stack< RenderStateChangeTracker* >*    m_stateChangeTrackersStack;
+   RenderStateFlags*                      m_renderStateFlags;
+   RenderingContext*                      m_context;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param pageSize      size of a single page of the commands memory
+    */
+   RenderCommandsBuffer( size_t pageSize );
+   ~RenderCommandsBuffer();
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -132,12 +132,30 @@ public:
    RCBindShader* rendererShadowMap( Renderer& renderer ) const;
 
    /**
-    * Called after the geometry rendering- resets the render state.
+    * Called after the geometry rendering - unbinds the shader.
     *
     * @param renderer
     */
    void postRender( Renderer& renderer ) const;
 
+   /**
+    * Sets the render states required by the material on the device.
+    *
+    * The states remain set until 'endBatch' is called, so all geometry that uses the same material
+    * can be rendered in between.
+    *
+    * @param renderer
+    * @param profile
+    */
+   void beginBatch( Renderer& renderer, enum RenderProfileId profile ) const;
+
+   /**
+    * Reverts the render states set by 'beginBatch'.
+    *
+    * @param renderer
+    */
+   void endBatch( Renderer& renderer ) const;
+
    // -------------------------------------------------------------------------
    // Runtime data access
    // -------------------------------------------------------------------------
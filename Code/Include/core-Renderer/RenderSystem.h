@@ -14,12 +14,15 @@
 class Renderer;
 class Thread;
 class CriticalSection;
-class TSContinuousMemoryPool;
+class ConditionVariable;
+class FrameMemoryPool;
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
  * This class manages the render thread and updates all existing Renderer instances.
+ *
+ * The render thread sleeps until the main thread commits a frame for it to render.
  */
 class RenderSystem : public Runnable
 {
@@ -32,7 +35,7 @@ class RenderSystem : public Runnable
 
       Renderer*                                    m_renderer;
 
-      TSContinuousMemoryPool*                      m_commandsDataAllocator;
+      FrameMemoryPool*                             m_commandsDataAllocator;
       SteppedLocklessCommandsQueue< Renderer >*    m_renderThreadCommandsQueue;
       SteppedLocklessCommandsQueue< Renderer >*    m_mainThreadCommandsQueue;
 
@@ -52,6 +55,8 @@ private:
 
    Array< RendererEntry* >    m_renderers;
    CriticalSection*           m_renderersListLock;
+   ConditionVariable*         m_renderThreadWakeUp;
+   ConditionVariable*         m_renderingFinished;
 
    bool                       m_runRenderingThread;
    Thread*                    m_mainRenderingThread;
@@ -112,8 +117,22 @@ public:
    void run();
 
 private:
+   struct RenderThreadWakeUpPredicate;
+   struct RenderingFinishedPredicate;
+
    void processRendererRegistrations();
    void renderSingleFrame( RendererEntry* entry );
+
+   /**
+    * Checks if any of the renderers has a committed frame the render thread should render.
+    * Must be called with m_renderersListLock held.
+    */
+   bool isFrameCommitted() const;
+
+   /**
+    * Wakes up the render thread, so that it renders the committed frames.
+    */
+   void wakeUpRenderThread();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -2,78 +2,93 @@
 /// @brief  render tree definition
 #pragma once
 
-#include "core\TSContinuousMemoryPool.h"
 #include "core\MemoryRouter.h"
 #include "core\Array.h"
+#include "core-Renderer\GeometryComponent.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class GeometryComponent;
-class RenderState;
 class Renderer;
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
- * A geometry node in the scene render tree - this is the tree's leaf.
+ * A sort key describes the order in which the geometry should be rendered.
+ *
+ * Its bits ( starting from the most significant ones ) store:
+ *   - the id of the render profile ( 8 bits )
+ *   - the id of the material ( 20 bits )
+ *   - the id of the mesh ( 20 bits )
+ *   - the depth bucket the geometry falls into ( 16 bits )
+ *
+ * The profile and the material form the state prefix of the key - the render states
+ * need to be changed only when that prefix changes.
  */
-struct GeometryNode
-{
-   DECLARE_ALLOCATOR( GeometryNode, AM_DEFAULT );
-
-   GeometryNode*           m_next;
-   GeometryComponent&      m_geometry;
-
-   /**
-    * Constructor.
-    *
-    * @param nextNode      the node can have siblings, but only ones containing geometry rendered with the same render state
-    * @param geometry      rendered geometry
-    */
-   GeometryNode( GeometryNode*& nextNode, GeometryComponent& geometry );
-   ~GeometryNode();
-};
+typedef unsigned __int64 RenderSortKey;
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
- * A state node in the scene render tree - this is the tree's composite node.
+ * A single entry of the render queue.
  */
-struct StateTreeNode
+struct RenderQueueEntry
 {
-   DECLARE_ALLOCATOR( StateTreeNode, AM_DEFAULT );
+   DECLARE_ALLOCATOR( RenderQueueEntry, AM_DEFAULT );
 
-   StateTreeNode*          m_sibling;
+   RenderSortKey           m_key;
+   GeometryComponent*      m_geometry;
+};
 
-   const RenderState*      m_state;
-   GeometryNode*           m_geometryNode;
+///////////////////////////////////////////////////////////////////////////////
 
-   /**
-    * Constructor.
-    *
-    * @param state         described render state
-    */
-   StateTreeNode( const RenderState& state );
-   ~StateTreeNode();
+/**
+ * A single draw call issued by the render queue. Draw calls that render more than one
+ * geometry instance use hardware instancing.
+ */
+struct RenderDrawCall
+{
+   DECLARE_ALLOCATOR( RenderDrawCall, AM_DEFAULT );
 
-   /**
-    * Compares another render state with the one contained in this node.
-    *
-    * @param state      other render state
-    */ 
-   bool compareState( const RenderState* state );
+   RenderSortKey           m_key;               // sort key of the first rendered geometry
+   uint                    m_firstInstance;     // index of the first rendered geometry in RenderTree::m_renderedGeometry
+   uint                    m_instancesCount;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * A queue of the visible geometry, sorted so that the geometry that uses the same render states
+ * is rendered together ( and the geometry closer to the camera is rendered first ).
+ *
+ * Every visible geometry component emits a sort key ( see RenderSortKey ) - the keys
+ * are then radix sorted, and the render states are changed only when the state prefix
+ * of the rendered key changes.
+ *
+ * Subsequent instances of the same mesh rendered with the same material are rendered
+ * in a single instanced draw call, as long as the material supports it ( see GeometryComponent::canBeInstanced ).
+ *
+ * Large queues are split into chunks of draw calls, recorded in parallel by the worker threads
+ * ( see Renderer::reserveCommandsBuffer ).
+ */
 class RenderTree
 {
    DECLARE_ALLOCATOR( RenderTree, AM_DEFAULT );
 
 public:
-   Renderer&            m_renderer;
-   StateTreeNode*       m_root;
+   static const uint                DEPTH_BITS = 16;
+   static const uint                MESH_BITS = 20;
+   static const uint                MATERIAL_BITS = 20;
+   static const uint                STATE_PREFIX_SHIFT = DEPTH_BITS + MESH_BITS;
+
+   // smallest number of draw calls worth recording on a separate thread
+   static const uint                MIN_DRAW_CALLS_PER_CHUNK = 64;
+
+   Renderer&                        m_renderer;
+   RenderProfileId                  m_profile;
+   Array< RenderQueueEntry >        m_entries;
+   Array< GeometryComponent* >      m_renderedGeometry;
+   Array< RenderDrawCall >          m_drawCalls;
 
 public:
    /**
@@ -81,16 +96,44 @@ public:
     *
     * @param renderer
     * @param visibleElems
+    * @param profile       the material profile the geometry will be rendered with
     */
-   RenderTree( Renderer& renderer, const Array< GeometryComponent* >& visibleElems );
+   RenderTree( Renderer& renderer, const Array< GeometryComponent* >& visibleElems, RenderProfileId profile );
    ~RenderTree();
 
    /**
-    * Renders the tree using the specified material profile.
+    * Renders the queued geometry.
+    */
+   void render();
+
+   /**
+    * Renders the specified range of the queued draw calls.
+    *
+    * @param firstDrawCall
+    * @param lastDrawCall     index of the draw call that follows the last rendered one
+    */
+   void renderDrawCalls( uint firstDrawCall, uint lastDrawCall );
+
+   /**
+    * Returns the number of times the render states will be changed when the queue is rendered.
+    */
+   uint getStateChangesCount() const;
+
+   /**
+    * Returns the number of draw calls the queue will issue.
+    */
+   inline uint getDrawCallsCount() const { return m_drawCalls.size(); }
+
+   /**
+    * Returns the state prefix of the specified sort key.
     *
-    * @param profileIdx
+    * @param key
     */
-   void render( enum RenderProfileId profileIdx );
+   static inline RenderSortKey getStatePrefix( RenderSortKey key ) { return key >> STATE_PREFIX_SHIFT; }
+
+private:
+   void sortEntries();
+   void buildDrawCalls();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -15,6 +15,7 @@
 #include "core\Runnable.h"
 #include "core\RoundBuffer.h"
 #include "core\SteppedLocklessCommandsQueue.h"
+#include "core\Atomic.h"
 #include <vector>
 #include <map>
 
@@ -33,10 +34,12 @@ struct RenderingContext;
 struct RenderStateFlags;
 class RenderStateChangeTracker;
 class ContinuousMemoryPool;
-class TSContinuousMemoryPool;
+class FrameMemoryPool;
 class FragmentedMemoryPool;
 class IRenderResourceStorage;
 class RenderResource;
+class CriticalSection;
+class RenderCommandsBuffer;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -77,9 +80,16 @@ private:
    Matrix                                       m_viewportMatrix;
 
    // render commands
-   TSContinuousMemoryPool*                      m_commandsDataAllocator;
+   FrameMemoryPool*                             m_commandsDataAllocator;
    SteppedLocklessCommandsQueue< Renderer >*    m_renderThreadCommandsQueue;
 
+   // render commands recorded by the worker threads
+   friend class RCExecuteCommandsBuffer;
+   CriticalSection*                             m_commandsBuffersLock;
+   Array< RenderCommandsBuffer* >               m_commandsBuffers;
+   Array< RenderCommandsBuffer* >               m_freeCommandsBuffers;
+   AtomicInt                                    m_unrecordedCommandsBuffersCount;    // buffers reserved, but not recorded yet
+
    // render state
    FragmentedMemoryPool*                        m_renderStateCommandsQueue;      // this memory pool is dedicated exclusively to render state changing commands, thus the friendship with their instantiator
    RenderStateFlags*                            m_renderStateFlags;
@@ -128,25 +138,24 @@ public:
     * Build the render tree.
     *
     * @param visibleElems
+    * @param profile       the material profile the geometry will be rendered with
     */
-   RenderTree* buildRenderTree( const Array< GeometryComponent* >& visibleElems );
+   RenderTree* buildRenderTree( const Array< GeometryComponent* >& visibleElems, enum RenderProfileId profile );
 
    // -------------------------------------------------------------------------
    // Rendering context & state access
    // -------------------------------------------------------------------------
    /**
     * Gives access to the rendering context ( constant version )
+    *
+    * A thread that's recording commands ( see beginRecording ) works on a copy of the context.
     */
-   inline const RenderingContext& getContext() const {
-      return *m_context;
-   }
+   const RenderingContext& getContext() const;
 
    /**
    * Gives access to the rendering context ( non-constant version )
    */
-   inline RenderingContext& accessContext() {
-      return *m_context;
-   }
+   RenderingContext& accessContext();
 
    /**
     * Gives access to the queries queue.
@@ -209,6 +218,9 @@ public:
    /**
     * Pushes a camera to the top of the camera stack, thus making it an active camera for this renderer.
     *
+    * The cameras can't be changed while the commands are being recorded - the recording threads
+    * share the camera that was active when the buffers were reserved.
+    *
     * @param camera
     */
    void pushCamera( Camera& camera );
@@ -224,28 +236,67 @@ public:
    // -------------------------------------------------------------------------
    /**
     * Gives access to the render thread's commands buffer.
+    *
+    * If the calling thread is recording commands ( see beginRecording ), the commands buffer
+    * it records to is returned instead.
     */
-   inline MemoryAllocator* rtComm() { return m_renderThreadCommandsQueue; }
+   MemoryAllocator* rtComm();
 
    /**
     * Gives access to a designated allocator that manages render thread's rendering commands data related memory
     */
-   inline TSContinuousMemoryPool* rtMemPool() {
+   inline FrameMemoryPool* rtMemPool() {
       return m_commandsDataAllocator;
    }
 
    /**
     * Gives access to a memory pool dedicated to render state changing commands.
     */
-   inline FragmentedMemoryPool* rsComm() {
-      return m_renderStateCommandsQueue;
-   }
+   FragmentedMemoryPool* rsComm();
 
    /**
     * Gives access to the render queries queue.
     */
    inline RoundBuffer* query() { return m_queriesQueue; }
 
+   // -------------------------------------------------------------------------
+   // Render commands recording
+   // -------------------------------------------------------------------------
+
+   /**
+    * Reserves a commands buffer a worker thread can record render commands in.
+    *
+    * The buffer is spliced into the render thread's commands queue at the point of the reservation,
+    * so the recorded commands will be executed in the order the buffers were reserved in,
+    * regardless of the order the workers finish recording them in.
+    *
+    * The recording needs to be finished ( see endRecording ) before the queue gets committed.
+    *
+    * @main thread
+    */
+   RenderCommandsBuffer* reserveCommandsBuffer();
+
+   /**
+    * Redirects the render commands the calling thread issues to the specified buffer.
+    *
+    * Until the recording ends, the thread works on its own copy of the render state and of
+    * the rendering context.
+    *
+    * @param buffer
+    */
+   void beginRecording( RenderCommandsBuffer* buffer );
+
+   /**
+    * Stops redirecting the render commands issued by the calling thread, marking the buffer
+    * it recorded as ready to be executed.
+    */
+   void endRecording();
+
+   /**
+    * Tells if the calling thread is recording the render commands.
+    */
+   bool isRecording() const;
+
    // -------------------------------------------------------------------------
    // Render state changes
    // -------------------------------------------------------------------------
@@ -253,10 +304,7 @@ public:
    /**
     * Gives access to the current setting of the render state.
     */
-   inline RenderStateFlags& accessRenderStateFlags()
-   {
-      return *m_renderStateFlags;
-   }
+   RenderStateFlags& accessRenderStateFlags();
 
    /**
     * Pushes a new state changes tracker on top of the stack.
@@ -277,7 +325,20 @@ private:
     * @param commandsDataAllocator
     * @param renderThreadCommandsQueue
     */
-   void initialize( TSContinuousMemoryPool* commandsDataAllocator, SteppedLocklessCommandsQueue< Renderer >* renderThreadCommandsQueue );
+   void initialize( FrameMemoryPool* commandsDataAllocator, SteppedLocklessCommandsQueue< Renderer >* renderThreadCommandsQueue );
+
+   /**
+    * Tells if all of the reserved commands buffers have been recorded, and the render thread's
+    * queue can be committed.
+    */
+   inline bool areCommandsBuffersRecorded() const { return m_unrecordedCommandsBuffersCount.get() == 0; }
+
+   /**
+    * Returns an executed commands buffer to the pool.
+    *
+    * @param buffer
+    */
+   void releaseCommandsBuffer( RenderCommandsBuffer* buffer );
 
    /**
     * Renders the graphical representation of the scene on
@@ -28,6 +28,10 @@ struct RenderingContext
    class ShaderTexture*       m_texture;
 
    class ShaderDataBuffer*    m_dataBuffer;
+
+   // geometry rendered by the current instanced draw call
+   const class GeometryComponent* const*  m_instances;
+   uint                                   m_instancesCount;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -133,6 +133,7 @@ public:
    // -------------------------------------------------------------------------
    const AxisAlignedBox& getBoundingVolume();
    void render( Renderer& renderer );
+   void renderInstances( Renderer& renderer, uint instancesCount );
 
    // -------------------------------------------------------------------------
    // Resource implementation
@@ -157,14 +158,16 @@ class RCRenderTriangleMesh : public RenderCommand
 
 private:
    const TriangleMesh*           m_mesh;
+   uint                          m_instancesCount;
 
 public:
    /**
     * Constructor.
     *
     * @param mesh
+    * @param instancesCount      number of the rendered instances of the mesh
     */
-   RCRenderTriangleMesh( const TriangleMesh* mesh);
+   RCRenderTriangleMesh( const TriangleMesh* mesh, uint instancesCount = 1 );
    ~RCRenderTriangleMesh();
 
    // -------------------------------------------------------------------------
@@ -46,6 +46,7 @@ REGISTER_TYPE( MNVec4 );
 REGISTER_TYPE( MNBool );
 REGISTER_TYPE( MNTimer );
 REGISTER_TYPE( MNTransform );
+REGISTER_TYPE( MNInstanceTransform );
 REGISTER_TYPE( MNTransformNormal );
 REGISTER_TYPE( MNTransformVector );
 REGISTER_TYPE( MNTransformSkinVector );
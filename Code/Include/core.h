@@ -42,6 +42,7 @@
 #include "core\FilesystemSection.h"
 #include "core\StreamBuffer.h"
 #include "core\FilePath.h"
+#include "core\FilePathMap.h"
 #include "core\FilesystemUtils.h"
 
 // ----------------------------------------------------------------------------
@@ -68,6 +69,7 @@
 // ----------------------------------------------------------------------------
 #include "core\ContinuousMemoryPool.h"
 #include "core\TSContinuousMemoryPool.h"
+#include "core\FrameMemoryPool.h"
 #include "core\FragmentedMemoryPool.h"
 #include "core\TSFragmentedMemoryPool.h"
 #include "core\RuntimeData.h"
@@ -88,6 +90,7 @@
 // -->Allocators
 // ----------------------------------------------------------------------------
 #include "core\DefaultAllocator.h"
+#include "core\ThreadCachingAllocator.h"
 
 // ----------------------------------------------------------------------------
 // Misc
@@ -117,17 +120,22 @@
 // ----------------------------------------------------------------------------
 #include "core\Mutex.h"
 #include "core\Semaphore.h"
+#include "core\ConditionVariable.h"
+#include "core\Atomic.h"
 // ----------------------------------------------------------------------------
 // -->TasksScheduler
 // ----------------------------------------------------------------------------
 #include "core\MultithreadedTasksScheduler.h"
 #include "core\MultithreadedTask.h"
+#include "core\Job.h"
+#include "core\WorkStealingQueue.h"
 // ----------------------------------------------------------------------------
 // -->LocklessCommandsQueue
 // ----------------------------------------------------------------------------
 #include "core\LocklessCommand.h"
 #include "core\LocklessCommandsQueue.h"
 #include "core\SteppedLocklessCommandsQueue.h"
+#include "core\LocklessCommandsBuffer.h"
 // ----------------------------------------------------------------------------
 // -->Utils
 // ----------------------------------------------------------------------------
@@ -188,6 +196,7 @@
 #include "core\ResourcesManager.h"
 #include "core\ResourceStorage.h"
 #include "core\ResourceHandle.h"
+#include "core\ResourceLoadRequest.h"
 // ----------------------------------------------------------------------------
 // -->DependenciesMapper
 // ----------------------------------------------------------------------------
@@ -206,6 +215,7 @@
 // ----------------------------------------------------------------------------
 #include "core\BSPNodeTree.h"
 #include "core\LinearStorage.h"
+#include "core\AABBTree.h"
 
 // ----------------------------------------------------------------------------
 // Streams
@@ -219,6 +229,7 @@
 #include "core/InArrayStream.h"
 #include "core/OutArrayStream.h"
 #include "core/InFileStream.h"
+#include "core/InMappedFileStream.h"
 #include "core/OutFileStream.h"
 #include "core/InRawArrayStream.h"
 #include "core/OutRawArrayStream.h"
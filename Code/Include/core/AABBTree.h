@@ -0,0 +1,165 @@
+/// @file   core\AABBTree.h
+/// @brief  a dynamic bounding volume hierarchy of axis aligned boxes
+#ifndef _AABB_TREE_H
+#define _AABB_TREE_H
+
+#include "core\MemoryRouter.h"
+#include "core\Array.h"
+#include "core\AxisAlignedBox.h"
+#include <map>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A spatial storage that keeps its elements in a dynamic bounding volume hierarchy.
+ *
+ * Every element is stored in a leaf of a binary tree, and every node of the tree is bounded
+ * by a box that contains the boxes of both its children - so a query can reject an entire
+ * subtree after testing a single box.
+ *
+ * The leaves store the bounds of the elements enlarged by a small margin. As long as an element
+ * moves within those bounds, the tree doesn't need to change. 'update' checks the elements
+ * and reinserts the ones that left their leaves' bounds - call it whenever the elements move
+ * ( once per frame, before the queries are made ).
+ *
+ * Elements inserted one by one make a tree of a decent quality, but a tree built from scratch
+ * ( using the surface area heuristic ) is a better fit for the static content - so call 'rebuild'
+ * after populating the storage with a large number of elements.
+ *
+ * Stored elements are required to implement the following method:
+ *
+ *    const AxisAlignedBox& getBoundingVolume() const;
+ */
+template< typename T >
+class AABBTree
+{
+   DECLARE_ALLOCATOR( AABBTree, AM_ALIGNED_16 );
+
+private:
+   struct Node
+   {
+      DECLARE_ALLOCATOR( Node, AM_ALIGNED_16 );
+
+      AxisAlignedBox                m_bounds;         // leaves keep the enlarged bounds of their elements here
+      int                           m_parent;         // index of the next unused node, if the node isn't used
+      int                           m_left;
+      int                           m_right;          // -1 for the leaves
+      T*                            m_elem;           // NULL for the internal nodes and the unused ones
+
+      Node();
+
+      inline bool isLeaf() const { return m_right < 0; }
+   };
+
+   struct CentroidComparator;
+
+   Array< Node >                    m_nodes;
+   int                              m_root;
+   int                              m_unusedNodes;
+   std::map< const T*, int >        m_leaves;
+
+   float                            m_margin;
+   AxisAlignedBox                   m_sceneBounds;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param margin     the distance by which the elements may move before they need to be reinserted
+    */
+   AABBTree( float margin = 0.1f );
+   ~AABBTree();
+
+   /**
+    * Checks if an element is stored in the storage.
+    *
+    * @param elem
+    */
+   bool isAdded( const T& elem ) const;
+
+   /**
+    * Inserts an element into the storage.
+    *
+    * @param elem
+    */
+   void insert( T& elem );
+
+   /**
+    * Removes an element from the storage.
+    *
+    * @param elem
+    */
+   void remove( T& elem );
+
+   /**
+    * Clears the storage of all elements.
+    */
+   void clear();
+
+   /**
+    * Reinserts the elements that moved out of the bounds of their leaves, and recalculates
+    * the scene bounds.
+    */
+   void update();
+
+   /**
+    * Builds the tree from scratch.
+    */
+   void rebuild();
+
+   /**
+    * Queries the storage for elements located in the specified area.
+    *
+    * @param sceneArea
+    * @param output
+    */
+   template< typename AreaTestCallback >
+   void query( const AreaTestCallback& sceneArea, Array< T* >& output ) const;
+
+   /**
+    * Queries the storage for elements that may be located in the specified area.
+    *
+    * Only the internal nodes of the tree are tested - the elements of the leaves whose parents
+    * intersect the area are returned without testing their bounds. It's up to the caller to test them
+    * ( in batches, which is faster than testing them one by one ).
+    *
+    * @param sceneArea
+    * @param output
+    */
+   template< typename AreaTestCallback >
+   void queryCandidates( const AreaTestCallback& sceneArea, Array< T* >& output ) const;
+
+   /**
+    * Returns a bounding box around all elements.
+    *
+    * @param outBounds
+    */
+   void getSceneBounds( AxisAlignedBox& outBounds ) const;
+
+   /**
+    * Returns the number of elements in the storage.
+    */
+   uint size() const;
+
+private:
+   int allocateNode();
+   void releaseNode( int nodeIdx );
+
+   void insertLeaf( int leafIdx );
+   void removeLeaf( int leafIdx );
+   void refitAncestors( int nodeIdx );
+   int buildSubtree( Array< int >& leaves, uint start, uint end );
+
+   void setLeafBounds( Node& leaf, const AxisAlignedBox& elemBounds ) const;
+   static float calcSurfaceArea( const AxisAlignedBox& box );
+   static bool contains( const AxisAlignedBox& container, const AxisAlignedBox& box );
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "core\AABBTree.inl"
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _AABB_TREE_H
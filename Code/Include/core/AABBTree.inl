@@ -0,0 +1,570 @@
+#ifndef _AABB_TREE_H
+#error "This file can only be included from AABBTree.h"
+#else
+
+#include "core\Vector.h"
+#include <algorithm>
+#include <float.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+AABBTree< T >::Node::Node()
+   : m_parent( -1 )
+   , m_left( -1 )
+   , m_right( -1 )
+   , m_elem( NULL )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+struct AABBTree< T >::CentroidComparator
+{
+   const Array< Node >&    m_nodes;
+   int                     m_axis;
+
+   CentroidComparator( const Array< Node >& nodes, int axis )
+      : m_nodes( nodes )
+      , m_axis( axis )
+   {}
+
+   static float calcCentroid( const AxisAlignedBox& box, int axis )
+   {
+      // empty boxes ( of the elements that don't have any bounds yet ) are all placed in the center
+      // ( and we don't need to divide the sum by 2, we're only comparing the values )
+      return box.min[axis] <= box.max[axis] ? box.min[axis] + box.max[axis] : 0.0f;
+   }
+
+   bool operator()( int lhsIdx, int rhsIdx ) const
+   {
+      return calcCentroid( m_nodes[lhsIdx].m_bounds, m_axis ) < calcCentroid( m_nodes[rhsIdx].m_bounds, m_axis );
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+AABBTree< T >::AABBTree( float margin )
+   : m_nodes( 64 )
+   , m_root( -1 )
+   , m_unusedNodes( -1 )
+   , m_margin( margin )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+AABBTree< T >::~AABBTree()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+bool AABBTree< T >::isAdded( const T& elem ) const
+{
+   return m_leaves.find( &elem ) != m_leaves.end();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::insert( T& elem )
+{
+   if ( isAdded( elem ) )
+   {
+      return;
+   }
+
+   int leafIdx = allocateNode();
+   Node& leaf = m_nodes[leafIdx];
+   leaf.m_elem = &elem;
+
+   const AxisAlignedBox& bb = elem.getBoundingVolume();
+   setLeafBounds( leaf, bb );
+   m_sceneBounds.add( bb, m_sceneBounds );
+
+   m_leaves.insert( std::make_pair( &elem, leafIdx ) );
+   insertLeaf( leafIdx );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::remove( T& elem )
+{
+   typename std::map< const T*, int >::iterator it = m_leaves.find( &elem );
+   if ( it == m_leaves.end() )
+   {
+      return;
+   }
+
+   int leafIdx = it->second;
+   m_leaves.erase( it );
+
+   removeLeaf( leafIdx );
+   releaseNode( leafIdx );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::clear()
+{
+   m_nodes.clear();
+   m_leaves.clear();
+   m_root = -1;
+   m_unusedNodes = -1;
+   m_sceneBounds.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::update()
+{
+   m_sceneBounds.reset();
+
+   // Only the leaves store the elements. A reinserted leaf keeps its index, and the node
+   // it allocates for its new parent is the one the removal has just released - so the nodes
+   // array doesn't change its size while we're iterating over it.
+   const uint nodesCount = m_nodes.size();
+   for ( uint i = 0; i < nodesCount; ++i )
+   {
+      T* elem = m_nodes[i].m_elem;
+      if ( !elem )
+      {
+         continue;
+      }
+
+      const AxisAlignedBox& bb = elem->getBoundingVolume();
+      m_sceneBounds.add( bb, m_sceneBounds );
+
+      if ( !contains( m_nodes[i].m_bounds, bb ) )
+      {
+         removeLeaf( i );
+         setLeafBounds( m_nodes[i], bb );
+         insertLeaf( i );
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::rebuild()
+{
+   // gather the elements and start from a clean slate
+   Array< T* > elems( m_leaves.size() );
+   for ( typename std::map< const T*, int >::const_iterator it = m_leaves.begin(); it != m_leaves.end(); ++it )
+   {
+      elems.push_back( m_nodes[it->second].m_elem );
+   }
+   clear();
+
+   const uint elemsCount = elems.size();
+   if ( elemsCount == 0 )
+   {
+      return;
+   }
+
+   Array< int > leaves( elemsCount );
+   for ( uint i = 0; i < elemsCount; ++i )
+   {
+      T* elem = elems[i];
+
+      int leafIdx = allocateNode();
+      Node& leaf = m_nodes[leafIdx];
+      leaf.m_elem = elem;
+
+      const AxisAlignedBox& bb = elem->getBoundingVolume();
+      setLeafBounds( leaf, bb );
+      m_sceneBounds.add( bb, m_sceneBounds );
+
+      m_leaves.insert( std::make_pair( elem, leafIdx ) );
+      leaves.push_back( leafIdx );
+   }
+
+   m_root = buildSubtree( leaves, 0, elemsCount );
+   m_nodes[m_root].m_parent = -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T > template< typename AreaTestCallback >
+void AABBTree< T >::query( const AreaTestCallback& sceneArea, Array< T* >& output ) const
+{
+   if ( m_root < 0 )
+   {
+      return;
+   }
+
+   Array< int > nodesToVisit( 64 );
+   nodesToVisit.push_back( m_root );
+   while ( nodesToVisit.size() > 0 )
+   {
+      const uint lastIdx = nodesToVisit.size() - 1;
+      const Node& node = m_nodes[nodesToVisit[lastIdx]];
+      nodesToVisit.remove( lastIdx );
+
+      if ( node.isLeaf() )
+      {
+         // test the actual bounds of the element, not the enlarged ones, so that we return
+         // exactly the same elements a brute force test would
+         const AxisAlignedBox& elemBounds = node.m_elem->getBoundingVolume();
+         if ( sceneArea.testIntersection( elemBounds ) )
+         {
+            output.push_back( node.m_elem );
+         }
+      }
+      else if ( sceneArea.testIntersection( node.m_bounds ) )
+      {
+         nodesToVisit.push_back( node.m_left );
+         nodesToVisit.push_back( node.m_right );
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T > template< typename AreaTestCallback >
+void AABBTree< T >::queryCandidates( const AreaTestCallback& sceneArea, Array< T* >& output ) const
+{
+   if ( m_root < 0 )
+   {
+      return;
+   }
+
+   Array< int > nodesToVisit( 64 );
+   nodesToVisit.push_back( m_root );
+   while ( nodesToVisit.size() > 0 )
+   {
+      const uint lastIdx = nodesToVisit.size() - 1;
+      const Node& node = m_nodes[nodesToVisit[lastIdx]];
+      nodesToVisit.remove( lastIdx );
+
+      if ( node.isLeaf() )
+      {
+         output.push_back( node.m_elem );
+      }
+      else if ( sceneArea.testIntersection( node.m_bounds ) )
+      {
+         nodesToVisit.push_back( node.m_left );
+         nodesToVisit.push_back( node.m_right );
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::getSceneBounds( AxisAlignedBox& outBounds ) const
+{
+   outBounds = m_sceneBounds;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+uint AABBTree< T >::size() const
+{
+   return m_leaves.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+int AABBTree< T >::allocateNode()
+{
+   if ( m_unusedNodes < 0 )
+   {
+      m_nodes.push_back( Node() );
+      return m_nodes.size() - 1;
+   }
+
+   int nodeIdx = m_unusedNodes;
+   m_unusedNodes = m_nodes[nodeIdx].m_parent;
+   m_nodes[nodeIdx] = Node();
+
+   return nodeIdx;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::releaseNode( int nodeIdx )
+{
+   Node& node = m_nodes[nodeIdx];
+   node.m_elem = NULL;
+   node.m_left = -1;
+   node.m_right = -1;
+   node.m_parent = m_unusedNodes;
+   m_unusedNodes = nodeIdx;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::insertLeaf( int leafIdx )
+{
+   if ( m_root < 0 )
+   {
+      m_root = leafIdx;
+      m_nodes[leafIdx].m_parent = -1;
+      return;
+   }
+
+   // Descend the tree looking for the best sibling for the new leaf. The cost of a tree is
+   // the sum of the surface areas of its internal nodes, and every node we step through grows
+   // to accommodate the leaf.
+   const AxisAlignedBox leafBounds = m_nodes[leafIdx].m_bounds;
+   int siblingIdx = m_root;
+   while ( !m_nodes[siblingIdx].isLeaf() )
+   {
+      const Node& node = m_nodes[siblingIdx];
+
+      AxisAlignedBox combinedBounds;
+      node.m_bounds.add( leafBounds, combinedBounds );
+      const float area = calcSurfaceArea( node.m_bounds );
+      const float combinedArea = calcSurfaceArea( combinedBounds );
+
+      // the cost of making this node the sibling of the leaf
+      const float siblingCost = 2.0f * combinedArea;
+
+      // the minimum cost of pushing the leaf further down
+      const float inheritedCost = 2.0f * ( combinedArea - area );
+
+      float childrenCosts[2];
+      const int children[2] = { node.m_left, node.m_right };
+      for ( uint i = 0; i < 2; ++i )
+      {
+         const Node& child = m_nodes[children[i]];
+         child.m_bounds.add( leafBounds, combinedBounds );
+         childrenCosts[i] = calcSurfaceArea( combinedBounds ) + inheritedCost;
+         if ( !child.isLeaf() )
+         {
+            childrenCosts[i] -= calcSurfaceArea( child.m_bounds );
+         }
+      }
+
+      if ( siblingCost < childrenCosts[0] && siblingCost < childrenCosts[1] )
+      {
+         break;
+      }
+      siblingIdx = childrenCosts[0] < childrenCosts[1] ? children[0] : children[1];
+   }
+
+   // create a new parent for the leaf and its sibling ( careful - allocating a node may reallocate the nodes array )
+   const int oldParentIdx = m_nodes[siblingIdx].m_parent;
+   const int newParentIdx = allocateNode();
+
+   Node& newParent = m_nodes[newParentIdx];
+   newParent.m_parent = oldParentIdx;
+   newParent.m_left = siblingIdx;
+   newParent.m_right = leafIdx;
+   m_nodes[siblingIdx].m_bounds.add( leafBounds, newParent.m_bounds );
+
+   m_nodes[siblingIdx].m_parent = newParentIdx;
+   m_nodes[leafIdx].m_parent = newParentIdx;
+
+   if ( oldParentIdx < 0 )
+   {
+      m_root = newParentIdx;
+   }
+   else
+   {
+      Node& oldParent = m_nodes[oldParentIdx];
+      if ( oldParent.m_left == siblingIdx )
+      {
+         oldParent.m_left = newParentIdx;
+      }
+      else
+      {
+         oldParent.m_right = newParentIdx;
+      }
+      refitAncestors( oldParentIdx );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::removeLeaf( int leafIdx )
+{
+   if ( leafIdx == m_root )
+   {
+      m_root = -1;
+      return;
+   }
+
+   // the sibling takes the place of the leaf's parent
+   const int parentIdx = m_nodes[leafIdx].m_parent;
+   const Node& parent = m_nodes[parentIdx];
+   const int grandparentIdx = parent.m_parent;
+   const int siblingIdx = ( parent.m_left == leafIdx ) ? parent.m_right : parent.m_left;
+
+   m_nodes[siblingIdx].m_parent = grandparentIdx;
+   if ( grandparentIdx < 0 )
+   {
+      m_root = siblingIdx;
+   }
+   else
+   {
+      Node& grandparent = m_nodes[grandparentIdx];
+      if ( grandparent.m_left == parentIdx )
+      {
+         grandparent.m_left = siblingIdx;
+      }
+      else
+      {
+         grandparent.m_right = siblingIdx;
+      }
+      refitAncestors( grandparentIdx );
+   }
+
+   releaseNode( parentIdx );
+   m_nodes[leafIdx].m_parent = -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::refitAncestors( int nodeIdx )
+{
+   while ( nodeIdx >= 0 )
+   {
+      Node& node = m_nodes[nodeIdx];
+      m_nodes[node.m_left].m_bounds.add( m_nodes[node.m_right].m_bounds, node.m_bounds );
+      nodeIdx = node.m_parent;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+int AABBTree< T >::buildSubtree( Array< int >& leaves, uint start, uint end )
+{
+   const uint count = end - start;
+   if ( count == 1 )
+   {
+      return leaves[start];
+   }
+
+   // split along the axis the centroids are spread the most along
+   AxisAlignedBox centroidBounds;
+   for ( uint i = start; i < end; ++i )
+   {
+      const AxisAlignedBox& bounds = m_nodes[leaves[i]].m_bounds;
+      Vector centroid;
+      for ( int axis = 0; axis < 3; ++axis )
+      {
+         centroid[axis] = CentroidComparator::calcCentroid( bounds, axis );
+      }
+      centroidBounds.include( centroid );
+   }
+
+   Vector spread;
+   centroidBounds.getExtents( spread );
+   int splitAxis = 0;
+   for ( int axis = 1; axis < 3; ++axis )
+   {
+      if ( spread[axis] > spread[splitAxis] )
+      {
+         splitAxis = axis;
+      }
+   }
+
+   int* leavesRange = leaves.getRaw() + start;
+   std::sort( leavesRange, leavesRange + count, CentroidComparator( m_nodes, splitAxis ) );
+
+   // Pick the split that minimizes the surface area heuristic - the number of elements on each side,
+   // weighted by the area of their bounds. Sweep from the right first to gather the areas...
+   Array< float > rightAreas;
+   rightAreas.resize( count );
+   AxisAlignedBox bounds;
+   for ( uint i = count - 1; i > 0; --i )
+   {
+      bounds.add( m_nodes[leavesRange[i]].m_bounds, bounds );
+      rightAreas[i] = calcSurfaceArea( bounds );
+   }
+
+   // ...and then from the left, evaluating the splits
+   uint splitIdx = 1;
+   float minCost = FLT_MAX;
+   bounds.reset();
+   for ( uint i = 1; i < count; ++i )
+   {
+      bounds.add( m_nodes[leavesRange[i - 1]].m_bounds, bounds );
+      const float cost = i * calcSurfaceArea( bounds ) + ( count - i ) * rightAreas[i];
+      if ( cost < minCost )
+      {
+         minCost = cost;
+         splitIdx = i;
+      }
+   }
+
+   const int leftIdx = buildSubtree( leaves, start, start + splitIdx );
+   const int rightIdx = buildSubtree( leaves, start + splitIdx, end );
+
+   const int nodeIdx = allocateNode();
+   Node& node = m_nodes[nodeIdx];
+   node.m_left = leftIdx;
+   node.m_right = rightIdx;
+   m_nodes[leftIdx].m_bounds.add( m_nodes[rightIdx].m_bounds, node.m_bounds );
+
+   m_nodes[leftIdx].m_parent = nodeIdx;
+   m_nodes[rightIdx].m_parent = nodeIdx;
+
+   return nodeIdx;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void AABBTree< T >::setLeafBounds( Node& leaf, const AxisAlignedBox& elemBounds ) const
+{
+   Vector margin;
+   margin.set( m_margin, m_margin, m_margin );
+
+   leaf.m_bounds.min.setSub( elemBounds.min, margin );
+   leaf.m_bounds.max.setAdd( elemBounds.max, margin );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+float AABBTree< T >::calcSurfaceArea( const AxisAlignedBox& box )
+{
+   // AxisAlignedBox::calcArea calculates the area of the box's XY projection, and we need
+   // all the faces. Empty boxes have no area.
+   Vector extents;
+   box.getExtents( extents );
+
+   float x = extents[0] > 0.0f ? extents[0] : 0.0f;
+   float y = extents[1] > 0.0f ? extents[1] : 0.0f;
+   float z = extents[2] > 0.0f ? extents[2] : 0.0f;
+
+   // half of the actual area - it's only used for comparisons
+   return x * y + y * z + z * x;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+bool AABBTree< T >::contains( const AxisAlignedBox& container, const AxisAlignedBox& box )
+{
+   VectorComparison c1, c2;
+   box.min.less( container.min, c1 );
+   container.max.less( box.max, c2 );
+   c1.setOr( c1, c2 );
+
+   return c1.areAllClear< VectorComparison::MASK_XYZ >();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _AABB_TREE_H
@@ -18,7 +18,7 @@ Array< T >::Array( unsigned int size, MemoryAllocator* allocator )
    if ( !m_allocator )
    {
       // no allocator was specified, so we need to create our own
-      m_allocator = &TSingleton< MemoryRouter >::getInstance().m_defaultAllocator;
+      m_allocator = TSingleton< MemoryRouter >::getInstance().getDefaultAllocator();
    }
 
    m_arr = (T*)TSingleton< MemoryRouter >::getInstance().alloc( sizeof( T ), GET_ALLOC_MODE( T ), m_allocator );
@@ -0,0 +1,84 @@
+/// @file   core/Atomic.h
+/// @brief  integer value with atomic access operations
+#ifndef _ATOMIC_H
+#define _ATOMIC_H
+
+#include "core\MemoryRouter.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * An integer value that can be safely modified by multiple threads at once
+ * without the need to lock it.
+ *
+ * All modifying operations act as full memory barriers.
+ */
+class AtomicInt
+{
+   DECLARE_ALLOCATOR( AtomicInt, AM_DEFAULT );
+
+private:
+   volatile long        m_val;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param val     initial value
+    */
+   inline AtomicInt( long val = 0 );
+
+   /**
+    * Returns the current value.
+    */
+   inline long get() const;
+
+   /**
+    * Sets a new value.
+    *
+    * @param val
+    */
+   inline void set( long val );
+
+   /**
+    * Increments the value, returning the incremented value.
+    */
+   inline long increment();
+
+   /**
+    * Decrements the value, returning the decremented value.
+    */
+   inline long decrement();
+
+   /**
+    * Adds the specified number to the value, returning the new value.
+    *
+    * @param delta
+    */
+   inline long add( long delta );
+
+   /**
+    * Sets a new value, returning the previous one.
+    *
+    * @param val
+    */
+   inline long exchange( long val );
+
+   /**
+    * Sets a new value only if the current value equals the comparand.
+    *
+    * @param val
+    * @param comparand
+    * @return           value stored before the operation
+    */
+   inline long compareExchange( long val, long comparand );
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "core\Atomic.inl"
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _ATOMIC_H
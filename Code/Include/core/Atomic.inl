@@ -0,0 +1,66 @@
+#ifndef _ATOMIC_H
+#error "This file can only be included from Atomic.h"
+#else
+
+#include <intrin.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+AtomicInt::AtomicInt( long val )
+   : m_val( val )
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+long AtomicInt::get() const
+{
+   return m_val;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void AtomicInt::set( long val )
+{
+   _InterlockedExchange( &m_val, val );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+long AtomicInt::increment()
+{
+   return _InterlockedIncrement( &m_val );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+long AtomicInt::decrement()
+{
+   return _InterlockedDecrement( &m_val );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+long AtomicInt::add( long delta )
+{
+   return _InterlockedExchangeAdd( &m_val, delta ) + delta;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+long AtomicInt::exchange( long val )
+{
+   return _InterlockedExchange( &m_val, val );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+long AtomicInt::compareExchange( long val, long comparand )
+{
+   return _InterlockedCompareExchange( &m_val, val, comparand );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _ATOMIC_H
@@ -0,0 +1,101 @@
+/// @file   core/ConditionVariable.h
+/// @brief  threads synchronization tool
+#ifndef _CONDITION_VARIABLE_H
+#define _CONDITION_VARIABLE_H
+
+#include "core\MemoryRouter.h"
+#include "core\Atomic.h"
+#include "core\CriticalSection.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A condition variable lets a thread go to sleep until the state it's waiting for
+ * gets changed by another thread, instead of polling that state in a loop.
+ *
+ * The state the waiting threads depend on has to be modified while holding the critical
+ * section the threads wait with, and the thread that changes it has to notify the variable
+ * before it releases that section.
+ *
+ * waitUntil uses an adaptive spin-then-sleep policy - it polls the condition for a while
+ * before it puts the thread to sleep, and adjusts the duration of that spin depending on
+ * whether the spinning paid off the previous time.
+ */
+class ConditionVariable
+{
+   DECLARE_ALLOCATOR( ConditionVariable, AM_DEFAULT );
+
+public:
+   static const uint    MIN_SPINS_COUNT = 1;
+   static const uint    MAX_SPINS_COUNT = 4096;
+
+private:
+   void*                m_conditionVariable;
+   AtomicInt            m_waitersCount;
+   volatile uint        m_spinsLimit;
+
+public:
+   /**
+    * Constructor.
+    */
+   ConditionVariable();
+   ~ConditionVariable();
+
+   /**
+    * Puts the calling thread to sleep until the variable is notified.
+    *
+    * The thread has to hold the specified critical section - it will be released for the duration
+    * of the sleep, and reacquired once the thread wakes up. The thread may wake up spuriously,
+    * so remember to call it in a loop that checks the awaited condition.
+    *
+    * @param lock
+    */
+   void wait( CriticalSection& lock );
+
+   /**
+    * Blocks the calling thread until the specified predicate is fulfilled.
+    *
+    * The predicate is evaluated while holding the specified critical section - the calling thread
+    * mustn't hold it when calling the method.
+    *
+    * @param lock
+    * @param predicate     a functor with a `bool operator()() const`
+    */
+   template< typename TPredicate >
+   void waitUntil( CriticalSection& lock, const TPredicate& predicate );
+
+   /**
+    * Wakes up one of the waiting threads.
+    */
+   void notifyOne();
+
+   /**
+    * Wakes up all waiting threads.
+    */
+   void notifyAll();
+
+   /**
+    * Returns the number of times waitUntil will poll the condition before the thread is put to sleep.
+    */
+   inline uint getSpinsLimit() const { return m_spinsLimit; }
+
+private:
+   void sleep( CriticalSection& lock );
+   void onSpinFinished( bool successful );
+   static void pause();
+
+   // -------------------------------------------------------------------------
+   // We don't allow for copying of condition variables
+   // -------------------------------------------------------------------------
+   ConditionVariable( const ConditionVariable& rhs ) {}
+   void operator=( const ConditionVariable& rhs ) {}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "core\ConditionVariable.inl"
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _CONDITION_VARIABLE_H
@@ -0,0 +1,47 @@
+#ifndef _CONDITION_VARIABLE_H
+#error "This file can only be included in ConditionVariable.h"
+#else
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename TPredicate >
+void ConditionVariable::waitUntil( CriticalSection& lock, const TPredicate& predicate )
+{
+   // poll the condition for a while first - if it gets fulfilled soon enough,
+   // we'll save ourselves the cost of putting the thread to sleep and waking it up
+   const uint spinsLimit = m_spinsLimit;
+   for ( uint i = 0; i < spinsLimit; ++i )
+   {
+      lock.enter();
+      const bool isFulfilled = predicate();
+      lock.leave();
+
+      if ( isFulfilled )
+      {
+         onSpinFinished( true );
+         return;
+      }
+
+      pause();
+   }
+
+   // Go to sleep. We need to register as a waiter before the condition is checked, so that
+   // the thread that changes the state under the lock knows there's someone to notify
+   m_waitersCount.increment();
+
+   lock.enter();
+   while ( !predicate() )
+   {
+      sleep( lock );
+   }
+   lock.leave();
+
+   m_waitersCount.decrement();
+
+   onSpinFinished( false );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _CONDITION_VARIABLE_H
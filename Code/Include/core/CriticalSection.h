@@ -21,6 +21,8 @@ class CriticalSection
    // memory allocations - so it's going to be instantiated before we have a memory system in place
 
 private:
+   friend class ConditionVariable;
+
    void*    m_criticalSectionHandle;
 
 public:
@@ -11,6 +11,12 @@
  */
 #define _USE_FAST_ARRAYS
 
+/**
+ * Makes the MemoryRouter allocate objects with the ThreadCachingAllocator
+ * instead of the DefaultAllocator.
+ */
+#define _USE_THREAD_CACHING_ALLOCATOR
+
 /**
  * Toggles global allocations tracing - each time global new/delete operators
  * will be used, a message will be logged.
@@ -125,6 +125,11 @@ public:
     */
    void setSize( std::size_t newSize );
 
+   /**
+    * Returns the operating system handle of the file.
+    */
+   HANDLE getSystemHandle() const;
+
 protected:
    friend class Filesystem;
 
@@ -19,6 +19,9 @@ class InStream;
 /**
  * This class represents a path to a file in our file system ( relative
  * to the filesystem root ).
+ *
+ * The path keeps a hash of its contents ( calculated the same way IDStrings are ), 
+ * so that paths can be quickly told apart and used as keys of hashed containers.
  */
 class FilePath
 {
@@ -26,6 +29,7 @@ class FilePath
 
 private:
    std::string       m_relativePath;
+   uint              m_hash;
 
 public:
    /**
@@ -70,10 +74,15 @@ public:
     */
    inline const std::string& getRelativePath() const { return m_relativePath; }
 
+   /**
+    * Returns the hash of the path.
+    */
+   inline uint getHash() const { return m_hash; }
+
    /**
     * Assignment operator.
     */
-   inline void operator=( const FilePath& rhs ) { m_relativePath = rhs.m_relativePath; }
+   inline void operator=( const FilePath& rhs ) { m_relativePath = rhs.m_relativePath; m_hash = rhs.m_hash; }
 
    /**
     * Conversion operator.
@@ -85,14 +94,14 @@ public:
     *
     * @param rhs
     */
-   inline bool operator==( const FilePath& rhs ) const { return m_relativePath == rhs.m_relativePath; }
+   inline bool operator==( const FilePath& rhs ) const { return m_hash == rhs.m_hash && m_relativePath == rhs.m_relativePath; }
 
    /**
     * Inequality operator.
     *
     * @param rhs
     */
-   bool operator!=( const FilePath& rhs ) const { return m_relativePath != rhs.m_relativePath; }
+   bool operator!=( const FilePath& rhs ) const { return m_hash != rhs.m_hash || m_relativePath != rhs.m_relativePath; }
 
    /**
     * Comparison operator.
@@ -246,6 +255,9 @@ public:
    * @param outPathElements
    */
    void getElements( List< std::string >& outPathElements ) const;
+
+private:
+   void updateHash();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
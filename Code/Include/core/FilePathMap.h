@@ -0,0 +1,138 @@
+/// @file   core/FilePathMap.h
+/// @brief  a hash map keyed by file paths
+#ifndef _FILE_PATH_MAP_H
+#define _FILE_PATH_MAP_H
+
+#include "core\MemoryRouter.h"
+#include "core\FilePath.h"
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A hash map keyed by file paths.
+ *
+ * The entries are stored in a continuous array ( so iterating over them is cheap,
+ * although they're not ordered in any way ), and they are indexed by an open addressing
+ * table of the paths hashes, which is kept at most half full.
+ *
+ * Removing an entry moves the last entry in its place, so the indices of the entries
+ * aren't stable.
+ */
+template< typename T >
+class TFilePathMap
+{
+   DECLARE_ALLOCATOR( TFilePathMap, AM_DEFAULT );
+
+public:
+   struct Entry
+   {
+      FilePath    m_path;
+      T           m_value;
+
+      Entry( const FilePath& path, const T& value ) : m_path( path ), m_value( value ) {}
+   };
+
+private:
+   struct Slot
+   {
+      uint        m_hash;
+      int         m_entryIdx;       // -1 if the slot is empty
+   };
+
+   std::vector< Entry >             m_entries;
+   std::vector< Slot >              m_slots;
+
+public:
+   /**
+    * Constructor.
+    */
+   TFilePathMap();
+
+   /**
+    * Returns the number of entries.
+    */
+   inline uint size() const { return m_entries.size(); }
+
+   /**
+    * Tells if the map is empty.
+    */
+   inline bool empty() const { return m_entries.empty(); }
+
+   /**
+    * Returns an entry with the specified index.
+    *
+    * @param idx
+    */
+   inline Entry& getEntry( uint idx ) { return m_entries[idx]; }
+
+   /**
+    * Returns an entry with the specified index ( const version ).
+    *
+    * @param idx
+    */
+   inline const Entry& getEntry( uint idx ) const { return m_entries[idx]; }
+
+   /**
+    * Looks for a value stored under the specified path.
+    *
+    * @param path
+    * @return     pointer to the value, or NULL if there's no such entry
+    */
+   T* find( const FilePath& path );
+
+   /**
+    * Looks for a value stored under the specified path ( const version ).
+    *
+    * @param path
+    * @return     pointer to the value, or NULL if there's no such entry
+    */
+   const T* find( const FilePath& path ) const;
+
+   /**
+    * Inserts a new entry.
+    *
+    * @param path
+    * @param value
+    * @return     'true' if the entry was inserted, 'false' if there already is an entry with that path
+    */
+   bool insert( const FilePath& path, const T& value );
+
+   /**
+    * Removes the entry with the specified path.
+    *
+    * @param path
+    * @return     'true' if the entry was removed, 'false' if there wasn't one
+    */
+   bool remove( const FilePath& path );
+
+   /**
+    * Removes all entries.
+    */
+   void clear();
+
+   /**
+    * Moves an entry to a different path.
+    *
+    * @param oldPath
+    * @param newPath
+    * @return     'true' if the entry was moved, 'false' if there's no entry with the old path,
+    *             or if there already is one with the new path
+    */
+   bool changePath( const FilePath& oldPath, const FilePath& newPath );
+
+private:
+   int findSlot( const FilePath& path ) const;
+   void insertSlot( uint hash, int entryIdx );
+   void removeSlot( uint slotIdx );
+   void rehash( uint slotsCount );
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "core\FilePathMap.inl"
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _FILE_PATH_MAP_H
@@ -0,0 +1,197 @@
+#ifndef _FILE_PATH_MAP_H
+#error "This file can only be included from FilePathMap.h"
+#else
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+TFilePathMap< T >::TFilePathMap()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+T* TFilePathMap< T >::find( const FilePath& path )
+{
+   int slotIdx = findSlot( path );
+   return slotIdx >= 0 ? &m_entries[ m_slots[slotIdx].m_entryIdx ].m_value : NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+const T* TFilePathMap< T >::find( const FilePath& path ) const
+{
+   int slotIdx = findSlot( path );
+   return slotIdx >= 0 ? &m_entries[ m_slots[slotIdx].m_entryIdx ].m_value : NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+bool TFilePathMap< T >::insert( const FilePath& path, const T& value )
+{
+   if ( findSlot( path ) >= 0 )
+   {
+      return false;
+   }
+
+   // keep the table at most half full, so that the probe sequences stay short
+   const uint newEntriesCount = m_entries.size() + 1;
+   if ( newEntriesCount * 2 > m_slots.size() )
+   {
+      rehash( m_slots.empty() ? 16 : m_slots.size() * 2 );
+   }
+
+   m_entries.push_back( Entry( path, value ) );
+   insertSlot( path.getHash(), newEntriesCount - 1 );
+
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+bool TFilePathMap< T >::remove( const FilePath& path )
+{
+   int slotIdx = findSlot( path );
+   if ( slotIdx < 0 )
+   {
+      return false;
+   }
+
+   const int entryIdx = m_slots[slotIdx].m_entryIdx;
+   removeSlot( slotIdx );
+
+   // move the last entry in place of the removed one
+   const int lastEntryIdx = m_entries.size() - 1;
+   if ( entryIdx != lastEntryIdx )
+   {
+      int movedSlotIdx = findSlot( m_entries[lastEntryIdx].m_path );
+      m_slots[movedSlotIdx].m_entryIdx = entryIdx;
+      m_entries[entryIdx] = m_entries[lastEntryIdx];
+   }
+   m_entries.pop_back();
+
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void TFilePathMap< T >::clear()
+{
+   m_entries.clear();
+   m_slots.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+bool TFilePathMap< T >::changePath( const FilePath& oldPath, const FilePath& newPath )
+{
+   int slotIdx = findSlot( oldPath );
+   if ( slotIdx < 0 || findSlot( newPath ) >= 0 )
+   {
+      return false;
+   }
+
+   const int entryIdx = m_slots[slotIdx].m_entryIdx;
+   removeSlot( slotIdx );
+
+   m_entries[entryIdx].m_path = newPath;
+   insertSlot( newPath.getHash(), entryIdx );
+
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+int TFilePathMap< T >::findSlot( const FilePath& path ) const
+{
+   if ( m_slots.empty() )
+   {
+      return -1;
+   }
+
+   const uint hash = path.getHash();
+   const uint mask = m_slots.size() - 1;
+   for ( uint slotIdx = hash & mask; ; slotIdx = ( slotIdx + 1 ) & mask )
+   {
+      const Slot& slot = m_slots[slotIdx];
+      if ( slot.m_entryIdx < 0 )
+      {
+         return -1;
+      }
+
+      if ( slot.m_hash == hash && m_entries[slot.m_entryIdx].m_path == path )
+      {
+         return slotIdx;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void TFilePathMap< T >::insertSlot( uint hash, int entryIdx )
+{
+   const uint mask = m_slots.size() - 1;
+
+   uint slotIdx = hash & mask;
+   while ( m_slots[slotIdx].m_entryIdx >= 0 )
+   {
+      slotIdx = ( slotIdx + 1 ) & mask;
+   }
+
+   m_slots[slotIdx].m_hash = hash;
+   m_slots[slotIdx].m_entryIdx = entryIdx;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void TFilePathMap< T >::removeSlot( uint slotIdx )
+{
+   // There are no tombstones - instead the slots that follow the removed one are shifted back
+   // to fill the gap, unless that would put them before the slot their hash points to
+   const uint mask = m_slots.size() - 1;
+
+   uint gapIdx = slotIdx;
+   for ( uint idx = ( slotIdx + 1 ) & mask; m_slots[idx].m_entryIdx >= 0; idx = ( idx + 1 ) & mask )
+   {
+      const uint homeIdx = m_slots[idx].m_hash & mask;
+      bool canFillGap = ( idx > gapIdx ) ? ( homeIdx <= gapIdx || homeIdx > idx ) : ( homeIdx <= gapIdx && homeIdx > idx );
+      if ( canFillGap )
+      {
+         m_slots[gapIdx] = m_slots[idx];
+         gapIdx = idx;
+      }
+   }
+
+   m_slots[gapIdx].m_entryIdx = -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void TFilePathMap< T >::rehash( uint slotsCount )
+{
+   Slot emptySlot;
+   emptySlot.m_hash = 0;
+   emptySlot.m_entryIdx = -1;
+   m_slots.assign( slotsCount, emptySlot );
+
+   const uint entriesCount = m_entries.size();
+   for ( uint i = 0; i < entriesCount; ++i )
+   {
+      insertSlot( m_entries[i].m_path.getHash(), i );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _FILE_PATH_MAP_H
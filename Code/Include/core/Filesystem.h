@@ -19,6 +19,7 @@
 class File;
 class FilePath;
 class CriticalSection;
+class ConditionVariable;
 class FilesystemScanner;
 class FilesystemChangesTracker;
 class FilesystemSnapshot;
@@ -153,6 +154,7 @@ private:
    Listeners                     m_listeners;
 
    CriticalSection*              m_fsAccessLock;
+   ConditionVariable*            m_fileClosed;
    OpenFilesDescriptors          m_openFiles;
 
    FilesystemChangesTracker*     m_changesScanner;
@@ -316,7 +318,15 @@ private:
     */
    void notifyFileClosed( const FilePath& fileName );
 
-   File* tryOpenFile( const FilePath& fileName, const std::ios_base::openmode mode );
+   /**
+    * Registers the file as open, provided it's not open for writing already ( and it's not open
+    * at all, if it's about to be written ). Must be called with m_fsAccessLock held.
+    *
+    * @param fileName
+    * @param mode
+    * @return  'true' if the file can be opened, 'false' otherwise
+    */
+   bool tryReservingFile( const FilePath& fileName, const std::ios_base::openmode mode );
 
    /**
     * Broadcasts the specified filesystem changes to the listeners.
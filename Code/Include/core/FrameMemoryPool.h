@@ -0,0 +1,116 @@
+/// @file   core/FrameMemoryPool.h
+/// @brief  a thread-safe, double-buffered memory pool for the per-frame data
+#pragma once
+
+#include "core\types.h"
+#include "core\MemoryRouter.h"
+#include "core\MemoryAllocator.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class CriticalSection;
+class ConditionVariable;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A thread-safe linear memory pool dedicated to the data that lives for a single frame.
+ *
+ * The pool is double-buffered - the allocations are made in the active frame, and a frame's
+ * memory gets reclaimed as soon as the last of its allocations is released. That way one thread
+ * can be filling the next frame with data ( see nextFrame ), while the other one is still
+ * consuming the previous one, and the memory of the consumed frame doesn't have to wait
+ * for the next one to be released.
+ *
+ * A frame grows by chaining pages of memory, so there's no upper limit on its size - the pages
+ * are recycled once the frame memory gets reclaimed.
+ *
+ * The allocated memory is aligned to a 16 byte boundary.
+ */
+class FrameMemoryPool : public MemoryAllocator
+{
+   DECLARE_ALLOCATOR( FrameMemoryPool, AM_DEFAULT );
+
+private:
+   struct Page
+   {
+      Page*                m_nextPage;
+      size_t               m_size;
+      size_t               m_allocStartOffset;
+
+      // the memory starts at the first aligned address past the header
+      inline char* getMemory() { return (char*)( ( (size_t)( this + 1 ) + MEMORY_ALIGNMENT - 1 ) & ~( MEMORY_ALIGNMENT - 1 ) ); }
+   };
+
+   struct Frame
+   {
+      Page*                m_firstPage;
+      Page*                m_lastPage;
+      uint                 m_allocationsCount;
+      size_t               m_memoryUsed;
+   };
+
+   struct FrameDrainedPredicate;
+
+private:
+   static const size_t     MEMORY_ALIGNMENT = 16;
+   static const size_t     POOL_INFO_CHUNK_SIZE = MEMORY_ALIGNMENT;
+
+   size_t                  m_pageSize;
+   Frame                   m_frames[2];
+   uint                    m_activeFrameIdx;
+
+   Page*                   m_freePages;
+   uint                    m_pagesCount;
+   size_t                  m_highWaterMark;
+
+   CriticalSection*        m_lock;
+   ConditionVariable*      m_frameDrained;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param pageSize      size of a single page of memory
+    */
+   FrameMemoryPool( size_t pageSize );
+   ~FrameMemoryPool();
+
+   /**
+    * Closes the active frame and starts allocating in the other one.
+    *
+    * The other frame is the one closed the time before - if the consumer didn't release all
+    * of its allocations yet, the method blocks until it does.
+    */
+   void nextFrame();
+
+   /**
+    * Returns the largest amount of memory a single frame used so far.
+    */
+   size_t getHighWaterMark() const;
+
+   /**
+    * Returns the number of memory pages the pool allocated.
+    */
+   inline uint getPagesCount() const { return m_pagesCount; }
+
+   // -------------------------------------------------------------------------
+   // MemoryAllocator implementation
+   // -------------------------------------------------------------------------
+   void* alloc( size_t size );
+   void dealloc( void* ptr );
+   ulong getMemoryUsed() const;
+
+private:
+   Page* acquirePage( size_t minSize );
+   void releasePages( Frame& frame );
+
+   // -------------------------------------------------------------------------
+   // We don't allow for copying of memory pools
+   // -------------------------------------------------------------------------
+   FrameMemoryPool( const FrameMemoryPool& rhs ) {}
+   void operator=( const FrameMemoryPool& rhs ) {}
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 struct AxisAlignedBox;
+class PackedAxisAlignedBoxes;
 struct Sphere;
 struct Matrix;
 struct Frustum;
@@ -71,6 +72,29 @@ ALIGN_16 struct Frustum
     * @param aabb
     */
    bool isInside( const Sphere& sphere ) const;
+
+   /**
+    * Tests a batch of axis-aligned bounding boxes, 4 boxes at a time.
+    *
+    * The results are exactly the same as the ones 'isInside' would give for the individual boxes.
+    *
+    * @param boxes
+    * @param outVisible    an array the results will be written to ( 1 for the boxes inside the frustum,
+    *                      0 for the ones outside ). Must be able to accommodate boxes.size() entries.
+    */
+   void cull( const PackedAxisAlignedBoxes& boxes, byte* outVisible ) const;
+
+   /**
+    * Tests an array of axis-aligned bounding boxes, 4 boxes at a time.
+    *
+    * The boxes are packed on the fly - if the same boxes are tested many times, it's faster
+    * to keep them in a PackedAxisAlignedBoxes collection.
+    *
+    * @param boxes
+    * @param count
+    * @param outVisible    an array the results will be written to. Must be able to accommodate 'count' entries.
+    */
+   void cull( const AxisAlignedBox* boxes, uint count, byte* outVisible ) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,77 @@
 #include "core\Singleton.h"
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+class CriticalSection;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Hashes strings into ids used by the IDString class ( 32-bit FNV-1a ).
+ *
+ * Both versions yield the same values - the one that takes a string literal
+ * gets folded into a constant by the compiler.
+ */
+class IDStringHash
+{
+public:
+   static const uint OFFSET_BASIS = 2166136261u;
+   static const uint PRIME = 16777619u;
+
+   /**
+    * Hashes a string of an arbitrary length.
+    *
+    * @param str
+    */
+   static uint calculate( const char* str );
+
+   /**
+    * Hashes a string literal.
+    *
+    * @param str
+    */
+   template< uint N >
+   static __forceinline uint calculateLiteral( const char ( &str )[N] )
+   {
+      return Step< N, N - 1 >::calculate( str );
+   }
+
+private:
+   template< uint N, uint I >
+   struct Step
+   {
+      static __forceinline uint calculate( const char ( &str )[N] )
+      {
+         return ( Step< N, I - 1 >::calculate( str ) ^ ( byte )str[I - 1] ) * PRIME;
+      }
+   };
+
+   template< uint N >
+   struct Step< N, 0 >
+   {
+      static __forceinline uint calculate( const char ( &str )[N] )
+      {
+         return OFFSET_BASIS;
+      }
+   };
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Creates an IDString from a string literal.
+ *
+ * In release builds the id is calculated at compile time and the strings pool isn't touched at all,
+ * so it's the way to go in the hot code paths. Mind that the string needs to be registered
+ * in the pool by other means for IDString::c_str to return it ( debug builds always register it ).
+ */
+#ifdef _DEBUG
+   #define IDSTR( literal ) IDString( literal )
+#else
+   #define IDSTR( literal ) IDString( IDStringHash::calculateLiteral( literal ) )
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -19,6 +90,8 @@
  * faster and cheaper, because instead of holding an actual string, it simply
  * holds a reference to a single string stored in a singleton instance of a pool
  * of strings ( IDStringsPool class instance that is ).
+ *
+ * The id is the hash of the string, so it's stable between runs.
  */
 class IDString
 {
@@ -31,7 +104,7 @@ public:
    /**
     * Constructor
     *
-    * @param stringId         id of a string that's already in the ids pool
+    * @param stringId         id of a string ( see IDStringHash )
     */
    IDString( uint stringId = 0 );
 
@@ -85,13 +158,43 @@ public:
 
 /**
  * A singleton repository of all string referenced by IDString instances.
+ *
+ * The strings are indexed with an open addressing hash table. Lookups don't
+ * take any locks, so the pool can be safely queried from many threads at once - only
+ * registering a new string requires an exclusive access.
  */
 class IDStringsPool
 {
    PRIORITY_SINGLETON( 5 );
 
 private:
-   Array< char* >             m_strings;
+   struct Entry
+   {
+      uint                    m_hash;
+      const char* volatile    m_str;         // NULL marks an empty entry
+   };
+
+   struct Table
+   {
+      uint                    m_capacity;    // always a power of 2
+      Entry*                  m_entries;
+   };
+
+   static const uint          INITIAL_CAPACITY = 1024;
+   static const uint          ARENA_PAGE_SIZE = 16384;
+
+   Table* volatile            m_table;
+   uint                       m_stringsCount;
+   CriticalSection*           m_insertLock;
+
+   // tables replaced by bigger ones - lookups that started before a table was replaced
+   // may still be reading it, so we keep them around until the pool is destroyed
+   Array< Table* >            m_retiredTables;
+
+   // the strings are stored in large pages
+   Array< char* >             m_arenaPages;
+   char*                      m_arenaPage;
+   uint                       m_arenaPageOffset;
 
 public:
    /**
@@ -108,16 +211,32 @@ public:
    /**
     * Registers a string and assigns it a unique id.
     *
+    * The id is the hash of the string. If the string's hash collides with that of a string
+    * registered earlier, the collision is reported and the application is terminated - in every build.
+    *
     * @param str
     */
    uint registerString( const char* str );
 
    /**
-    * Returns a string corresponding to the specified id.
+    * Returns a string corresponding to the specified id, or an empty string
+    * if no string with such id was registered.
     *
     * @para stringId
     */
    const char* getString( uint stringId ) const;
+
+   /**
+    * Returns the number of registered strings.
+    */
+   inline uint getStringsCount() const { return m_stringsCount; }
+
+private:
+   void init();
+   const Entry* find( const Table* table, uint hash ) const;
+   const char* storeString( const char* str );
+   void insert( Table* table, uint hash, const char* str );
+   void grow();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
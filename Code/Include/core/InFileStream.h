@@ -13,21 +13,36 @@ class File;
 ///////////////////////////////////////////////////////////////////////////////
 /**
  * This stream will persist data in a simple binary file archive.
+ *
+ * The stream can read the file ahead in large blocks, so that loading small values
+ * doesn't result in a file system call each time.
  */
 class InFileStream: public InStream
 {
    DECLARE_ALLOCATOR( InFileStream, AM_DEFAULT );
 
+public:
+   static const uint DEFAULT_READ_AHEAD_SIZE = 65536;
+
 private:
-   File* m_archive;
+   File*    m_archive;
+
+   byte*    m_buffer;
+   uint     m_bufferSize;
+   uint     m_bufferedBytesCount;
+   uint     m_bufferOffset;
 
 public:
    /**
     * Constructor.
     *
-    * @param archive    binary file archive
+    * The read-ahead buffer moves the file position past the data the stream actually loaded,
+    * so don't use it if you intend to read from the file directly while the stream's alive.
+    *
+    * @param archive          binary file archive
+    * @param readAheadSize    size of the read-ahead buffer ( 0 means that the data will be read straight from the file )
     */
-   InFileStream( File* archive );
+   InFileStream( File* archive, uint readAheadSize = 0 );
    ~InFileStream();
 
 protected:
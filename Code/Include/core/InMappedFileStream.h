@@ -0,0 +1,57 @@
+/// @file   core\InMappedFileStream.h
+/// @brief  stream that reads a binary file archive mapped into memory
+#pragma once
+
+#include "core/InStream.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class File;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * This stream maps the entire file archive into the address space of the process
+ * and reads the data straight from the mapped pages.
+ *
+ * It's meant for read-only access - use it when the archive is going to be read
+ * from start to finish, as is the case with resources.
+ */
+class InMappedFileStream : public InStream
+{
+   DECLARE_ALLOCATOR( InMappedFileStream, AM_DEFAULT );
+
+private:
+   File*             m_archive;
+
+   void*             m_mapping;
+   const byte*       m_data;
+   byte*             m_fallbackBuffer;    // file contents, if the file couldn't be mapped
+   uint              m_size;
+   uint              m_offset;
+
+public:
+   /**
+    * Constructor.
+    *
+    * If the file can't be mapped, its contents will be read into memory instead.
+    *
+    * @param archive    binary file archive
+    */
+   InMappedFileStream( File* archive );
+   ~InMappedFileStream();
+
+   /**
+    * Tells if the file was successfully mapped into memory.
+    */
+   inline bool isMapped() const { return m_mapping != NULL; }
+
+protected:
+   // ----------------------------------------------------------------------
+   // InStream implementation
+   // ----------------------------------------------------------------------
+   void load( void* val, unsigned int dataSize );
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -8,6 +8,7 @@
 #include "core\MemoryRouter.h"
 #include "core\types.h"
 #include "core\Array.h"
+#include "core\StreamTraits.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -31,7 +32,8 @@ public:
    InStream& operator>>( T& val );
 
    /**
-    * Loads array of POD data from the stream.
+    * Loads an array from the stream. The elements are loaded as a single block of memory,
+    * unless they need to be streamed one by one ( see TStreamedElementwise ).
     *
     * @param val     loaded array
     */
@@ -39,7 +41,8 @@ public:
    InStream& operator>>( std::vector< T >& val );
 
    /**
-    * Loads array of POD data from the stream.
+    * Loads an array from the stream. The elements are loaded as a single block of memory,
+    * unless they need to be streamed one by one ( see TStreamedElementwise ).
     *
     * @param val     loaded array
     */
@@ -67,6 +70,13 @@ public:
     * @param dataSize   size ( in bytes ) of the data we want to load from the stream
     */
    virtual void load( void* val, unsigned int dataSize ) = 0;
+
+private:
+   template< typename T >
+   void loadElements( T* elements, uint count, const std::true_type& memoryImage );
+
+   template< typename T >
+   void loadElements( T* elements, uint count, const std::false_type& memoryImage );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -25,9 +25,9 @@ InStream& InStream::operator>>( std::vector< T >& val )
    val.resize( size );
 
    // load the elements
-   for ( uint i = 0; i < size; ++i )
+   if ( size > 0 )
    {
-      load( (void*)&val[i], sizeof( T ) );
+      loadElements( &val[0], size, std::integral_constant< bool, !TStreamedElementwise< T >::value >() );
    }
 
    return *this;
@@ -42,13 +42,20 @@ InStream& InStream::operator>>( Array< T >& val )
    uint size;
    load( (void*)&size, sizeof( uint ) );
 
-   // resize the array
-   val.resize( size );
+   // resize the array - there's no point in initializing the elements we're about to overwrite
+   if ( TBlockSerializable< T >::value )
+   {
+      val.resizeWithoutInitializing( size );
+   }
+   else
+   {
+      val.resize( size );
+   }
 
    // load the elements
-   for ( uint i = 0; i < size; ++i )
+   if ( size > 0 )
    {
-      load( (void*)&val[i], sizeof( T ) );
+      loadElements( (T*)val, size, std::integral_constant< bool, !TStreamedElementwise< T >::value >() );
    }
 
    return *this;
@@ -56,4 +63,23 @@ InStream& InStream::operator>>( Array< T >& val )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+template< typename T >
+void InStream::loadElements( T* elements, uint count, const std::true_type& memoryImage )
+{
+   load( (void*)elements, sizeof( T ) * count );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void InStream::loadElements( T* elements, uint count, const std::false_type& memoryImage )
+{
+   for ( uint i = 0; i < count; ++i )
+   {
+      *this >> elements[i];
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 #endif // _IN_STREAM_H
@@ -0,0 +1,183 @@
+/// @file   core/Job.h
+/// @brief  a fine grained task that can be a part of a dependency graph
+#pragma once
+
+#include "core\MultithreadedTask.h"
+#include "core\Array.h"
+#include "core\Atomic.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class MultithreadedTasksScheduler;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Counts the jobs that are yet to be completed.
+ *
+ * Jobs assigned to a counter increase it when they are scheduled and decrease it
+ * when they complete. Use MultithreadedTasksScheduler::waitFor to wait until
+ * the counter drops to zero.
+ */
+class JobCounter
+{
+   DECLARE_ALLOCATOR( JobCounter, AM_DEFAULT );
+
+private:
+   AtomicInt         m_count;
+
+public:
+   /**
+    * Constructor.
+    */
+   JobCounter();
+
+   /**
+    * Tells if all counted jobs have completed.
+    */
+   inline bool isDone() const { return m_count.get() <= 0; }
+
+   /**
+    * Returns the number of jobs that haven't completed yet.
+    */
+   inline uint getCount() const { long count = m_count.get(); return count > 0 ? (uint)count : 0; }
+
+   /**
+    * Adds a job to the counter.
+    */
+   inline void increment() { m_count.increment(); }
+
+   /**
+    * Removes a completed job from the counter.
+    */
+   inline void decrement() { m_count.decrement(); }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A fine grained task that can be a part of a dependency graph.
+ *
+ * A job can have continuations - jobs that are automatically scheduled once
+ * all of the jobs they depend on complete. Only the root jobs of a graph
+ * ( the ones without dependencies ) should be scheduled manually.
+ *
+ * The graph can be scheduled many times over ( once per frame i.e. ) - but not until 
+ * the previous run has completed.
+ */
+class Job : public MultithreadedTask
+{
+   DECLARE_ALLOCATOR( Job, AM_DEFAULT );
+
+private:
+   MultithreadedTasksScheduler*     m_scheduler;
+   JobCounter*                      m_counter;
+
+   Array< Job* >                    m_continuations;
+   uint                             m_dependenciesCount;
+   AtomicInt                        m_pendingDependenciesCount;
+
+public:
+   virtual ~Job();
+
+   /**
+    * Assigns the job to a counter that will keep track of its completion.
+    *
+    * @param counter
+    */
+   void setCounter( JobCounter* counter );
+
+   /**
+    * Returns the counter the job is assigned to.
+    */
+   inline JobCounter* getCounter() const { return m_counter; }
+
+   /**
+    * Adds a job that will be scheduled once this job ( and all other jobs it depends on ) completes.
+    *
+    * @param continuation
+    */
+   void addContinuation( Job& continuation );
+
+   /**
+    * Makes this job wait for the specified job to complete before it's scheduled.
+    *
+    * @param dependency
+    */
+   inline void addDependency( Job& dependency ) { dependency.addContinuation( *this ); }
+
+   /**
+    * Returns the number of jobs this job depends on.
+    */
+   inline uint getDependenciesCount() const { return m_dependenciesCount; }
+
+   /**
+    * Place the job's code here.
+    */
+   virtual void execute() = 0;
+
+   // -------------------------------------------------------------------------
+   // MultithreadedTask implementation
+   // -------------------------------------------------------------------------
+   void run();
+
+protected:
+   /**
+    * Constructor.
+    *
+    * @param scheduler        scheduler the continuations will be scheduled with
+    * @param counter          ( optional ) counter tracking the job's completion
+    */
+   Job( MultithreadedTasksScheduler& scheduler, JobCounter* counter = NULL );
+
+   // -------------------------------------------------------------------------
+   // MultithreadedTask implementation
+   // -------------------------------------------------------------------------
+   void onScheduled();
+   void onCompleted();
+   JobCounter* getCompletionCounter() const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A job that processes a chunk of a range split by MultithreadedTasksScheduler::parallelFor.
+ */
+template< typename TFunc >
+class ParallelForJob : public Job
+{
+   DECLARE_ALLOCATOR( ParallelForJob, AM_DEFAULT );
+
+private:
+   const TFunc&      m_func;
+   uint              m_chunkStart;
+   uint              m_chunkEnd;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param scheduler
+    * @param counter
+    * @param func
+    * @param chunkStart
+    * @param chunkEnd
+    */
+   ParallelForJob( MultithreadedTasksScheduler& scheduler, JobCounter& counter, const TFunc& func, uint chunkStart, uint chunkEnd )
+      : Job( scheduler, &counter )
+      , m_func( func )
+      , m_chunkStart( chunkStart )
+      , m_chunkEnd( chunkEnd )
+   {}
+
+   // -------------------------------------------------------------------------
+   // Job implementation
+   // -------------------------------------------------------------------------
+   void execute()
+   {
+      m_func( m_chunkStart, m_chunkEnd );
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -17,7 +17,7 @@ List< T >::List( MemoryAllocator* allocator )
 {
    if ( !m_allocator )
    {
-      m_allocator = &TSingleton< MemoryRouter >::getInstance().m_defaultAllocator;
+      m_allocator = TSingleton< MemoryRouter >::getInstance().getDefaultAllocator();
    }
 }
 
@@ -0,0 +1,121 @@
+/// @file   core/LocklessCommandsBuffer.h
+/// @brief  a buffer a worker thread can record commands in
+#ifndef _LOCKLESS_COMMANDS_BUFFER_H
+#define _LOCKLESS_COMMANDS_BUFFER_H
+
+#include "core\MemoryRouter.h"
+#include "core\MemoryAllocator.h"
+#include "core\LocklessCommand.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A linear buffer commands can be recorded in.
+ *
+ * Unlike the commands queues, the buffer doesn't process the commands as they are being
+ * recorded - the commands are executed in one go, in the order they were recorded in,
+ * once the buffer gets processed. That allows a worker thread to record a batch of commands
+ * while another thread is busy executing the contents of a commands queue.
+ *
+ * The buffer has a single writer thread - so if you want to record commands on several threads,
+ * give each of them a buffer of its own.
+ *
+ * The buffer grows by chaining pages of memory, so there's no upper limit on the number of commands
+ * that can be recorded in it - the pages are reused once the buffer gets processed.
+ */
+template< typename Owner >
+class LocklessCommandsBuffer : public MemoryAllocator
+{
+   DECLARE_ALLOCATOR( LocklessCommandsBuffer, AM_DEFAULT );
+
+private:
+   struct Page
+   {
+      Page*                   m_nextPage;
+      size_t                  m_size;
+      size_t                  m_head;
+
+      inline char* getMemory() { return (char*)( this + 1 ); }
+   };
+
+private:
+   static size_t              BUFFER_INFO_CHUNK_SIZE;
+
+   size_t                     m_pageSize;
+   Page*                      m_firstPage;
+   Page*                      m_activePage;
+   uint                       m_pagesCount;
+
+   uint                       m_commandsCount;
+   size_t                     m_memoryUsed;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param pageSize      size of a single page of memory
+    */
+   LocklessCommandsBuffer( size_t pageSize );
+   ~LocklessCommandsBuffer();
+
+   /**
+    * Executes the recorded commands in the order they were recorded in, and clears the buffer.
+    *
+    * @param owner
+    */
+   void process( Owner& owner );
+
+   /**
+    * Releases the recorded commands without executing them.
+    */
+   void clear();
+
+   /**
+    * Returns the number of recorded commands.
+    */
+   inline uint getCommandsCount() const { return m_commandsCount; }
+
+   /**
+    * Returns the number of memory pages the buffer allocated.
+    */
+   inline uint getPagesCount() const { return m_pagesCount; }
+
+   // -------------------------------------------------------------------------
+   // MemoryAllocator implementation
+   // -------------------------------------------------------------------------
+   void* alloc( size_t size );
+   void dealloc( void* ptr );
+   ulong getMemoryUsed() const;
+
+private:
+   /**
+    * Releases the recorded commands, executing them first if the owner is specified.
+    *
+    * @param owner
+    */
+   void releaseCommands( Owner* owner );
+
+   /**
+    * Makes the page that follows the active one active, chaining a new one if that page
+    * can't fit an allocation of the specified size.
+    *
+    * @param minSize
+    */
+   void nextPage( size_t minSize );
+
+   /**
+    * Allocates a new page of memory.
+    *
+    * @param size
+    */
+   Page* createPage( size_t size );
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "core\LocklessCommandsBuffer.inl"
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _LOCKLESS_COMMANDS_BUFFER_H
@@ -0,0 +1,174 @@
+#ifndef _LOCKLESS_COMMANDS_BUFFER_H
+#error "This file can only be included in LocklessCommandsBuffer.h"
+#else
+
+#include "core\Assert.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+size_t LocklessCommandsBuffer< Owner >::BUFFER_INFO_CHUNK_SIZE = sizeof( size_t );
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+LocklessCommandsBuffer< Owner >::LocklessCommandsBuffer( size_t pageSize )
+   : m_pageSize( pageSize )
+   , m_pagesCount( 0 )
+   , m_commandsCount( 0 )
+   , m_memoryUsed( 0 )
+{
+   m_firstPage = createPage( m_pageSize );
+   m_activePage = m_firstPage;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+LocklessCommandsBuffer< Owner >::~LocklessCommandsBuffer()
+{
+   clear();
+
+   MemoryRouter& memRouter = TSingleton< MemoryRouter >::getInstance();
+   while ( m_firstPage )
+   {
+      Page* page = m_firstPage;
+      m_firstPage = page->m_nextPage;
+      memRouter.dealloc( page, AM_DEFAULT );
+   }
+   m_activePage = NULL;
+   m_pagesCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+void LocklessCommandsBuffer< Owner >::process( Owner& owner )
+{
+   releaseCommands( &owner );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+void LocklessCommandsBuffer< Owner >::clear()
+{
+   releaseCommands( NULL );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+void LocklessCommandsBuffer< Owner >::releaseCommands( Owner* owner )
+{
+   // each allocation is preceded by its size, so we can walk the commands in the order they were recorded in.
+   // The pages that follow the active one are empty
+   for ( Page* page = m_firstPage; page; page = page->m_nextPage )
+   {
+      char* memory = page->getMemory();
+
+      size_t offset = 0;
+      while ( offset < page->m_head )
+      {
+         char* allocatedAddr = memory + offset;
+         const size_t allocationSize = *(size_t*)allocatedAddr;
+
+         LocklessCommand< Owner >* c = reinterpret_cast< LocklessCommand< Owner >* >( MemoryRouter::convertAllocatedToObjectAddress( allocatedAddr + BUFFER_INFO_CHUNK_SIZE ) );
+         if ( owner )
+         {
+            c->execute( *owner );
+         }
+         delete c;
+
+         offset += allocationSize;
+      }
+
+      page->m_head = 0;
+      if ( page == m_activePage )
+      {
+         break;
+      }
+   }
+
+   m_activePage = m_firstPage;
+   m_commandsCount = 0;
+   m_memoryUsed = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+void* LocklessCommandsBuffer< Owner >::alloc( size_t size )
+{
+   const size_t actualAllocationSize = size + BUFFER_INFO_CHUNK_SIZE;
+   if ( m_activePage->m_head + actualAllocationSize > m_activePage->m_size )
+   {
+      nextPage( actualAllocationSize );
+   }
+
+   char* ptr = m_activePage->getMemory() + m_activePage->m_head;
+   *(size_t*)ptr = actualAllocationSize;
+   ptr += BUFFER_INFO_CHUNK_SIZE;
+
+   m_activePage->m_head += actualAllocationSize;
+   m_memoryUsed += actualAllocationSize;
+   ++m_commandsCount;
+
+   return ptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+void LocklessCommandsBuffer< Owner >::dealloc( void* ptr )
+{
+   // the memory is reclaimed all at once, when the buffer gets processed
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+ulong LocklessCommandsBuffer< Owner >::getMemoryUsed() const
+{
+   return m_memoryUsed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+void LocklessCommandsBuffer< Owner >::nextPage( size_t minSize )
+{
+   // reuse the page that follows, unless the allocation doesn't fit in it - allocations larger
+   // than a page get a page of their own
+   Page* page = m_activePage->m_nextPage;
+   if ( !page || page->m_size < minSize )
+   {
+      page = createPage( minSize > m_pageSize ? minSize : m_pageSize );
+      page->m_nextPage = m_activePage->m_nextPage;
+      m_activePage->m_nextPage = page;
+   }
+
+   m_activePage = page;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename Owner >
+typename LocklessCommandsBuffer< Owner >::Page* LocklessCommandsBuffer< Owner >::createPage( size_t size )
+{
+   MemoryRouter& memRouter = TSingleton< MemoryRouter >::getInstance();
+   Page* page = (Page*)memRouter.alloc( sizeof( Page ) + size, AM_DEFAULT, memRouter.getDefaultAllocator() );
+   ASSERT_MSG( page, "LocklessCommandsBuffer couldn't allocate a page of memory" );
+
+   page->m_nextPage = NULL;
+   page->m_size = size;
+   page->m_head = 0;
+   ++m_pagesCount;
+
+   return page;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _LOCKLESS_COMMANDS_BUFFER_H
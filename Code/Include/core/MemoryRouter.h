@@ -4,6 +4,7 @@
 #define _MEMORY_ROUTER_H
 
 #include "core\DefaultAllocator.h"
+#include "core\ThreadCachingAllocator.h"
 #include "core\EngineDefines.h"
 #include "core\Singleton.h"
 
@@ -33,10 +34,13 @@ class MemoryRouter
 
 public:
    DefaultAllocator              m_defaultAllocator;
+   ThreadCachingAllocator        m_threadCachingAllocator;
 
 private:
    static uint                   s_headerSize;
 
+   MemoryAllocator*              m_generalPurposeAllocator;
+
 #ifdef _TRACK_MEMORY_ALLOCATIONS
    CallstackTracer*              m_tracer;
    CallstackTree*                m_callstacksTree;
@@ -52,7 +56,13 @@ public:
    /**
     * Returns the size of allocated memory.
     */
-   inline ulong getMemoryUsed() const { return m_defaultAllocator.getMemoryUsed(); }
+   inline ulong getMemoryUsed() const { return m_defaultAllocator.getMemoryUsed() + m_threadCachingAllocator.getMemoryUsed(); }
+
+   /**
+    * Returns the allocator objects that don't specify one should be allocated with
+    * ( selected with the _USE_THREAD_CACHING_ALLOCATOR flag ).
+    */
+   inline MemoryAllocator* getDefaultAllocator() const { return m_generalPurposeAllocator; }
 
    /**
     * Translates an address returned by a memory allocator to an object address
@@ -118,7 +128,7 @@ public: \
    static void* operator new( size_t size ) \
    { \
       MemoryRouter& router = TSingleton< MemoryRouter >::getInstance(); \
-      void* ptr = router.alloc( size, AllocMode, &router.m_defaultAllocator ); \
+      void* ptr = router.alloc( size, AllocMode, router.getDefaultAllocator() ); \
       return ptr; \
    } \
    \
@@ -129,7 +139,7 @@ public: \
    static void* operator new[]( size_t size ) \
    { \
       MemoryRouter& router = TSingleton< MemoryRouter >::getInstance(); \
-      void* ptr = router.alloc( size, AllocMode, &router.m_defaultAllocator ); \
+      void* ptr = router.alloc( size, AllocMode, router.getDefaultAllocator() ); \
       return ptr; \
    } \
    \
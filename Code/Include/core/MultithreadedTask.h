@@ -3,12 +3,13 @@
 #pragma once
 
 #include "core\MemoryRouter.h"
+#include "core\Atomic.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
 class MultithreadedTasksScheduler;
-class CriticalSection;
+class JobCounter;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -28,11 +29,10 @@ public:
    };
 
 private:
+   // both values are accessed without locking - tasks can be very fine grained ( see Job ),
+   // and we don't want to pay for a pair of critical sections per each one of them
    volatile bool                 m_forceClose;
-   CriticalSection*              m_forceCloseLock;
-
-   CriticalSection*              m_statusLock;
-   Status                        m_status;
+   AtomicInt                     m_status;
 
 public:
    virtual ~MultithreadedTask();
@@ -69,6 +69,24 @@ protected:
     */
    bool shouldClose() const;
 
+   /**
+    * Called by the scheduler right before the task is put in one of its queues.
+    */
+   virtual void onScheduled() {}
+
+   /**
+    * Called by the scheduler once the task's run, right before it's marked as completed.
+    *
+    * The task's owner may still be waiting for it to complete, so the task must not
+    * be released from here.
+    */
+   virtual void onCompleted() {}
+
+   /**
+    * Returns a counter the scheduler should decrement once the task's been marked as completed.
+    */
+   virtual JobCounter* getCompletionCounter() const { return NULL; }
+
 private:
    // ---------------------------------------------------------------------------------
    // MultithreadedTasksScheduler API
@@ -79,6 +97,22 @@ private:
     * Sets a new task status
     */
    void setStatus( Status status );
+
+   /**
+    * Notifies the task that it's completed and marks it as such.
+    *
+    * The task's owner may release it as soon as it's marked as completed ( see join ),
+    * so the scheduler must not touch the task after this call.
+    */
+   void complete();
+
+   /**
+    * Atomically switches the task to the running state, unless it's already running
+    * ( the same task instance may be scheduled multiple times, but it can't run on two threads at once ).
+    *
+    * @return  'true' if the task was activated, 'false' if it's already running
+    */
+   bool activate();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -1,18 +1,23 @@
 /// @file   core/MultithreadedTasksScheduler.h
 /// @brief  Scheduler of methods executed on separate threads ( so called tasks )
-#pragma once
+#ifndef _MULTITHREADED_TASKS_SCHEDULER_H
+#define _MULTITHREADED_TASKS_SCHEDULER_H
 
 #include "core\MemoryRouter.h"
-#include "core\List.h"
 #include "core\Array.h"
 #include "core\Dequeue.h"
 #include "core\Runnable.h"
+#include "core\Atomic.h"
+#include "core\WorkStealingQueue.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
 
 class MultithreadedTask;
+class JobCounter;
 class CriticalSection;
+class ConditionVariable;
+class Semaphore;
 class Thread;
 struct SingletonConstruct;
 
@@ -20,8 +25,16 @@ struct SingletonConstruct;
 
 /**
  * Scheduler of methods executed on separate threads ( so called tasks ).
+ *
+ * The scheduler runs a fixed number of worker threads. Each worker owns a lock-free
+ * queue of tasks it pops from, and when it runs out of work, it takes tasks
+ * from the shared queue or steals them from other workers.
+ * Workers that can't find anything to do go to sleep until new tasks are scheduled.
+ *
+ * Fine grained work should be scheduled as Jobs, which can be organized in dependency graphs 
+ * and waited for using 'waitFor'. Loops can be split into jobs using 'parallelFor'.
  */
-class MultithreadedTasksScheduler : public Runnable
+class MultithreadedTasksScheduler
 {
    REGULAR_SINGLETON();
    DECLARE_ALLOCATOR( MultithreadedTasksScheduler, AM_DEFAULT );
@@ -31,21 +44,38 @@ private:
    {
       DECLARE_ALLOCATOR( ThreadContext, AM_DEFAULT );
 
+   public:
+      // tasks spawned by the task running in this context
+      WorkStealingQueue< MultithreadedTask* >*  m_localQueue;
+
    private:
       Thread*                          m_thread;
       MultithreadedTasksScheduler*     m_scheduler;
       uint                             m_threadIdx;
 
       CriticalSection*                 m_taskLock;
+      ConditionVariable*               m_taskStopped;
       MultithreadedTask*               m_task;
-      volatile bool                    m_newTaskAvailable;
+      MultithreadedTask*               m_immediateTask;
       volatile bool                    m_forceClose;
+      volatile bool                    m_finished;
 
    public:
       /**
-       * Constructor.
+       * Constructor of a worker context.
+       *
+       * @param scheduler
+       * @param threadIdx
        */
-      ThreadContext( MultithreadedTasksScheduler* scheduler, int threadIdx );
+      ThreadContext( MultithreadedTasksScheduler* scheduler, uint threadIdx );
+
+      /**
+       * Constructor of a temporary context, dedicated to running a single task.
+       *
+       * @param scheduler
+       * @param immediateTask
+       */
+      ThreadContext( MultithreadedTasksScheduler* scheduler, MultithreadedTask* immediateTask );
       ~ThreadContext();
 
       /**
@@ -54,36 +84,61 @@ private:
       bool isProcessing() const;
 
       /**
-       * Assigns a task to be executed by this context.
-       *
-       * @param task
+       * Checks if a temporary context has finished running its task.
        */
-      void assignTask( MultithreadedTask* task );
+      inline bool isFinished() const { return m_finished; }
+
+      /**
+       * Checks if the context is running on the thread this method was called from.
+       */
+      bool isCurrentThread() const;
 
       /**
        * Stops the running task.
        */
       void stopTask();
 
+      /**
+       * Tells the context's thread to stop as soon as it completes its current task.
+       */
+      void close();
+
       // ----------------------------------------------------------------------
       // Runnable implementation
       // ----------------------------------------------------------------------
       void run();
+
+   private:
+      void runWorkerLoop();
+
+      // ----------------------------------------------------------------------
+      // Channel of communication with MultithreadedTasksScheduler
+      // ----------------------------------------------------------------------
+      friend class MultithreadedTasksScheduler;
+
+      void setCurrentTask( MultithreadedTask* task );
    };
 
 private:
    uint                                m_fixedThreadsCount;
 
    volatile bool                       m_closeRequest;
-   Thread*                             m_schedulerThread;
 
-   typedef List< MultithreadedTask* >  TasksQueue;
-   TasksQueue                          m_tasksQueue;
+   Array< ThreadContext* >             m_threadContexts;
+
+   CriticalSection*                    m_temporaryContextsLock;
+   Array< ThreadContext* >             m_temporaryContexts;
 
-   CriticalSection*                    m_runningTasksLock;
+   CriticalSection*                    m_sharedQueueLock;
+   Dequeue< MultithreadedTask* >       m_sharedQueue;
+   AtomicInt                           m_sharedTasksCount;     // lets the workers check the shared queue without locking it
 
-   Array< ThreadContext* >             m_threadContexts;
-   Dequeue< uint >*                    m_freeThreadIds;
+   Semaphore*                          m_wakeUpSemaphore;
+   AtomicInt                           m_sleepingWorkersCount;
+
+   AtomicInt                           m_scheduledTasksCount;
+   AtomicInt                           m_runningTasksCount;
+   AtomicInt                           m_busyWorkersCount;
 
 public:
    /**
@@ -112,6 +167,63 @@ public:
     */
    void run( MultithreadedTask& task, bool immediateExecution = false );
 
+   /**
+    * Schedules a task to be executed on a worker thread.
+    *
+    * When called from a task that runs on one of the worker threads, the task is put
+    * in that worker's local queue, where it will be picked up by that worker as soon as
+    * the current task finishes, unless an idle worker steals it first.
+    * That makes it the preferred way of fanning out work from inside of other tasks.
+    *
+    * When called from any other thread, it works just like 'run'.
+    *
+    * @param task
+    */
+   void spawn( MultithreadedTask& task );
+
+   /**
+    * Waits until all jobs tracked by the specified counter complete.
+    *
+    * Instead of blocking, the caller thread helps the workers by executing the scheduled tasks
+    * in the meantime - so it's safe to call it from within a task running on a worker thread.
+    *
+    * @param counter
+    */
+   void waitFor( const JobCounter& counter );
+
+   /**
+    * Splits the range [ rangeStart, rangeEnd ) into chunks of 'grainSize' elements and processes
+    * them in parallel. The call returns when the whole range has been processed. The caller thread
+    * processes the first chunk itself.
+    *
+    * The functor is called with the boundaries of a chunk:
+    *
+    *    void operator()( uint chunkStart, uint chunkEnd ) const;
+    *
+    * and can be called from multiple threads at once.
+    *
+    * @param rangeStart
+    * @param rangeEnd
+    * @param grainSize
+    * @param func
+    */
+   template< typename TFunc >
+   void parallelFor( uint rangeStart, uint rangeEnd, uint grainSize, const TFunc& func );
+
+   /**
+    * Calculates a grain size that splits the specified number of elements into a few chunks
+    * per worker ( see parallelFor ).
+    *
+    * @param elementsCount
+    * @param minGrainSize     chunks won't get any smaller than that
+    */
+   uint calcGrainSize( uint elementsCount, uint minGrainSize ) const;
+
+   /**
+    * Returns the number of worker threads the tasks are distributed amongst.
+    */
+   inline uint getWorkersCount() const { return m_fixedThreadsCount; }
+
    /**
     * Returns number of scheduled and running tasks.
     */
@@ -132,25 +244,26 @@ public:
     */
    void clear();
 
+private:
+   void init( uint numThreads );
+
    // -------------------------------------------------------------------------
    // Channel of communication with ThreadContext
    // -------------------------------------------------------------------------
-   /**
-    * Called by a task to report that it's completed.
-    *
-    * @param threadIdx
-    */
-   void reportTaskCompleted( uint threadIdx );
+   void enqueueShared( MultithreadedTask* task );
+   void pushToSharedQueue( MultithreadedTask* task );
+   ThreadContext* findCurrentWorker() const;
+   MultithreadedTask* acquireTask( ThreadContext* context );
+   void executeTask( MultithreadedTask* task, ThreadContext* context );
+   void waitForTasks();
+   void wakeUpWorker();
+   void releaseFinishedTemporaryContexts();
+};
 
-   // -------------------------------------------------------------------------
-   // Runnable implementation
-   // -------------------------------------------------------------------------
-   void run();
+///////////////////////////////////////////////////////////////////////////////
 
-private:
-   void init( uint numThreads );
-   void scheduleTasks();
-   void scheduleImmediateTask( MultithreadedTask& task );
-};
+#include "core\MultithreadedTasksScheduler.inl"
 
 ///////////////////////////////////////////////////////////////////////////////
+
+#endif // _MULTITHREADED_TASKS_SCHEDULER_H
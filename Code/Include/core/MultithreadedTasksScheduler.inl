@@ -0,0 +1,57 @@
+#ifndef _MULTITHREADED_TASKS_SCHEDULER_H
+#error "This file can only be included from MultithreadedTasksScheduler.h"
+#else
+
+#include "core\Job.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename TFunc >
+void MultithreadedTasksScheduler::parallelFor( uint rangeStart, uint rangeEnd, uint grainSize, const TFunc& func )
+{
+   if ( rangeEnd <= rangeStart )
+   {
+      return;
+   }
+
+   if ( grainSize == 0 )
+   {
+      grainSize = 1;
+   }
+
+   uint chunksCount = ( rangeEnd - rangeStart + grainSize - 1 ) / grainSize;
+   if ( chunksCount == 1 )
+   {
+      // there's nothing to split
+      func( rangeStart, rangeEnd );
+      return;
+   }
+
+   // schedule all chunks but the first one, which we're going to process ourselves
+   JobCounter counter;
+   Array< ParallelForJob< TFunc >* > jobs( chunksCount - 1 );
+   for ( uint chunkStart = rangeStart + grainSize; chunkStart < rangeEnd; chunkStart += grainSize )
+   {
+      uint chunkEnd = ( rangeEnd - chunkStart > grainSize ) ? chunkStart + grainSize : rangeEnd;
+
+      ParallelForJob< TFunc >* job = new ParallelForJob< TFunc >( *this, counter, func, chunkStart, chunkEnd );
+      jobs.push_back( job );
+      spawn( *job );
+   }
+
+   func( rangeStart, rangeStart + grainSize );
+
+   // help with the remaining chunks
+   waitFor( counter );
+
+   uint count = jobs.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      delete jobs[i];
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _MULTITHREADED_TASKS_SCHEDULER_H
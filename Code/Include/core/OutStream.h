@@ -6,6 +6,7 @@
 #include <vector>
 #include "core\MemoryRouter.h"
 #include "core\Array.h"
+#include "core\StreamTraits.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -29,7 +30,8 @@ public:
    OutStream& operator<<( const T& val );
 
    /**
-    * Saves data to the stream.
+    * Saves an array to the stream. The elements are saved as a single block of memory,
+    * unless they need to be streamed one by one ( see TStreamedElementwise ).
     *
     * @param val     saved value
     */
@@ -37,7 +39,8 @@ public:
    OutStream& operator<<( const std::vector< T >& val );
 
    /**
-    * Saves data to the stream.
+    * Saves an array to the stream. The elements are saved as a single block of memory,
+    * unless they need to be streamed one by one ( see TStreamedElementwise ).
     *
     * @param val     saved value
     */
@@ -58,6 +61,13 @@ public:
     * @param dataSize   size ( in bytes ) of the data we want to save to the stream
     */
    virtual void save( const void* val, unsigned int dataSize ) = 0;
+
+private:
+   template< typename T >
+   void saveElements( const T* elements, uint count, const std::true_type& memoryImage );
+
+   template< typename T >
+   void saveElements( const T* elements, uint count, const std::false_type& memoryImage );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -22,9 +22,9 @@ OutStream& OutStream::operator<<( const std::vector< T >& val )
    save( (void*)&size, sizeof( uint ) );
 
    // save the elements
-   for ( uint i = 0; i < size; ++i )
+   if ( size > 0 )
    {
-      save( (void*)&val[i], sizeof( T ) );
+      saveElements( &val[0], size, std::integral_constant< bool, !TStreamedElementwise< T >::value >() );
    }
 
    return *this;
@@ -40,9 +40,9 @@ OutStream& OutStream::operator<<( const Array< T >& val )
    save( (void*)&size, sizeof( uint ) );
 
    // save the elements
-   for ( uint i = 0; i < size; ++i )
+   if ( size > 0 )
    {
-      save( (void*)&val[i], sizeof( T ) );
+      saveElements( &val[0], size, std::integral_constant< bool, !TStreamedElementwise< T >::value >() );
    }
 
    return *this;
@@ -50,5 +50,23 @@ OutStream& OutStream::operator<<( const Array< T >& val )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+template< typename T >
+void OutStream::saveElements( const T* elements, uint count, const std::true_type& memoryImage )
+{
+   save( (const void*)elements, sizeof( T ) * count );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void OutStream::saveElements( const T* elements, uint count, const std::false_type& memoryImage )
+{
+   for ( uint i = 0; i < count; ++i )
+   {
+      *this << elements[i];
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
 #endif // _OUT_STREAM_H
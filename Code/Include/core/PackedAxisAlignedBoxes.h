@@ -0,0 +1,96 @@
+/// @file   core/PackedAxisAlignedBoxes.h
+/// @brief  a collection of axis aligned boxes stored in a SIMD friendly layout
+#pragma once
+
+#include "core\MemoryRouter.h"
+#include "core\MathDataStorage.h"
+#include "core\Array.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct AxisAlignedBox;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A collection of axis aligned boxes stored in a SIMD friendly layout.
+ *
+ * The boxes are packed in quads - each quad stores the coordinates of 4 boxes,
+ * one quad storage per coordinate ( structure of arrays ). That allows to test 4 boxes
+ * at a time against a plane ( see Frustum::cull ).
+ *
+ * The last quad may be only partially filled - the contents of its unused lanes are zeroed.
+ */
+class PackedAxisAlignedBoxes
+{
+   DECLARE_ALLOCATOR( PackedAxisAlignedBoxes, AM_DEFAULT );
+
+public:
+   struct Quad
+   {
+      DECLARE_ALLOCATOR( Quad, AM_ALIGNED_16 );
+
+      QuadStorage       m_min[3];         // x, y and z coordinates of the min corners of 4 boxes
+      QuadStorage       m_max[3];         // x, y and z coordinates of the max corners of 4 boxes
+   };
+
+private:
+   Array< Quad >        m_quads;
+   uint                 m_boxesCount;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param capacity   number of boxes the collection will preallocate memory for
+    */
+   PackedAxisAlignedBoxes( uint capacity = 64 );
+
+   /**
+    * Returns the number of stored boxes.
+    */
+   inline uint size() const { return m_boxesCount; }
+
+   /**
+    * Returns the number of quads the boxes are packed in.
+    */
+   inline uint getQuadsCount() const { return m_quads.size(); }
+
+   /**
+    * Returns a quad with the specified index.
+    *
+    * @param idx
+    */
+   inline const Quad& getQuad( uint idx ) const { return m_quads[idx]; }
+
+   /**
+    * Removes all boxes.
+    */
+   void clear();
+
+   /**
+    * Appends a box.
+    *
+    * @param box
+    */
+   void push_back( const AxisAlignedBox& box );
+
+   /**
+    * Replaces a box stored under the specified index.
+    *
+    * @param idx
+    * @param box
+    */
+   void set( uint idx, const AxisAlignedBox& box );
+
+   /**
+    * Returns a box stored under the specified index.
+    *
+    * @param idx
+    * @param outBox
+    */
+   void get( uint idx, AxisAlignedBox& outBox ) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,7 @@
 #include "core\MathDataStorage.h"
 #include "core\FastFloat.h"
 #include "core\MemoryRouter.h"
+#include "core\StreamTraits.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -287,6 +288,8 @@ ALIGN_16 struct Quaternion
    friend InStream& operator>>( InStream& serializer, Quaternion& rhs );
 };
 
+DECLARE_BLOCK_SERIALIZABLE( Quaternion );
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef _USE_SIMD
@@ -39,6 +39,9 @@ public:
    uint                                               m_id;
    int                                                m_versionNo;
 
+   // index of the type in the registry's ancestry tables ( -1 if the type isn't there )
+   int                                                m_ancestryIdx;
+
 public:
    /**
     * Constructor.
@@ -126,6 +129,7 @@ public:
 
    // runtime data
    TSContinuousMemoryPool*                            m_searchMemPool;
+   const uint*                                        m_ancestryMask;
 
 public:
    /**
@@ -303,15 +303,10 @@ void TMemberField< std::vector< T > >::save( const void* object, const Reflectio
    const char* memberPtr = (const char*)object + m_dataOffset;
    const std::vector< T >* dataPtr = reinterpret_cast< const std::vector< T >* >( memberPtr );
 
-   // serialize the number of entries
+   // serialize the entries
    SerializedArrayOfValues& arr = savedObject.addArrayOfValues( m_id );
    uint count = dataPtr->size();
-   arr.setSize( count );
-
-   for ( uint i = 0; i < count; ++i )
-   {
-      arr.set< T >( i, (*dataPtr)[i] );
-   }
+   arr.setAll< T >( count > 0 ? &(*dataPtr)[0] : NULL, count );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -334,9 +329,9 @@ void TMemberField< std::vector< T > >::load( void* object, const SerializedRefle
    dataPtr->resize( count );
 
    // deserialize the entries
-   for ( uint i = 0; i < count; ++i )
+   if ( count > 0 )
    {
-      arr->initialize< T >( i, (*dataPtr)[i] );
+      arr->initializeAll< T >( &(*dataPtr)[0] );
    }
 }
 
@@ -622,15 +617,10 @@ void TMemberField< Array< T > >::save( const void* object, const ReflectionDepen
    const char* memberPtr = (const char*)object + m_dataOffset;
    const Array< T >* dataPtr = reinterpret_cast< const Array< T >* >( memberPtr );
 
-   // serialize the number of entries
+   // serialize the entries
    SerializedArrayOfValues& arr = savedObject.addArrayOfValues( m_id );
    uint count = dataPtr->size();
-   arr.setSize( count );
-
-   for ( uint i = 0; i < count; ++i )
-   {
-      arr.set< T >( i, (*dataPtr)[i] );
-   }
+   arr.setAll< T >( count > 0 ? &(*dataPtr)[0] : NULL, count );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -653,9 +643,9 @@ void TMemberField< Array< T > >::load( void* object, const SerializedReflectionO
    dataPtr->resizeWithoutInitializing( count );
 
    // deserialize the entries
-   for ( uint i = 0; i < count; ++i )
+   if ( count > 0 )
    {
-      arr->initialize< T >( i, (*dataPtr)[i] );
+      arr->initializeAll< T >( &(*dataPtr)[0] );
    }
 }
 
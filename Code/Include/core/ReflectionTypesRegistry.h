@@ -34,6 +34,12 @@ private:
    std::vector< ReflectionType* >                           m_allTypes;
    ReflectionType*                                          m_genericEnumType;
 
+   // Flattened inheritance hierarchy of the serializable types - each type gets a row of bits, 
+   // one per serializable type, with the bits of the type's ancestors ( and the type itself ) set
+   std::vector< uint >                                      m_ancestryTable;
+   uint                                                     m_ancestryRowSize;
+   bool                                                     m_ancestryTablesValid;
+
 public:
    /**
     * Singleton constructor.
@@ -128,6 +134,29 @@ public:
     */
    void build( PatchesDB& patchesDB );
 
+   // -------------------------------------------------------------------------
+   // Ancestry tables
+   // -------------------------------------------------------------------------
+   /**
+    * Flattens the inheritance hierarchy of all registered serializable types, so that
+    * SerializableReflectionType::isA becomes a constant time check.
+    *
+    * Called automatically by 'build' - call it manually if types are added at runtime,
+    * otherwise the types will fall back to searching the hierarchy.
+    */
+   void buildAncestryTables();
+
+   /**
+    * Marks the ancestry tables as outdated. Called automatically when a type is added
+    * or its parents change.
+    */
+   void invalidateAncestryTables();
+
+   /**
+    * Tells if the ancestry tables reflect the current types hierarchy.
+    */
+   inline bool areAncestryTablesValid() const;
+
 private:
    /**
     * Populates the database with records of all types from the registry, for which
@@ -141,6 +170,14 @@ private:
     * Resolves parent type version numbers.
     */
    void resolveTypeVersions();
+
+   /**
+    * Sets the bits of all ancestors of the specified type in its ancestry table row.
+    *
+    * @param type
+    * @param visitedTypes     flags marking the types whose rows are complete
+    */
+   void collectAncestors( SerializableReflectionType* type, std::vector< bool >& visitedTypes );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -35,6 +35,8 @@ bool ReflectionTypesRegistry::addSerializableType( const std::string& typeName,
       m_serializableTypesMap.insert( std::make_pair( type->m_id, type ) );
       m_allTypes.push_back( type );
 
+      invalidateAncestryTables();
+
       return true;
    }
 }
@@ -142,4 +144,11 @@ ReflectionType& ReflectionTypesRegistry::getGenericEnumType() const
 
 ///////////////////////////////////////////////////////////////////////////////
 
+bool ReflectionTypesRegistry::areAncestryTablesValid() const
+{
+   return m_ancestryTablesValid;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 #endif // _REFLECTION_TYPES_REGISTRY_H
@@ -14,11 +14,17 @@
 class IProgressObserver;
 class Resource;
 class ResourcesManager;
+class ReflectionObject;
 
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
  * This operation that takes care of atomic loading of multiple resources.
+ *
+ * The operation is split into two phases. 'prepare' reads and deserializes the resource
+ * and its external dependencies - independent dependencies are loaded in parallel, and the whole phase 
+ * can run on a worker thread. 'commit' links the loaded objects and registers them with 
+ * the resources manager, and has to be run on the thread that owns the manager.
  */
 class ResOpLoad
 {
@@ -35,6 +41,21 @@ private:
    typedef std::map< FilePath, Resource* >   ResourcesMap;
    ResourcesMap                              m_resourcesToFinalize;
 
+   struct LoadedFile
+   {
+      DECLARE_ALLOCATOR( LoadedFile, AM_DEFAULT );
+
+      FilePath                               m_path;
+      Resource*                              m_resource;
+      std::vector< ReflectionObject* >       m_objects;
+      std::vector< FilePath >                m_dependencies;
+      std::vector< FilePath >                m_remappedDependencies;
+
+      LoadedFile( const FilePath& path ) : m_path( path ), m_resource( NULL ) {}
+   };
+   std::vector< LoadedFile* >                m_loadedFiles;
+   struct FilesLoader;
+
    // this flag indicates whether the created resource was loaded, or created
    Resource*                                 m_loadedResource;
    Resource*                                 m_resourceToSave;
@@ -51,6 +72,12 @@ public:
     * @param progressObserver    a thread-safe progress observer ( optional )
     */
    ResOpLoad( ResourcesManager* resMgr, const FilePath& loadPath, bool loadOnly = false, IProgressObserver* progressObserver = NULL );
+   ~ResOpLoad();
+
+   /**
+    * Returns the path of the loaded resource.
+    */
+   inline const FilePath& getResourcePath() const { return m_resourcePath; }
 
    /**
     * Returns the loaded resource.
@@ -62,6 +89,21 @@ public:
     */
    void execute();
 
+   /**
+    * Loads the resource along with its external dependencies, without registering them
+    * with the resources manager. Can be run on a worker thread.
+    */
+   void prepare();
+
+   /**
+    * Links the resources loaded by 'prepare' and registers them with the resources manager.
+    * Has to be run on the thread that owns the resources manager.
+    *
+    * Dependencies that have been registered with the manager in the meantime by other 
+    * operations are discarded and the registered instances are used instead.
+    */
+   void commit();
+
    /**
     * Reloads the specified resource.
     *
@@ -80,6 +122,31 @@ private:
     */
    Resource* load();
 
+   /**
+    * Loads the files of the resource and its dependencies - each level of the dependencies 
+    * tree is loaded in parallel.
+    */
+   void loadFiles();
+
+   /**
+    * Deserializes a single file.
+    *
+    * @param file
+    */
+   void loadFile( LoadedFile& file ) const;
+
+   /**
+    * Links the loaded files and puts the loaded resources up for registration.
+    */
+   void linkLoadedFiles();
+
+   /**
+    * Checks if the resource has already been registered with the resources manager.
+    *
+    * @param path
+    */
+   bool isRegistered( const FilePath& path ) const;
+
    /**
     * Looks for a resource among the deserialized resources and in the specified resources manager instance.
     *
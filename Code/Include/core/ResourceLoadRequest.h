@@ -0,0 +1,171 @@
+/// @file   core/ResourceLoadRequest.h
+/// @brief  a request to load a resource in the background
+#ifndef _RESOURCE_LOAD_REQUEST_H
+#define _RESOURCE_LOAD_REQUEST_H
+
+#include "core\MemoryRouter.h"
+#include "core\Job.h"
+#include "core\Atomic.h"
+#include "core\ResOpLoad.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class Resource;
+class ResourcesManager;
+class FilePath;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A request to load a resource in the background.
+ *
+ * The resource and its dependencies are loaded on a worker thread, but they're registered
+ * with the resources manager only on the thread that owns it - when it calls
+ * ResourcesManager::processAsyncLoads or ResourcesManager::waitFor.
+ *
+ * Requests are reference counted - they are held by the manager until they're committed,
+ * and by the handles the manager gives out.
+ */
+class ResourceLoadRequest : public Job
+{
+   DECLARE_ALLOCATOR( ResourceLoadRequest, AM_DEFAULT );
+
+private:
+   ResOpLoad            m_operation;
+   JobCounter           m_loadingCounter;
+   volatile bool        m_committed;
+
+   AtomicInt            m_referencesCount;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param scheduler
+    * @param resMgr
+    * @param path
+    * @param loadOnly   if set to 'true', the manager won't attempt to create a new resource
+    *                   if it doesn't already exist in the filesystem
+    */
+   ResourceLoadRequest( MultithreadedTasksScheduler& scheduler, ResourcesManager* resMgr, const FilePath& path, bool loadOnly );
+   ~ResourceLoadRequest();
+
+   /**
+    * Returns the path of the requested resource.
+    */
+   inline const FilePath& getResourcePath() const { return m_operation.getResourcePath(); }
+
+   /**
+    * Tells if the background part of the loading process has finished.
+    */
+   inline bool isLoaded() const { return m_loadingCounter.isDone(); }
+
+   /**
+    * Tells if the loaded resource has been registered with the resources manager
+    * and can be used.
+    */
+   inline bool isCommitted() const { return m_committed; }
+
+   /**
+    * Returns the loaded resource, or NULL if the request hasn't been committed yet
+    * ( or if the resource couldn't be loaded ).
+    */
+   Resource* getResource() const;
+
+   /**
+    * Adds a reference to the request.
+    */
+   void addReference();
+
+   /**
+    * Removes a reference to the request. The request is deleted once the last one is removed.
+    */
+   void removeReference();
+
+   // -------------------------------------------------------------------------
+   // Job implementation
+   // -------------------------------------------------------------------------
+   void execute();
+
+private:
+   // -------------------------------------------------------------------------
+   // ResourcesManager API
+   // -------------------------------------------------------------------------
+   friend class ResourcesManager;
+
+   /**
+    * Returns the counter the manager can wait on until the background loading completes.
+    */
+   inline const JobCounter& getLoadingCounter() const { return m_loadingCounter; }
+
+   /**
+    * Registers the loaded resources with the resources manager.
+    */
+   void commit();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A handle to a resource that's being loaded in the background.
+ */
+template< typename RESOURCE_TYPE >
+class TResourceLoadHandle
+{
+   DECLARE_ALLOCATOR( TResourceLoadHandle, AM_DEFAULT );
+
+private:
+   ResourceLoadRequest*       m_request;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param request
+    */
+   TResourceLoadHandle( ResourceLoadRequest* request = NULL );
+
+   /**
+    * Copy constructor.
+    *
+    * @param rhs
+    */
+   TResourceLoadHandle( const TResourceLoadHandle& rhs );
+   ~TResourceLoadHandle();
+
+   /**
+    * Assignment operator.
+    *
+    * @param rhs
+    */
+   TResourceLoadHandle& operator=( const TResourceLoadHandle& rhs );
+
+   /**
+    * Checks if the handle doesn't reference any request.
+    */
+   inline bool isNull() const { return m_request == NULL; }
+
+   /**
+    * Tells if the resource can already be accessed.
+    */
+   inline bool isReady() const { return m_request == NULL || m_request->isCommitted(); }
+
+   /**
+    * Returns the loaded resource, or NULL if it's not ready yet.
+    */
+   RESOURCE_TYPE* get() const;
+
+   /**
+    * Returns the request the handle references.
+    */
+   inline ResourceLoadRequest* getRequest() const { return m_request; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "core\ResourceLoadRequest.inl"
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _RESOURCE_LOAD_REQUEST_H
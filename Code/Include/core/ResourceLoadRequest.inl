@@ -0,0 +1,79 @@
+#ifndef _RESOURCE_LOAD_REQUEST_H
+#error "This file can only be included from ResourceLoadRequest.h"
+#else
+
+#include "core\Resource.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename RESOURCE_TYPE >
+TResourceLoadHandle< RESOURCE_TYPE >::TResourceLoadHandle( ResourceLoadRequest* request )
+   : m_request( request )
+{
+   if ( m_request )
+   {
+      m_request->addReference();
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename RESOURCE_TYPE >
+TResourceLoadHandle< RESOURCE_TYPE >::TResourceLoadHandle( const TResourceLoadHandle& rhs )
+   : m_request( rhs.m_request )
+{
+   if ( m_request )
+   {
+      m_request->addReference();
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename RESOURCE_TYPE >
+TResourceLoadHandle< RESOURCE_TYPE >::~TResourceLoadHandle()
+{
+   if ( m_request )
+   {
+      m_request->removeReference();
+      m_request = NULL;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename RESOURCE_TYPE >
+TResourceLoadHandle< RESOURCE_TYPE >& TResourceLoadHandle< RESOURCE_TYPE >::operator=( const TResourceLoadHandle& rhs )
+{
+   if ( rhs.m_request )
+   {
+      rhs.m_request->addReference();
+   }
+
+   if ( m_request )
+   {
+      m_request->removeReference();
+   }
+
+   m_request = rhs.m_request;
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename RESOURCE_TYPE >
+RESOURCE_TYPE* TResourceLoadHandle< RESOURCE_TYPE >::get() const
+{
+   if ( m_request == NULL )
+   {
+      return NULL;
+   }
+
+   Resource* resource = m_request->getResource();
+   return resource ? DynamicCast< RESOURCE_TYPE >( resource ) : NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _RESOURCE_LOAD_REQUEST_H
@@ -7,7 +7,7 @@
 #include "core\types.h"
 #include "core\Array.h"
 #include "core\List.h"
-#include <map>
+#include "core\FilePathMap.h"
 #include <set>
 
 
@@ -16,6 +16,7 @@
 class Resource;
 class ResourcesManager;
 class FilesystemScanner;
+class CriticalSection;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -27,12 +28,15 @@ class ResourcesDB
    DECLARE_ALLOCATOR( ResourcesDB, AM_DEFAULT );
 
 private:
-   typedef std::map< FilePath, Resource* >                     ResourcesMap;
+   typedef TFilePathMap< Resource* >                           ResourcesMap;
 
 private:
    ResourcesManager&                   m_host;
    ResourcesMap                        m_resources;
 
+   // resources can be looked up from the threads that load resources in the background
+   CriticalSection*                    m_lock;
+
 public:
    /**
     * Constructor.
@@ -114,7 +118,9 @@ public:
    void unlinkDependencies( const FilePath& path );
 
    /**
-    * Looks for a resource with the specified name ( utility method )
+    * Looks for a resource with the specified name ( utility method ).
+    *
+    * Safe to call from any thread, as long as all modifications are made under the lock.
     *
     * @param name
     */
@@ -8,6 +8,8 @@
 #include "core\Filesystem.h"
 #include "core\MemoryAllocator.h"
 #include "core\Singleton.h"
+#include "core\Array.h"
+#include "core\ResourceLoadRequest.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -64,6 +66,8 @@ private:
    Filesystem*                         m_filesystem;
    ResourcesDB*                        m_resourcesDB;
    class ResourceDependenciesGraph*    m_dependenciesGraph;
+
+   Array< ResourceLoadRequest* >       m_asyncLoads;
    friend class Resource;
 
 public:
@@ -235,6 +239,54 @@ public:
     */
    void copyResource( Resource* resource, const FilePath& newPath );
 
+   // -------------------------------------------------------------------------
+   // Asynchronous operations API
+   // -------------------------------------------------------------------------
+
+   /**
+    * Starts loading a resource with the specified name in the background.
+    *
+    * The resource will be accessible through the returned handle once it's registered 
+    * with the manager - which happens during a 'processAsyncLoads' call, or when it's explicitly 
+    * waited for with 'waitFor'.
+    *
+    * Should be called from the thread that owns the manager.
+    *
+    * @param name       name of the resource file (should exist in the
+    *                   currently set filesystem)
+    * @param loadOnly   if set to 'true', the manager won't attempt to create a new resource
+    *                   if it doesn't already exist in the filesystem
+    */
+   template< typename RESOURCE_TYPE >
+   TResourceLoadHandle< RESOURCE_TYPE > createAsync( const FilePath& name, bool loadOnly = false );
+
+   /**
+    * Starts loading a resource with the specified name in the background.
+    *
+    * @param name       name of the resource file (should exist in the
+    *                   currently set filesystem)
+    * @param loadOnly   if set to 'true', the manager won't attempt to create a new resource
+    *                   if it doesn't already exist in the filesystem
+    */
+   TResourceLoadHandle< Resource > createAsync( const FilePath& name, bool loadOnly = false );
+
+   /**
+    * Blocks until the resource referenced by the handle is loaded and registers it.
+    * The caller thread helps the worker threads in the meantime.
+    *
+    * @param handle
+    * @return  the loaded resource
+    */
+   template< typename RESOURCE_TYPE >
+   RESOURCE_TYPE* waitFor( const TResourceLoadHandle< RESOURCE_TYPE >& handle );
+
+   /**
+    * Registers all resources whose loading has completed in the background.
+    *
+    * Should be called regularly ( once per frame ) by the thread that owns the manager.
+    */
+   void processAsyncLoads();
+
 protected:
    // -------------------------------------------------------------------------
    // ResourcesDB notifications API
@@ -257,6 +309,8 @@ protected:
 private:
    void init();
    void scanResourceDependencies( const FilePath& path );
+   void waitFor( ResourceLoadRequest* request );
+   void commitAsyncLoad( uint loadIdx );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
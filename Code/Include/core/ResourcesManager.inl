@@ -43,6 +43,32 @@ RESOURCE_TYPE* ResourcesManager::create( const FilePath& name, bool loadOnly )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+template< typename RESOURCE_TYPE >
+TResourceLoadHandle< RESOURCE_TYPE > ResourcesManager::createAsync( const FilePath& name, bool loadOnly )
+{
+   FilePath nameWithCorrectExtension;
+   name.changeFileExtension( RESOURCE_TYPE::getExtension(), nameWithCorrectExtension );
+   TResourceLoadHandle< Resource > handle = createAsync( nameWithCorrectExtension, loadOnly );
+
+   return TResourceLoadHandle< RESOURCE_TYPE >( handle.getRequest() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename RESOURCE_TYPE >
+RESOURCE_TYPE* ResourcesManager::waitFor( const TResourceLoadHandle< RESOURCE_TYPE >& handle )
+{
+   ResourceLoadRequest* request = handle.getRequest();
+   if ( request )
+   {
+      waitFor( request );
+   }
+
+   return handle.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 template< typename RESOURCE_TYPE >
 RESOURCE_TYPE* ResourcesManager::findResource( const FilePath& name )
 {
@@ -25,6 +25,18 @@ public:
     * @param maxThreadsCount     how many threads can simultaneously pass through the semaphore
     */
    Semaphore( uint maxThreadsCount );
+
+   /**
+    * Constructor.
+    *
+    * Allows to create a semaphore that initially lets fewer threads through than
+    * its maximum capacity - i.e. a semaphore with a zero initial count can be used
+    * to put threads to sleep until some other thread releases it.
+    *
+    * @param initialCount        how many threads can pass through the semaphore right after it's created
+    * @param maxThreadsCount     how many threads can simultaneously pass through the semaphore
+    */
+   Semaphore( uint initialCount, uint maxThreadsCount );
    ~Semaphore();
 
    /**
@@ -46,6 +58,13 @@ public:
     * Releases a semaphore lock.
     */
    void release();
+
+   /**
+    * Releases the specified number of semaphore locks at once.
+    *
+    * @param count
+    */
+   void release( uint count );
 };
 
 ///////////////////////////////////////////////////////////////////////////////
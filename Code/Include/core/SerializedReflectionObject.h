@@ -6,6 +6,7 @@
 #include "core\types.h"
 #include "core\Array.h"
 #include "core\MemoryRouter.h"
+#include "core\StreamTraits.h"
 #include <string>
 
 
@@ -161,11 +162,42 @@ public:
    template< typename T >
    void initialize( uint elemIdx, T& value ) const;
 
+   /**
+    * Serializes the specified values, replacing the contents of the array.
+    * Values of block serializable types ( see TBlockSerializable ) are copied in one go.
+    *
+    * @param values
+    * @param count
+    */
+   template< typename T >
+   void setAll( const T* values, uint count );
+
+   /**
+    * Initializes the specified variables with the values of the consecutive elements.
+    *
+    * @param values     there should be room for 'size()' elements there
+    */
+   template< typename T >
+   void initializeAll( T* values ) const;
+
    // -------------------------------------------------------------------------
    // Serialization support
    // -------------------------------------------------------------------------
    friend OutStream& operator<<( OutStream& stream, const SerializedArrayOfValues& object );
    friend InStream& operator>>( InStream& stream, SerializedArrayOfValues& object );
+
+private:
+   template< typename T >
+   void setAll( const T* values, uint count, const std::true_type& blockSerializable );
+
+   template< typename T >
+   void setAll( const T* values, uint count, const std::false_type& blockSerializable );
+
+   template< typename T >
+   void initializeAll( T* values, const std::true_type& blockSerializable ) const;
+
+   template< typename T >
+   void initializeAll( T* values, const std::false_type& blockSerializable ) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -57,4 +57,85 @@ void SerializedArrayOfValues::initialize( uint elemIdx, T& value ) const
 
 ///////////////////////////////////////////////////////////////////////////////
 
+template< typename T >
+void SerializedArrayOfValues::setAll( const T* values, uint count )
+{
+   setAll( values, count, std::integral_constant< bool, TBlockSerializable< T >::value >() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void SerializedArrayOfValues::setAll( const T* values, uint count, const std::true_type& blockSerializable )
+{
+   // the values are laid out in the buffer exactly as they would be if we serialized them one by one
+   m_buffer.resizeWithoutInitializing( count * sizeof( T ) );
+   m_startOffsets.resizeWithoutInitializing( count );
+   if ( count > 0 )
+   {
+      memcpy( (byte*)m_buffer, values, count * sizeof( T ) );
+   }
+
+   for ( uint i = 0; i < count; ++i )
+   {
+      m_startOffsets[i] = i * sizeof( T );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void SerializedArrayOfValues::setAll( const T* values, uint count, const std::false_type& blockSerializable )
+{
+   m_buffer.clear();
+   m_startOffsets.clear();
+
+   for ( uint i = 0; i < count; ++i )
+   {
+      set< T >( i, values[i] );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void SerializedArrayOfValues::initializeAll( T* values ) const
+{
+   initializeAll( values, std::integral_constant< bool, TBlockSerializable< T >::value >() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void SerializedArrayOfValues::initializeAll( T* values, const std::true_type& blockSerializable ) const
+{
+   uint count = m_startOffsets.size();
+   if ( m_buffer.size() != count * sizeof( T ) )
+   {
+      // the data was saved when the type had a different layout - let the element's serialization
+      // operators deal with it
+      initializeAll( values, std::false_type() );
+      return;
+   }
+
+   if ( count > 0 )
+   {
+      memcpy( values, (const byte*)m_buffer, count * sizeof( T ) );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+void SerializedArrayOfValues::initializeAll( T* values, const std::false_type& blockSerializable ) const
+{
+   uint count = m_startOffsets.size();
+   for ( uint i = 0; i < count; ++i )
+   {
+      initialize< T >( i, values[i] );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 #endif // _SERIALIZED_REFLECTION_OBJECT_H
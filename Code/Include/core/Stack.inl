@@ -14,7 +14,7 @@ Stack< T >::Stack( MemoryAllocator* allocator )
 {
    if ( !m_allocator )
    {
-      m_allocator = &TSingleton< MemoryRouter >::getInstance().m_defaultAllocator;
+      m_allocator = TSingleton< MemoryRouter >::getInstance().getDefaultAllocator();
    }
 }
 
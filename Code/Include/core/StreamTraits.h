@@ -0,0 +1,81 @@
+/// @file   core/StreamTraits.h
+/// @brief  compile time information about how the types should be serialized
+#ifndef _STREAM_TRAITS_H
+#define _STREAM_TRAITS_H
+
+#include <type_traits>
+#include <string>
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+class Array;
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Tells if an array of values of the specified type can be serialized as a single
+ * block of memory, instead of serializing each element individually.
+ *
+ * That's true for all POD types. Types with constructors that serialize their members
+ * one after another, without any padding between them, produce the same bytes as their
+ * memory image does - such types can opt in using the DECLARE_BLOCK_SERIALIZABLE macro.
+ */
+template< typename T >
+struct TBlockSerializable
+{
+   enum { value = std::is_pod< T >::value };
+};
+
+/**
+ * Marks a type as one whose arrays can be serialized as a single memory block.
+ * Put it in the global namespace, after the type's definition.
+ */
+#define DECLARE_BLOCK_SERIALIZABLE( Type )                                    \
+   template<>                                                                 \
+   struct TBlockSerializable< Type >                                          \
+   {                                                                          \
+      enum { value = true };                                                  \
+   }
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Tells if the elements of an array of the specified type should be streamed one by one,
+ * using their own serialization operators ( see InStream and OutStream ).
+ *
+ * The arrays have always been streamed as the memory images of their elements, and that's
+ * how the existing resources store them, so that's what happens to all other types. The memory
+ * images of strings and arrays are meaningless outside of the process that saved them,
+ * so no resource could have stored them that way.
+ */
+template< typename T >
+struct TStreamedElementwise
+{
+   enum { value = false };
+};
+
+template<>
+struct TStreamedElementwise< std::string >
+{
+   enum { value = true };
+};
+
+template< typename T >
+struct TStreamedElementwise< std::vector< T > >
+{
+   enum { value = true };
+};
+
+template< typename T >
+struct TStreamedElementwise< Array< T > >
+{
+   enum { value = true };
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _STREAM_TRAITS_H
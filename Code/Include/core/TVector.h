@@ -4,6 +4,7 @@
 #define _TVECTOR_H
 
 #include <iostream>
+#include "core/StreamTraits.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -53,6 +54,12 @@ public:
    template< int VDim > friend InStream& operator>>( InStream& serializer, TVector< VDim >& rhs );
 };
 
+template< int Dim >
+struct TBlockSerializable< TVector< Dim > >
+{
+   enum { value = true };
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "core/TVector.inl"
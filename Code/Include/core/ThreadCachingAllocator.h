@@ -0,0 +1,125 @@
+/// @file   core/ThreadCachingAllocator.h
+/// @brief  a general purpose allocator that serves small allocations from per-thread caches
+#pragma once
+
+#include "core\types.h"
+#include "core\MemoryAllocator.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+class CriticalSection;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A general purpose allocator that serves small allocations from per-thread caches.
+ *
+ * Small allocations are rounded up to one of the size classes. Each thread keeps
+ * a free list of blocks for every size class, so most of the allocations and deallocations
+ * don't take any locks at all. When a thread runs out of blocks of a certain class,
+ * it takes a whole batch of them from the central heap, and when it accumulates too many
+ * free blocks, it returns a batch there.
+ *
+ * A block is always released to the cache of the thread that releases it - so releasing
+ * memory allocated by a different thread doesn't take any locks either.
+ *
+ * Allocations larger than MAX_CACHED_SIZE go directly to the system heap.
+ *
+ * The cached blocks are carved out of chunks that are returned to the system only when
+ * the allocator is destroyed - and only if all of the blocks have been released by then.
+ * Otherwise the allocator keeps its memory, so that the leaked blocks can still be released safely.
+ */
+class ThreadCachingAllocator : public MemoryAllocator
+{
+public:
+   static const uint    SIZE_CLASS_GRANULARITY = 16;
+   static const uint    MAX_CACHED_SIZE = 1024;
+   static const uint    SIZE_CLASSES_COUNT = MAX_CACHED_SIZE / SIZE_CLASS_GRANULARITY;
+
+   /**
+    * Number of blocks moved between a thread cache and the central heap at once.
+    */
+   static const uint    BATCH_SIZE = 32;
+
+private:
+   struct FreeBlock
+   {
+      FreeBlock*        m_next;
+   };
+
+   struct FreeList
+   {
+      FreeBlock*        m_head;
+      uint              m_count;
+   };
+
+   struct ThreadCache
+   {
+      FreeList          m_freeLists[SIZE_CLASSES_COUNT];
+
+      // modified only by the thread that owns the cache
+      volatile long     m_allocatedMemorySize;
+
+      ThreadCache*      m_nextCache;
+      ThreadCache*      m_nextUnusedCache;
+   };
+
+   struct Chunk
+   {
+      Chunk*            m_next;
+   };
+
+   CriticalSection*     m_centralLock;
+   ulong                m_tlsIndex;
+
+   FreeList             m_centralFreeLists[SIZE_CLASSES_COUNT];
+   Chunk*               m_chunks;
+
+   // caches are never released before the allocator is destroyed, as they keep
+   // track of the memory used by their threads
+   ThreadCache*         m_caches;
+   ThreadCache*         m_unusedCaches;
+
+public:
+   /**
+    * Constructor.
+    */
+   ThreadCachingAllocator();
+
+   /**
+    * Destructor. Releases the allocator's memory, unless some of the blocks are still in use.
+    */
+   ~ThreadCachingAllocator();
+
+   /**
+    * Returns the cached blocks of the calling thread to the central heap, so that
+    * other threads can use them. Call it before a thread exits.
+    *
+    * The cache itself is kept and will be reused by the next thread that starts allocating.
+    */
+   void releaseThreadCache();
+
+   // -------------------------------------------------------------------------
+   // MemoryAllocator implementation
+   // -------------------------------------------------------------------------
+   void* alloc( size_t size );
+   void dealloc( void* ptr );
+   ulong getMemoryUsed() const;
+
+private:
+   // -------------------------------------------------------------------------
+   // We don't support making copies of allocators
+   // -------------------------------------------------------------------------
+   ThreadCachingAllocator( const ThreadCachingAllocator& rhs ) {}
+   void operator=( const ThreadCachingAllocator& rhs ) {}
+
+   static inline uint getSizeClass( size_t size ) { return size > 0 ? ( size - 1 ) / SIZE_CLASS_GRANULARITY : 0; }
+
+   ThreadCache* getThreadCache();
+   void fetchFromCentralHeap( uint sizeClass, FreeList& list );
+   void releaseToCentralHeap( uint sizeClass, FreeList& list, uint blocksCount );
+   void allocateChunk( uint sizeClass );
+};
+
+///////////////////////////////////////////////////////////////////////////////
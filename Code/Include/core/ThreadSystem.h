@@ -71,9 +71,23 @@ public:
 
    /**
     * Returns a Thread instance dedicated to the thread this method was called from.
+    *
+    * The instance is cached in the thread local storage when the thread registers,
+    * so the method doesn't lock anything ( it's called every time a reflection object
+    * is created or type-checked ).
     */
    Thread& getCurrentThread();
 
+   /**
+    * Looks up a Thread instance registered for the specified thread of execution.
+    *
+    * Unlike 'getCurrentThread', this method needs to lock the threads registry.
+    *
+    * @param threadId
+    * @return     the thread instance, or NULL if no such thread is registered
+    */
+   Thread* findThread( ulong threadId ) const;
+
    /**
     * Returns a number of active processor cores.
     */
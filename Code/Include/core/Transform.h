@@ -242,6 +242,8 @@ ALIGN_16 struct Transform
    friend InStream& operator>>( InStream& serializer, Transform& rhs );
 };
 
+DECLARE_BLOCK_SERIALIZABLE( Transform );
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #endif // _TRANSFORM_H
@@ -7,6 +7,7 @@
 #include "core/MathDataStorage.h"
 #include "core/TVector.h"
 #include "core/FastFloat.h"
+#include "core/StreamTraits.h"
 #include <iostream>
 
 
@@ -776,6 +777,8 @@ ALIGN_16 struct Vector
    friend InStream& operator>>( InStream& serializer, Vector& rhs );
 };
 
+DECLARE_BLOCK_SERIALIZABLE( Vector );
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef _USE_SIMD
@@ -0,0 +1,87 @@
+/// @file   core/WorkStealingQueue.h
+/// @brief  a lock-free queue owned by a single thread that other threads can steal from
+#ifndef _WORK_STEALING_QUEUE_H
+#define _WORK_STEALING_QUEUE_H
+
+#include "core\MemoryRouter.h"
+#include "core\Atomic.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A lock-free, fixed capacity queue owned by a single thread ( Chase-Lev deque ).
+ *
+ * The owner thread pushes and pops elements at the queue's bottom ( LIFO order, which
+ * keeps the recently produced data warm in the cache ), while any other thread
+ * can steal elements from its top ( FIFO order ).
+ *
+ * Only the owner thread is allowed to call 'push' and 'pop'. 'steal' can be called
+ * from any thread.
+ *
+ * The queue stores plain values - it's meant to hold pointers.
+ */
+template< typename T >
+class WorkStealingQueue
+{
+   DECLARE_ALLOCATOR( WorkStealingQueue, AM_DEFAULT );
+
+private:
+   T*                      m_elements;
+   long                    m_mask;
+
+   volatile long           m_bottom;
+   AtomicInt               m_top;
+
+public:
+   /**
+    * Constructor.
+    *
+    * @param capacity      max number of stored elements ( rounded up to a power of 2 )
+    */
+   WorkStealingQueue( uint capacity );
+   ~WorkStealingQueue();
+
+   /**
+    * Appends an element to the bottom of the queue ( owner thread only ).
+    *
+    * @param elem
+    * @return     'false' if the queue is full and the element couldn't be added
+    */
+   bool push( const T& elem );
+
+   /**
+    * Removes an element from the bottom of the queue ( owner thread only ).
+    *
+    * @param outElem
+    * @return     'true' if an element was removed
+    */
+   bool pop( T& outElem );
+
+   /**
+    * Removes an element from the top of the queue ( any thread ).
+    *
+    * @param outElem
+    * @return     'true' if an element was stolen
+    */
+   bool steal( T& outElem );
+
+   /**
+    * Tells if the queue is empty. The result is only an estimate if other threads
+    * are operating on the queue at the same time.
+    */
+   bool empty() const;
+
+   /**
+    * Returns the approximate number of elements in the queue.
+    */
+   uint size() const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+#include "core\WorkStealingQueue.inl"
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _WORK_STEALING_QUEUE_H
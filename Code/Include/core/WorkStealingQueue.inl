@@ -0,0 +1,134 @@
+#ifndef _WORK_STEALING_QUEUE_H
+#error "This file can only be included from WorkStealingQueue.h"
+#else
+
+#include "core\Assert.h"
+#include <intrin.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+WorkStealingQueue< T >::WorkStealingQueue( uint capacity )
+   : m_bottom( 0 )
+   , m_top( 0 )
+{
+   uint roundedCapacity = 2;
+   while ( roundedCapacity < capacity )
+   {
+      roundedCapacity <<= 1;
+   }
+
+   m_elements = new T[roundedCapacity];
+   m_mask = roundedCapacity - 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+WorkStealingQueue< T >::~WorkStealingQueue()
+{
+   delete [] m_elements;
+   m_elements = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+bool WorkStealingQueue< T >::push( const T& elem )
+{
+   long bottom = m_bottom;
+   long top = m_top.get();
+   if ( bottom - top > m_mask )
+   {
+      // the queue is full
+      return false;
+   }
+
+   m_elements[bottom & m_mask] = elem;
+
+   // the element needs to be in place before thieves can see the new bottom
+   _ReadWriteBarrier();
+   m_bottom = bottom + 1;
+
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+bool WorkStealingQueue< T >::pop( T& outElem )
+{
+   // reserve the bottom element - this has to be a full barrier, because we need to
+   // read the top index only after the thieves can see the reservation
+   long bottom = m_bottom - 1;
+   _InterlockedExchange( &m_bottom, bottom );
+
+   long top = m_top.get();
+   if ( top > bottom )
+   {
+      // the queue was empty
+      m_bottom = top;
+      return false;
+   }
+
+   outElem = m_elements[bottom & m_mask];
+   if ( top < bottom )
+   {
+      // there's more than one element left - no thief could have touched this one
+      return true;
+   }
+
+   // this is the last element - race the thieves for it
+   bool popped = ( m_top.compareExchange( top + 1, top ) == top );
+   m_bottom = top + 1;
+
+   return popped;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+bool WorkStealingQueue< T >::steal( T& outElem )
+{
+   long top = m_top.get();
+   _ReadWriteBarrier();
+   long bottom = m_bottom;
+
+   if ( top >= bottom )
+   {
+      // the queue is empty
+      return false;
+   }
+
+   T elem = m_elements[top & m_mask];
+   if ( m_top.compareExchange( top + 1, top ) != top )
+   {
+      // another thread took the element
+      return false;
+   }
+
+   outElem = elem;
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+bool WorkStealingQueue< T >::empty() const
+{
+   return m_bottom <= m_top.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+template< typename T >
+uint WorkStealingQueue< T >::size() const
+{
+   long count = m_bottom - m_top.get();
+   return count > 0 ? (uint)count : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif // _WORK_STEALING_QUEUE_H
@@ -47,6 +47,7 @@ class EntitiesGroup;
 class Model;
 class Light;
 class Shader;
+class AnimationVisibilityProvider;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -135,6 +136,12 @@ public:
     */
    void assignSelectionGroup( EntitiesGroup* group );
 
+   /**
+    * Tells which entities of the main scene were visible in the last rendered frame ( available once the mechanism is initialized ).
+    * Pass it to AnimationLODManager::setVisibilityProvider to pause the animations of the off screen entities.
+    */
+   const AnimationVisibilityProvider& getMainSceneVisibility() const;
+
    // -------------------------------------------------------------------------
    // RenderingMechanism implementation
    // -------------------------------------------------------------------------
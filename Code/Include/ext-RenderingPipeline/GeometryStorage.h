@@ -4,7 +4,7 @@
 
 #include "core\MemoryRouter.h"
 #include "core\Array.h"
-#include "core\List.h"
+#include "core\AABBTree.h"
 #include "core\AxisAlignedBox.h"
 
 
@@ -17,19 +17,33 @@ class RPBoundingVolume;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Spatial geometry storage.
+ *
+ * Renderables are indexed by a bounding volume hierarchy, so that the queries can skip
+ * entire regions of the scene that lie outside of the queried volume.
+ */
 class GeometryStorage
 {
    DECLARE_ALLOCATOR( GeometryStorage, AM_ALIGNED_16 );
 
 private:
-   List< GeometryComponent* >          m_renderables;
-   AxisAlignedBox                      m_sceneBounds;
+   AABBTree< GeometryComponent >       m_renderables;
 
 public:
    /**
-    * Recalculates scene bounds.
+    * Updates the spatial index with the new locations of the renderables that moved,
+    * and recalculates scene bounds.
+    *
+    * Call it once per frame, before the storage is queried.
+    */
+   void update();
+
+   /**
+    * Rebuilds the spatial index from scratch. Call it after inserting a large batch
+    * of renderables ( when a scene is loaded, for instance ).
     */
-   void recalcSceneBounds();
+   void rebuild();
 
    /**
     * Queries the storage contents, returning only the elements contained in the specified bounding volume
@@ -48,7 +62,7 @@ public:
    void queryForShadowMapping( const RPBoundingVolume& volume, Array< GeometryComponent* >& outVisibleElems ) const;
 
    /**
-    * Inserts a entity.
+    * Inserts a renderable.
     *
     * @param renderable.
     */
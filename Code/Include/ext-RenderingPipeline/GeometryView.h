@@ -6,8 +6,10 @@
 #include "core\List.h"
 #include "core-MVC\ModelView.h"
 #include "core-MVC\EntitiesGroupView.h"
+#include "core-AI\AnimationLODManager.h"
 #include "core\AxisAlignedBox.h"
 #include "ext-RenderingPipeline\RPDataProxies.h"
+#include <set>
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -19,7 +21,7 @@ class RPBoundingVolume;
 
 ///////////////////////////////////////////////////////////////////////////////
 
-class GeometryView : public ModelView, public EntitiesGroupView
+class GeometryView : public ModelView, public EntitiesGroupView, public AnimationVisibilityProvider
 {
    DECLARE_ALLOCATOR( GeometryView, AM_ALIGNED_16 );
 
@@ -27,6 +29,10 @@ public:
    GeometryArray*                                           m_visibleGeometry;
    GeometryStorage*                                         m_geometryStorage;
 
+private:
+   // entities the visible geometry belongs to, along with their ancestors
+   std::set< const Entity* >                                m_visibleEntities;
+
 public:
    /**
     * Constructor.
@@ -57,6 +63,11 @@ public:
    void onEntityRemoved( Entity* entity );
    void onAttachedToGroup( EntitiesGroup& group );
    void onDetachedFromGroup( EntitiesGroup& group );
+
+   // ----------------------------------------------------------------------
+   // AnimationVisibilityProvider implementation
+   // ----------------------------------------------------------------------
+   bool isVisible( const Entity* entity ) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -4,7 +4,7 @@
 
 #include "core\Array.h"
 #include "core-MVC\ModelView.h"
-#include "core\LinearStorage.h"
+#include "core\AABBTree.h"
 #include "core\AxisAlignedBox.h"
 #include "ext-RenderingPipeline\RPDataProxies.h"
 
@@ -25,7 +25,7 @@ public:
    LightsArray*                                             m_visibleLights;
 
 private:
-   LinearStorage< Light >*                                  m_lightsStorage;
+   AABBTree< Light >*                                       m_lightsStorage;
 
 public:
    /**
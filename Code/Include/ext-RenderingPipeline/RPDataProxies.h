@@ -6,6 +6,7 @@
 #include "core\Array.h"
 #include "core\Frustum.h"
 #include "core\AxisAlignedBox.h"
+#include "core\PackedAxisAlignedBoxes.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -65,6 +66,15 @@ public:
     * @param aab
     */
    virtual bool testIntersection( const AxisAlignedBox& aab ) const = 0;
+
+   /**
+    * Tests the intersection of this volume with a batch of axis aligned boxes.
+    *
+    * @param boxes
+    * @param outResults    1 for the boxes that intersect the volume, 0 for the rest.
+    *                      Must be able to accommodate boxes.size() entries.
+    */
+   virtual void testIntersections( const PackedAxisAlignedBoxes& boxes, byte* outResults ) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -82,6 +92,7 @@ public:
    // RPBoundingVolume implementation
    // -------------------------------------------------------------------------
    bool testIntersection( const AxisAlignedBox& aab ) const;
+   void testIntersections( const PackedAxisAlignedBoxes& boxes, byte* outResults ) const;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
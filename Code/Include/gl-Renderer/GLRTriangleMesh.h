@@ -41,8 +41,10 @@ public:
 
    /**
     * Renders the mesh.
+    *
+    * @param instancesCount      number of instances of the mesh to render
     */
-   void render();
+   void render( uint instancesCount = 1 );
 
    /**
     * Refreshes the resource to reflect the changes in the corresponding engine resource.
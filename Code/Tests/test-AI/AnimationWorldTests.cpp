@@ -0,0 +1,809 @@
+#include "core-TestFramework\TestFramework.h"
+#include "TypesRegistryInitializer.h"
+#include "core\MultithreadedTasksScheduler.h"
+#include "core\Timer.h"
+#include "core\Log.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   class EventsRecorderMock : public BlendTreePlayerListener
+   {
+   public:
+      Array< BlendTreePlayer* >     m_notifyingPlayers;
+
+      void onEventTriggered( BlendTreePlayer* player, const BlendTreeEvent* btEvent )
+      {
+         m_notifyingPlayers.push_back( player );
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   class VisibilityProviderMock : public AnimationVisibilityProvider
+   {
+   public:
+      const Entity*                 m_hiddenEntity;
+
+      VisibilityProviderMock() : m_hiddenEntity( NULL ) {}
+
+      bool isVisible( const Entity* entity ) const
+      {
+         return entity != m_hiddenEntity;
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   void placeCharacter( BlendTreePlayer* player, float distance )
+   {
+      Matrix mtx;
+      mtx.setTranslation( Vector( 0.0f, 0.0f, distance ) );
+
+      Entity* entity = player->getParent();
+      entity->setLocalMtx( mtx );
+      entity->updateTransforms();
+   }
+
+   // -------------------------------------------------------------------------
+
+   void createSkeleton( uint bonesCount, Skeleton& outSkeleton )
+   {
+      Matrix boneLocalMtx;
+      boneLocalMtx.setTranslation( Vector( 0.0f, 0.1f, 0.0f ) );
+
+      outSkeleton.addBone( "Bone", Matrix::IDENTITY, -1, 0.1f );
+      for ( uint i = 1; i < bonesCount; ++i )
+      {
+         // a few chains of bones growing out of the root
+         const int parentIdx = ( i % 5 == 1 ) ? 0 : (int)i - 1;
+         outSkeleton.addBone( "Bone", boneLocalMtx, parentIdx, 0.1f );
+      }
+   }
+
+   // -------------------------------------------------------------------------
+
+   void createAnimation( uint bonesCount, uint framesCount, SnapshotAnimation& outAnimation )
+   {
+      Array< Transform > poses;
+      poses.resize( framesCount * bonesCount );
+
+      Vector axis;
+      for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+      {
+         const float time = (float)frameIdx * SnapshotAnimation::ANIMATION_SAMPLING_FREQUENCY;
+         for ( uint boneIdx = 0; boneIdx < bonesCount; ++boneIdx )
+         {
+            axis.setNormalized( 1.0f, (float)( boneIdx % 3 ), (float)( boneIdx % 4 ) );
+            poses[frameIdx * bonesCount + boneIdx].m_rotation.setAxisAngle( axis, 0.5f * sinf( time * ( 1.0f + 0.1f * (float)boneIdx ) ) );
+         }
+      }
+
+      SnapshotAnimation::build( outAnimation, 24.0f, framesCount, bonesCount, (Transform*)poses, NULL );
+   }
+
+   // -------------------------------------------------------------------------
+
+   void createCharacters( uint charactersCount, Skeleton& skeleton, BlendTree& tree, Model& scene, Array< BlendTreePlayer* >& outPlayers, Array< SkeletonComponent* >& outSkeletonComponents )
+   {
+      for ( uint i = 0; i < charactersCount; ++i )
+      {
+         Entity* entity = new Entity();
+
+         SkeletonComponent* skeletonComponent = new SkeletonComponent();
+         skeletonComponent->setSkeleton( &skeleton );
+         entity->addChild( skeletonComponent );
+
+         BlendTreePlayer* player = new BlendTreePlayer();
+         player->setBlendTree( tree );
+         entity->addChild( player );
+
+         scene.addChild( entity );
+
+         outPlayers.push_back( player );
+         outSkeletonComponents.push_back( skeletonComponent );
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, parallelSamplingMatchesSerialSampling )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   const uint bonesCount = 20;
+   Skeleton skeleton;
+   createSkeleton( bonesCount, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( bonesCount, 49, animation );
+
+   BlendTree tree;
+   tree.setSkeleton( &skeleton );
+   tree.getRoot().add( new BlendTreeAnimation( "Anim", &animation ) );
+
+   const uint charactersCount = 64;
+   Model serialScene;
+   Model parallelScene;
+   Array< BlendTreePlayer* > serialPlayers, parallelPlayers;
+   Array< SkeletonComponent* > serialSkeletons, parallelSkeletons;
+   createCharacters( charactersCount, skeleton, tree, serialScene, serialPlayers, serialSkeletons );
+   createCharacters( charactersCount, skeleton, tree, parallelScene, parallelPlayers, parallelSkeletons );
+
+   AnimationWorld serialWorld;
+   serialWorld.setParallelUpdates( false );
+   serialWorld.play( true );
+   serialScene.attachListener( &serialWorld );
+
+   AnimationWorld parallelWorld;
+   parallelWorld.setParallelUpdates( true );
+   parallelWorld.play( true );
+   parallelScene.attachListener( &parallelWorld );
+
+   const uint framesCount = 5;
+   for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+   {
+      serialWorld.tickAnimations( 0.1f );
+      parallelWorld.tickAnimations( 0.1f );
+
+      for ( uint i = 0; i < charactersCount; ++i )
+      {
+         for ( uint boneIdx = 0; boneIdx < bonesCount; ++boneIdx )
+         {
+            COMPARE_MTX( serialSkeletons[i]->m_boneLocalMtx[boneIdx], parallelSkeletons[i]->m_boneLocalMtx[boneIdx] );
+         }
+      }
+   }
+
+   // cleanup
+   serialScene.detachListener( &serialWorld );
+   parallelScene.detachListener( &parallelWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, notificationsSentInPlayersOrder )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   Skeleton skeleton;
+   createSkeleton( 1, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( 1, 25, animation );
+
+   BlendTree tree;
+   BlendTreeEvent* btEvent = new BlendTreeEvent();
+   {
+      tree.setSkeleton( &skeleton );
+      tree.addEvent( btEvent );
+
+      BlendTreeAnimation* animationNode = new BlendTreeAnimation( "Anim", &animation );
+      animationNode->addEvent( new BlendTreeAnimationEvent( btEvent, 0.5f ) );
+      tree.getRoot().add( animationNode );
+   }
+
+   const uint charactersCount = 64;
+   Model scene;
+   Array< BlendTreePlayer* > players;
+   Array< SkeletonComponent* > skeletonComponents;
+   createCharacters( charactersCount, skeleton, tree, scene, players, skeletonComponents );
+
+   EventsRecorderMock listener;
+   for ( uint i = 0; i < charactersCount; ++i )
+   {
+      players[i]->attachListener( &listener );
+   }
+
+   AnimationWorld animWorld;
+   animWorld.setParallelUpdates( true );
+   animWorld.play( true );
+   scene.attachListener( &animWorld );
+
+   // all players trigger the event at the same time - even though they were sampled
+   // on different threads, the listener learns about it in the order the players were added in
+   animWorld.tickAnimations( 0.75f );
+   CPPUNIT_ASSERT_EQUAL( charactersCount, listener.m_notifyingPlayers.size() );
+   for ( uint i = 0; i < charactersCount; ++i )
+   {
+      CPPUNIT_ASSERT( players[i] == listener.m_notifyingPlayers[i] );
+   }
+
+   // the triggered events are visible the next frame
+   animWorld.tickAnimations( 0.1f );
+   for ( uint i = 0; i < charactersCount; ++i )
+   {
+      CPPUNIT_ASSERT( players[i]->wasEventTriggered( btEvent ) );
+   }
+
+   // cleanup
+   for ( uint i = 0; i < charactersCount; ++i )
+   {
+      players[i]->detachListener( &listener );
+   }
+   scene.detachListener( &animWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, updateRateDependsOnDistance )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   Skeleton skeleton;
+   createSkeleton( 3, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( 3, 25, animation );
+
+   BlendTree tree;
+   tree.setSkeleton( &skeleton );
+   tree.getRoot().add( new BlendTreeAnimation( "Anim", &animation ) );
+
+   Model scene;
+   Array< BlendTreePlayer* > players;
+   Array< SkeletonComponent* > skeletonComponents;
+   createCharacters( 3, skeleton, tree, scene, players, skeletonComponents );
+   placeCharacter( players[0], 5.0f );
+   placeCharacter( players[1], 30.0f );
+   placeCharacter( players[2], 100.0f );
+
+   AnimationWorld animWorld;
+   AnimationLODManager& lodManager = animWorld.accessLODManager();
+   lodManager.setEnabled( true );
+   lodManager.setDistances( 20.0f, 50.0f );
+   lodManager.setViewpoint( Vector_ZERO );
+   animWorld.play( true );
+   scene.attachListener( &animWorld );
+
+   // the first frame samples all players
+   animWorld.tickAnimations( 0.1f );
+   CPPUNIT_ASSERT_EQUAL( AUR_EveryFrame, players[0]->getLODState().m_updateRate );
+   CPPUNIT_ASSERT_EQUAL( AUR_Every2ndFrame, players[1]->getLODState().m_updateRate );
+   CPPUNIT_ASSERT_EQUAL( AUR_Every4thFrame, players[2]->getLODState().m_updateRate );
+
+   uint samplesCount[3] = { 0, 0, 0 };
+   float sampledTime[3] = { 0.0f, 0.0f, 0.0f };
+   const uint framesCount = 8;
+   for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+   {
+      animWorld.tickAnimations( 0.1f );
+      for ( uint i = 0; i < 3; ++i )
+      {
+         const AnimationLODState& lodState = players[i]->getLODState();
+         if ( lodState.m_sampleThisFrame )
+         {
+            ++samplesCount[i];
+            sampledTime[i] += lodState.m_timeToSample;
+         }
+      }
+   }
+
+   CPPUNIT_ASSERT_EQUAL( (uint)8, samplesCount[0] );
+   CPPUNIT_ASSERT_EQUAL( (uint)4, samplesCount[1] );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, samplesCount[2] );
+
+   // the players that are sampled less frequently advance by the time of all skipped frames,
+   // so no time is lost
+   for ( uint i = 0; i < 3; ++i )
+   {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.8f, sampledTime[i] + players[i]->getLODState().m_timeSinceSample, 1e-4f );
+   }
+
+   // cleanup
+   scene.detachListener( &animWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, samplingStaggeredAcrossFrames )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   Skeleton skeleton;
+   createSkeleton( 3, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( 3, 25, animation );
+
+   BlendTree tree;
+   tree.setSkeleton( &skeleton );
+   tree.getRoot().add( new BlendTreeAnimation( "Anim", &animation ) );
+
+   // all characters are far away
+   const uint charactersCount = 8;
+   Model scene;
+   Array< BlendTreePlayer* > players;
+   Array< SkeletonComponent* > skeletonComponents;
+   createCharacters( charactersCount, skeleton, tree, scene, players, skeletonComponents );
+   for ( uint i = 0; i < charactersCount; ++i )
+   {
+      placeCharacter( players[i], 100.0f );
+   }
+
+   AnimationWorld animWorld;
+   AnimationLODManager& lodManager = animWorld.accessLODManager();
+   lodManager.setEnabled( true );
+   lodManager.setDistances( 20.0f, 50.0f );
+   animWorld.play( true );
+   scene.attachListener( &animWorld );
+
+   animWorld.tickAnimations( 0.1f );
+
+   // instead of sampling all of them every 4th frame, a quarter of them is sampled every frame
+   for ( uint frameIdx = 0; frameIdx < 8; ++frameIdx )
+   {
+      animWorld.tickAnimations( 0.1f );
+
+      uint sampledPlayersCount = 0;
+      for ( uint i = 0; i < charactersCount; ++i )
+      {
+         if ( players[i]->getLODState().m_sampleThisFrame )
+         {
+            ++sampledPlayersCount;
+         }
+      }
+      CPPUNIT_ASSERT_EQUAL( charactersCount / 4, sampledPlayersCount );
+   }
+
+   // cleanup
+   scene.detachListener( &animWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, skippedFramesInterpolateSampledPoses )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   const uint bonesCount = 5;
+   Skeleton skeleton;
+   createSkeleton( bonesCount, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( bonesCount, 49, animation );
+
+   BlendTree tree;
+   tree.setSkeleton( &skeleton );
+   tree.getRoot().add( new BlendTreeAnimation( "Anim", &animation ) );
+
+   Model scene;
+   Array< BlendTreePlayer* > players;
+   Array< SkeletonComponent* > skeletonComponents;
+   createCharacters( 1, skeleton, tree, scene, players, skeletonComponents );
+   placeCharacter( players[0], 100.0f );
+
+   AnimationWorld animWorld;
+   AnimationLODManager& lodManager = animWorld.accessLODManager();
+   lodManager.setEnabled( true );
+   lodManager.setDistances( 20.0f, 50.0f );
+   animWorld.play( true );
+   scene.attachListener( &animWorld );
+
+   BlendTreePlayer* player = players[0];
+   const AnimationLODState& lodState = player->getLODState();
+
+   // run until the player gets sampled twice
+   Array< Transform > prevSampledPose, lastSampledPose;
+   uint samplesCount = 0;
+   while ( samplesCount < 2 )
+   {
+      animWorld.tickAnimations( 0.05f );
+      if ( lodState.m_sampleThisFrame )
+      {
+         prevSampledPose = lastSampledPose;
+         lastSampledPose = player->m_finalSourcePose;
+         ++samplesCount;
+      }
+   }
+
+   // the frames until the next sample show the poses in between the last two sampled ones
+   Transform expectedTransform;
+   Matrix expectedMtx;
+   for ( uint frameIdx = 0; frameIdx < 4; ++frameIdx )
+   {
+      CPPUNIT_ASSERT( lodState.m_interpolationProgress > 0.0f && lodState.m_interpolationProgress <= 1.0f );
+      CPPUNIT_ASSERT_DOUBLES_EQUAL( (float)( frameIdx + 1 ) / 4.0f, lodState.m_interpolationProgress, 1e-4f );
+
+      for ( uint i = 0; i < bonesCount; ++i )
+      {
+         expectedTransform.setSlerp( prevSampledPose[i], lastSampledPose[i], FastFloat::fromFloat( lodState.m_interpolationProgress ) );
+         expectedTransform.toMatrix( expectedMtx );
+         COMPARE_MTX( expectedMtx, skeletonComponents[0]->m_boneLocalMtx[i] );
+      }
+
+      animWorld.tickAnimations( 0.05f );
+      if ( frameIdx < 3 )
+      {
+         CPPUNIT_ASSERT( !lodState.m_sampleThisFrame );
+      }
+   }
+
+   // and then a new pose is sampled
+   CPPUNIT_ASSERT( lodState.m_sampleThisFrame );
+
+   // cleanup
+   scene.detachListener( &animWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, offscreenPlayersArePaused )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   const uint bonesCount = 3;
+   Skeleton skeleton;
+   createSkeleton( bonesCount, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( bonesCount, 49, animation );
+
+   BlendTree tree;
+   tree.setSkeleton( &skeleton );
+   tree.getRoot().add( new BlendTreeAnimation( "Anim", &animation ) );
+
+   Model scene;
+   Array< BlendTreePlayer* > players;
+   Array< SkeletonComponent* > skeletonComponents;
+   createCharacters( 2, skeleton, tree, scene, players, skeletonComponents );
+
+   VisibilityProviderMock visibilityProvider;
+   visibilityProvider.m_hiddenEntity = players[1]->getParent();
+
+   AnimationWorld animWorld;
+   AnimationLODManager& lodManager = animWorld.accessLODManager();
+   lodManager.setEnabled( true );
+   lodManager.setVisibilityProvider( &visibilityProvider );
+   animWorld.play( true );
+   scene.attachListener( &animWorld );
+
+   animWorld.tickAnimations( 0.1f );
+   CPPUNIT_ASSERT_EQUAL( AUR_EveryFrame, players[0]->getLODState().m_updateRate );
+   CPPUNIT_ASSERT_EQUAL( AUR_Paused, players[1]->getLODState().m_updateRate );
+
+   // the hidden character doesn't move
+   Matrix hiddenBoneMtx = skeletonComponents[1]->m_boneLocalMtx[1];
+   Matrix visibleBoneMtx = skeletonComponents[0]->m_boneLocalMtx[1];
+   animWorld.tickAnimations( 0.1f );
+   COMPARE_MTX( hiddenBoneMtx, skeletonComponents[1]->m_boneLocalMtx[1] );
+   CPPUNIT_ASSERT( visibleBoneMtx != skeletonComponents[0]->m_boneLocalMtx[1] );
+
+   // once it's back on screen, it gets sampled right away
+   visibilityProvider.m_hiddenEntity = NULL;
+   animWorld.tickAnimations( 0.1f );
+   CPPUNIT_ASSERT_EQUAL( AUR_EveryFrame, players[1]->getLODState().m_updateRate );
+   CPPUNIT_ASSERT( players[1]->getLODState().m_sampleThisFrame );
+
+   // cleanup
+   scene.detachListener( &animWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, resumedPlayersAreSampledRightAway )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   Skeleton skeleton;
+   createSkeleton( 3, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( 3, 49, animation );
+
+   BlendTree tree;
+   tree.setSkeleton( &skeleton );
+   tree.getRoot().add( new BlendTreeAnimation( "Anim", &animation ) );
+
+   Model scene;
+   Array< BlendTreePlayer* > players;
+   Array< SkeletonComponent* > skeletonComponents;
+   createCharacters( 1, skeleton, tree, scene, players, skeletonComponents );
+   placeCharacter( players[0], 100.0f );
+
+   VisibilityProviderMock visibilityProvider;
+
+   AnimationWorld animWorld;
+   AnimationLODManager& lodManager = animWorld.accessLODManager();
+   lodManager.setEnabled( true );
+   lodManager.setVisibilityProvider( &visibilityProvider );
+   animWorld.play( true );
+   scene.attachListener( &animWorld );
+
+   // the first frame samples the player, and then it goes off screen for a few frames
+   animWorld.tickAnimations( 0.1f );
+   visibilityProvider.m_hiddenEntity = players[0]->getParent();
+   for ( uint i = 0; i < 3; ++i )
+   {
+      animWorld.tickAnimations( 0.1f );
+   }
+
+   // it's back on screen in a frame that isn't the start of its update period - it gets sampled nonetheless,
+   // and it shows the new pose instead of interpolating between the ones sampled before it was paused
+   visibilityProvider.m_hiddenEntity = NULL;
+   animWorld.tickAnimations( 0.1f );
+   const AnimationLODState& lodState = players[0]->getLODState();
+   CPPUNIT_ASSERT_EQUAL( AUR_Every4thFrame, lodState.m_updateRate );
+   CPPUNIT_ASSERT( lodState.m_sampleThisFrame );
+   CPPUNIT_ASSERT_EQUAL( (uint)0, lodState.m_framesSinceSample );
+   CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0f, lodState.m_interpolationProgress, 1e-4f );
+   CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.1f, lodState.m_timeToSample, 1e-4f );
+
+   // cleanup
+   scene.detachListener( &animWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, eventTransitionsFireAtReducedUpdateRates )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   Skeleton skeleton;
+   createSkeleton( 3, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( 3, 25, animation );
+
+   // the character walks until the walk animation triggers an event, and then it starts running
+   BlendTree tree;
+   BlendTreeAnimation* runNode = NULL;
+   {
+      tree.setSkeleton( &skeleton );
+
+      BlendTreeEvent* btEvent = new BlendTreeEvent();
+      tree.addEvent( btEvent );
+
+      BlendTreeAnimation* walkNode = new BlendTreeAnimation( "Walk", &animation );
+      walkNode->addEvent( new BlendTreeAnimationEvent( btEvent, 0.5f ) );
+      runNode = new BlendTreeAnimation( "Run", &animation );
+
+      BlendTreeStateMachine& root = tree.getRoot();
+      root.add( walkNode );
+      root.add( runNode );
+
+      BTTTEvent* trigger = new BTTTEvent();
+      trigger->setEvent( btEvent );
+
+      BlendTreeStateTransition* transition = new BlendTreeStateTransition();
+      transition->setConnection( walkNode, runNode );
+      transition->setTransitionTrigger( trigger );
+      root.addTransition( transition );
+   }
+
+   // the character is far away, so it's sampled every 4th frame
+   Model scene;
+   Array< BlendTreePlayer* > players;
+   Array< SkeletonComponent* > skeletonComponents;
+   createCharacters( 1, skeleton, tree, scene, players, skeletonComponents );
+   placeCharacter( players[0], 100.0f );
+
+   AnimationWorld animWorld;
+   animWorld.accessLODManager().setEnabled( true );
+   animWorld.play( true );
+   scene.attachListener( &animWorld );
+
+   // the event is triggered half a second in - the sample that follows the one it was
+   // triggered in needs to see it, even though the frames in between weren't sampled
+   bool transitionFired = false;
+   for ( uint frameIdx = 0; frameIdx < 20 && !transitionFired; ++frameIdx )
+   {
+      animWorld.tickAnimations( 0.1f );
+      CPPUNIT_ASSERT_EQUAL( AUR_Every4thFrame, players[0]->getLODState().m_updateRate );
+
+      transitionFired = runNode->getState( players[0] ) != BlendTreeNode::Inactive;
+   }
+   CPPUNIT_ASSERT( transitionFired );
+
+   // cleanup
+   scene.detachListener( &animWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, poseCacheSharesIdenticalPoses )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   const uint bonesCount = 20;
+   Skeleton skeleton;
+   createSkeleton( bonesCount, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( bonesCount, 49, animation );
+
+   BlendTree tree;
+   tree.setSkeleton( &skeleton );
+   tree.getRoot().add( new BlendTreeAnimation( "Anim", &animation ) );
+
+   const uint charactersCount = 16;
+   Model referenceScene, serialScene, parallelScene;
+   Array< BlendTreePlayer* > referencePlayers, serialPlayers, parallelPlayers;
+   Array< SkeletonComponent* > referenceSkeletons, serialSkeletons, parallelSkeletons;
+   createCharacters( charactersCount, skeleton, tree, referenceScene, referencePlayers, referenceSkeletons );
+   createCharacters( charactersCount, skeleton, tree, serialScene, serialPlayers, serialSkeletons );
+   createCharacters( charactersCount, skeleton, tree, parallelScene, parallelPlayers, parallelSkeletons );
+
+   AnimationWorld referenceWorld;
+   referenceWorld.play( true );
+   referenceScene.attachListener( &referenceWorld );
+
+   AnimationWorld serialWorld;
+   serialWorld.accessPoseCache().setEnabled( true );
+   serialWorld.setParallelUpdates( false );
+   serialWorld.play( true );
+   serialScene.attachListener( &serialWorld );
+
+   AnimationWorld parallelWorld;
+   parallelWorld.accessPoseCache().setEnabled( true );
+   parallelWorld.setParallelUpdates( true );
+   parallelWorld.play( true );
+   parallelScene.attachListener( &parallelWorld );
+
+   const uint framesCount = 3;
+   for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+   {
+      referenceWorld.tickAnimations( 0.1f );
+      serialWorld.tickAnimations( 0.1f );
+      parallelWorld.tickAnimations( 0.1f );
+
+      // all players play the clip at the same phase - it's sampled only once
+      const AnimationPoseCache& serialCache = serialWorld.accessPoseCache();
+      CPPUNIT_ASSERT_EQUAL( (uint)1, serialCache.getMissesCount() );
+      CPPUNIT_ASSERT_EQUAL( charactersCount - 1, serialCache.getHitsCount() );
+
+      // the players sampled in parallel may request the pose before it's cached, so it may be sampled a few times
+      const AnimationPoseCache& parallelCache = parallelWorld.accessPoseCache();
+      CPPUNIT_ASSERT_EQUAL( charactersCount, parallelCache.getHitsCount() + parallelCache.getMissesCount() );
+      CPPUNIT_ASSERT( parallelCache.getMissesCount() >= 1 );
+
+      for ( uint i = 0; i < charactersCount; ++i )
+      {
+         for ( uint boneIdx = 0; boneIdx < bonesCount; ++boneIdx )
+         {
+            COMPARE_MTX( referenceSkeletons[i]->m_boneLocalMtx[boneIdx], serialSkeletons[i]->m_boneLocalMtx[boneIdx] );
+            COMPARE_MTX( referenceSkeletons[i]->m_boneLocalMtx[boneIdx], parallelSkeletons[i]->m_boneLocalMtx[boneIdx] );
+         }
+      }
+   }
+
+   // cleanup
+   referenceScene.detachListener( &referenceWorld );
+   serialScene.detachListener( &serialWorld );
+   parallelScene.detachListener( &parallelWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, poseCacheDistinguishesPhases )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   const uint bonesCount = 3;
+   Skeleton skeleton;
+   createSkeleton( bonesCount, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( bonesCount, 49, animation );
+
+   BlendTree tree;
+   tree.setSkeleton( &skeleton );
+   tree.getRoot().add( new BlendTreeAnimation( "Anim", &animation ) );
+
+   Model scene;
+   Array< BlendTreePlayer* > players;
+   Array< SkeletonComponent* > skeletonComponents;
+   createCharacters( 4, skeleton, tree, scene, players, skeletonComponents );
+
+   AnimationWorld animWorld;
+   animWorld.accessPoseCache().setEnabled( true );
+   animWorld.setParallelUpdates( false );
+   animWorld.play( true );
+   scene.attachListener( &animWorld );
+
+   const AnimationPoseCache& poseCache = animWorld.accessPoseCache();
+   animWorld.tickAnimations( 0.1f );
+   CPPUNIT_ASSERT_EQUAL( (uint)1, poseCache.getMissesCount() );
+   CPPUNIT_ASSERT_EQUAL( (uint)3, poseCache.getHitsCount() );
+   CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.75f, poseCache.getHitRate(), 1e-3f );
+
+   // the characters added now lag a frame behind the ones that are already playing
+   createCharacters( 4, skeleton, tree, scene, players, skeletonComponents );
+   animWorld.tickAnimations( 0.1f );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, poseCache.getMissesCount() );
+   CPPUNIT_ASSERT_EQUAL( (uint)6, poseCache.getHitsCount() );
+
+   COMPARE_MTX( skeletonComponents[0]->m_boneLocalMtx[1], skeletonComponents[3]->m_boneLocalMtx[1] );
+   COMPARE_MTX( skeletonComponents[4]->m_boneLocalMtx[1], skeletonComponents[7]->m_boneLocalMtx[1] );
+   CPPUNIT_ASSERT( skeletonComponents[0]->m_boneLocalMtx[1] != skeletonComponents[4]->m_boneLocalMtx[1] );
+
+   // the phases that fall into the same time quantum share the same pose
+   animWorld.accessPoseCache().setTimeQuantum( 0.25f );
+   animWorld.tickAnimations( 0.1f );
+   CPPUNIT_ASSERT_EQUAL( (uint)1, poseCache.getMissesCount() );
+   CPPUNIT_ASSERT_EQUAL( (uint)7, poseCache.getHitsCount() );
+
+   // once the cache runs out of entries, the poses are sampled straight from the clips
+   animWorld.accessPoseCache().setMaxEntriesCount( 0 );
+   animWorld.tickAnimations( 0.1f );
+   CPPUNIT_ASSERT_EQUAL( (uint)8, poseCache.getMissesCount() );
+   CPPUNIT_ASSERT_EQUAL( (uint)0, poseCache.getHitsCount() );
+
+   // cleanup
+   scene.detachListener( &animWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AnimationWorld, samplingScalesWithCores )
+{
+   // setup reflection types
+   BLENDTREETESTS_INIT_TYPES_REGISTRY();
+
+   const uint bonesCount = 60;
+   Skeleton skeleton;
+   createSkeleton( bonesCount, skeleton );
+
+   SnapshotAnimation animation;
+   createAnimation( bonesCount, 10 * 24 + 1, animation );
+
+   BlendTree tree;
+   tree.setSkeleton( &skeleton );
+   tree.getRoot().add( new BlendTreeAnimation( "Anim", &animation ) );
+
+   const uint charactersCount = 500;
+   Model scene;
+   Array< BlendTreePlayer* > players;
+   Array< SkeletonComponent* > skeletonComponents;
+   createCharacters( charactersCount, skeleton, tree, scene, players, skeletonComponents );
+
+   AnimationWorld animWorld;
+   animWorld.play( true );
+   scene.attachListener( &animWorld );
+
+   // the first frame starts the players up
+   animWorld.tickAnimations( 0.0f );
+
+   const uint framesCount = 30;
+   CTimer timer;
+
+   animWorld.setParallelUpdates( false );
+   timer.tick();
+   for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+   {
+      animWorld.tickAnimations( 1.0f / 30.0f );
+   }
+   timer.tick();
+   const float serialDuration = timer.getTimeElapsed();
+
+   animWorld.setParallelUpdates( true );
+   timer.tick();
+   for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+   {
+      animWorld.tickAnimations( 1.0f / 30.0f );
+   }
+   timer.tick();
+   const float parallelDuration = timer.getTimeElapsed();
+
+   MultithreadedTasksScheduler& scheduler = TSingleton< MultithreadedTasksScheduler >::getInstance();
+   LOG( "AnimationWorld: %d characters, %d frames - serial %.3f ms, parallel %.3f ms on %d workers ( %.2fx speedup )",
+      charactersCount, framesCount, serialDuration * 1000.0f, parallelDuration * 1000.0f, scheduler.getWorkersCount() + 1, serialDuration / parallelDuration );
+
+   // cleanup
+   scene.detachListener( &animWorld );
+}
+
+///////////////////////////////////////////////////////////////////////////////
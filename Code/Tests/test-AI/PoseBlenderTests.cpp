@@ -1,5 +1,26 @@
 #include "core-TestFramework\TestFramework.h"
 #include "core-AI\PoseBlendingUtils.h"
+#include "core-AI\PackedPose.h"
+#include "core\Timer.h"
+#include "core\Log.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   void createPose( uint bonesCount, float seed, Transform* outPose )
+   {
+      Vector axis;
+      for ( uint i = 0; i < bonesCount; ++i )
+      {
+         const float val = seed + (float)i;
+         axis.setNormalized( sinf( val ), cosf( val * 1.3f ), 0.5f + sinf( val * 0.7f ) );
+         outPose[i].m_rotation.setAxisAngle( axis, 3.0f * sinf( val * 2.1f ) );
+         outPose[i].m_translation.set( sinf( val ), 2.0f * cosf( val ), val );
+      }
+   }
+}
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -75,3 +96,188 @@ TEST( PoseBlendingUtils, synchronizingTwoAnimations )
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+TEST( PoseBlendingUtils, packingPoses )
+{
+   const uint bonesCount = 7;
+   Transform pose[bonesCount];
+   createPose( bonesCount, 0.0f, pose );
+
+   PackedPose packedPose;
+   packedPose.pack( pose, bonesCount );
+   CPPUNIT_ASSERT_EQUAL( bonesCount, packedPose.size() );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, packedPose.getQuadsCount() );
+
+   Transform unpackedPose[bonesCount];
+   packedPose.unpack( unpackedPose );
+   for ( uint i = 0; i < bonesCount; ++i )
+   {
+      CPPUNIT_ASSERT( pose[i] == unpackedPose[i] );
+   }
+
+   // the unused lane of the last quad contains an identity transform
+   Transform paddingTransform;
+   packedPose.getQuad( 1 ).getTransform( 3, paddingTransform );
+   CPPUNIT_ASSERT( Transform::IDENTITY == paddingTransform );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( PoseBlendingUtils, packedPosesBlendingAccuracy )
+{
+   // a number of bones that's not a multiple of 4, so that the last quad is only partially filled
+   const uint bonesCount = 13;
+   Transform sourcePose[bonesCount];
+   Transform targetPose[bonesCount];
+   createPose( bonesCount, 0.0f, sourcePose );
+   createPose( bonesCount, 0.3f, targetPose );
+
+   // one of the bones is almost the same in both poses, and that takes a different code path
+   targetPose[5].m_rotation.setAxisAngle( Vector_OX, 0.001f );
+   sourcePose[5].m_rotation.setAxisAngle( Vector_OX, 0.0015f );
+
+   PackedPose packedSourcePose, packedTargetPose, packedBlendedPose( bonesCount );
+   packedSourcePose.pack( sourcePose, bonesCount );
+   packedTargetPose.pack( targetPose, bonesCount );
+
+   const float weights[] = { 0.0f, 0.1f, 0.25f, 0.5f, 0.75f, 0.9f, 1.0f };
+   const uint weightsCount = sizeof( weights ) / sizeof( float );
+
+   Transform expectedTransform, blendedTransform;
+   Transform blendedPose[bonesCount];
+   for ( uint weightIdx = 0; weightIdx < weightsCount; ++weightIdx )
+   {
+      const FastFloat blendWeight = FastFloat::fromFloat( weights[weightIdx] );
+
+      // slerp
+      PoseBlendingUtils::blend( blendWeight, packedSourcePose, packedTargetPose, packedBlendedPose );
+      PoseBlendingUtils::blend( blendWeight, sourcePose, targetPose, bonesCount, blendedPose );
+      for ( uint i = 0; i < bonesCount; ++i )
+      {
+         expectedTransform.setSlerp( sourcePose[i], targetPose[i], blendWeight );
+
+         packedBlendedPose.get( i, blendedTransform );
+         COMPARE_QUAT( expectedTransform.m_rotation, blendedTransform.m_rotation );
+         COMPARE_VEC( expectedTransform.m_translation, blendedTransform.m_translation );
+
+         // the version that works with the unpacked poses returns the same results
+         COMPARE_QUAT( expectedTransform.m_rotation, blendedPose[i].m_rotation );
+         COMPARE_VEC( expectedTransform.m_translation, blendedPose[i].m_translation );
+      }
+
+      // nlerp
+      PoseBlendingUtils::nlerp( blendWeight, packedSourcePose, packedTargetPose, packedBlendedPose );
+      for ( uint i = 0; i < bonesCount; ++i )
+      {
+         expectedTransform.setNlerp( sourcePose[i], targetPose[i], blendWeight );
+
+         packedBlendedPose.get( i, blendedTransform );
+         COMPARE_QUAT( expectedTransform.m_rotation, blendedTransform.m_rotation );
+         COMPARE_VEC( expectedTransform.m_translation, blendedTransform.m_translation );
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( PoseBlendingUtils, addingAdditivePose )
+{
+   const uint bonesCount = 6;
+   Transform basePose[bonesCount];
+   Transform additivePose[bonesCount];
+   createPose( bonesCount, 0.0f, basePose );
+   createPose( bonesCount, 1.7f, additivePose );
+
+   PackedPose packedBasePose, packedAdditivePose, packedPose( bonesCount );
+   packedBasePose.pack( basePose, bonesCount );
+   packedAdditivePose.pack( additivePose, bonesCount );
+
+   Transform transform;
+
+   // zero weight leaves the base pose intact
+   PoseBlendingUtils::addAdditive( Float_0, packedBasePose, packedAdditivePose, packedPose );
+   for ( uint i = 0; i < bonesCount; ++i )
+   {
+      packedPose.get( i, transform );
+      COMPARE_QUAT( basePose[i].m_rotation, transform.m_rotation );
+      COMPARE_VEC( basePose[i].m_translation, transform.m_translation );
+   }
+
+   // the additive rotations are scaled along the shorter arc
+   const float weights[] = { 0.4f, 1.0f };
+   Quaternion additiveRotation, weightedRotation, expectedRotation;
+   Vector expectedTranslation;
+   for ( uint weightIdx = 0; weightIdx < 2; ++weightIdx )
+   {
+      const FastFloat blendWeight = FastFloat::fromFloat( weights[weightIdx] );
+      PoseBlendingUtils::addAdditive( blendWeight, packedBasePose, packedAdditivePose, packedPose );
+
+      for ( uint i = 0; i < bonesCount; ++i )
+      {
+         additiveRotation = additivePose[i].m_rotation;
+         if ( additiveRotation[3] < 0.0f )
+         {
+            additiveRotation.neg();
+         }
+         weightedRotation.setNlerp( Quaternion::IDENTITY, additiveRotation, blendWeight );
+         expectedRotation.setMul( weightedRotation, basePose[i].m_rotation );
+         expectedTranslation.setMulAdd( additivePose[i].m_translation, blendWeight, basePose[i].m_translation );
+
+         packedPose.get( i, transform );
+         COMPARE_QUAT( expectedRotation, transform.m_rotation );
+         COMPARE_VEC( expectedTranslation, transform.m_translation );
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( PoseBlendingUtils, packedPosesBlendingSpeed )
+{
+   const uint bonesCount = 60;
+   Transform sourcePose[bonesCount];
+   Transform targetPose[bonesCount];
+   Transform blendedPose[bonesCount];
+   createPose( bonesCount, 0.0f, sourcePose );
+   createPose( bonesCount, 0.3f, targetPose );
+
+   PackedPose packedSourcePose, packedTargetPose, packedBlendedPose( bonesCount );
+   packedSourcePose.pack( sourcePose, bonesCount );
+   packedTargetPose.pack( targetPose, bonesCount );
+
+   const uint blendsCount = 10000;
+   const FastFloat blendWeight = FastFloat::fromFloat( 0.3f );
+   CTimer timer;
+
+   timer.tick();
+   for ( uint blendIdx = 0; blendIdx < blendsCount; ++blendIdx )
+   {
+      for ( uint i = 0; i < bonesCount; ++i )
+      {
+         blendedPose[i].setSlerp( sourcePose[i], targetPose[i], blendWeight );
+      }
+   }
+   timer.tick();
+   const float perBoneDuration = timer.getTimeElapsed();
+
+   timer.tick();
+   for ( uint blendIdx = 0; blendIdx < blendsCount; ++blendIdx )
+   {
+      PoseBlendingUtils::blend( blendWeight, packedSourcePose, packedTargetPose, packedBlendedPose );
+   }
+   timer.tick();
+   const float packedDuration = timer.getTimeElapsed();
+
+   LOG( "PoseBlendingUtils: %d blends of %d bones - per bone %.3f ms, packed %.3f ms", blendsCount, bonesCount, perBoneDuration * 1000.0f, packedDuration * 1000.0f );
+
+   // both ways of blending arrive at the same pose
+   Transform blendedTransform;
+   for ( uint i = 0; i < bonesCount; ++i )
+   {
+      packedBlendedPose.get( i, blendedTransform );
+      COMPARE_QUAT( blendedPose[i].m_rotation, blendedTransform.m_rotation );
+      COMPARE_VEC( blendedPose[i].m_translation, blendedTransform.m_translation );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
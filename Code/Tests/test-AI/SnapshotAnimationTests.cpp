@@ -2,8 +2,89 @@
 #include "core-AI\BoneSRTAnimation.h"
 #include "core-AI\SnapshotAnimation.h"
 #include "core\Math.h"
+#include "core\Timer.h"
+#include "core\Log.h"
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   /**
+    * Creates a clip that resembles a character animation - some of the bones remain still,
+    * others rotate at different rates, and the root bone moves around.
+    */
+   void createAnimatedPoses( uint framesCount, uint bonesCount, Array< Transform >& outPoses )
+   {
+      outPoses.resize( framesCount * bonesCount );
+
+      Vector axis;
+      for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+      {
+         const float time = (float)frameIdx * SnapshotAnimation::ANIMATION_SAMPLING_FREQUENCY;
+         for ( uint boneIdx = 0; boneIdx < bonesCount; ++boneIdx )
+         {
+            Transform& transform = outPoses[frameIdx * bonesCount + boneIdx];
+
+            // the bones are offset from their parents by a constant translation
+            transform.m_translation.set( 0.0f, 0.1f + 0.01f * (float)boneIdx, 0.0f );
+
+            if ( boneIdx % 3 == 2 )
+            {
+               // every third bone doesn't move at all
+               continue;
+            }
+
+            axis.setNormalized( 1.0f, (float)( boneIdx % 4 ), (float)( boneIdx % 5 ) );
+            const float frequency = 0.5f + 0.1f * (float)( boneIdx % 7 );
+            transform.m_rotation.setAxisAngle( axis, 0.8f * sinf( time * frequency * 2.0f * (float)M_PI ) );
+         }
+
+         // the root bone sways from side to side and bobs up and down ( the forward motion goes to the motion track )
+         outPoses[frameIdx * bonesCount].m_translation.set( 0.1f * sinf( time * (float)M_PI ), 1.0f + 0.05f * sinf( time * 2.0f * (float)M_PI ), 0.0f );
+      }
+   }
+
+   // -------------------------------------------------------------------------
+
+   void measureCompressionError( const SnapshotAnimation& animation, uint framesCount, const Array< Transform >& poses, float& outMaxRotationError, float& outMaxTranslationError )
+   {
+      const uint bonesCount = animation.m_bonesCount;
+      Array< Transform > sampledPose;
+      sampledPose.resize( bonesCount );
+
+      outMaxRotationError = 0.0f;
+      outMaxTranslationError = 0.0f;
+      for ( uint frameIdx = 0; frameIdx < framesCount; ++frameIdx )
+      {
+         animation.samplePose( (float)frameIdx * animation.m_playbackFrequency, (Transform*)sampledPose, bonesCount );
+
+         for ( uint boneIdx = 0; boneIdx < bonesCount; ++boneIdx )
+         {
+            const Transform& expected = poses[frameIdx * bonesCount + boneIdx];
+            const Transform& sampled = sampledPose[boneIdx];
+
+            // q and -q describe the same rotation
+            float dot = 0.0f;
+            for ( uint i = 0; i < 4; ++i )
+            {
+               dot += expected.m_rotation[i] * sampled.m_rotation[i];
+            }
+            const float sign = dot < 0.0f ? -1.0f : 1.0f;
+
+            for ( uint i = 0; i < 4; ++i )
+            {
+               outMaxRotationError = max2( outMaxRotationError, (float)fabs( expected.m_rotation[i] - sampled.m_rotation[i] * sign ) );
+            }
+            for ( uint i = 0; i < 3; ++i )
+            {
+               outMaxTranslationError = max2( outMaxTranslationError, (float)fabs( expected.m_translation[i] - sampled.m_translation[i] ) );
+            }
+         }
+      }
+   }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 TEST( SnapshotAnimation, build )
@@ -29,8 +110,18 @@ TEST( SnapshotAnimation, build )
    {
       CPPUNIT_ASSERT_EQUAL( 1.0f, animation.m_duration );
       CPPUNIT_ASSERT_EQUAL( bonesCount, animation.m_bonesCount );
-      CPPUNIT_ASSERT_EQUAL( (uint)50, animation.m_poseTracks.size() ); // the animation is 1s long and we were sampling at 24 frames/sec, so we have 25 key frames per bone, which gives 50 frames for a skeleton that consists of 2 bones
-      CPPUNIT_ASSERT_EQUAL( (uint)25, animation.m_motionTrack.size() ); // and 25 keyframes in the motion track
+      CPPUNIT_ASSERT_EQUAL( (uint)25, animation.m_motionTrack.size() ); // the animation is 1s long and we were sampling at 24 frames/sec, so we have 25 keyframes in the motion track
+
+      // each bone has a rotation and a translation track
+      CPPUNIT_ASSERT_EQUAL( (uint)8, animation.m_trackDescriptors.size() );
+
+      // the bones don't rotate, so their rotation tracks don't need any keys
+      CPPUNIT_ASSERT_EQUAL( (uint)0, animation.m_trackDescriptors[1] );
+      CPPUNIT_ASSERT_EQUAL( (uint)0, animation.m_trackDescriptors[5] );
+
+      // the translations change linearly, so we only need the keys at the frames where the direction changes
+      CPPUNIT_ASSERT_EQUAL( (uint)3, animation.m_trackDescriptors[3] );
+      CPPUNIT_ASSERT_EQUAL( (uint)2, animation.m_trackDescriptors[7] );
    }
 
    // test the animation
@@ -108,3 +199,104 @@ TEST( SnapshotAnimation, build )
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+TEST( SnapshotAnimation, compressionErrorVsSize )
+{
+   // a 60 bones, 30 seconds long clip
+   const uint bonesCount = 60;
+   const uint framesCount = 30 * 24 + 1;
+   Array< Transform > poses;
+   createAnimatedPoses( framesCount, bonesCount, poses );
+
+   const uint uncompressedSize = framesCount * bonesCount * sizeof( Transform );
+   LOG( "SnapshotAnimation compression: uncompressed size %d bytes", uncompressedSize );
+
+   const float tolerances[] = { 0.0001f, 0.0005f, 0.002f, 0.01f };
+   const uint tolerancesCount = sizeof( tolerances ) / sizeof( float );
+
+   uint prevSize = uncompressedSize;
+   for ( uint i = 0; i < tolerancesCount; ++i )
+   {
+      SnapshotAnimation animation;
+      SnapshotAnimation::build( animation, 24.0f, framesCount, bonesCount, (Transform*)poses, NULL, AnimationCompressionSettings( tolerances[i], tolerances[i] ) );
+
+      float maxRotationError, maxTranslationError;
+      measureCompressionError( animation, framesCount, poses, maxRotationError, maxTranslationError );
+
+      const uint size = animation.getPoseTracksSize();
+      LOG( "SnapshotAnimation compression: tolerance %.4f - %d bytes ( %.1f%% ), max rotation error %.6f, max translation error %.6f",
+         tolerances[i], size, 100.0f * (float)size / (float)uncompressedSize, maxRotationError, maxTranslationError );
+
+      // the error stays within the tolerance ( give or take the quantization error )
+      CPPUNIT_ASSERT( maxRotationError <= tolerances[i] + 0.0002f );
+      CPPUNIT_ASSERT( maxTranslationError <= tolerances[i] + 0.0002f );
+
+      // and the larger the tolerance, the smaller the clip
+      CPPUNIT_ASSERT( size < prevSize );
+      prevSize = size;
+   }
+
+   // even with the tightest tolerance, the clip takes a fraction of its uncompressed size
+   SnapshotAnimation animation;
+   SnapshotAnimation::build( animation, 24.0f, framesCount, bonesCount, (Transform*)poses, NULL );
+   CPPUNIT_ASSERT( animation.getPoseTracksSize() * 4 < uncompressedSize );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( SnapshotAnimation, rebuildingCompressedClip )
+{
+   const uint bonesCount = 12;
+   const uint framesCount = 2 * 24 + 1;
+   Array< Transform > animatedPoses;
+   createAnimatedPoses( framesCount, bonesCount, animatedPoses );
+
+   Array< Transform > stillPoses;
+   stillPoses.resize( framesCount * bonesCount );
+   for ( uint i = 0; i < stillPoses.size(); ++i )
+   {
+      stillPoses[i] = Transform::IDENTITY;
+   }
+
+   // the tracks of the still clip don't have any keys - none of the tracks of the animated clip may survive
+   SnapshotAnimation animation;
+   SnapshotAnimation::build( animation, 24.0f, framesCount, bonesCount, (Transform*)animatedPoses, NULL );
+   SnapshotAnimation::build( animation, 24.0f, framesCount, bonesCount, (Transform*)stillPoses, NULL );
+
+   float maxRotationError, maxTranslationError;
+   measureCompressionError( animation, framesCount, stillPoses, maxRotationError, maxTranslationError );
+   CPPUNIT_ASSERT( maxRotationError <= 0.0002f );
+   CPPUNIT_ASSERT( maxTranslationError <= 0.0002f );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( SnapshotAnimation, decodingSpeed )
+{
+   const uint bonesCount = 60;
+   const uint framesCount = 30 * 24 + 1;
+   Array< Transform > poses;
+   createAnimatedPoses( framesCount, bonesCount, poses );
+
+   SnapshotAnimation animation;
+   SnapshotAnimation::build( animation, 24.0f, framesCount, bonesCount, (Transform*)poses, NULL );
+
+   Array< Transform > sampledPose;
+   sampledPose.resize( bonesCount );
+
+   // sample the clip at scattered points in time, so that we're not benefiting from the cache
+   const uint posesCount = 2000;
+   CTimer timer;
+   timer.tick();
+   for ( uint i = 0; i < posesCount; ++i )
+   {
+      const float trackTime = (float)( ( i * 7919 ) % 30000 ) * 0.001f;
+      animation.samplePose( trackTime, (Transform*)sampledPose, bonesCount );
+   }
+   timer.tick();
+
+   const float duration = timer.getTimeElapsed();
+   LOG( "SnapshotAnimation decoding: %d poses of %d bones sampled in %.3f ms", posesCount, bonesCount, duration * 1000.0f );
+}
+
+///////////////////////////////////////////////////////////////////////////////
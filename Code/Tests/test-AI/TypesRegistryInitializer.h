@@ -32,6 +32,7 @@
    typesRegistry.addSerializableType< BlendTreeStateMachine >( "BlendTreeStateMachine", new TSerializableTypeInstantiator< BlendTreeStateMachine >() ); \
    typesRegistry.addSerializableType< BlendTreeStateTransition >( "BlendTreeStateTransition", new TSerializableTypeInstantiator< BlendTreeStateTransition >() ); \
    typesRegistry.addSerializableType< BlendTreeTransitionTrigger >( "BlendTreeTransitionTrigger", NULL ); \
+   typesRegistry.addSerializableType< BTTTEvent >( "BTTTEvent", new TSerializableTypeInstantiator< BTTTEvent >() ); \
    typesRegistry.addSerializableType< BlendTreeTransitionEffect >( "BlendTreeTransitionEffect", NULL ); \
    typesRegistry.addSerializableType< BlendTreeSelector >( "BlendTreeSelector", new TSerializableTypeInstantiator< BlendTreeSelector >() ); \
    typesRegistry.addSerializableType< BlendTreeBlender1D >( "BlendTreeBlender1D", new TSerializableTypeInstantiator< BlendTreeBlender1D >() ); \
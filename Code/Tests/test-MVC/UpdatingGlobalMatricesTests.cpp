@@ -1,7 +1,14 @@
 #include "core-TestFramework\TestFramework.h"
 #include "core-TestFramework\MatrixWriter.h"
 #include "core-MVC\Entity.h"
+#include "core-MVC\Model.h"
+#include "core-MVC\SceneTransforms.h"
+#include "core-MVC\TransformsManagementSystem.h"
 #include "core\Vector.h"
+#include "core\Timer.h"
+#include "core\Log.h"
+#include "core\MathDefs.h"
+#include "core\Array.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -97,3 +104,322 @@ TEST( Entity, sequenceOfUpdatesInfluencingChild )
 };
 
 ///////////////////////////////////////////////////////////////////////////////
+
+TEST( Entity, incrementalUpdateVisitsDirtyBranchesOnly )
+{
+   // setup reflection types
+   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+   typesRegistry.clear();
+   typesRegistry.addSerializableType< Entity >( "Entity", new TSerializableTypeInstantiator< Entity >() );
+
+   Entity root;
+   Entity* staticChild = new Entity();
+   Entity* movingChild = new Entity();
+   Entity* movingGrandchild = new Entity();
+   root.addChild( staticChild );
+   root.addChild( movingChild );
+   movingChild->addChild( movingGrandchild );
+
+   // freshly created nodes are dirty
+   CPPUNIT_ASSERT( root.isTransformDirty() );
+   root.updateDirtyTransforms();
+   CPPUNIT_ASSERT( !root.isTransformDirty() );
+   CPPUNIT_ASSERT( !staticChild->isTransformDirty() );
+   CPPUNIT_ASSERT( !movingGrandchild->isTransformDirty() );
+
+   // modify the static child's matrix behind the entity's back - since it's not marked as dirty,
+   // the incremental update won't notice the change
+   Matrix staticChildMatrix; staticChildMatrix.setTranslation( Vector( 0, 7, 0 ) );
+   staticChild->m_localMtx = staticChildMatrix;
+
+   Matrix movingChildMatrix; movingChildMatrix.setTranslation( Vector( 5, 0, 0 ) );
+   movingChild->setLocalMtx( movingChildMatrix );
+   CPPUNIT_ASSERT( movingChild->isTransformDirty() );
+   CPPUNIT_ASSERT( !root.isTransformDirty() );
+
+   root.updateDirtyTransforms();
+   CPPUNIT_ASSERT_EQUAL( Matrix::IDENTITY, staticChild->getGlobalMtx() );
+   CPPUNIT_ASSERT_EQUAL( movingChildMatrix, movingChild->getGlobalMtx() );
+   CPPUNIT_ASSERT_EQUAL( movingChildMatrix, movingGrandchild->getGlobalMtx() );
+   CPPUNIT_ASSERT( !movingChild->isTransformDirty() );
+
+   // accessing the matrix directly marks the node dirty as well
+   staticChild->accessLocalMtx();
+   root.updateDirtyTransforms();
+   CPPUNIT_ASSERT_EQUAL( staticChildMatrix, staticChild->getGlobalMtx() );
+
+   // a full update still updates everything
+   Matrix rootMatrix; rootMatrix.setTranslation( Vector( 0, 0, 3 ) );
+   root.m_localMtx = rootMatrix;
+   root.updateTransforms();
+
+   Matrix expectedMovingChildGlobalMtx;
+   expectedMovingChildGlobalMtx.setMul( movingChildMatrix, rootMatrix );
+   CPPUNIT_ASSERT_EQUAL( expectedMovingChildGlobalMtx, movingGrandchild->getGlobalMtx() );
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( Entity, incrementalUpdateOfMostlyStaticScene )
+{
+   // setup reflection types
+   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+   typesRegistry.clear();
+   typesRegistry.addSerializableType< Entity >( "Entity", new TSerializableTypeInstantiator< Entity >() );
+
+   // a scene of 100k entities - 1000 groups of 100 entities each, only one of which is moving
+   const uint groupsCount = 1000;
+   const uint groupSize = 100;
+   Entity root;
+   Entity** movingEntities = new Entity*[groupsCount];
+   for ( uint i = 0; i < groupsCount; ++i )
+   {
+      Entity* group = new Entity();
+      root.addChild( group );
+
+      for ( uint j = 0; j < groupSize - 1; ++j )
+      {
+         Entity* entity = new Entity();
+         group->addChild( entity );
+
+         if ( j == 0 )
+         {
+            movingEntities[i] = entity;
+         }
+      }
+   }
+   root.updateTransforms();
+
+   const uint framesCount = 10;
+   Matrix mtx;
+   CTimer timer;
+
+   timer.tick();
+   for ( uint frame = 0; frame < framesCount; ++frame )
+   {
+      for ( uint i = 0; i < groupsCount; ++i )
+      {
+         mtx.setTranslation( Vector( (float)frame, 0, 0 ) );
+         movingEntities[i]->setLocalMtx( mtx );
+      }
+      root.updateTransforms();
+   }
+   timer.tick();
+   float fullUpdatesDuration = timer.getTimeElapsed();
+
+   timer.tick();
+   for ( uint frame = 0; frame < framesCount; ++frame )
+   {
+      for ( uint i = 0; i < groupsCount; ++i )
+      {
+         mtx.setTranslation( Vector( (float)frame, 1, 0 ) );
+         movingEntities[i]->setLocalMtx( mtx );
+      }
+      root.updateDirtyTransforms();
+   }
+   timer.tick();
+   float incrementalUpdatesDuration = timer.getTimeElapsed();
+
+   // the incremental updates reached all moving entities
+   for ( uint i = 0; i < groupsCount; ++i )
+   {
+      CPPUNIT_ASSERT_EQUAL( mtx, movingEntities[i]->getGlobalMtx() );
+   }
+
+   LOG( "Entity: %d frames of a scene of %d entities, 1%% of which are moving - full updates %.3f ms, incremental updates %.3f ms",
+      framesCount, groupsCount * groupSize, fullUpdatesDuration * 1000.0f, incrementalUpdatesDuration * 1000.0f );
+
+   // cleanup
+   delete [] movingEntities;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( SceneTransforms, updatingTransforms )
+{
+   // setup reflection types
+   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+   typesRegistry.clear();
+   typesRegistry.addSerializableType< Entity >( "Entity", new TSerializableTypeInstantiator< Entity >() );
+
+   Model model;
+   Entity* parent = new Entity();
+   Entity* child = new Entity();
+   parent->addChild( child );
+   model.addChild( parent );
+
+   SceneTransforms transforms;
+   model.attachListener( &transforms );
+
+   // entities get bound to the store during the first update
+   transforms.update();
+   CPPUNIT_ASSERT( parent->getTransformsStore() == &transforms );
+   CPPUNIT_ASSERT( child->getTransformsStore() == &transforms );
+
+   // parents precede their children in the store
+   CPPUNIT_ASSERT( parent->getTransformIdx() < child->getTransformIdx() );
+
+   Matrix parentMatrix; parentMatrix.setTranslation( Vector( 5, 0, 0 ) );
+   Matrix childMatrix; childMatrix.setTranslation( Vector( 0, 3, 0 ) );
+   parent->setLocalMtx( parentMatrix );
+   child->setLocalMtx( childMatrix );
+   transforms.update();
+
+   Matrix expectedChildGlobalMtx;
+   expectedChildGlobalMtx.setMul( childMatrix, parentMatrix );
+   CPPUNIT_ASSERT_EQUAL( parentMatrix, parent->getGlobalMtx() );
+   CPPUNIT_ASSERT_EQUAL( expectedChildGlobalMtx, child->getGlobalMtx() );
+   CPPUNIT_ASSERT_EQUAL( childMatrix, child->getLocalMtx() );
+
+   // when the structure of the scene changes, the entities get unbound ( retaining their transforms )
+   child->addReference();
+   parent->removeChild( child );
+   CPPUNIT_ASSERT( child->getTransformsStore() == NULL );
+   CPPUNIT_ASSERT( parent->getTransformsStore() == NULL );
+   CPPUNIT_ASSERT_EQUAL( childMatrix, child->getLocalMtx() );
+   CPPUNIT_ASSERT_EQUAL( parentMatrix, parent->getGlobalMtx() );
+
+   // ...and the store is rebuilt during the next update
+   transforms.update();
+   CPPUNIT_ASSERT( parent->getTransformsStore() == &transforms );
+   CPPUNIT_ASSERT( child->getTransformsStore() == NULL );
+
+   // cleanup
+   child->removeReference();
+   model.detachListener( &transforms );
+   CPPUNIT_ASSERT( parent->getTransformsStore() == NULL );
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( SceneTransforms, announcingLocalMatrixChanges )
+{
+   // setup reflection types
+   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+   typesRegistry.clear();
+   typesRegistry.addSerializableType< Entity >( "Entity", new TSerializableTypeInstantiator< Entity >() );
+
+   Model model;
+   Entity* entity = new Entity();
+   model.addChild( entity );
+
+   SceneTransforms transforms;
+   model.attachListener( &transforms );
+   transforms.update();
+   CPPUNIT_ASSERT( entity->getTransformsStore() == &transforms );
+
+   // the way the editor moves the entities around - the change is announced after the matrix was set
+   Matrix movedMtx; movedMtx.setTranslation( Vector( 5, 0, 0 ) );
+   entity->setLocalMtx( movedMtx );
+
+   ReflectionProperty* property = entity->getProperty( "m_localMtx" );
+   entity->notifyPropertyChange( *property );
+   transforms.update();
+
+   CPPUNIT_ASSERT_EQUAL( movedMtx, entity->getLocalMtx() );
+   CPPUNIT_ASSERT_EQUAL( movedMtx, entity->getGlobalMtx() );
+
+   // the matrix modified directly in the store survives the property being edited
+   Matrix accessedMtx; accessedMtx.setTranslation( Vector( 0, 3, 0 ) );
+   entity->accessLocalMtx() = accessedMtx;
+
+   entity->notifyPrePropertyChange( *property );
+   entity->notifyPropertyChange( *property );
+   transforms.update();
+
+   CPPUNIT_ASSERT_EQUAL( accessedMtx, entity->getLocalMtx() );
+   CPPUNIT_ASSERT_EQUAL( accessedMtx, entity->getGlobalMtx() );
+
+   // cleanup
+   delete property;
+   model.detachListener( &transforms );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   void buildTestScene( Model& scene, Array< Entity* >& outEntities )
+   {
+      // many independent subtrees of varied depths, with a rotation on every level
+      // so that the order of the multiplications matters
+      const uint subtreesCount = 50;
+      for ( uint i = 0; i < subtreesCount; ++i )
+      {
+         Entity* parent = NULL;
+         const uint depth = 1 + i % 5;
+         for ( uint j = 0; j < depth; ++j )
+         {
+            Entity* entity = new Entity();
+
+            Matrix mtx;
+            mtx.setAxisAnglePos( Vector_OY, FastFloat::fromFloat( DEG2RAD( 10.0f * ( i + j ) ) ), Vector( (float)j, (float)i, 1.0f ) );
+            entity->setLocalMtx( mtx );
+
+            if ( parent )
+            {
+               parent->addChild( entity );
+            }
+            else
+            {
+               scene.addChild( entity );
+            }
+            parent = entity;
+            outEntities.push_back( entity );
+         }
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( TransformsManagementSystem, parallelUpdateMatchesSerialUpdate )
+{
+   // setup reflection types
+   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+   typesRegistry.clear();
+   typesRegistry.addSerializableType< Entity >( "Entity", new TSerializableTypeInstantiator< Entity >() );
+
+   Model serialScene;
+   Model parallelScene;
+   Array< Entity* > serialEntities;
+   Array< Entity* > parallelEntities;
+   buildTestScene( serialScene, serialEntities );
+   buildTestScene( parallelScene, parallelEntities );
+
+   Matrix rootMtx; rootMtx.setTranslation( Vector( 0, 0, 3 ) );
+   serialScene.getRoot()->setLocalMtx( rootMtx );
+   parallelScene.getRoot()->setLocalMtx( rootMtx );
+
+   TransformsManagementSystem& system = TSingleton< TransformsManagementSystem >::getInstance();
+   const uint entitiesCount = serialEntities.size();
+   const uint framesCount = 3;
+   for ( uint frame = 0; frame < framesCount; ++frame )
+   {
+      system.setParallelUpdates( false );
+      system.addScene( &serialScene );
+      system.tick();
+      system.removeScene( &serialScene );
+
+      system.setParallelUpdates( true );
+      system.addScene( &parallelScene );
+      system.tick();
+      system.removeScene( &parallelScene );
+
+      for ( uint i = 0; i < entitiesCount; ++i )
+      {
+         CPPUNIT_ASSERT_EQUAL( serialEntities[i]->getGlobalMtx(), parallelEntities[i]->getGlobalMtx() );
+      }
+
+      // move every third entity in both scenes before the next, incremental update
+      Matrix mtx;
+      for ( uint i = 0; i < entitiesCount; i += 3 )
+      {
+         mtx.setAxisAnglePos( Vector_OX, FastFloat::fromFloat( DEG2RAD( 5.0f * ( frame + i ) ) ), Vector( (float)frame, 0, 0 ) );
+         serialEntities[i]->setLocalMtx( mtx );
+         parallelEntities[i]->setLocalMtx( mtx );
+      }
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,53 @@
+#include "core-TestFramework\TestFramework.h"
+#include "core-Renderer\Renderer.h"
+#include "core-Renderer\RendererImplementation.h"
+#include "core-Renderer\RenderCommandsBuffer.h"
+#include "core-Renderer\RenderingContext.h"
+#include "core-Renderer\RenderStateFlags.h"
+#include "core-Renderer\RenderStateChangeTracker.h"
+#include "core-Renderer\RenderStateCommand.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   class RendererImplementationMock : public RendererImplementation
+   {
+      DECLARE_ALLOCATOR( RendererImplementationMock, AM_DEFAULT );
+   };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( RenderCommandsRecording, recordingThreadWorksOnItsOwnState )
+{
+   RendererImplementationMock* rendererImpl = new RendererImplementationMock();
+   Renderer renderer( rendererImpl );
+   renderer.accessContext().m_int = 1;
+
+   // the buffer starts with the state the renderer was in when the buffer was reserved
+   RenderCommandsBuffer* buffer = renderer.reserveCommandsBuffer();
+   renderer.beginRecording( buffer );
+   CPPUNIT_ASSERT( renderer.isRecording() );
+   CPPUNIT_ASSERT_EQUAL( 1, renderer.getContext().m_int );
+   CPPUNIT_ASSERT( !renderer.accessRenderStateFlags().m_useBlending );
+
+   // the changes made while recording don't affect the state of the renderer
+   renderer.accessContext().m_int = 2;
+   {
+      SAVE_RENDER_STATE( renderer );
+      CHANGE_RENDER_STATE( renderer, RSSetBlending( true, BLEND_ONE, BLEND_ONE ) );
+      CPPUNIT_ASSERT( renderer.accessRenderStateFlags().m_useBlending );
+      CPPUNIT_ASSERT( buffer->getCommandsCount() > 0 );
+      RESTORE_RENDER_STATE( renderer );
+   }
+   CPPUNIT_ASSERT( !renderer.accessRenderStateFlags().m_useBlending );
+
+   renderer.endRecording();
+   CPPUNIT_ASSERT( !renderer.isRecording() );
+   CPPUNIT_ASSERT_EQUAL( 1, renderer.getContext().m_int );
+   CPPUNIT_ASSERT( !renderer.accessRenderStateFlags().m_useBlending );
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -5,9 +5,11 @@
 #include "core-Renderer\RenderState.h"
 #include "core-Renderer\Material.h"
 #include "core-Renderer\RenderTree.h"
+#include "core-Renderer\Defines.h"
 #include "core-MVC\Entity.h"
 #include "core\ReflectionObject.h"
 #include <string>
+#include <stdlib.h>
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -27,30 +29,49 @@ namespace // anonymous
 
    private:
       std::string    m_id;
+      bool           m_instanced;
 
    public:
-      GeometryMock( const std::string& id ) 
+      GeometryMock( const std::string& id, bool instanced = false )
          : m_id( std::string( "RenderGeometry_" ) + id + ";" )
+         , m_instanced( instanced )
       {}
 
       void render( Renderer& renderer, VertexShaderConfigurator* externalConfigurator )
       {
       }
+
+      bool canBeInstanced( RenderProfileId profile ) const
+      {
+         return m_instanced;
+      }
+
+      void place( float distFromCamera )
+      {
+         m_worldSpaceBounds.min.set( -1.0f, -1.0f, distFromCamera - 1.0f );
+         m_worldSpaceBounds.max.set( 1.0f, 1.0f, distFromCamera + 1.0f );
+      }
    };
+
+   // -------------------------------------------------------------------------
+
+   void registerTypes()
+   {
+      ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+      typesRegistry.clear();
+      typesRegistry.addSerializableType< ReflectionObject >( "ReflectionObject", NULL );
+      typesRegistry.addSerializableType< Entity >( "Entity", NULL );
+      typesRegistry.addSerializableType< GeometryComponent >( "GeometryComponent", NULL );
+      typesRegistry.addSerializableType< Material >( "Material", NULL );
+      typesRegistry.addSerializableType< RenderState >( "RenderState", NULL );
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 TEST( RenderTree, basics )
 {
-   // setup reflection types
-   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
-   typesRegistry.clear();
-   typesRegistry.addSerializableType< ReflectionObject >( "ReflectionObject", NULL );
-   typesRegistry.addSerializableType< Entity >( "Entity", NULL );
-   typesRegistry.addSerializableType< GeometryComponent >( "GeometryComponent", NULL );
-   typesRegistry.addSerializableType< Material >( "Material", NULL );
-   typesRegistry.addSerializableType< RenderState >( "RenderState", NULL );
+   registerTypes();
 
    Material mat1;
    Material mat2;
@@ -64,41 +85,21 @@ TEST( RenderTree, basics )
    Array< GeometryComponent* > geometry( 2 );
    geometry.push_back( g1 );
    geometry.push_back( g2 );
-   
+
    // setup the renderer
    RendererImplementationMock* rendererImpl = new RendererImplementationMock();
    Renderer renderer( rendererImpl );
 
-   RenderTree* renderTree = renderer.buildRenderTree( geometry );
+   RenderTree* renderTree = renderer.buildRenderTree( geometry, RP_Default );
    {
+      CPPUNIT_ASSERT_EQUAL( (uint)2, renderTree->m_entries.size() );
+      CPPUNIT_ASSERT( renderTree->m_entries[0].m_geometry == g1 );
+      CPPUNIT_ASSERT( renderTree->m_entries[1].m_geometry == g2 );
 
-      StateTreeNode* analyzedNode = renderTree->m_root;
-      CPPUNIT_ASSERT( analyzedNode != NULL );
-      {
-         CPPUNIT_ASSERT( analyzedNode->m_state->m_material == &mat1 );
-         CPPUNIT_ASSERT( analyzedNode->m_geometryNode != NULL );
-         {
-            CPPUNIT_ASSERT( analyzedNode->m_geometryNode->m_next == NULL );
-            CPPUNIT_ASSERT( &analyzedNode->m_geometryNode->m_geometry == g1 );
-         }
-
-         CPPUNIT_ASSERT( analyzedNode->m_sibling != NULL );
-         analyzedNode = analyzedNode->m_sibling;
-      }
-
-      // child state 2 that renders geometry2 using state2
-      {
-         CPPUNIT_ASSERT( analyzedNode->m_state->m_material == &mat2 );
-         CPPUNIT_ASSERT( analyzedNode->m_geometryNode != NULL );
-         {
-            CPPUNIT_ASSERT( analyzedNode->m_geometryNode->m_next == NULL );
-            CPPUNIT_ASSERT( &analyzedNode->m_geometryNode->m_geometry == g2 );
-         }
-
-         CPPUNIT_ASSERT( analyzedNode->m_sibling == NULL );
-      }
+      // each geometry uses a different state
+      CPPUNIT_ASSERT_EQUAL( (uint)2, renderTree->getStateChangesCount() );
    }
-   
+
    // cleanup
    delete renderTree;
    delete g1;
@@ -109,13 +110,7 @@ TEST( RenderTree, basics )
 
 TEST( RenderTree, statesBatching )
 {
-   // setup reflection types
-   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
-   typesRegistry.clear();
-   typesRegistry.addSerializableType< Entity >( "Entity", NULL );
-   typesRegistry.addSerializableType< GeometryComponent >( "GeometryComponent", NULL );
-   typesRegistry.addSerializableType< Material >( "Material", NULL );
-   typesRegistry.addSerializableType< RenderState >( "RenderState", NULL );
+   registerTypes();
 
    Material mat1;
    Material mat2;
@@ -126,7 +121,7 @@ TEST( RenderTree, statesBatching )
 
    g1->setMaterial( &mat1 );      // it uses state 1
    g2->setMaterial( &mat2 );      // uses a different state - state 2
-   g3->setMaterial( &mat1 ); // it also uses state 1
+   g3->setMaterial( &mat1 );      // it also uses state 1
 
    Array< GeometryComponent* > geometry( 3 );
    geometry.push_back( g1 );
@@ -137,45 +132,17 @@ TEST( RenderTree, statesBatching )
    RendererImplementationMock* rendererImpl = new RendererImplementationMock();
    Renderer renderer( rendererImpl );
 
-   RenderTree* renderTree = renderer.buildRenderTree( geometry );
+   RenderTree* renderTree = renderer.buildRenderTree( geometry, RP_Default );
    {
-      // child state 1 that renders using state1
-      StateTreeNode* analyzedNode = renderTree->m_root;
-      CPPUNIT_ASSERT( analyzedNode != NULL );
-      {
-         CPPUNIT_ASSERT( analyzedNode->m_state->m_material == &mat1 );
-         CPPUNIT_ASSERT( analyzedNode->m_geometryNode != NULL );
-
-         // two geometry nodes are rendered using this state - g1...
-         GeometryNode* analyzedGeometryNode = analyzedNode->m_geometryNode;
-         {
-            CPPUNIT_ASSERT( &analyzedGeometryNode->m_geometry == g3 );
-
-            CPPUNIT_ASSERT( analyzedGeometryNode->m_next != NULL );
-            analyzedGeometryNode = analyzedGeometryNode->m_next;
-         }
-         // .. and g1
-         {
-            CPPUNIT_ASSERT( &analyzedGeometryNode->m_geometry == g1 );
-
-            CPPUNIT_ASSERT( analyzedGeometryNode->m_next == NULL );
-         }
-
-         CPPUNIT_ASSERT( analyzedNode->m_sibling != NULL );
-         analyzedNode = analyzedNode->m_sibling;
-      }
+      // g1 and g3 are rendered using state 1...
+      CPPUNIT_ASSERT_EQUAL( (uint)3, renderTree->m_entries.size() );
+      CPPUNIT_ASSERT( renderTree->m_entries[0].m_geometry == g1 );
+      CPPUNIT_ASSERT( renderTree->m_entries[1].m_geometry == g3 );
 
-      // child state 2 that renders geometry2 using state2
-      {
-         CPPUNIT_ASSERT( analyzedNode->m_state->m_material == &mat2 );
-         CPPUNIT_ASSERT( analyzedNode->m_geometryNode != NULL );
-         {
-            CPPUNIT_ASSERT( analyzedNode->m_geometryNode->m_next == NULL );
-            CPPUNIT_ASSERT( &analyzedNode->m_geometryNode->m_geometry == g2 );
-         }
-
-         CPPUNIT_ASSERT( analyzedNode->m_sibling == NULL );
-      }
+      // ...and g2 using state 2
+      CPPUNIT_ASSERT( renderTree->m_entries[2].m_geometry == g2 );
+
+      CPPUNIT_ASSERT_EQUAL( (uint)2, renderTree->getStateChangesCount() );
    }
 
    // cleanup
@@ -189,13 +156,7 @@ TEST( RenderTree, statesBatching )
 
 TEST( RenderTree, manySingleStatesBatching )
 {
-   // setup reflection types
-   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
-   typesRegistry.clear();
-   typesRegistry.addSerializableType< Entity >( "Entity", NULL );
-   typesRegistry.addSerializableType< GeometryComponent >( "GeometryComponent", NULL );
-   typesRegistry.addSerializableType< Material >( "Material", NULL );
-   typesRegistry.addSerializableType< RenderState >( "RenderState", NULL );
+   registerTypes();
 
    Material mat1;
    Material mat2;
@@ -219,65 +180,224 @@ TEST( RenderTree, manySingleStatesBatching )
 
    // setup the renderer
    RendererImplementationMock* rendererImpl = new RendererImplementationMock();
-   Renderer renderer( rendererImpl );   
+   Renderer renderer( rendererImpl );
 
-   RenderTree* renderTree = renderer.buildRenderTree( geometry );
+   RenderTree* renderTree = renderer.buildRenderTree( geometry, RP_Default );
    {
-      // child state 1 that renders using state1
-      StateTreeNode* analyzedNode = renderTree->m_root;
-      CPPUNIT_ASSERT( analyzedNode != NULL );
-      {
-         CPPUNIT_ASSERT( analyzedNode->m_state->m_material == &mat1 );
-         CPPUNIT_ASSERT( analyzedNode->m_geometryNode != NULL );
+      CPPUNIT_ASSERT_EQUAL( (uint)4, renderTree->m_entries.size() );
+      CPPUNIT_ASSERT( renderTree->m_entries[0].m_geometry == g1 );
+      CPPUNIT_ASSERT( renderTree->m_entries[1].m_geometry == g2 );
 
-         // g1 is the rendered geometry node
-         {
-            CPPUNIT_ASSERT( &analyzedNode->m_geometryNode->m_geometry == g1 );
-            CPPUNIT_ASSERT( analyzedNode->m_geometryNode->m_next == NULL );
-         }
+      // state 3 renders 2 geometry pieces
+      CPPUNIT_ASSERT( renderTree->m_entries[2].m_geometry == g3 );
+      CPPUNIT_ASSERT( renderTree->m_entries[3].m_geometry == g4 );
+      CPPUNIT_ASSERT( RenderTree::getStatePrefix( renderTree->m_entries[2].m_key ) == RenderTree::getStatePrefix( renderTree->m_entries[3].m_key ) );
 
-         CPPUNIT_ASSERT( analyzedNode->m_sibling != NULL );
-         analyzedNode = analyzedNode->m_sibling;
-      }
+      CPPUNIT_ASSERT_EQUAL( (uint)3, renderTree->getStateChangesCount() );
+   }
 
-      // child state 2 that renders using state2
-      CPPUNIT_ASSERT( analyzedNode != NULL );
-      {
-         CPPUNIT_ASSERT( analyzedNode->m_state->m_material == &mat2 );
-         CPPUNIT_ASSERT( analyzedNode->m_geometryNode != NULL );
+   // cleanup
+   delete renderTree;
+   delete g1;
+   delete g2;
+   delete g3;
+   delete g4;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( RenderTree, geometryWithSameStateSortedFrontToBack )
+{
+   registerTypes();
+
+   Material mat1;
+
+   GeometryMock* g1 = new GeometryMock( "1" );
+   GeometryMock* g2 = new GeometryMock( "2" );
+   GeometryMock* g3 = new GeometryMock( "3" );
+
+   g1->setMaterial( &mat1 );
+   g2->setMaterial( &mat1 );
+   g3->setMaterial( &mat1 );
+
+   // the default camera is located at the origin, looking down the Z axis
+   g1->place( 30.0f );
+   g2->place( 10.0f );
+   g3->place( 20.0f );
+
+   Array< GeometryComponent* > geometry( 3 );
+   geometry.push_back( g1 );
+   geometry.push_back( g2 );
+   geometry.push_back( g3 );
 
-         // g2 is the rendered geometry node
-         {
-            CPPUNIT_ASSERT( &analyzedNode->m_geometryNode->m_geometry == g2 );
-            CPPUNIT_ASSERT( analyzedNode->m_geometryNode->m_next == NULL );
-         }
+   // setup the renderer
+   RendererImplementationMock* rendererImpl = new RendererImplementationMock();
+   Renderer renderer( rendererImpl );
+
+   RenderTree* renderTree = renderer.buildRenderTree( geometry, RP_Default );
+   {
+      CPPUNIT_ASSERT_EQUAL( (uint)3, renderTree->m_entries.size() );
+      CPPUNIT_ASSERT( renderTree->m_entries[0].m_geometry == g2 );
+      CPPUNIT_ASSERT( renderTree->m_entries[1].m_geometry == g3 );
+      CPPUNIT_ASSERT( renderTree->m_entries[2].m_geometry == g1 );
+
+      CPPUNIT_ASSERT_EQUAL( (uint)1, renderTree->getStateChangesCount() );
+   }
 
-         CPPUNIT_ASSERT( analyzedNode->m_sibling != NULL );
-         analyzedNode = analyzedNode->m_sibling;
+   // cleanup
+   delete renderTree;
+   delete g1;
+   delete g2;
+   delete g3;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( RenderTree, statesChangeOnlyWhenPrefixChanges )
+{
+   registerTypes();
+
+   const uint materialsCount = 4;
+   const uint geometryCount = 200;
+   Material materials[materialsCount];
+
+   srand( 1024 );
+   Array< GeometryComponent* > geometry( geometryCount );
+   for ( uint i = 0; i < geometryCount; ++i )
+   {
+      GeometryMock* g = new GeometryMock( "" );
+      g->setMaterial( &materials[rand() % materialsCount] );
+      g->place( (float)( rand() % 1000 ) );
+      geometry.push_back( g );
+   }
+
+   // setup the renderer
+   RendererImplementationMock* rendererImpl = new RendererImplementationMock();
+   Renderer renderer( rendererImpl );
+
+   RenderTree* renderTree = renderer.buildRenderTree( geometry, RP_Default );
+   {
+      CPPUNIT_ASSERT_EQUAL( geometryCount, renderTree->m_entries.size() );
+
+      // the keys are sorted, and each material is bound exactly once
+      for ( uint i = 1; i < geometryCount; ++i )
+      {
+         CPPUNIT_ASSERT( renderTree->m_entries[i - 1].m_key <= renderTree->m_entries[i].m_key );
       }
+      CPPUNIT_ASSERT_EQUAL( materialsCount, renderTree->getStateChangesCount() );
 
-      // child state 3 that renders using state3, and it renders 2 geometry pieces
-      CPPUNIT_ASSERT( analyzedNode != NULL );
+      // the state prefix changes together with the material
+      for ( uint i = 1; i < geometryCount; ++i )
       {
-         CPPUNIT_ASSERT( analyzedNode->m_state->m_material == &mat3 );
-         CPPUNIT_ASSERT( analyzedNode->m_geometryNode != NULL );
+         const RenderQueueEntry& prevEntry = renderTree->m_entries[i - 1];
+         const RenderQueueEntry& entry = renderTree->m_entries[i];
+         CPPUNIT_ASSERT( geometry.find( entry.m_geometry ) != EOA );
+
+         const bool sameState = RenderTree::getStatePrefix( prevEntry.m_key ) == RenderTree::getStatePrefix( entry.m_key );
+         const bool sameMaterial = prevEntry.m_geometry->getRenderState()->m_material == entry.m_geometry->getRenderState()->m_material;
+         CPPUNIT_ASSERT( sameState == sameMaterial );
+      }
+   }
 
-         //the geometry pieces rendered are g4 ...
-         GeometryNode* analyzedGeometryNode = analyzedNode->m_geometryNode;
-         {
-            CPPUNIT_ASSERT( &analyzedGeometryNode->m_geometry == g4 );
-            CPPUNIT_ASSERT( analyzedGeometryNode->m_next != NULL );
+   // cleanup
+   delete renderTree;
+   for ( uint i = 0; i < geometryCount; ++i )
+   {
+      delete geometry[i];
+   }
+}
 
-            analyzedGeometryNode = analyzedGeometryNode->m_next;
-         }
+///////////////////////////////////////////////////////////////////////////////
 
-         // ...and g3
-         {
-            CPPUNIT_ASSERT( &analyzedGeometryNode->m_geometry == g3 );
-            CPPUNIT_ASSERT( analyzedGeometryNode->m_next == NULL );
-         }
+TEST( RenderTree, instancesOfTheSameMeshAndMaterialRenderedTogether )
+{
+   registerTypes();
 
-         CPPUNIT_ASSERT( analyzedNode->m_sibling == NULL );
+   Material mat1;
+   Material mat2;
+
+   // 150 instances will require 3 instanced draw calls, and the remaining geometry uses a different material
+   const uint instancesCount = 150;
+   Array< GeometryComponent* > geometry( instancesCount + 1 );
+   for ( uint i = 0; i < instancesCount; ++i )
+   {
+      GeometryMock* g = new GeometryMock( "", true );
+      g->setMaterial( &mat1 );
+      geometry.push_back( g );
+   }
+
+   GeometryMock* otherGeometry = new GeometryMock( "", true );
+   otherGeometry->setMaterial( &mat2 );
+   geometry.push_back( otherGeometry );
+
+   // setup the renderer
+   RendererImplementationMock* rendererImpl = new RendererImplementationMock();
+   Renderer renderer( rendererImpl );
+
+   RenderTree* renderTree = renderer.buildRenderTree( geometry, RP_Default );
+   {
+      CPPUNIT_ASSERT_EQUAL( (uint)4, renderTree->getDrawCallsCount() );
+      CPPUNIT_ASSERT_EQUAL( (uint)2, renderTree->getStateChangesCount() );
+
+      CPPUNIT_ASSERT_EQUAL( (uint)0, renderTree->m_drawCalls[0].m_firstInstance );
+      CPPUNIT_ASSERT_EQUAL( (uint)MAX_INSTANCES_PER_DRAW_CALL, renderTree->m_drawCalls[0].m_instancesCount );
+      CPPUNIT_ASSERT_EQUAL( (uint)MAX_INSTANCES_PER_DRAW_CALL, renderTree->m_drawCalls[1].m_firstInstance );
+      CPPUNIT_ASSERT_EQUAL( (uint)MAX_INSTANCES_PER_DRAW_CALL, renderTree->m_drawCalls[1].m_instancesCount );
+      CPPUNIT_ASSERT_EQUAL( (uint)( instancesCount - 2 * MAX_INSTANCES_PER_DRAW_CALL ), renderTree->m_drawCalls[2].m_instancesCount );
+
+      // the geometry that uses a different material is rendered separately
+      CPPUNIT_ASSERT_EQUAL( instancesCount, renderTree->m_drawCalls[3].m_firstInstance );
+      CPPUNIT_ASSERT_EQUAL( (uint)1, renderTree->m_drawCalls[3].m_instancesCount );
+      CPPUNIT_ASSERT( renderTree->m_renderedGeometry[instancesCount] == otherGeometry );
+   }
+
+   // cleanup
+   delete renderTree;
+   for ( uint i = 0; i < geometry.size(); ++i )
+   {
+      delete geometry[i];
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( RenderTree, geometryThatCantBeInstancedRenderedSeparately )
+{
+   registerTypes();
+
+   Material mat1;
+
+   // g2 can't be instanced ( it could be a skinned mesh for instance ), so it breaks the run of instances
+   GeometryMock* g1 = new GeometryMock( "1", true );
+   GeometryMock* g2 = new GeometryMock( "2", false );
+   GeometryMock* g3 = new GeometryMock( "3", true );
+
+   g1->setMaterial( &mat1 );
+   g2->setMaterial( &mat1 );
+   g3->setMaterial( &mat1 );
+
+   g1->place( 10.0f );
+   g2->place( 20.0f );
+   g3->place( 30.0f );
+
+   Array< GeometryComponent* > geometry( 3 );
+   geometry.push_back( g1 );
+   geometry.push_back( g2 );
+   geometry.push_back( g3 );
+
+   // setup the renderer
+   RendererImplementationMock* rendererImpl = new RendererImplementationMock();
+   Renderer renderer( rendererImpl );
+
+   RenderTree* renderTree = renderer.buildRenderTree( geometry, RP_Default );
+   {
+      CPPUNIT_ASSERT_EQUAL( (uint)3, renderTree->getDrawCallsCount() );
+      CPPUNIT_ASSERT_EQUAL( (uint)1, renderTree->getStateChangesCount() );
+
+      for ( uint i = 0; i < 3; ++i )
+      {
+         CPPUNIT_ASSERT_EQUAL( i, renderTree->m_drawCalls[i].m_firstInstance );
+         CPPUNIT_ASSERT_EQUAL( (uint)1, renderTree->m_drawCalls[i].m_instancesCount );
       }
    }
 
@@ -286,7 +406,6 @@ TEST( RenderTree, manySingleStatesBatching )
    delete g1;
    delete g2;
    delete g3;
-   delete g4;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
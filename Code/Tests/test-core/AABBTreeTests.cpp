@@ -0,0 +1,200 @@
+#include "core-TestFramework\TestFramework.h"
+#include "core\AABBTree.h"
+#include "core\Array.h"
+#include "core\Frustum.h"
+#include "core\FastFloat.h"
+#include <algorithm>
+#include <stdlib.h>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   struct BoxElemMock
+   {
+      AxisAlignedBox    m_bounds;
+
+      const AxisAlignedBox& getBoundingVolume() const { return m_bounds; }
+
+      void place( const Vector& pos, float size )
+      {
+         m_bounds.min = pos;
+         m_bounds.max.set( pos[0] + size, pos[1] + size, pos[2] + size );
+      }
+   };
+
+   // ----------------------------------------------------------------------------
+
+   struct FrustumArea
+   {
+      const Frustum&    m_frustum;
+
+      FrustumArea( const Frustum& frustum ) : m_frustum( frustum ) {}
+
+      bool testIntersection( const AxisAlignedBox& aabb ) const { return m_frustum.isInside( aabb ); }
+   };
+
+   // ----------------------------------------------------------------------------
+
+   float randomCoord( float range )
+   {
+      return ( (float)rand() / (float)RAND_MAX ) * range - range * 0.5f;
+   }
+
+   // ----------------------------------------------------------------------------
+
+   template< typename AreaTestCallback >
+   bool compareWithBruteForce( const AABBTree< BoxElemMock >& tree, BoxElemMock* elems, uint elemsCount, const AreaTestCallback& area )
+   {
+      Array< BoxElemMock* > expected;
+      for ( uint i = 0; i < elemsCount; ++i )
+      {
+         if ( tree.isAdded( elems[i] ) && area.testIntersection( elems[i].getBoundingVolume() ) )
+         {
+            expected.push_back( &elems[i] );
+         }
+      }
+
+      Array< BoxElemMock* > result;
+      tree.query( area, result );
+      if ( result.size() != expected.size() )
+      {
+         return false;
+      }
+
+      // the tree returns the elements in a different order
+      std::sort( result.getRaw(), result.getRaw() + result.size() );
+      for ( uint i = 0; i < expected.size(); ++i )
+      {
+         if ( result[i] != expected[i] )
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   // ----------------------------------------------------------------------------
+
+   bool compareQueriesWithBruteForce( const AABBTree< BoxElemMock >& tree, BoxElemMock* elems, uint elemsCount )
+   {
+      AxisAlignedBox queriedBoxes[3];
+      queriedBoxes[0].set( Vector( -10, -10, -10 ), Vector( 10, 10, 10 ) );
+      queriedBoxes[1].set( Vector( -100, -5, -100 ), Vector( 0, 5, 100 ) );
+      queriedBoxes[2].set( Vector( -1000, -1000, -1000 ), Vector( 1000, 1000, 1000 ) );
+      for ( uint i = 0; i < 3; ++i )
+      {
+         if ( !compareWithBruteForce( tree, elems, elemsCount, queriedBoxes[i] ) )
+         {
+            return false;
+         }
+      }
+
+      // a frustum looking down the Z axis
+      Frustum frustum;
+      const FastFloat ff_707 = FastFloat::fromFloat( 0.707107f );
+      const FastFloat ff_neg_707 = FastFloat::fromFloat( -0.707107f );
+      frustum.planes[0].set( Float_0,    Float_0,    Float_1,       FastFloat::fromFloat( -1.0f ) );
+      frustum.planes[1].set( Float_0,    Float_0,    Float_Minus1,  FastFloat::fromFloat( 50.0f ) );
+      frustum.planes[2].set( ff_707,     Float_0,    ff_707,        Float_0 );
+      frustum.planes[3].set( ff_neg_707, Float_0,    ff_707,        Float_0 );
+      frustum.planes[4].set( Float_0,    ff_neg_707, ff_707,        Float_0 );
+      frustum.planes[5].set( Float_0,    ff_707,     ff_707,        Float_0 );
+
+      return compareWithBruteForce( tree, elems, elemsCount, FrustumArea( frustum ) );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AABBTree, queriesMatchBruteForceTests )
+{
+   srand( 1024 );
+
+   const uint elemsCount = 2000;
+   BoxElemMock* elems = new BoxElemMock[elemsCount];
+   for ( uint i = 0; i < elemsCount; ++i )
+   {
+      elems[i].place( Vector( randomCoord( 200.0f ), randomCoord( 200.0f ), randomCoord( 200.0f ) ), 0.5f + randomCoord( 1.0f ) );
+   }
+
+   AABBTree< BoxElemMock > tree;
+   for ( uint i = 0; i < elemsCount; ++i )
+   {
+      tree.insert( elems[i] );
+   }
+   CPPUNIT_ASSERT_EQUAL( elemsCount, tree.size() );
+   CPPUNIT_ASSERT( compareQueriesWithBruteForce( tree, elems, elemsCount ) );
+
+   // move some of the elements - both by a tiny bit, and by a lot
+   for ( uint i = 0; i < elemsCount; i += 3 )
+   {
+      Vector pos = elems[i].m_bounds.min;
+      pos[0] += ( i % 2 ) ? 0.01f : 50.0f;
+      elems[i].place( pos, 1.0f );
+   }
+   tree.update();
+   CPPUNIT_ASSERT( compareQueriesWithBruteForce( tree, elems, elemsCount ) );
+
+   // remove some of the elements
+   for ( uint i = 0; i < elemsCount; i += 5 )
+   {
+      tree.remove( elems[i] );
+   }
+   CPPUNIT_ASSERT( compareQueriesWithBruteForce( tree, elems, elemsCount ) );
+
+   // rebuild the tree
+   tree.rebuild();
+   CPPUNIT_ASSERT( compareQueriesWithBruteForce( tree, elems, elemsCount ) );
+
+   // scene bounds encompass all elements
+   AxisAlignedBox sceneBounds;
+   tree.getSceneBounds( sceneBounds );
+   for ( uint i = 0; i < elemsCount; ++i )
+   {
+      if ( tree.isAdded( elems[i] ) )
+      {
+         AxisAlignedBox unionBox;
+         sceneBounds.add( elems[i].m_bounds, unionBox );
+         CPPUNIT_ASSERT( sceneBounds == unionBox );
+      }
+   }
+
+   // cleanup
+   tree.clear();
+   CPPUNIT_ASSERT_EQUAL( (uint)0, tree.size() );
+   delete [] elems;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( AABBTree, elementsWithoutBounds )
+{
+   // the bounds of an element may not be known at the moment it's inserted ( a mesh that hasn't been loaded yet )
+   BoxElemMock elems[3];
+   elems[0].place( Vector( 0, 0, 0 ), 1.0f );
+   elems[2].place( Vector( 5, 0, 0 ), 1.0f );
+
+   AABBTree< BoxElemMock > tree;
+   tree.insert( elems[0] );
+   tree.insert( elems[1] );
+   tree.insert( elems[2] );
+   tree.rebuild();
+
+   AxisAlignedBox queriedBox( Vector( -10, -10, -10 ), Vector( 10, 10, 10 ) );
+   Array< BoxElemMock* > result;
+   tree.query( queriedBox, result );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, result.size() );
+
+   // once the element gets its bounds, the update puts it in the right place
+   elems[1].place( Vector( -5, 0, 0 ), 1.0f );
+   tree.update();
+   CPPUNIT_ASSERT( compareWithBruteForce( tree, elems, 3, queriedBox ) );
+
+   result.clear();
+   tree.query( queriedBox, result );
+   CPPUNIT_ASSERT_EQUAL( (uint)3, result.size() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -6,6 +6,9 @@
 #include "core\Sphere.h"
 #include "core\Frustum.h"
 #include "core\Triangle.h"
+#include "core\PackedAxisAlignedBoxes.h"
+#include "core\Timer.h"
+#include "core\Log.h"
 #include "core-TestFramework\MatrixWriter.h"
 
 
@@ -494,3 +497,134 @@ TEST(Triangle, intersects_Ray)
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   void createTestFrustum( Frustum& outFrustum )
+   {
+      const FastFloat ff_707 = FastFloat::fromFloat( 0.707107f );
+      const FastFloat ff_neg_707 = FastFloat::fromFloat( -0.707107f );
+
+      outFrustum.planes[0].set( Float_0,    Float_0,    Float_1,       FastFloat::fromFloat( -1.01f ) );
+      outFrustum.planes[1].set( Float_0,    Float_0,    Float_Minus1,  FastFloat::fromFloat( 100.0f ) );
+      outFrustum.planes[2].set( ff_707,     Float_0,    ff_707,        Float_0 );
+      outFrustum.planes[3].set( ff_neg_707, Float_0,    ff_707,        Float_0 );
+      outFrustum.planes[4].set( Float_0,    ff_neg_707, ff_707,        Float_0 );
+      outFrustum.planes[5].set( Float_0,    ff_707,     ff_707,        Float_0 );
+   }
+
+   void createTestBoxes( uint count, AxisAlignedBox* outBoxes )
+   {
+      // boxes scattered around the frustum, some of them inside, some outside, and some crossing its planes
+      for ( uint i = 0; i < count; ++i )
+      {
+         float x = (float)( (int)( i * 37 ) % 201 - 100 );
+         float y = (float)( (int)( i * 53 ) % 201 - 100 );
+         float z = (float)( (int)( i * 71 ) % 241 - 120 );
+         float size = 0.5f + (float)( i % 7 );
+         outBoxes[i].set( Vector( x, y, z ), Vector( x + size, y + size, z + size ) );
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( Frustum, batchCulling )
+{
+   Frustum frustum;
+   createTestFrustum( frustum );
+
+   // a number of boxes that doesn't fill the last quad
+   const uint boxesCount = 1003;
+   AxisAlignedBox* boxes = new AxisAlignedBox[boxesCount];
+   createTestBoxes( boxesCount, boxes );
+
+   PackedAxisAlignedBoxes packedBoxes;
+   for ( uint i = 0; i < boxesCount; ++i )
+   {
+      packedBoxes.push_back( boxes[i] );
+   }
+   CPPUNIT_ASSERT_EQUAL( boxesCount, packedBoxes.size() );
+
+   AxisAlignedBox unpackedBox;
+   packedBoxes.get( 501, unpackedBox );
+   CPPUNIT_ASSERT_EQUAL( boxes[501].min, unpackedBox.min );
+   CPPUNIT_ASSERT_EQUAL( boxes[501].max, unpackedBox.max );
+
+   byte* packedResults = new byte[boxesCount];
+   byte* unpackedResults = new byte[boxesCount];
+   frustum.cull( packedBoxes, packedResults );
+   frustum.cull( boxes, boxesCount, unpackedResults );
+
+   uint visibleCount = 0;
+   for ( uint i = 0; i < boxesCount; ++i )
+   {
+      const byte expectedResult = frustum.isInside( boxes[i] ) ? 1 : 0;
+      CPPUNIT_ASSERT_EQUAL( expectedResult, packedResults[i] );
+      CPPUNIT_ASSERT_EQUAL( expectedResult, unpackedResults[i] );
+
+      visibleCount += expectedResult;
+   }
+
+   // make sure the test is meaningful
+   CPPUNIT_ASSERT( visibleCount > 0 );
+   CPPUNIT_ASSERT( visibleCount < boxesCount );
+
+   // cleanup
+   delete [] packedResults;
+   delete [] unpackedResults;
+   delete [] boxes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( Frustum, batchCullingPerformance )
+{
+   Frustum frustum;
+   createTestFrustum( frustum );
+
+   const uint boxesCount = 100000;
+   AxisAlignedBox* boxes = new AxisAlignedBox[boxesCount];
+   createTestBoxes( boxesCount, boxes );
+
+   PackedAxisAlignedBoxes packedBoxes( boxesCount );
+   for ( uint i = 0; i < boxesCount; ++i )
+   {
+      packedBoxes.push_back( boxes[i] );
+   }
+
+   byte* scalarResults = new byte[boxesCount];
+   byte* batchResults = new byte[boxesCount];
+   const uint repetitionsCount = 10;
+   CTimer timer;
+
+   timer.tick();
+   for ( uint rep = 0; rep < repetitionsCount; ++rep )
+   {
+      for ( uint i = 0; i < boxesCount; ++i )
+      {
+         scalarResults[i] = frustum.isInside( boxes[i] ) ? 1 : 0;
+      }
+   }
+   timer.tick();
+   float scalarDuration = timer.getTimeElapsed();
+
+   timer.tick();
+   for ( uint rep = 0; rep < repetitionsCount; ++rep )
+   {
+      frustum.cull( packedBoxes, batchResults );
+   }
+   timer.tick();
+   float batchDuration = timer.getTimeElapsed();
+
+   CPPUNIT_ASSERT( memcmp( scalarResults, batchResults, boxesCount ) == 0 );
+
+   LOG( "Frustum: %d boxes culled %d times - one by one %.3f ms, in a batch %.3f ms", boxesCount, repetitionsCount, scalarDuration * 1000.0f, batchDuration * 1000.0f );
+
+   // cleanup
+   delete [] scalarResults;
+   delete [] batchResults;
+   delete [] boxes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,223 @@
+#include "core-TestFramework\TestFramework.h"
+#include "core\Filesystem.h"
+#include "core\FilesystemScanner.h"
+#include "core\File.h"
+#include "core\InFileStream.h"
+#include "core\InMappedFileStream.h"
+#include "core\OutFileStream.h"
+#include "core\Timer.h"
+#include "core\Log.h"
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   const uint VALUES_COUNT = 1000;
+   const uint BLOCK_SIZE = 300;
+
+   void writeTestFile( Filesystem& filesystem, const FilePath& path )
+   {
+      File* file = filesystem.open( path, std::ios_base::out | std::ios_base::binary );
+      OutFileStream fileStream( file );
+      OutStream& stream = fileStream;
+
+      for ( uint i = 0; i < VALUES_COUNT; ++i )
+      {
+         stream << i;
+
+         // every now and then put a block that's larger than the read-ahead buffers used in the tests
+         if ( i % 100 == 0 )
+         {
+            byte block[BLOCK_SIZE];
+            memset( block, i % 256, BLOCK_SIZE );
+            stream.save( block, BLOCK_SIZE );
+         }
+      }
+   }
+
+   // -------------------------------------------------------------------------
+
+   void verifyTestFile( InStream& stream )
+   {
+      for ( uint i = 0; i < VALUES_COUNT; ++i )
+      {
+         uint val = -1;
+         stream >> val;
+         CPPUNIT_ASSERT_EQUAL( i, val );
+
+         if ( i % 100 == 0 )
+         {
+            byte block[BLOCK_SIZE];
+            stream.load( block, BLOCK_SIZE );
+            CPPUNIT_ASSERT_EQUAL( (byte)( i % 256 ), block[0] );
+            CPPUNIT_ASSERT_EQUAL( (byte)( i % 256 ), block[BLOCK_SIZE - 1] );
+         }
+      }
+   }
+
+   // -------------------------------------------------------------------------
+
+   class FilesCollector : public FilesystemScanner
+   {
+   public:
+      std::vector< FilePath >    m_files;
+
+      void onFile( const FilePath& name ) 
+      {
+         m_files.push_back( name );
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   enum StreamType
+   {
+      ST_Unbuffered,
+      ST_Buffered,
+      ST_Mapped
+   };
+
+   uint readFiles( Filesystem& filesystem, const std::vector< FilePath >& files, StreamType streamType )
+   {
+      uint checksum = 0;
+
+      uint count = files.size();
+      for ( uint i = 0; i < count; ++i )
+      {
+         File* file = filesystem.open( files[i], std::ios_base::in | std::ios_base::binary );
+         if ( !file )
+         {
+            continue;
+         }
+
+         uint valsCount = file->size() / sizeof( uint );
+
+         InStream* stream = NULL;
+         switch( streamType )
+         {
+         case ST_Unbuffered:  stream = new InFileStream( file );                                             break;
+         case ST_Buffered:    stream = new InFileStream( file, InFileStream::DEFAULT_READ_AHEAD_SIZE );      break;
+         case ST_Mapped:      stream = new InMappedFileStream( file );                                       break;
+         }
+
+         // deserialization reads the data in small chunks like these
+         for ( uint j = 0; j < valsCount; ++j )
+         {
+            uint val;
+            *stream >> val;
+            checksum ^= val;
+         }
+
+         delete stream;
+      }
+
+      return checksum;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( InFileStream, readAhead )
+{
+   Filesystem filesystem;
+   filesystem.changeRootDir( "../Data/" );
+
+   FilePath path( "fileStreamsTest.bin" );
+   writeTestFile( filesystem, path );
+
+   // regular stream
+   {
+      InFileStream stream( filesystem.open( path, std::ios_base::in | std::ios_base::binary ) );
+      verifyTestFile( stream );
+   }
+
+   // a buffer smaller than some of the blocks we're reading
+   {
+      InFileStream stream( filesystem.open( path, std::ios_base::in | std::ios_base::binary ), 256 );
+      verifyTestFile( stream );
+   }
+
+   // a buffer larger than the file itself
+   {
+      InFileStream stream( filesystem.open( path, std::ios_base::in | std::ios_base::binary ), InFileStream::DEFAULT_READ_AHEAD_SIZE );
+      verifyTestFile( stream );
+
+      // there's nothing more to read
+      uint val = 5;
+      stream >> val;
+      CPPUNIT_ASSERT_EQUAL( (uint)5, val );
+   }
+
+   // cleanup
+   filesystem.remove( path );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( InMappedFileStream, readingMappedFile )
+{
+   Filesystem filesystem;
+   filesystem.changeRootDir( "../Data/" );
+
+   FilePath path( "fileStreamsTest.bin" );
+   writeTestFile( filesystem, path );
+
+   {
+      InMappedFileStream stream( filesystem.open( path, std::ios_base::in | std::ios_base::binary ) );
+      CPPUNIT_ASSERT( stream.isMapped() );
+      verifyTestFile( stream );
+
+      // there's nothing more to read
+      uint val = 5;
+      stream >> val;
+      CPPUNIT_ASSERT_EQUAL( (uint)5, val );
+   }
+
+   // cleanup
+   filesystem.remove( path );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( InFileStream, loadingAssetsPerformance )
+{
+   // the tests are run from their project directory
+   Filesystem filesystem;
+   filesystem.changeRootDir( "../../../Assets/" );
+
+   FilePath rootDir( "/" );
+   FilesCollector collector;
+   filesystem.scan( rootDir, collector );
+   if ( collector.m_files.empty() )
+   {
+      // the assets aren't there
+      return;
+   }
+
+   // read everything once, so that all runs work with the files in the system cache
+   uint referenceChecksum = readFiles( filesystem, collector.m_files, ST_Buffered );
+
+   CTimer timer;
+   timer.tick();
+
+   uint checksum = readFiles( filesystem, collector.m_files, ST_Unbuffered );
+   timer.tick();
+   float unbufferedDuration = timer.getTimeElapsed();
+   CPPUNIT_ASSERT_EQUAL( referenceChecksum, checksum );
+
+   checksum = readFiles( filesystem, collector.m_files, ST_Buffered );
+   timer.tick();
+   float bufferedDuration = timer.getTimeElapsed();
+   CPPUNIT_ASSERT_EQUAL( referenceChecksum, checksum );
+
+   checksum = readFiles( filesystem, collector.m_files, ST_Mapped );
+   timer.tick();
+   float mappedDuration = timer.getTimeElapsed();
+   CPPUNIT_ASSERT_EQUAL( referenceChecksum, checksum );
+
+   LOG( "InFileStream: %d asset files read - unbuffered %.3f ms, buffered %.3f ms, mapped %.3f ms",
+      collector.m_files.size(), unbufferedDuration * 1000.0f, bufferedDuration * 1000.0f, mappedDuration * 1000.0f );
+}
+
+///////////////////////////////////////////////////////////////////////////////
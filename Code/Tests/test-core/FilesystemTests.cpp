@@ -2,8 +2,38 @@
 #include "core\Filesystem.h"
 #include "core\FilesystemUtils.h"
 #include "core\StreamBuffer.h"
+#include "core\FilePathMap.h"
+#include "core\IDString.h"
+#include "core\Thread.h"
+#include "core\Runnable.h"
 
 
+///////////////////////////////////////////////////////////////////////////////
+
+namespace // anonymous
+{
+   struct FileReader : public Runnable
+   {
+      Filesystem&       m_filesystem;
+      FilePath          m_path;
+      std::size_t       m_readSize;
+
+      FileReader( Filesystem& filesystem, const FilePath& path )
+         : m_filesystem( filesystem )
+         , m_path( path )
+         , m_readSize( 0 )
+      {}
+
+      void run()
+      {
+         File* file = m_filesystem.open( m_path, std::ios_base::in );
+         m_readSize = file->size();
+         delete file;
+      }
+   };
+
+} // anonymous
+
 ///////////////////////////////////////////////////////////////////////////////
 
 TEST(Filesystem, loadingFilesUnderSpecificRoot)
@@ -52,6 +82,33 @@ TEST(Filesystem, accessingFileLikeAMemoryBuffer)
 
 ///////////////////////////////////////////////////////////////////////////////
 
+TEST( Filesystem, openingFileThatIsBeingWritten )
+{
+   Filesystem filesystem;
+   filesystem.changeRootDir( "../Data/" );
+
+   FilePath path( "openingFileThatIsBeingWritten.txt" );
+   File* writtenFile = filesystem.open( path, std::ios_base::out );
+
+   // the reader is refused access to the file until we're done writing it - and it mustn't
+   // keep the filesystem locked while it waits, or we wouldn't be able to close the file
+   Thread thread;
+   FileReader reader( filesystem, path );
+   thread.start( reader );
+   Thread::sleep( 50 );
+
+   writtenFile->writeString( "12345" );
+   delete writtenFile;
+
+   thread.join();
+   CPPUNIT_ASSERT_EQUAL( (std::size_t)5, reader.m_readSize );
+
+   // cleanup
+   filesystem.remove( path );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 TEST(FilesystemUtils, extractingPathParts)
 {
    std::string fileName( "/ola/ula/pies.txt" );
@@ -151,3 +208,78 @@ TEST( FilesystemUtils, normalize )
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+TEST( FilePath, hash )
+{
+   FilePath path( "dirA/dirB/file.txt" );
+   CPPUNIT_ASSERT( path.getHash() == FilePath( "dirA\\dirB\\file.txt" ).getHash() );
+   CPPUNIT_ASSERT( path.getHash() != FilePath( "dirA/dirB/file.ext" ).getHash() );
+
+   // the hash follows the changes of the path
+   FilePath changedPath;
+   path.changeFileExtension( "ext", changedPath );
+   CPPUNIT_ASSERT( changedPath.getHash() == FilePath( "dirA/dirB/file.ext" ).getHash() );
+   CPPUNIT_ASSERT( changedPath == FilePath( "dirA/dirB/file.ext" ) );
+
+   FilePath dir;
+   path.extractDir( dir );
+   CPPUNIT_ASSERT( dir.getHash() == IDStringHash::calculate( dir.c_str() ) );
+
+   changedPath = path;
+   CPPUNIT_ASSERT( changedPath.getHash() == path.getHash() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( FilePathMap, insertingAndRemovingEntries )
+{
+   TFilePathMap< int > map;
+
+   const int ENTRIES_COUNT = 1000;
+   char pathStr[64];
+   for ( int i = 0; i < ENTRIES_COUNT; ++i )
+   {
+      sprintf_s( pathStr, "dir%d/file%d.txt", i % 10, i );
+      CPPUNIT_ASSERT( map.insert( FilePath( pathStr ), i ) );
+   }
+   CPPUNIT_ASSERT_EQUAL( (uint)ENTRIES_COUNT, map.size() );
+
+   // duplicates are rejected
+   CPPUNIT_ASSERT( !map.insert( FilePath( "dir0/file0.txt" ), -1 ) );
+   CPPUNIT_ASSERT_EQUAL( 0, *map.find( FilePath( "dir0/file0.txt" ) ) );
+
+   // remove every other entry
+   for ( int i = 0; i < ENTRIES_COUNT; i += 2 )
+   {
+      sprintf_s( pathStr, "dir%d/file%d.txt", i % 10, i );
+      CPPUNIT_ASSERT( map.remove( FilePath( pathStr ) ) );
+   }
+   CPPUNIT_ASSERT_EQUAL( (uint)( ENTRIES_COUNT / 2 ), map.size() );
+
+   for ( int i = 0; i < ENTRIES_COUNT; ++i )
+   {
+      sprintf_s( pathStr, "dir%d/file%d.txt", i % 10, i );
+      const int* value = map.find( FilePath( pathStr ) );
+      if ( i % 2 == 0 )
+      {
+         CPPUNIT_ASSERT( value == NULL );
+      }
+      else
+      {
+         CPPUNIT_ASSERT( value != NULL );
+         CPPUNIT_ASSERT_EQUAL( i, *value );
+      }
+   }
+
+   // move an entry
+   CPPUNIT_ASSERT( map.changePath( FilePath( "dir1/file1.txt" ), FilePath( "moved/file1.txt" ) ) );
+   CPPUNIT_ASSERT( map.find( FilePath( "dir1/file1.txt" ) ) == NULL );
+   CPPUNIT_ASSERT_EQUAL( 1, *map.find( FilePath( "moved/file1.txt" ) ) );
+   CPPUNIT_ASSERT( !map.changePath( FilePath( "dir3/file3.txt" ), FilePath( "moved/file1.txt" ) ) );
+
+   map.clear();
+   CPPUNIT_ASSERT( map.empty() );
+   CPPUNIT_ASSERT( map.find( FilePath( "dir3/file3.txt" ) ) == NULL );
+}
+
+///////////////////////////////////////////////////////////////////////////////
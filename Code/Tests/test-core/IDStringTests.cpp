@@ -0,0 +1,90 @@
+#include "core-TestFramework\TestFramework.h"
+#include "core\IDString.h"
+#include <string>
+#include <sstream>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( IDStringsPool, registeringStrings )
+{
+   IDStringsPool pool;
+
+   uint idA = pool.registerString( "A" );
+   uint idB = pool.registerString( "B" );
+   CPPUNIT_ASSERT( idA != idB );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, pool.getStringsCount() );
+
+   // registering the same string again yields the same id
+   CPPUNIT_ASSERT_EQUAL( idA, pool.registerString( "A" ) );
+   CPPUNIT_ASSERT_EQUAL( idB, pool.registerString( std::string( "B" ).c_str() ) );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, pool.getStringsCount() );
+
+   CPPUNIT_ASSERT_EQUAL( std::string( "A" ), std::string( pool.getString( idA ) ) );
+   CPPUNIT_ASSERT_EQUAL( std::string( "B" ), std::string( pool.getString( idB ) ) );
+
+   // unknown ids map to an empty string
+   CPPUNIT_ASSERT_EQUAL( std::string( "" ), std::string( pool.getString( IDStringHash::calculate( "C" ) ) ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( IDStringsPool, growing )
+{
+   IDStringsPool pool;
+
+   const uint count = 5000;
+   Array< uint > ids( count );
+   for ( uint i = 0; i < count; ++i )
+   {
+      std::stringstream str;
+      str << "str_" << i;
+      ids.push_back( pool.registerString( str.str().c_str() ) );
+   }
+   CPPUNIT_ASSERT_EQUAL( count, pool.getStringsCount() );
+
+   for ( uint i = 0; i < count; ++i )
+   {
+      std::stringstream str;
+      str << "str_" << i;
+      CPPUNIT_ASSERT_EQUAL( str.str(), std::string( pool.getString( ids[i] ) ) );
+   }
+
+   // strings longer than the arena page are handled as well
+   std::string longStr( 20000, 'x' );
+   uint longStrId = pool.registerString( longStr.c_str() );
+   CPPUNIT_ASSERT_EQUAL( longStr, std::string( pool.getString( longStrId ) ) );
+   CPPUNIT_ASSERT_EQUAL( std::string( "str_0" ), std::string( pool.getString( ids[0] ) ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( IDStringsPool, hashCollision )
+{
+   IDStringsPool pool;
+
+   // "costarring" and "liquid" share the same FNV-1a hash
+   CPPUNIT_ASSERT_EQUAL( IDStringHash::calculate( "costarring" ), IDStringHash::calculate( "liquid" ) );
+
+   pool.registerString( "costarring" );
+
+   // the collision is reported through an assertion, which the tests runner turns into an exception
+   CPPUNIT_ASSERT_THROW( pool.registerString( "liquid" ), CppUnit::Exception );
+   CPPUNIT_ASSERT_EQUAL( std::string( "costarring" ), std::string( pool.getString( IDStringHash::calculate( "liquid" ) ) ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( IDString, literalHashing )
+{
+   const char* str = "g_DiffuseTex";
+   CPPUNIT_ASSERT_EQUAL( IDStringHash::calculate( str ), IDStringHash::calculateLiteral( "g_DiffuseTex" ) );
+   CPPUNIT_ASSERT_EQUAL( IDStringHash::calculate( "" ), IDStringHash::calculateLiteral( "" ) );
+
+   IDString id( str );
+   CPPUNIT_ASSERT( id == IDSTR( "g_DiffuseTex" ) );
+   CPPUNIT_ASSERT( id != IDSTR( "g_SpecularTex" ) );
+   CPPUNIT_ASSERT_EQUAL( std::string( "g_DiffuseTex" ), std::string( IDSTR( "g_DiffuseTex" ).c_str() ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "core-TestFramework\TestFramework.h"
+#include "core\MultithreadedTasksScheduler.h"
+#include "core\Job.h"
+#include "core\Atomic.h"
+#include "core\Thread.h"
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace 
+{
+   class SequenceRecorder
+   {
+   public:
+      AtomicInt            m_timestamp;
+      std::vector< long >  m_executionTimes;
+
+      SequenceRecorder( uint jobsCount )
+         : m_executionTimes( jobsCount, -1 )
+      {}
+
+      void record( uint jobIdx )
+      {
+         // let the job run for a moment so that the jobs that don't wait for it
+         // have a chance to overlap with it
+         for ( uint i = 0; i < 3; ++i )
+         {
+            Thread::yield();
+         }
+
+         m_executionTimes[jobIdx] = m_timestamp.increment();
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   class RecordingJobMock : public Job
+   {
+      DECLARE_ALLOCATOR( RecordingJobMock, AM_DEFAULT );
+
+   private:
+      SequenceRecorder&    m_recorder;
+      uint                 m_idx;
+
+   public:
+      RecordingJobMock( MultithreadedTasksScheduler& scheduler, JobCounter& counter, SequenceRecorder& recorder, uint idx )
+         : Job( scheduler, &counter )
+         , m_recorder( recorder )
+         , m_idx( idx )
+      {}
+
+      void execute()
+      {
+         m_recorder.record( m_idx );
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   struct SummingFunctor
+   {
+      std::vector< uint >&    m_values;
+      AtomicInt&              m_sum;
+      AtomicInt&              m_calls;
+
+      SummingFunctor( std::vector< uint >& values, AtomicInt& sum, AtomicInt& calls )
+         : m_values( values )
+         , m_sum( sum )
+         , m_calls( calls )
+      {}
+
+      void operator()( uint chunkStart, uint chunkEnd ) const
+      {
+         long chunkSum = 0;
+         for ( uint i = chunkStart; i < chunkEnd; ++i )
+         {
+            chunkSum += m_values[i];
+         }
+
+         m_sum.add( chunkSum );
+         m_calls.increment();
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   class NestedParallelForJobMock : public Job
+   {
+      DECLARE_ALLOCATOR( NestedParallelForJobMock, AM_DEFAULT );
+
+   private:
+      MultithreadedTasksScheduler&  m_scheduler;
+      const SummingFunctor&         m_functor;
+      uint                          m_rangeSize;
+
+   public:
+      NestedParallelForJobMock( MultithreadedTasksScheduler& scheduler, JobCounter& counter, const SummingFunctor& functor, uint rangeSize )
+         : Job( scheduler, &counter )
+         , m_scheduler( scheduler )
+         , m_functor( functor )
+         , m_rangeSize( rangeSize )
+      {}
+
+      void execute()
+      {
+         m_scheduler.parallelFor( 0, m_rangeSize, 16, m_functor );
+      }
+   };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( Jobs, dependencies )
+{
+   MultithreadedTasksScheduler scheduler( 4 );
+
+   //       +-> 1 -+
+   //    0 -+      +-> 3
+   //       +-> 2 -+
+   JobCounter counter;
+   SequenceRecorder recorder( 4 );
+   RecordingJobMock job0( scheduler, counter, recorder, 0 );
+   RecordingJobMock job1( scheduler, counter, recorder, 1 );
+   RecordingJobMock job2( scheduler, counter, recorder, 2 );
+   RecordingJobMock job3( scheduler, counter, recorder, 3 );
+
+   job0.addContinuation( job1 );
+   job0.addContinuation( job2 );
+   job3.addDependency( job1 );
+   job3.addDependency( job2 );
+   CPPUNIT_ASSERT_EQUAL( (uint)0, job0.getDependenciesCount() );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, job3.getDependenciesCount() );
+
+   // the graph can be run multiple times
+   for ( uint run = 0; run < 3; ++run )
+   {
+      scheduler.run( job0 );
+      scheduler.waitFor( counter );
+
+      CPPUNIT_ASSERT( counter.isDone() );
+      CPPUNIT_ASSERT( recorder.m_executionTimes[0] < recorder.m_executionTimes[1] );
+      CPPUNIT_ASSERT( recorder.m_executionTimes[0] < recorder.m_executionTimes[2] );
+      CPPUNIT_ASSERT( recorder.m_executionTimes[1] < recorder.m_executionTimes[3] );
+      CPPUNIT_ASSERT( recorder.m_executionTimes[2] < recorder.m_executionTimes[3] );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( Jobs, parallelFor )
+{
+   MultithreadedTasksScheduler scheduler( 4 );
+
+   const uint valuesCount = 1000;
+   std::vector< uint > values( valuesCount );
+   long expectedSum = 0;
+   for ( uint i = 0; i < valuesCount; ++i )
+   {
+      values[i] = i;
+      expectedSum += i;
+   }
+
+   AtomicInt sum;
+   AtomicInt calls;
+   SummingFunctor functor( values, sum, calls );
+
+   // the last chunk is smaller than the rest
+   scheduler.parallelFor( 0, valuesCount, 64, functor );
+   CPPUNIT_ASSERT_EQUAL( expectedSum, sum.get() );
+   CPPUNIT_ASSERT_EQUAL( (long)16, calls.get() );
+
+   // a range that doesn't need to be split
+   sum.set( 0 );
+   calls.set( 0 );
+   scheduler.parallelFor( 0, valuesCount, valuesCount, functor );
+   CPPUNIT_ASSERT_EQUAL( expectedSum, sum.get() );
+   CPPUNIT_ASSERT_EQUAL( (long)1, calls.get() );
+
+   // empty range
+   sum.set( 0 );
+   calls.set( 0 );
+   scheduler.parallelFor( 10, 10, 64, functor );
+   CPPUNIT_ASSERT_EQUAL( (long)0, calls.get() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( Jobs, nestedParallelFor )
+{
+   // there are more jobs waiting for their nested loops than there are workers - if the waiting
+   // workers were blocked instead of helping out, this test would deadlock
+   MultithreadedTasksScheduler scheduler( 2 );
+
+   const uint valuesCount = 256;
+   std::vector< uint > values( valuesCount, 1 );
+   AtomicInt sum;
+   AtomicInt calls;
+   SummingFunctor functor( values, sum, calls );
+
+   const uint jobsCount = 8;
+   JobCounter counter;
+   std::vector< NestedParallelForJobMock* > jobs;
+   for ( uint i = 0; i < jobsCount; ++i )
+   {
+      jobs.push_back( new NestedParallelForJobMock( scheduler, counter, functor, valuesCount ) );
+      scheduler.run( *jobs.back() );
+   }
+
+   scheduler.waitFor( counter );
+   CPPUNIT_ASSERT_EQUAL( (long)( valuesCount * jobsCount ), sum.get() );
+
+   for ( uint i = 0; i < jobsCount; ++i )
+   {
+      delete jobs[i];
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,168 @@
+#include "core-TestFramework\TestFramework.h"
+#include "core\LocklessCommandsBuffer.h"
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+   struct CommandsOwnerMock
+   {
+      std::vector< int >      m_executedCommands;
+   };
+
+   // -------------------------------------------------------------------------
+
+   class CommandMock : public LocklessCommand< CommandsOwnerMock >
+   {
+      DECLARE_ALLOCATOR( CommandMock, AM_DEFAULT );
+
+   private:
+      int         m_id;
+      int*        m_deletionsCount;
+
+   public:
+      CommandMock( int id, int& deletionsCount ) : m_id( id ), m_deletionsCount( &deletionsCount ) {}
+      ~CommandMock() { ++( *m_deletionsCount ); }
+
+      void execute( CommandsOwnerMock& owner )
+      {
+         owner.m_executedCommands.push_back( m_id );
+      }
+   };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( LocklessCommandsBuffer, commandsExecutedInRecordingOrder )
+{
+   LocklessCommandsBuffer< CommandsOwnerMock > buffer( 1024 );
+   CommandsOwnerMock owner;
+   int deletionsCount = 0;
+
+   new ( &buffer ) CommandMock( 1, deletionsCount );
+   new ( &buffer ) CommandMock( 2, deletionsCount );
+   new ( &buffer ) CommandMock( 3, deletionsCount );
+   CPPUNIT_ASSERT_EQUAL( (uint)3, buffer.getCommandsCount() );
+
+   buffer.process( owner );
+   CPPUNIT_ASSERT_EQUAL( (uint)3, owner.m_executedCommands.size() );
+   CPPUNIT_ASSERT_EQUAL( 1, owner.m_executedCommands[0] );
+   CPPUNIT_ASSERT_EQUAL( 2, owner.m_executedCommands[1] );
+   CPPUNIT_ASSERT_EQUAL( 3, owner.m_executedCommands[2] );
+
+   // the commands were released, and the buffer is empty
+   CPPUNIT_ASSERT_EQUAL( 3, deletionsCount );
+   CPPUNIT_ASSERT_EQUAL( (uint)0, buffer.getCommandsCount() );
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, buffer.getMemoryUsed() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( LocklessCommandsBuffer, reusingBuffer )
+{
+   LocklessCommandsBuffer< CommandsOwnerMock > buffer( 1024 );
+   CommandsOwnerMock owner;
+   int deletionsCount = 0;
+
+   // the buffer is small, but it's reclaimed each time it's processed
+   for ( int i = 0; i < 100; ++i )
+   {
+      new ( &buffer ) CommandMock( i, deletionsCount );
+      new ( &buffer ) CommandMock( -i, deletionsCount );
+      buffer.process( owner );
+   }
+
+   CPPUNIT_ASSERT_EQUAL( (uint)200, owner.m_executedCommands.size() );
+   CPPUNIT_ASSERT_EQUAL( 200, deletionsCount );
+   CPPUNIT_ASSERT_EQUAL( 99, owner.m_executedCommands[198] );
+   CPPUNIT_ASSERT_EQUAL( -99, owner.m_executedCommands[199] );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( LocklessCommandsBuffer, growingBuffer )
+{
+   // the buffer's page can fit only a couple of commands
+   LocklessCommandsBuffer< CommandsOwnerMock > buffer( 64 );
+   CommandsOwnerMock owner;
+   int deletionsCount = 0;
+
+   // the buffer chains more pages to fit all commands, and they are executed in the order they were recorded in
+   for ( int i = 0; i < 100; ++i )
+   {
+      new ( &buffer ) CommandMock( i, deletionsCount );
+   }
+   CPPUNIT_ASSERT_EQUAL( (uint)100, buffer.getCommandsCount() );
+   const uint pagesCount = buffer.getPagesCount();
+   CPPUNIT_ASSERT( pagesCount > 1 );
+
+   buffer.process( owner );
+   CPPUNIT_ASSERT_EQUAL( (uint)100, owner.m_executedCommands.size() );
+   CPPUNIT_ASSERT_EQUAL( 100, deletionsCount );
+   for ( int i = 0; i < 100; ++i )
+   {
+      CPPUNIT_ASSERT_EQUAL( i, owner.m_executedCommands[i] );
+   }
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, buffer.getMemoryUsed() );
+
+   // the pages are reused when the buffer is filled again
+   for ( int i = 0; i < 100; ++i )
+   {
+      new ( &buffer ) CommandMock( i, deletionsCount );
+   }
+   CPPUNIT_ASSERT_EQUAL( pagesCount, buffer.getPagesCount() );
+   buffer.clear();
+   CPPUNIT_ASSERT_EQUAL( 200, deletionsCount );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( LocklessCommandsBuffer, clearingBuffer )
+{
+   CommandsOwnerMock owner;
+   int deletionsCount = 0;
+   {
+      LocklessCommandsBuffer< CommandsOwnerMock > buffer( 1024 );
+
+      new ( &buffer ) CommandMock( 1, deletionsCount );
+      buffer.clear();
+      CPPUNIT_ASSERT_EQUAL( 1, deletionsCount );
+      CPPUNIT_ASSERT_EQUAL( (uint)0, buffer.getCommandsCount() );
+
+      // the commands that weren't processed are released together with the buffer
+      new ( &buffer ) CommandMock( 2, deletionsCount );
+   }
+
+   CPPUNIT_ASSERT_EQUAL( 2, deletionsCount );
+   CPPUNIT_ASSERT( owner.m_executedCommands.empty() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( LocklessCommandsBuffer, buffersProcessedInDeterministicOrder )
+{
+   LocklessCommandsBuffer< CommandsOwnerMock > buffer1( 1024 );
+   LocklessCommandsBuffer< CommandsOwnerMock > buffer2( 1024 );
+   CommandsOwnerMock owner;
+   int deletionsCount = 0;
+
+   // the buffers can be recorded in any order...
+   new ( &buffer2 ) CommandMock( 3, deletionsCount );
+   new ( &buffer1 ) CommandMock( 1, deletionsCount );
+   new ( &buffer2 ) CommandMock( 4, deletionsCount );
+   new ( &buffer1 ) CommandMock( 2, deletionsCount );
+
+   // ...it's the order they are processed in that decides the order of the commands
+   buffer1.process( owner );
+   buffer2.process( owner );
+
+   CPPUNIT_ASSERT_EQUAL( (uint)4, owner.m_executedCommands.size() );
+   for ( int i = 0; i < 4; ++i )
+   {
+      CPPUNIT_ASSERT_EQUAL( i + 1, owner.m_executedCommands[i] );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -5,7 +5,12 @@
 #include "core/Thread.h"
 #include "core/Runnable.h"
 #include "core/DefaultAllocator.h"
+#include "core/ThreadCachingAllocator.h"
+#include "core/Timer.h"
+#include "core/Log.h"
+#include <string.h>
 #include "core/TSContinuousMemoryPool.h"
+#include "core/FrameMemoryPool.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -67,6 +72,82 @@ namespace // anonymous
       }
    };
 
+   // -------------------------------------------------------------------------
+
+   struct MultithreadedDeallocFunc : public Runnable
+   {
+      MemoryAllocator&     m_allocator;
+      void**               m_ptrs;
+      uint                 m_count;
+
+      MultithreadedDeallocFunc( MemoryAllocator& allocator, void** ptrs, uint count )
+         : m_allocator( allocator )
+         , m_ptrs( ptrs )
+         , m_count( count )
+      {}
+
+      void run()
+      {
+         for ( uint i = 0; i < m_count; ++i )
+         {
+            m_allocator.dealloc( m_ptrs[i] );
+         }
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   struct AllocationsBenchmarkFunc : public Runnable
+   {
+      MemoryAllocator&     m_allocator;
+
+      AllocationsBenchmarkFunc( MemoryAllocator& allocator )
+         : m_allocator( allocator )
+      {}
+
+      void run()
+      {
+         void* ptrs[64];
+         for ( uint round = 0; round < 2000; ++round )
+         {
+            for ( uint i = 0; i < 64; ++i )
+            {
+               ptrs[i] = m_allocator.alloc( 16 + ( i % 8 ) * 48 );
+            }
+
+            for ( uint i = 0; i < 64; ++i )
+            {
+               m_allocator.dealloc( ptrs[i] );
+            }
+         }
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   float runAllocationsBenchmark( MemoryAllocator& allocator )
+   {
+      const uint threadsCount = 4;
+      Thread threads[threadsCount];
+      AllocationsBenchmarkFunc benchmark( allocator );
+
+      CTimer timer;
+      timer.tick();
+
+      for ( uint i = 0; i < threadsCount; ++i )
+      {
+         threads[i].start( benchmark );
+      }
+
+      for ( uint i = 0; i < threadsCount; ++i )
+      {
+         threads[i].join();
+      }
+
+      timer.tick();
+      return timer.getTimeElapsed();
+   }
+
 } // anonymous
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -244,3 +325,266 @@ TEST( ContinuousMemoryPool, threadSafety )
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+TEST( ThreadCachingAllocator, allocatingBlocksOfDifferentSizes )
+{
+   ThreadCachingAllocator allocator;
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+
+   // a small block is served from the cache, a large one goes directly to the system heap
+   char* smallBlock = (char*)allocator.alloc( 24 );
+   char* largeBlock = (char*)allocator.alloc( 4096 );
+   CPPUNIT_ASSERT( smallBlock != NULL );
+   CPPUNIT_ASSERT( largeBlock != NULL );
+   CPPUNIT_ASSERT_EQUAL( (ulong)( 24 + 4096 ), allocator.getMemoryUsed() );
+
+   // the whole blocks are usable
+   memset( smallBlock, 1, 24 );
+   memset( largeBlock, 1, 4096 );
+
+   allocator.dealloc( smallBlock );
+   CPPUNIT_ASSERT_EQUAL( (ulong)4096, allocator.getMemoryUsed() );
+
+   // a released block gets reused by the next allocation of the same size class
+   char* reusedBlock = (char*)allocator.alloc( 20 );
+   CPPUNIT_ASSERT( smallBlock == reusedBlock );
+
+   allocator.dealloc( reusedBlock );
+   allocator.dealloc( largeBlock );
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( ThreadCachingAllocator, threadSafety )
+{
+   Thread thread1;
+   Thread thread2;
+
+   ThreadCachingAllocator allocator;
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+
+   MultithreadedAllocFunc allocOperator1( allocator );
+   MultithreadedAllocFunc allocOperator2( allocator );
+
+   thread1.start( allocOperator1 );
+   thread2.start( allocOperator2 );
+
+   thread1.join();
+   thread2.join();
+
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( ThreadCachingAllocator, releasingMemoryAllocatedByAnotherThread )
+{
+   ThreadCachingAllocator allocator;
+
+   const uint blocksCount = 500;
+   void* ptrs[blocksCount];
+   for ( uint i = 0; i < blocksCount; ++i )
+   {
+      ptrs[i] = allocator.alloc( 32 );
+   }
+   CPPUNIT_ASSERT_EQUAL( (ulong)( blocksCount * 32 ), allocator.getMemoryUsed() );
+
+   Thread thread;
+   MultithreadedDeallocFunc deallocOperator( allocator, ptrs, blocksCount );
+   thread.start( deallocOperator );
+   thread.join();
+
+   // the memory usage is tracked per thread, but it sums up correctly
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+
+   // the blocks the other thread released made their way back to the central heap
+   // and can be allocated again
+   for ( uint i = 0; i < blocksCount; ++i )
+   {
+      ptrs[i] = allocator.alloc( 32 );
+   }
+   for ( uint i = 0; i < blocksCount; ++i )
+   {
+      allocator.dealloc( ptrs[i] );
+   }
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( ThreadCachingAllocator, multithreadedPerformance )
+{
+   DefaultAllocator defaultAllocator;
+   ThreadCachingAllocator threadCachingAllocator;
+
+   float defaultAllocatorDuration = runAllocationsBenchmark( defaultAllocator );
+   float threadCachingAllocatorDuration = runAllocationsBenchmark( threadCachingAllocator );
+
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, defaultAllocator.getMemoryUsed() );
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, threadCachingAllocator.getMemoryUsed() );
+
+   LOG( "ThreadCachingAllocator: 4 threads allocating concurrently - default allocator %.3f ms, thread caching allocator %.3f ms",
+      defaultAllocatorDuration * 1000.0f, threadCachingAllocatorDuration * 1000.0f );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( FrameMemoryPool, growsByChainingPages )
+{
+   FrameMemoryPool allocator( 256 );
+
+   // allocate more than a single page can fit
+   void* ptrs[32];
+   for ( uint i = 0; i < 32; ++i )
+   {
+      ptrs[i] = allocator.alloc( 32 );
+      CPPUNIT_ASSERT( ptrs[i] != NULL );
+      memset( ptrs[i], i, 32 );
+   }
+   CPPUNIT_ASSERT( allocator.getPagesCount() > 1 );
+
+   // the data stored in the subsequent pages doesn't overlap
+   for ( uint i = 0; i < 32; ++i )
+   {
+      CPPUNIT_ASSERT_EQUAL( (char)i, *(char*)ptrs[i] );
+      allocator.dealloc( ptrs[i] );
+   }
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+
+   // allocations larger than a page are fine too
+   void* largePtr = allocator.alloc( 1024 );
+   CPPUNIT_ASSERT( largePtr != NULL );
+   allocator.dealloc( largePtr );
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( FrameMemoryPool, allocationsAligned )
+{
+   FrameMemoryPool allocator( 256 );
+
+   void* ptrs[16];
+   for ( uint i = 0; i < 16; ++i )
+   {
+      ptrs[i] = allocator.alloc( i * 3 + 1 );
+      CPPUNIT_ASSERT_EQUAL( (size_t)0, (size_t)ptrs[i] & 15 );
+   }
+
+   for ( uint i = 0; i < 16; ++i )
+   {
+      allocator.dealloc( ptrs[i] );
+   }
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( FrameMemoryPool, nextFrameWaitsForTheOtherFrameToBeReleased )
+{
+   FrameMemoryPool allocator( 1024 );
+
+   const uint count = 16;
+   void* frame1Ptrs[count];
+   for ( uint i = 0; i < count; ++i )
+   {
+      frame1Ptrs[i] = allocator.alloc( 64 );
+   }
+   allocator.nextFrame();
+
+   const ulong frame1MemoryUsed = allocator.getMemoryUsed();
+   void* frame2Ptr = allocator.alloc( 64 );
+   const ulong frame2MemoryUsed = allocator.getMemoryUsed() - frame1MemoryUsed;
+
+   // the consumer releases frame 1 on another thread - we can't start filling it again before it's done
+   Thread thread;
+   MultithreadedDeallocFunc deallocOperator( allocator, frame1Ptrs, count );
+   thread.start( deallocOperator );
+
+   allocator.nextFrame();
+   CPPUNIT_ASSERT_EQUAL( frame2MemoryUsed, allocator.getMemoryUsed() );
+
+   thread.join();
+
+   allocator.dealloc( frame2Ptr );
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( FrameMemoryPool, framesReleasedIndependently )
+{
+   FrameMemoryPool allocator( 1024 );
+
+   // frame 1
+   void* frame1Ptr = allocator.alloc( 128 );
+   memset( frame1Ptr, 1, 128 );
+   allocator.nextFrame();
+
+   // frame 2 is being filled while frame 1 is still in use
+   void* frame2Ptr = allocator.alloc( 128 );
+   memset( frame2Ptr, 2, 128 );
+   CPPUNIT_ASSERT_EQUAL( (char)1, *(char*)frame1Ptr );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, allocator.getPagesCount() );
+
+   // once frame 1 is consumed, its page gets recycled even though frame 2 is still in use
+   allocator.dealloc( frame1Ptr );
+   allocator.nextFrame();
+   void* frame3Ptr = allocator.alloc( 128 );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, allocator.getPagesCount() );
+   CPPUNIT_ASSERT_EQUAL( (char)2, *(char*)frame2Ptr );
+
+   allocator.dealloc( frame2Ptr );
+   allocator.dealloc( frame3Ptr );
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( FrameMemoryPool, pagesRecycledBetweenFrames )
+{
+   FrameMemoryPool allocator( 1024 );
+
+   void* prevFramePtrs[16];
+   memset( prevFramePtrs, 0, sizeof( prevFramePtrs ) );
+
+   uint pagesCount = 0;
+   for ( uint frameIdx = 0; frameIdx < 100; ++frameIdx )
+   {
+      void* framePtrs[16];
+      for ( uint i = 0; i < 16; ++i )
+      {
+         framePtrs[i] = allocator.alloc( 100 );
+      }
+
+      // the consumer releases the previous frame while this one's being filled
+      for ( uint i = 0; i < 16; ++i )
+      {
+         if ( prevFramePtrs[i] )
+         {
+            allocator.dealloc( prevFramePtrs[i] );
+         }
+         prevFramePtrs[i] = framePtrs[i];
+      }
+      allocator.nextFrame();
+
+      // after the first couple of frames, the pool stops growing
+      if ( frameIdx == 2 )
+      {
+         pagesCount = allocator.getPagesCount();
+      }
+   }
+   CPPUNIT_ASSERT_EQUAL( pagesCount, allocator.getPagesCount() );
+
+   for ( uint i = 0; i < 16; ++i )
+   {
+      allocator.dealloc( prevFramePtrs[i] );
+   }
+   CPPUNIT_ASSERT_EQUAL( (ulong)0, allocator.getMemoryUsed() );
+
+   // the high-water mark remembers the size of the largest frame
+   CPPUNIT_ASSERT( allocator.getHighWaterMark() >= 16 * 100 );
+}
+
+///////////////////////////////////////////////////////////////////////////////
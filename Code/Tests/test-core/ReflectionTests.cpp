@@ -262,6 +262,63 @@ TEST( Reflection, isA )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+TEST( Reflection, isAWithAncestryTables )
+{
+   // setup reflection types
+   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+   typesRegistry.addSerializableType< TestClass >( "TestClass", new TSerializableTypeInstantiator< TestClass >() );
+   typesRegistry.addSerializableType< DerivedTestClass >( "DerivedTestClass", new TSerializableTypeInstantiator< DerivedTestClass >() );
+   typesRegistry.addSerializableType< TestClassWithPODArray >( "TestClassWithPODArray", new TSerializableTypeInstantiator< TestClassWithPODArray >() );
+   CPPUNIT_ASSERT( !typesRegistry.areAncestryTablesValid() );
+
+   typesRegistry.buildAncestryTables();
+   CPPUNIT_ASSERT( typesRegistry.areAncestryTablesValid() );
+
+   DerivedTestClass instA;
+   TestClass instB;
+   TestClassWithPODArray instC;
+
+   CPPUNIT_ASSERT( instA.isA< DerivedTestClass >() );
+   CPPUNIT_ASSERT( instA.isA< TestClass >() );
+   CPPUNIT_ASSERT( !instA.isA< TestClassWithPODArray >() );
+
+   CPPUNIT_ASSERT( !instB.isA< DerivedTestClass >() );
+   CPPUNIT_ASSERT( instB.isA< TestClass >() );
+   CPPUNIT_ASSERT( !instB.isA< TestClassWithPODArray >() );
+
+   CPPUNIT_ASSERT( !instC.isA< TestClass >() );
+   CPPUNIT_ASSERT( instC.isA< TestClassWithPODArray >() );
+
+   // types that aren't a part of the registry are still recognized
+   CPPUNIT_ASSERT( instA.isA( SerializableReflectionType( "TestClass" ) ) );
+   CPPUNIT_ASSERT( !instB.isA( SerializableReflectionType( "DerivedTestClass" ) ) );
+
+   // changing the hierarchy invalidates the tables, but the results stay correct.
+   // Let's give one of the types a second parent
+   SerializableReflectionType* podArrayType = typesRegistry.findSerializable( "TestClassWithPODArray" );
+   podArrayType->addBaseType( "DerivedTestClass" );
+   CPPUNIT_ASSERT( !typesRegistry.areAncestryTablesValid() );
+   CPPUNIT_ASSERT( instC.isA< DerivedTestClass >() );
+   CPPUNIT_ASSERT( instC.isA< TestClass >() );
+
+   typesRegistry.buildAncestryTables();
+   CPPUNIT_ASSERT( instC.isA< DerivedTestClass >() );
+   CPPUNIT_ASSERT( instC.isA< TestClass >() );
+   CPPUNIT_ASSERT( instC.isA< TestClassWithPODArray >() );
+   CPPUNIT_ASSERT( !instA.isA< TestClassWithPODArray >() );
+
+   podArrayType->removeBaseType( DerivedTestClass::getStaticRTTI().m_id );
+   typesRegistry.buildAncestryTables();
+   CPPUNIT_ASSERT( !instC.isA< DerivedTestClass >() );
+   CPPUNIT_ASSERT( !instC.isA< TestClass >() );
+
+   // cleanup
+   typesRegistry.clear();
+   CPPUNIT_ASSERT( !typesRegistry.areAncestryTablesValid() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 TEST( Reflection, primitiveTypes )
 {
    // setup reflection types
@@ -318,3 +318,75 @@ TEST( ResourceHandle, unloadedResources )
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+TEST( ResourcesManager, createAsync )
+{
+   // setup reflection types
+   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+   typesRegistry.clear();
+   typesRegistry.addSerializableType< ReflectionObject >( "ReflectionObject", NULL );
+   typesRegistry.addSerializableType< Resource >( "Resource", NULL );
+   typesRegistry.addSerializableType< ResourceWithPointerMock >( "ResourceWithPointerMock", new TSerializableTypeInstantiator< ResourceWithPointerMock >() );
+
+   // setup patches DB
+   PatchesDB& patchesDB = TSingleton< PatchesDB >::getInstance();
+   patchesDB.clear();
+   typesRegistry.build( patchesDB );
+
+   // prepare the resources
+   ResourcesManager manager;
+   Filesystem filesystem( "..\\Data" );
+   manager.setFilesystem( filesystem );
+
+   FilePath resource1Name( "res1.rwp" );
+   ResourceWithPointerMock* res1 = new ResourceWithPointerMock( resource1Name );
+   manager.addResource( res1 );
+
+   FilePath resource2Name( "res2.rwp" );
+   ResourceWithPointerMock* res2 = new ResourceWithPointerMock( resource2Name );
+   manager.addResource( res2 );
+
+   res1->m_referencedRes = res2;
+   res2->m_referencedRes = res1;
+   res1->saveResource();
+
+   manager.reset();
+   res1 = NULL;
+   res2 = NULL;
+
+   // start loading the resource - it won't be registered until we wait for it
+   TResourceLoadHandle< ResourceWithPointerMock > handle = manager.createAsync< ResourceWithPointerMock >( resource1Name, true );
+   CPPUNIT_ASSERT( !handle.isNull() );
+   CPPUNIT_ASSERT( NULL == manager.findResource( resource1Name ) );
+
+   // requesting the same resource again gives us the same request
+   TResourceLoadHandle< ResourceWithPointerMock > duplicateHandle = manager.createAsync< ResourceWithPointerMock >( resource1Name, true );
+   CPPUNIT_ASSERT( handle.getRequest() == duplicateHandle.getRequest() );
+
+   ResourceWithPointerMock* restoredRes1 = manager.waitFor( handle );
+   CPPUNIT_ASSERT( restoredRes1 != NULL );
+   CPPUNIT_ASSERT( handle.isReady() );
+   CPPUNIT_ASSERT( duplicateHandle.get() == restoredRes1 );
+   CPPUNIT_ASSERT( manager.findResource( resource1Name ) == restoredRes1 );
+
+   // the dependency was loaded along with it
+   ResourceWithPointerMock* restoredRes2 = manager.findResource< ResourceWithPointerMock >( resource2Name );
+   CPPUNIT_ASSERT( restoredRes2 != NULL );
+   CPPUNIT_ASSERT( restoredRes1->m_referencedRes == restoredRes2 );
+   CPPUNIT_ASSERT( restoredRes2->m_referencedRes == restoredRes1 );
+
+   // a resource that's already registered is available right away
+   TResourceLoadHandle< ResourceWithPointerMock > loadedHandle = manager.createAsync< ResourceWithPointerMock >( resource2Name, true );
+   CPPUNIT_ASSERT( loadedHandle.isReady() );
+   CPPUNIT_ASSERT( loadedHandle.get() == restoredRes2 );
+
+   // a missing resource ends up as a NULL, once the background loads are processed
+   TResourceLoadHandle< ResourceWithPointerMock > missingHandle = manager.createAsync< ResourceWithPointerMock >( FilePath( "missing.rwp" ), true );
+   while ( !missingHandle.isReady() )
+   {
+      manager.processAsyncLoads();
+   }
+   CPPUNIT_ASSERT( NULL == missingHandle.get() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -13,6 +13,8 @@
 #include "core\PatchesDB.h"
 #include "core\ThreadSystem.h"
 #include "core\Thread.h"
+#include "core\Timer.h"
+#include "core\Log.h"
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -88,6 +90,37 @@ namespace // anonymous
 
    // -------------------------------------------------------------------------
 
+   struct SerializationTestVertex
+   {
+      float                               m_coords[4];
+      float                               m_normal[3];
+      float                               m_uv[2];
+   };
+
+   struct SerializationTestKey
+   {
+      int                                 m_id;
+      float                               m_time;
+
+      SerializationTestKey( int id = 0, float time = 0.0f ) : m_id( id ), m_time( time ) {}
+   };
+
+   // -------------------------------------------------------------------------
+
+   struct SerializationTestMesh : public ReflectionObject
+   {
+      DECLARE_STRUCT()
+
+      Array< SerializationTestVertex >    m_vertices;
+      std::vector< int >                  m_indices;
+   };
+   BEGIN_OBJECT( SerializationTestMesh );
+      PROPERTY( Array< SerializationTestVertex >, m_vertices );
+      PROPERTY( std::vector< int >, m_indices );
+   END_OBJECT();
+
+   // -------------------------------------------------------------------------
+
    struct SerializationTestClassWithPtrArray : public ReflectionObject
    {
       DECLARE_STRUCT()
@@ -194,6 +227,7 @@ DEFINE_TYPE_ID( SerializationTestClassNotifiable )
 DEFINE_TYPE_ID( SerializationTestClassWithSharedPointers )
 DEFINE_TYPE_ID( SerializationTestClassWithPtrArray )
 DEFINE_TYPE_ID( SerializationTestClassWithPODArray )
+DEFINE_TYPE_ID( SerializationTestMesh )
 DEFINE_TYPE_ID( SerializationTestClassWithPointers )
 DEFINE_TYPE_ID( DerivedSerializationTestClass )
 
@@ -367,6 +401,139 @@ TEST( Serialization, podsArrays )
 
 ///////////////////////////////////////////////////////////////////////////////
 
+TEST( Serialization, arraysOfNonPodTypes )
+{
+   Array< byte > memBuf;
+   InArrayStream inStream( memBuf );
+   OutArrayStream outStream( memBuf );
+
+   // elements of such arrays are serialized one by one, using their own serialization operators
+   Array< std::string > strings;
+   strings.push_back( "Hello" );
+   strings.push_back( "" );
+   strings.push_back( "world" );
+
+   Array< Array< int > > nestedArrays;
+   nestedArrays.resize( 2 );
+   nestedArrays[0].push_back( 1 );
+   nestedArrays[1].push_back( 2 );
+   nestedArrays[1].push_back( 3 );
+
+   outStream << strings << nestedArrays;
+
+   Array< std::string > restoredStrings;
+   Array< Array< int > > restoredNestedArrays;
+   inStream >> restoredStrings >> restoredNestedArrays;
+
+   CPPUNIT_ASSERT_EQUAL( (uint)3, restoredStrings.size() );
+   CPPUNIT_ASSERT_EQUAL( std::string( "Hello" ), restoredStrings[0] );
+   CPPUNIT_ASSERT_EQUAL( std::string( "" ), restoredStrings[1] );
+   CPPUNIT_ASSERT_EQUAL( std::string( "world" ), restoredStrings[2] );
+
+   CPPUNIT_ASSERT_EQUAL( (uint)2, restoredNestedArrays.size() );
+   CPPUNIT_ASSERT_EQUAL( (uint)1, restoredNestedArrays[0].size() );
+   CPPUNIT_ASSERT_EQUAL( (uint)2, restoredNestedArrays[1].size() );
+   CPPUNIT_ASSERT_EQUAL( 1, restoredNestedArrays[0][0] );
+   CPPUNIT_ASSERT_EQUAL( 2, restoredNestedArrays[1][0] );
+   CPPUNIT_ASSERT_EQUAL( 3, restoredNestedArrays[1][1] );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( Serialization, arraysOfTypesWithConstructors )
+{
+   Array< byte > memBuf;
+   InArrayStream inStream( memBuf );
+   OutArrayStream outStream( memBuf );
+
+   // such arrays are streamed as the memory images of their elements, which is how the existing resources store them
+   Array< SerializationTestKey > keys;
+   keys.push_back( SerializationTestKey( 1, 0.5f ) );
+   keys.push_back( SerializationTestKey( 2, 1.5f ) );
+   outStream << keys;
+
+   CPPUNIT_ASSERT_EQUAL( (uint)( sizeof( uint ) + sizeof( SerializationTestKey ) * 2 ), memBuf.size() );
+   CPPUNIT_ASSERT( memcmp( (const byte*)memBuf + sizeof( uint ), (const SerializationTestKey*)keys, sizeof( SerializationTestKey ) * 2 ) == 0 );
+
+   Array< SerializationTestKey > restoredKeys;
+   inStream >> restoredKeys;
+
+   CPPUNIT_ASSERT_EQUAL( (uint)2, restoredKeys.size() );
+   CPPUNIT_ASSERT_EQUAL( 2, restoredKeys[1].m_id );
+   CPPUNIT_ASSERT_EQUAL( 1.5f, restoredKeys[1].m_time );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( Serialization, largePodArraysPerformance )
+{
+   // setup reflection types
+   ReflectionTypesRegistry& typesRegistry = TSingleton< ReflectionTypesRegistry >::getInstance();
+   typesRegistry.clear();
+   typesRegistry.addSerializableType< Resource >( "Resource", NULL );
+   typesRegistry.addSerializableType< SerializationTestMesh >( "SerializationTestMesh", new TSerializableTypeInstantiator< SerializationTestMesh >() );
+
+   // setup patches DB
+   PatchesDB& patchesDB = TSingleton< PatchesDB >::getInstance();
+   patchesDB.clear();
+   typesRegistry.build( patchesDB );
+
+   // prepare the serializers
+   Array< byte > memBuf;
+   InArrayStream inStream( memBuf );
+   OutArrayStream outStream( memBuf );
+
+   // create a large mesh
+   const uint verticesCount = 100000;
+   SerializationTestMesh mesh;
+   mesh.m_vertices.resize( verticesCount );
+   mesh.m_indices.resize( verticesCount * 3 );
+   for ( uint i = 0; i < verticesCount; ++i )
+   {
+      SerializationTestVertex& vtx = mesh.m_vertices[i];
+      for ( uint j = 0; j < 4; ++j )
+      {
+         vtx.m_coords[j] = (float)( i + j );
+      }
+      for ( uint j = 0; j < 3; ++j )
+      {
+         vtx.m_normal[j] = (float)j;
+         mesh.m_indices[i * 3 + j] = ( i + j ) % verticesCount;
+      }
+      vtx.m_uv[0] = vtx.m_uv[1] = 0.5f;
+   }
+
+   CTimer timer;
+   timer.tick();
+
+   ReflectionSaver saver( outStream );
+   saver.save( &mesh );
+   saver.flush();
+
+   timer.tick();
+   float saveDuration = timer.getTimeElapsed();
+
+   ReflectionLoader loader;
+   loader.deserialize( inStream );
+   SerializationTestMesh* restoredMesh = loader.getNextObject< SerializationTestMesh >();
+
+   timer.tick();
+   float loadDuration = timer.getTimeElapsed();
+
+   CPPUNIT_ASSERT( restoredMesh != NULL );
+   CPPUNIT_ASSERT_EQUAL( verticesCount, restoredMesh->m_vertices.size() );
+   CPPUNIT_ASSERT_EQUAL( verticesCount * 3, (uint)restoredMesh->m_indices.size() );
+   CPPUNIT_ASSERT( memcmp( (const SerializationTestVertex*)mesh.m_vertices, (const SerializationTestVertex*)restoredMesh->m_vertices, sizeof( SerializationTestVertex ) * verticesCount ) == 0 );
+   CPPUNIT_ASSERT( mesh.m_indices == restoredMesh->m_indices );
+
+   LOG( "Serialization: %d bytes of vertex data - saved in %.3f ms, loaded in %.3f ms", sizeof( SerializationTestVertex ) * verticesCount, saveDuration * 1000.0f, loadDuration * 1000.0f );
+
+   // cleanup
+   delete restoredMesh;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 TEST( Serialization, pointersArrays )
 {
    // setup reflection types
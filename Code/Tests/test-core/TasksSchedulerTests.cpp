@@ -3,6 +3,9 @@
 #include "core\MultithreadedTask.h"
 #include "core\Thread.h"
 #include "core\CriticalSection.h"
+#include "core\Atomic.h"
+#include "core\Timer.h"
+#include "core\Log.h"
 #include "core\math.h"
 #include <set>
 
@@ -145,6 +148,49 @@ namespace
          m_endTime.push_back( m_timer.getTimestamp() );
       }
    };
+
+   // -------------------------------------------------------------------------
+
+   struct CountingTaskMock : public MultithreadedTask
+   {
+      DECLARE_ALLOCATOR( CountingTaskMock, AM_DEFAULT );
+
+      AtomicInt*        m_counter;
+
+      CountingTaskMock()
+         : m_counter( NULL )
+      {}
+
+      void run()
+      {
+         m_counter->increment();
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   struct SpawningTaskMock : public MultithreadedTask
+   {
+      DECLARE_ALLOCATOR( SpawningTaskMock, AM_DEFAULT );
+
+      MultithreadedTasksScheduler*  m_scheduler;
+      CountingTaskMock*             m_children;
+      uint                          m_childrenCount;
+
+      SpawningTaskMock( MultithreadedTasksScheduler& scheduler, CountingTaskMock* children, uint childrenCount )
+         : m_scheduler( &scheduler )
+         , m_children( children )
+         , m_childrenCount( childrenCount )
+      {}
+
+      void run()
+      {
+         for ( uint i = 0; i < m_childrenCount; ++i )
+         {
+            m_scheduler->spawn( m_children[i] );
+         }
+      }
+   };
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -330,3 +376,96 @@ TEST( TasksScheduler, workerThreads )
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+TEST( TasksScheduler, spawningTasksFromWorkerThreads )
+{
+   MultithreadedTasksScheduler scheduler( 4 );
+
+   const uint childrenCount = 100;
+   AtomicInt counter;
+   CountingTaskMock* children = new CountingTaskMock[childrenCount];
+   for ( uint i = 0; i < childrenCount; ++i )
+   {
+      children[i].m_counter = &counter;
+   }
+
+   SpawningTaskMock parent( scheduler, children, childrenCount );
+   scheduler.run( parent );
+
+   // wait for the tasks to complete
+   while( scheduler.getAllTasksCount() > 0 || parent.getStatus() != MultithreadedTask::MTS_Completed )
+   {
+      Thread::yield();
+   }
+
+   CPPUNIT_ASSERT_EQUAL( (long)childrenCount, counter.get() );
+   for ( uint i = 0; i < childrenCount; ++i )
+   {
+      CPPUNIT_ASSERT_EQUAL( MultithreadedTask::MTS_Completed, children[i].getStatus() );
+   }
+
+   // cleanup
+   delete [] children;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( TasksScheduler, throughput )
+{
+   MultithreadedTasksScheduler scheduler( 4 );
+
+   const uint tasksCount = 1000;
+   const uint roundsCount = 100;
+   AtomicInt counter;
+   CountingTaskMock* tasks = new CountingTaskMock[tasksCount];
+   for ( uint i = 0; i < tasksCount; ++i )
+   {
+      tasks[i].m_counter = &counter;
+   }
+
+   CTimer timer;
+   timer.tick();
+
+   // tasks scheduled from outside of the workers go through the shared queue
+   for ( uint round = 0; round < roundsCount; ++round )
+   {
+      for ( uint i = 0; i < tasksCount; ++i )
+      {
+         scheduler.run( tasks[i] );
+      }
+
+      while( scheduler.getAllTasksCount() > 0 )
+      {
+         // spin - we're measuring the throughput here, and yielding would skew the results
+      }
+   }
+
+   timer.tick();
+   float sharedQueueDuration = timer.getTimeElapsed();
+   CPPUNIT_ASSERT_EQUAL( (long)( tasksCount * roundsCount ), counter.get() );
+
+   // tasks spawned by a worker go to its local queue, and the remaining workers steal them
+   counter.set( 0 );
+   SpawningTaskMock parent( scheduler, tasks, tasksCount );
+
+   timer.tick();
+   for ( uint round = 0; round < roundsCount; ++round )
+   {
+      scheduler.run( parent );
+
+      while( scheduler.getAllTasksCount() > 0 || parent.getStatus() != MultithreadedTask::MTS_Completed )
+      {
+      }
+   }
+
+   timer.tick();
+   float localQueuesDuration = timer.getTimeElapsed();
+   CPPUNIT_ASSERT_EQUAL( (long)( tasksCount * roundsCount ), counter.get() );
+
+   LOG( "TasksScheduler: %d tasks - shared queue %.3f ms, local queues %.3f ms", tasksCount * roundsCount, sharedQueueDuration * 1000.0f, localQueuesDuration * 1000.0f );
+
+   // cleanup
+   delete [] tasks;
+}
+
+///////////////////////////////////////////////////////////////////////////////
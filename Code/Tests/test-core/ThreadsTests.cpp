@@ -5,7 +5,11 @@
 #include "core\Mutex.h"
 #include "core\Semaphore.h"
 #include "core\CriticalSection.h"
+#include "core\ConditionVariable.h"
+#include "core\Timer.h"
+#include "core\Log.h"
 #include <vector>
+#include <windows.h>
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -174,6 +178,143 @@ namespace
    };
 
    CriticalSection CriticalSectionedTaskMock::s_criticalSection;
+
+   // -------------------------------------------------------------------------
+
+   struct ThreadLookupTaskMock : public Runnable
+   {
+      Thread*                 m_hostThread;
+      bool                    m_useLockedLookup;
+      uint                    m_lookupsCount;
+      uint                    m_mismatchesCount;
+      volatile bool*          m_start;
+
+      ThreadLookupTaskMock()
+         : m_hostThread( NULL )
+         , m_useLockedLookup( false )
+         , m_lookupsCount( 0 )
+         , m_mismatchesCount( 0 )
+         , m_start( NULL )
+      {
+      }
+
+      void run()
+      {
+         while ( !*m_start )
+         {
+            Thread::yield();
+         }
+
+         ThreadSystem& threadSystem = TSingleton< ThreadSystem >::getInstance();
+         ulong threadId = Thread::getCurrentThreadId();
+         for ( uint i = 0; i < m_lookupsCount; ++i )
+         {
+            Thread* thread = m_useLockedLookup ? threadSystem.findThread( threadId ) : &threadSystem.getCurrentThread();
+            if ( thread != m_hostThread )
+            {
+               ++m_mismatchesCount;
+            }
+         }
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   float measureThreadLookups( bool useLockedLookup, uint& outMismatchesCount )
+   {
+      const uint threadsCount = 8;
+      Thread threads[threadsCount];
+      ThreadLookupTaskMock tasks[threadsCount];
+      volatile bool start = false;
+
+      for ( uint i = 0; i < threadsCount; ++i )
+      {
+         tasks[i].m_hostThread = &threads[i];
+         tasks[i].m_useLockedLookup = useLockedLookup;
+         tasks[i].m_lookupsCount = 100000;
+         tasks[i].m_start = &start;
+         threads[i].start( tasks[i] );
+      }
+
+      CTimer timer;
+      timer.tick();
+      start = true;
+      for ( uint i = 0; i < threadsCount; ++i )
+      {
+         threads[i].join();
+      }
+      timer.tick();
+
+      outMismatchesCount = 0;
+      for ( uint i = 0; i < threadsCount; ++i )
+      {
+         outMismatchesCount += tasks[i].m_mismatchesCount;
+      }
+
+      return timer.getTimeElapsed();
+   }
+
+   // -------------------------------------------------------------------------
+
+   float getThreadCpuTime()
+   {
+      FILETIME creationTime, exitTime, kernelTime, userTime;
+      GetThreadTimes( GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime );
+
+      // the times are expressed in 100 nanosecond units
+      unsigned __int64 kernelTicks = ( (unsigned __int64)kernelTime.dwHighDateTime << 32 ) | kernelTime.dwLowDateTime;
+      unsigned __int64 userTicks = ( (unsigned __int64)userTime.dwHighDateTime << 32 ) | userTime.dwLowDateTime;
+      return (float)( kernelTicks + userTicks ) * 1e-7f;
+   }
+
+   // -------------------------------------------------------------------------
+
+   struct FlagSetPredicate
+   {
+      const volatile bool&    m_flag;
+
+      FlagSetPredicate( const volatile bool& flag ) : m_flag( flag ) {}
+
+      bool operator()() const
+      {
+         return m_flag;
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   struct ConditionWaiterMock : public Runnable
+   {
+      CriticalSection&        m_lock;
+      ConditionVariable&      m_condition;
+      volatile bool&          m_flag;
+      float                   m_cpuTime;
+
+      ConditionWaiterMock( CriticalSection& lock, ConditionVariable& condition, volatile bool& flag )
+         : m_lock( lock )
+         , m_condition( condition )
+         , m_flag( flag )
+         , m_cpuTime( 0.0f )
+      {
+      }
+
+      void run()
+      {
+         float startTime = getThreadCpuTime();
+         m_condition.waitUntil( m_lock, FlagSetPredicate( m_flag ) );
+         m_cpuTime = getThreadCpuTime() - startTime;
+      }
+   };
+
+   // -------------------------------------------------------------------------
+
+   void signalFlag( CriticalSection& lock, ConditionVariable& condition, volatile bool& flag )
+   {
+      lock.enter();
+      flag = true;
+      condition.notifyAll();
+      lock.leave();
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -296,3 +437,127 @@ TEST( CriticalSection, exclusiveAccessToResource )
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+TEST( ThreadSystem, currentThreadLookup )
+{
+   ThreadSystem& threadSystem = TSingleton< ThreadSystem >::getInstance();
+   CPPUNIT_ASSERT( threadSystem.isMainThread() );
+   CPPUNIT_ASSERT_EQUAL( threadSystem.findThread( threadSystem.getMainThreadId() ), &threadSystem.getCurrentThread() );
+
+   // each thread should see its own instance
+   uint mismatchesCount = 0;
+   measureThreadLookups( false, mismatchesCount );
+   CPPUNIT_ASSERT_EQUAL( (uint)0, mismatchesCount );
+
+   measureThreadLookups( true, mismatchesCount );
+   CPPUNIT_ASSERT_EQUAL( (uint)0, mismatchesCount );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( ThreadSystem, currentThreadLookupContention )
+{
+   // 8 threads hammering the lookup at the same time - each of them should keep seeing its own instance
+   uint mismatchesCount = 0;
+   float lockedLookupDuration = measureThreadLookups( true, mismatchesCount );
+   CPPUNIT_ASSERT_EQUAL( (uint)0, mismatchesCount );
+
+   float threadLocalLookupDuration = measureThreadLookups( false, mismatchesCount );
+   CPPUNIT_ASSERT_EQUAL( (uint)0, mismatchesCount );
+
+   LOG( "ThreadSystem: current thread lookups under contention - locked %.3f ms, thread local %.3f ms", lockedLookupDuration * 1000.0f, threadLocalLookupDuration * 1000.0f );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( ConditionVariable, waitingForCondition )
+{
+   CriticalSection lock;
+   ConditionVariable condition;
+   volatile bool flag = false;
+
+   const uint threadsCount = 3;
+   Thread threads[threadsCount];
+   ConditionWaiterMock* waiters[threadsCount];
+   for ( uint i = 0; i < threadsCount; ++i )
+   {
+      waiters[i] = new ConditionWaiterMock( lock, condition, flag );
+      threads[i].start( *waiters[i] );
+   }
+
+   Sleep( 50 );
+
+   // all threads are still waiting - signal the flag to release them
+   signalFlag( lock, condition, flag );
+   for ( uint i = 0; i < threadsCount; ++i )
+   {
+      threads[i].join();
+      delete waiters[i];
+   }
+
+   // a condition that's already fulfilled doesn't block at all
+   ConditionWaiterMock waiter( lock, condition, flag );
+   waiter.run();
+   CPPUNIT_ASSERT( flag );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( ConditionVariable, adaptiveSpinning )
+{
+   CriticalSection lock;
+   ConditionVariable condition;
+   volatile bool flag = false;
+
+   // when the threads keep having to go to sleep, the spinning stops paying off and is reduced to a minimum
+   for ( uint i = 0; i < 16; ++i )
+   {
+      flag = false;
+
+      Thread thread;
+      ConditionWaiterMock waiter( lock, condition, flag );
+      thread.start( waiter );
+
+      Sleep( 10 );
+      signalFlag( lock, condition, flag );
+      thread.join();
+   }
+   CPPUNIT_ASSERT_EQUAL( ConditionVariable::MIN_SPINS_COUNT, condition.getSpinsLimit() );
+
+   // when the condition is fulfilled as soon as it's checked, the thread can afford to spin longer
+   ConditionWaiterMock waiter( lock, condition, flag );
+   for ( uint i = 0; i < 16; ++i )
+   {
+      waiter.run();
+   }
+   CPPUNIT_ASSERT_EQUAL( ConditionVariable::MAX_SPINS_COUNT, condition.getSpinsLimit() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( ConditionVariable, idleThreadCpuUsage )
+{
+   CriticalSection lock;
+   ConditionVariable condition;
+   volatile bool flag = false;
+
+   Thread thread;
+   ConditionWaiterMock waiter( lock, condition, flag );
+   thread.start( waiter );
+
+   // keep the thread waiting for a quarter of a second
+   CTimer timer;
+   timer.tick();
+   Sleep( 250 );
+   signalFlag( lock, condition, flag );
+   thread.join();
+   timer.tick();
+
+   CPPUNIT_ASSERT( flag );
+
+   // a sleeping thread doesn't get scheduled, so it should consume only a tiny fraction of that time
+   // ( the measurement granularity is that of a scheduler's quantum )
+   LOG( "ConditionVariable: idle thread - waited %.3f ms, consumed %.3f ms of CPU time", timer.getTimeElapsed() * 1000.0f, waiter.m_cpuTime * 1000.0f );
+}
+
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,149 @@
+#include "core-TestFramework\TestFramework.h"
+#include "core\WorkStealingQueue.h"
+#include "core\Thread.h"
+#include "core\Runnable.h"
+#include <vector>
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace 
+{
+   struct ThiefMock : public Runnable
+   {
+      WorkStealingQueue< int >*     m_queue;
+      std::vector< int >            m_stolenElements;
+      volatile bool*                m_ownerFinished;
+
+      ThiefMock( WorkStealingQueue< int >& queue, volatile bool& ownerFinished )
+         : m_queue( &queue )
+         , m_ownerFinished( &ownerFinished )
+      {}
+
+      void run()
+      {
+         int elem;
+         while ( !*m_ownerFinished || !m_queue->empty() )
+         {
+            if ( m_queue->steal( elem ) )
+            {
+               m_stolenElements.push_back( elem );
+            }
+         }
+      }
+   };
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( WorkStealingQueue, ownerAndThiefOrder )
+{
+   WorkStealingQueue< int > queue( 8 );
+   CPPUNIT_ASSERT( queue.empty() );
+
+   for ( int i = 0; i < 4; ++i )
+   {
+      CPPUNIT_ASSERT( queue.push( i ) );
+   }
+   CPPUNIT_ASSERT_EQUAL( (uint)4, queue.size() );
+
+   // the owner takes the most recently added elements...
+   int elem = -1;
+   CPPUNIT_ASSERT( queue.pop( elem ) );
+   CPPUNIT_ASSERT_EQUAL( 3, elem );
+
+   // ...and the thieves the oldest ones
+   CPPUNIT_ASSERT( queue.steal( elem ) );
+   CPPUNIT_ASSERT_EQUAL( 0, elem );
+
+   CPPUNIT_ASSERT( queue.pop( elem ) );
+   CPPUNIT_ASSERT_EQUAL( 2, elem );
+   CPPUNIT_ASSERT( queue.pop( elem ) );
+   CPPUNIT_ASSERT_EQUAL( 1, elem );
+
+   CPPUNIT_ASSERT( !queue.pop( elem ) );
+   CPPUNIT_ASSERT( !queue.steal( elem ) );
+   CPPUNIT_ASSERT( queue.empty() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( WorkStealingQueue, capacityLimit )
+{
+   WorkStealingQueue< int > queue( 4 );
+
+   for ( int i = 0; i < 4; ++i )
+   {
+      CPPUNIT_ASSERT( queue.push( i ) );
+   }
+   CPPUNIT_ASSERT( !queue.push( 4 ) );
+
+   // the space freed by a thief can be reused
+   int elem = -1;
+   CPPUNIT_ASSERT( queue.steal( elem ) );
+   CPPUNIT_ASSERT( queue.push( 4 ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+TEST( WorkStealingQueue, concurrentStealing )
+{
+   const int elementsCount = 100000;
+   WorkStealingQueue< int > queue( 256 );
+   volatile bool ownerFinished = false;
+
+   ThiefMock thief1( queue, ownerFinished );
+   ThiefMock thief2( queue, ownerFinished );
+   Thread thread1;
+   Thread thread2;
+   thread1.start( thief1 );
+   thread2.start( thief2 );
+
+   // every element needs to be taken exactly once - either by the owner or by one of the thieves
+   std::vector< int > poppedElements;
+   int elem;
+   for ( int i = 0; i < elementsCount; ++i )
+   {
+      while ( !queue.push( i ) )
+      {
+         if ( queue.pop( elem ) )
+         {
+            poppedElements.push_back( elem );
+         }
+      }
+
+      if ( ( i % 3 ) == 0 && queue.pop( elem ) )
+      {
+         poppedElements.push_back( elem );
+      }
+   }
+   while ( queue.pop( elem ) )
+   {
+      poppedElements.push_back( elem );
+   }
+   ownerFinished = true;
+
+   thread1.join();
+   thread2.join();
+
+   std::vector< int > occurrences( elementsCount, 0 );
+   for ( uint i = 0; i < poppedElements.size(); ++i )
+   {
+      ++occurrences[ poppedElements[i] ];
+   }
+   for ( uint i = 0; i < thief1.m_stolenElements.size(); ++i )
+   {
+      ++occurrences[ thief1.m_stolenElements[i] ];
+   }
+   for ( uint i = 0; i < thief2.m_stolenElements.size(); ++i )
+   {
+      ++occurrences[ thief2.m_stolenElements[i] ];
+   }
+
+   for ( int i = 0; i < elementsCount; ++i )
+   {
+      CPPUNIT_ASSERT_EQUAL( 1, occurrences[i] );
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////